@@ -2,6 +2,14 @@
 #define OMEGA_DAW_ADVANCED_EFFECTS_H
 
 #include "AudioEngine.h"
+#include "BiquadCascade.h"
+#include "Convolver.h"
+#include "GraphCompiler.h"
+#include "STFT.h"
+#include <atomic>
+#include <complex>
+#include <mutex>
+#include <string>
 #include <vector>
 #include <cmath>
 #include <algorithm>
@@ -16,6 +24,7 @@ class StereoEnhancer : public IAudioProcessor {
     void process(float** inputs, float** outputs, int numChannels, int numFrames) override;
     void prepare(int sampleRate, int maxBufferSize) override;
     std::string getName() const override { return "Stereo Enhancer"; }
+    double getTailLengthSeconds() const override { return 0.0; }
     
     void setWidth(float width); // 0.0 = mono, 1.0 = normal, 2.0 = ultra wide
     float getWidth() const { return width_; }
@@ -60,31 +69,60 @@ class MultibandCompressor : public IAudioProcessor {
     int maxBufferSize_;
 };
 
-// Convolution Reverb - high quality reverb using impulse responses
+// Convolution Reverb - partitioned FFT convolution with an impulse response
 class ConvolutionReverb : public IAudioProcessor {
 public:
     ConvolutionReverb();
+    ~ConvolutionReverb();
     
     void process(float** inputs, float** outputs, int numChannels, int numFrames) override;
     void prepare(int sampleRate, int maxBufferSize) override;
     std::string getName() const override { return "Convolution Reverb"; }
+    double getTailLengthSeconds() const override;
+    int getLatencySamples() const override { return convolver_.getLatency(); }
     
+    // Impulse responses have 1, 2 or 4 channels (true stereo: LL, LR, RL,
+    // RR). They are read, partitioned and transformed on a background
+    // thread and crossfaded in a block or so later; flushImpulseResponse()
+    // waits for that.
     bool loadImpulseResponse(const std::string& filename);
+    void setImpulseResponse(const float* ir, int irLength, int numChannels); // Interleaved frames
+    void flushImpulseResponse();
+    
     void setDryWetMix(float mix); // 0.0 = dry, 1.0 = wet
+    float getDryWetMix() const { return dryWet_; }
     void setPreDelay(float delayMs);
     
+    // Partitioning (see Convolver), applied at the next prepare(). Low
+    // latency is the default; non-uniform partitions suit long responses.
+    void setLowLatency(bool enabled);
+    void setNonUniformPartitions(bool enabled);
+    
 private:
-    std::vector<float> impulseResponse_;
-    std::vector<float> inputHistory_;
-    int historyPosition_;
+    void buildImpulseResponse();
+    void updateTailLength();
+    
+    Convolver convolver_;
+    std::vector<std::vector<float>> wet_;
+    std::vector<float*> wetPointers_;
+    std::vector<const float*> inputPointers_;
     float dryWet_;
-    int preDelayFrames_;
-    std::vector<float> preDelayBuffer_;
-    int preDelayPosition_;
     int sampleRate_;
+    int maxBufferSize_;
+    std::atomic<bool> hasResponse_;
+    std::atomic<int> tailFrames_;
+    
+    // Shared with the loader thread
+    std::mutex sourceMutex_;
+    std::string pendingFile_;
+    std::vector<std::vector<float>> source_;
+    int preDelayFrames_;
+    ConvolverLayout layout_;
+    
+    GraphCompiler loader_;
 };
 
-// Parametric EQ - 4-band parametric equalizer
+// Parametric EQ - 4-band parametric equalizer; band changes glide over a block
 class ParametricEQ : public IAudioProcessor {
 public:
     enum FilterType {
@@ -105,8 +143,6 @@ class ParametricEQ : public IAudioProcessor {
         
         // Filter coefficients
         float b0, b1, b2, a1, a2;
-        // Filter state (per channel)
-        std::vector<float> x1, x2, y1, y2;
     };
     
     ParametricEQ();
@@ -114,6 +150,7 @@ class ParametricEQ : public IAudioProcessor {
     void process(float** inputs, float** outputs, int numChannels, int numFrames) override;
     void prepare(int sampleRate, int maxBufferSize) override;
     std::string getName() const override { return "Parametric EQ"; }
+    double getTailLengthSeconds() const override;
     
     void setBand(int index, FilterType type, float freq, float Q, float gainDB);
     void setBandEnabled(int index, bool enabled);
@@ -122,11 +159,11 @@ class ParametricEQ : public IAudioProcessor {
     
 private:
     void calculateCoefficients(EQBand& band);
-    float processSample(float input, EQBand& band, int channel);
     
     std::vector<EQBand> bands_;
     int sampleRate_;
     int numChannels_;
+    BiquadCascade cascade_;   // One section per band; disabled bands pass through
 };
 
 // Spectral Gate - frequency-dependent noise gate
@@ -137,19 +174,28 @@ class SpectralGate : public IAudioProcessor {
     void process(float** inputs, float** outputs, int numChannels, int numFrames) override;
     void prepare(int sampleRate, int maxBufferSize) override;
     std::string getName() const override { return "Spectral Gate"; }
+    double getTailLengthSeconds() const override;
+    int getLatencySamples() const override { return stft_.getLatency(); }
     
+    // Threshold in dB relative to a full-scale sine in one bin
     void setThreshold(float thresholdDB);
     void setReduction(float reductionDB);
     void setAttack(float attackMs);
     void setRelease(float releaseMs);
     
 private:
+    void gateSpectrum(int channel, std::complex<float>* bins, int numBins);
+    void updateCoefficients();
+    
     float threshold_;
     float reduction_;
-    float attackCoeff_;
+    float attackMs_;
+    float releaseMs_;
+    float attackCoeff_;   // Per hop
     float releaseCoeff_;
-    std::vector<float> envelopes_;
+    std::vector<std::vector<float>> envelopes_;  // Per channel, per bin (magnitude)
     int sampleRate_;
+    StreamingSTFT stft_;
 };
 
 // Tube Saturation - analog-style harmonic saturation
@@ -4,6 +4,7 @@
 #include <memory>
 #include <string>
 #include "Clip.h"
+#include "ScratchArena.h"
 #include "Track.h"
 #include "Transport.h"
 
@@ -47,7 +48,8 @@ class Arrangement {
     void start();
     void stop();
     void shutdown();
-    AudioBuffer renderAtPosition(double position);
+    // The returned buffer is borrowed from the arena's current scope
+    AudioBufferView renderAtPosition(double position, int numSamples, ScratchArena& arena);
     void loadFromProject(class Project* project);
     std::string serialize() const;
     
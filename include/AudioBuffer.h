@@ -2,41 +2,123 @@
 #define OMEGA_DAW_AUDIO_BUFFER_H
 
 #include <vector>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 
 namespace OmegaDAW {
 
+class AudioBuffer;
+
+// Non-owning window onto planar channel data
+//
+// Holds its own channel pointer array, so a sub-block slice needs no copy and
+// getArrayOfPointers() can go straight to IAudioProcessor::process(). The
+// data must outlive the view.
+class AudioBufferView {
+public:
+    static constexpr int kMaxChannels = 32;
+
+    AudioBufferView();
+    AudioBufferView(float* const* channels, int numChannels, int numSamples);
+
+    int getNumChannels() const { return numChannels_; }
+    int getNumSamples() const { return numSamples_; }
+
+    float* getChannel(int channel) const { return channels_[channel]; }
+    float** getArrayOfPointers() { return channels_; }
+    const float* const* getArrayOfReadPointers() const { return channels_; }
+
+    // Samples [startSample, startSample + numSamples), clamped to this view
+    AudioBufferView getSubView(int startSample, int numSamples) const;
+
+    void clear();
+    void applyGain(float gain);
+    void applyGainRamp(float startGain, float endGain);
+    void copyFrom(const AudioBufferView& other);
+    void addFrom(const AudioBufferView& other, float gain = 1.0f);
+    void addFromWithRamp(const AudioBufferView& other, float startGain, float endGain);
+
+private:
+    float* channels_[kMaxChannels];
+    int numChannels_;
+    int numSamples_;
+};
+
+// Planar audio in one 64-byte aligned allocation
+//
+// Channels are laid out back to back with the stride padded to a whole cache
+// line, so every channel starts aligned. The channel pointer array is kept
+// up to date for handing to processors. Shrinking (and growing back within
+// the allocated size) never reallocates.
+//
+// The silence flag is set only while every sample is known to be zero:
+// clear() sets it, the math below keeps it, and anything that hands out
+// write access drops it. Adding a silent buffer is skipped entirely.
 class AudioBuffer {
 public:
+    static constexpr size_t kAlignment = 64;
+
     AudioBuffer(int numChannels = 2, int numSamples = 0);
-    ~AudioBuffer() = default;
+    ~AudioBuffer();
+
+    AudioBuffer(const AudioBuffer& other);
+    AudioBuffer(AudioBuffer&& other) noexcept;
+    AudioBuffer& operator=(const AudioBuffer& other);
+    AudioBuffer& operator=(AudioBuffer&& other) noexcept;
 
     void resize(int numSamples);
     void setSize(int numChannels, int numSamples);
     void clear();
-    
+
     float* getChannelData(int channel);
     const float* getChannelData(int channel) const;
     float* getWritePointer(int channel) { return getChannelData(channel); }
     const float* getReadPointer(int channel) const { return getChannelData(channel); }
-    
+
+    // One pointer per channel, valid until the next resize that reallocates
+    float** getArrayOfWritePointers() { silent_ = false; return channelPointers_.data(); }
+    const float* const* getArrayOfReadPointers() const { return channelPointers_.data(); }
+
+    // Zero-copy views of the whole buffer or a range of samples
+    AudioBufferView getView();
+    AudioBufferView getSubView(int startSample, int numSamples);
+
     int getNumChannels() const { return numChannels_; }
     int getNumSamples() const { return numSamples_; }
-    
+    int getChannelStride() const { return channelStride_; }
+
     void setSample(int channel, int sample, float value);
     float getSample(int channel, int sample) const;
-    
+
+    // Math runs on the SIMD kernels for the detected instruction set
     void copyFrom(const AudioBuffer& other);
     void addFrom(const AudioBuffer& other, float gain = 1.0f);
-    
+    void addFromWithRamp(const AudioBuffer& other, float startGain, float endGain);
+    void addProductFrom(const AudioBuffer& a, const AudioBuffer& b);  // this += a * b
+
     void applyGain(float gain);
     void applyGainRamp(float startGain, float endGain);
 
+    bool isSilent() const { return silent_; }
+    // For writers that know what they produced (through the write pointers)
+    void setSilent(bool silent) { silent_ = silent; }
+    // Scans the samples unless already flagged; flags a buffer that is all
+    // zeros and never changes the samples
+    bool detectSilence();
+
 private:
+    void allocate(int numChannels, int channelStride);
+    void release();
+    void updateChannelPointers();
+
     int numChannels_;
     int numSamples_;
-    std::vector<std::vector<float>> channelData_;
+    int channelStride_;       // Floats between channel starts
+    size_t capacity_;         // Floats in data_
+    float* data_;
+    std::vector<float*> channelPointers_;
+    bool silent_;
 };
 
 } // namespace OmegaDAW
@@ -0,0 +1,208 @@
+#ifndef OMEGA_DAW_AUDIO_DEVICE_H
+#define OMEGA_DAW_AUDIO_DEVICE_H
+
+#include "FileIO.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Include PortAudio for types
+#include <portaudio.h>
+
+namespace OmegaDAW {
+
+// Audio device info
+struct AudioDeviceInfo {
+    int index;
+    std::string name;
+    int maxInputChannels;
+    int maxOutputChannels;
+    double defaultSampleRate;
+};
+
+struct AudioStreamConfig {
+    int sampleRate = 48000;
+    int bufferSize = 256;
+    int numOutputChannels = 2;
+    int numInputChannels = 0;
+    int outputDeviceIndex = -1;  // -1 selects the backend default
+    int inputDeviceIndex = -1;
+};
+
+// Called on the device thread with interleaved buffers.
+// input is null when the stream has no input channels.
+using AudioDeviceCallback = void (*)(const float* input, float* output, int numFrames, void* userData);
+
+// Device backend behind AudioEngine
+class IAudioDeviceBackend {
+public:
+    virtual ~IAudioDeviceBackend() = default;
+
+    virtual std::string getName() const = 0;
+
+    // Device enumeration
+    virtual std::vector<AudioDeviceInfo> getDevices() = 0;
+    virtual bool getDeviceInfo(int deviceIndex, AudioDeviceInfo& info) = 0;
+
+    // Stream lifetime
+    virtual bool open(const AudioStreamConfig& config, AudioDeviceCallback callback, void* userData) = 0;
+    virtual void close() = 0;
+    virtual bool start() = 0;
+    virtual void stop() = 0;
+    virtual bool isOpen() const = 0;
+    virtual bool isRunning() const = 0;
+
+    // Stream properties (valid while open)
+    virtual std::string getOutputDeviceName() const { return getName(); }
+    virtual std::string getInputDeviceName() const { return getName(); }
+    virtual double getInputLatency() const { return 0.0; }
+    virtual double getOutputLatency() const { return 0.0; }
+    virtual float getCPULoad() const { return 0.0f; }
+};
+
+// Hardware devices through PortAudio
+class PortAudioBackend : public IAudioDeviceBackend {
+public:
+    PortAudioBackend();
+    ~PortAudioBackend() override;
+
+    std::string getName() const override { return "PortAudio"; }
+
+    std::vector<AudioDeviceInfo> getDevices() override;
+    bool getDeviceInfo(int deviceIndex, AudioDeviceInfo& info) override;
+
+    bool open(const AudioStreamConfig& config, AudioDeviceCallback callback, void* userData) override;
+    void close() override;
+    bool start() override;
+    void stop() override;
+    bool isOpen() const override { return stream_ != nullptr; }
+    bool isRunning() const override { return running_; }
+
+    std::string getOutputDeviceName() const override { return outputDeviceName_; }
+    std::string getInputDeviceName() const override { return inputDeviceName_; }
+    double getInputLatency() const override { return inputLatency_; }
+    double getOutputLatency() const override { return outputLatency_; }
+    float getCPULoad() const override;
+
+private:
+    // PortAudio callback (static for C API)
+    static int streamCallback(const void* inputBuffer, void* outputBuffer,
+                              unsigned long framesPerBuffer,
+                              const struct ::PaStreamCallbackTimeInfo* timeInfo,
+                              unsigned long statusFlags, void* userData);
+
+    bool paInitialized_;
+    PaStream* stream_;
+    bool running_;
+
+    AudioDeviceCallback callback_;
+    void* userData_;
+
+    std::string outputDeviceName_;
+    std::string inputDeviceName_;
+    double inputLatency_;
+    double outputLatency_;
+};
+
+// Device-less backend driven by a high-resolution timer thread.
+// Runs the engine callback at the configured rate (or as fast as possible
+// when free-running) so the callback path can be tested on headless machines.
+class NullAudioBackend : public IAudioDeviceBackend {
+public:
+    NullAudioBackend();
+    ~NullAudioBackend() override;
+
+    std::string getName() const override { return "Null"; }
+
+    std::vector<AudioDeviceInfo> getDevices() override;
+    bool getDeviceInfo(int deviceIndex, AudioDeviceInfo& info) override;
+
+    bool open(const AudioStreamConfig& config, AudioDeviceCallback callback, void* userData) override;
+    void close() override;
+    bool start() override;
+    void stop() override;
+    bool isOpen() const override { return open_; }
+    bool isRunning() const override { return running_.load(); }
+
+    float getCPULoad() const override { return cpuLoad_.load(); }
+
+    // Skip the timer and call back as soon as the previous block finishes
+    void setFreeRunning(bool freeRunning) { freeRunning_.store(freeRunning); }
+    bool isFreeRunning() const { return freeRunning_.load(); }
+
+    // Stats
+    uint64_t getCallbackCount() const { return callbackCount_.load(); }
+    uint64_t getLateCallbackCount() const { return lateCallbackCount_.load(); }
+
+protected:
+    // Hooks for derived devices, called on the device thread
+    virtual bool onOpen(const AudioStreamConfig& config) { return true; }
+    virtual void onClose() {}
+    virtual void fillInput(float* input, int numFrames);
+    virtual void consumeOutput(const float* output, int numFrames) {}
+
+    const AudioStreamConfig& getConfig() const { return config_; }
+
+private:
+    void threadLoop();
+
+    AudioStreamConfig config_;
+    AudioDeviceCallback callback_;
+    void* userData_;
+    bool open_;
+
+    std::thread thread_;
+    std::atomic<bool> running_;
+    std::atomic<bool> freeRunning_;
+
+    std::vector<float> inputBuffer_;
+    std::vector<float> outputBuffer_;
+
+    std::atomic<uint64_t> callbackCount_;
+    std::atomic<uint64_t> lateCallbackCount_;
+    std::atomic<float> cpuLoad_;
+};
+
+// Null device that reads its input from a WAV file and writes its output
+// to another. Either path may be empty.
+class FileAudioBackend : public NullAudioBackend {
+public:
+    FileAudioBackend(const std::string& inputPath, const std::string& outputPath);
+    ~FileAudioBackend() override;
+
+    std::string getName() const override { return "File"; }
+    std::string getOutputDeviceName() const override { return outputPath_; }
+    std::string getInputDeviceName() const override { return inputPath_; }
+
+    // Restart the input file when it runs out (otherwise feed silence)
+    void setLoopInput(bool loop) { loopInput_ = loop; }
+
+protected:
+    bool onOpen(const AudioStreamConfig& config) override;
+    void onClose() override;
+    void fillInput(float* input, int numFrames) override;
+    void consumeOutput(const float* output, int numFrames) override;
+
+private:
+    std::string inputPath_;
+    std::string outputPath_;
+    bool loopInput_;
+
+    AudioFileReader reader_;
+    AudioFileWriter writer_;
+    bool readerOpen_;
+    bool writerOpen_;
+
+    std::vector<float> fileBuffer_;
+    size_t framesRemaining_;
+};
+
+// "portaudio" or "null"; anything else returns nullptr
+std::unique_ptr<IAudioDeviceBackend> createAudioDeviceBackend(const std::string& name);
+
+} // namespace OmegaDAW
+
+#endif // OMEGA_DAW_AUDIO_DEVICE_H
@@ -8,9 +8,18 @@
 #include <mutex>
 #include <atomic>
 #include <string>
+#include <map>
+#include <ostream>
 
-// Include PortAudio for types
-#include <portaudio.h>
+#include "AudioBuffer.h"
+#include "AudioDevice.h"
+#include "AudioThreadPool.h"
+#include "DiskRecorder.h"
+#include "Metering.h"
+#include "Profiler.h"
+#include "ScratchArena.h"
+#include "SnapshotPublisher.h"
+#include "TailTracker.h"
 
 namespace OmegaDAW {
 
@@ -24,49 +33,48 @@ class IAudioProcessor {
     virtual void setBypassed(bool bypassed) { bypassed_ = bypassed; }
     virtual std::string getName() const { return "Unknown Processor"; }
     
+    // How long output continues once input goes silent. Generators and
+    // processors that don't know keep kInfiniteTail and are never skipped.
+    virtual double getTailLengthSeconds() const { return kInfiniteTail; }
+    
+    // Samples the output runs behind the input, for delay compensation
+    virtual int getLatencySamples() const { return 0; }
+    
+    // In place on a buffer; its channel pointers are passed straight through
+    void processInPlace(AudioBufferView buffer) {
+        process(buffer.getArrayOfPointers(), buffer.getArrayOfPointers(),
+                buffer.getNumChannels(), buffer.getNumSamples());
+    }
+    
 protected:
     bool bypassed_ = false;
 };
 
-// Audio device info
-struct AudioDeviceInfo {
-    int index;
-    std::string name;
-    int maxInputChannels;
-    int maxOutputChannels;
-    double defaultSampleRate;
-};
-
-// Resampler for handling different sample rates
-class Resampler {
-public:
-    Resampler();
-    ~Resampler();
-    void initialize(int inputSampleRate, int outputSampleRate, int numChannels);
-    void process(const float* input, float* output, int inputFrames, int& outputFrames);
-    int getOutputFrameCount(int inputFrames) const;
-private:
-    int inputSampleRate_;
-    int outputSampleRate_;
-    int numChannels_;
-    double ratio_;
-    std::vector<float> leftover_;
+// Independent chain (track/bus) rendered into its own buffers
+struct ProcessorChain {
+    int id;
+    std::vector<std::shared_ptr<IAudioProcessor>> processors;
+    std::vector<std::string> processorNames;
+    std::vector<std::shared_ptr<TimingStats>> processorStats;
+    
+    // Scratch output and per-processor silence tracking, touched only by
+    // the thread that runs this chain
+    mutable AudioBuffer buffer;
+    mutable std::vector<TailTracker> tailTrackers;
 };
 
-// Recording buffer
-class RecordingBuffer {
-public:
-    RecordingBuffer(int sampleRate, int numChannels);
-    void clear();
-    void appendSamples(const float* samples, int numFrames);
-    const std::vector<float>& getData() const { return data_; }
-    int getNumFrames() const { return numFrames_; }
-    bool saveToWav(const std::string& filename);
-private:
-    int sampleRate_;
-    int numChannels_;
-    int numFrames_;
-    std::vector<float> data_;
+// Immutable processor chain snapshot consumed by the audio thread
+struct ProcessorGraph {
+    // Parallel chains, summed in order before the master chain
+    std::vector<ProcessorChain> chains;
+    int chainCapacity = 0;  // Frames each chain buffer can hold
+    RealtimeThreadPool* threadPool = nullptr;  // Set while there are chains
+    
+    // Master chain, run serially on the summed output
+    std::vector<std::shared_ptr<IAudioProcessor>> processors;
+    std::vector<std::string> processorNames;  // Resolved off the audio thread
+    std::vector<std::shared_ptr<TimingStats>> processorStats;
+    mutable std::vector<TailTracker> tailTrackers;
 };
 
 class AudioEngine {
@@ -74,6 +82,11 @@ class AudioEngine {
     AudioEngine();
     ~AudioEngine();
     
+    // Device backend (PortAudio by default, or OMEGA_AUDIO_BACKEND=null).
+    // Can only be replaced while the engine is not initialized.
+    bool setBackend(std::unique_ptr<IAudioDeviceBackend> backend);
+    IAudioDeviceBackend* getBackend() const { return backend_.get(); }
+    
     // Device management
     std::vector<AudioDeviceInfo> getAvailableDevices();
     bool selectDevice(int deviceIndex);
@@ -85,16 +98,33 @@ class AudioEngine {
                             int numOutputChannels = 2, int numInputChannels = 2);
     void shutdown();
     
+    // Offline mode - no device stream; blocks are pulled with processOfflineBlock
+    bool initializeOffline(int sampleRate = 48000, int maxBlockSize = 1024, int numChannels = 2);
+    bool isOffline() const { return initialized_ && !backend_->isOpen(); }
+    
+    // Back to uninitialized after offline mode, keeping the processor graph
+    // (unlike shutdown()), so initialize() can open a device afterwards.
+    // Puts back the configuration, buffer sizes and position from before
+    // initializeOffline() and re-prepares the processors for it.
+    void leaveOfflineMode();
+    
+    // Render one block of interleaved output through the processor graph.
+    // mix (planar, at least numFrames long) is added to the graph's output
+    // ahead of master volume and clipping. Must not be called while a
+    // device stream is running.
+    bool processOfflineBlock(float* outputBuffer, int numFrames, const AudioBuffer* mix = nullptr);
+    
     // Transport control
     void startPlayback();
     void stopPlayback();
     void pausePlayback();
     
-    // Recording control
-    void startRecording();
+    // Recording control - input is streamed to disk while recording
+    bool startRecording(const std::string& filepath);                // All inputs to one file
+    bool startRecording(const std::vector<RecordingTrack>& tracks);  // Multitrack
     void stopRecording();
     bool isRecording() const { return isRecording_.load(); }
-    std::shared_ptr<RecordingBuffer> getRecordingBuffer() const { return recordingBuffer_; }
+    const DiskRecorder& getDiskRecorder() const { return diskRecorder_; }
     
     // State queries
     bool isPlaying() const { return isPlaying_.load(); }
@@ -113,12 +143,39 @@ class AudioEngine {
     void removeProcessor(std::shared_ptr<IAudioProcessor> processor);
     void clearProcessors();
     
+    // Parallel processor chains (tracks/buses). Each renders into its own
+    // buffer on the worker pool; all are summed before the serial chain above.
+    int addParallelChain(const std::vector<std::shared_ptr<IAudioProcessor>>& processors);
+    void removeParallelChain(int chainId);
+    size_t getParallelChainCount() const;
+    
+    // Worker pool size (0 runs chains on the audio thread); not while playing
+    bool setWorkerThreadCount(int numThreads);
+    int getWorkerThreadCount() const;
+    
+    // Blocks smaller than this run single-threaded (dispatch costs more)
+    void setParallelMinBlockSize(int numFrames) { parallelMinBlockSize_.store(numFrames); }
+    int getParallelMinBlockSize() const { return parallelMinBlockSize_.load(); }
+    
     // Master volume and metering
     void setMasterVolume(float volume);
     float getMasterVolume() const { return masterVolume_; }
     float getPeakLevel(int channel) const;
     float getRMSLevel(int channel) const;
     
+    // Lock-free output meters; safe to poll from any thread at any rate
+    MeterReading getMeterReading(int channel) const { return outputMeter_.getReading(channel); }
+    LevelMeter& getOutputMeter() { return outputMeter_; }
+    
+    // Profiling - callback duration against the block deadline and per-processor
+    // timing, recorded lock-free on the audio side and readable from any thread
+    void setProfilingEnabled(bool enabled) { profilingEnabled_.store(enabled); }
+    bool isProfilingEnabled() const { return profilingEnabled_.load(); }
+    CallbackProfile getCallbackProfile() const { return callbackProfiler_.getProfile(); }
+    std::vector<ProcessorProfile> getProcessorProfiles() const;
+    void resetProfiling();
+    void printProfileReport(std::ostream& out) const;
+    
     // Latency
     double getInputLatency() const { return inputLatency_; }
     double getOutputLatency() const { return outputLatency_; }
@@ -135,32 +192,38 @@ class AudioEngine {
     
     // Performance optimization
     void setThreadPriority(int priority); // Set audio thread priority
-    void enableDenormalPrevention(bool enable) { preventDenormals_ = enable; }
+    void enableDenormalPrevention(bool enable) { preventDenormals_ = enable; }  // FTZ/DAZ in the callback
     
     // Advanced processor management
-    size_t getProcessorCount() const { return processors_.size(); }
+    size_t getProcessorCount() const;
     std::shared_ptr<IAudioProcessor> getProcessor(size_t index);
     void setProcessorBypassed(size_t index, bool bypassed);
     
     // Buffer pre-allocation
     void preallocateBuffers(int maxBufferSize);
+    int getPreallocatedBufferSize() const { return maxPreallocatedBufferSize_; }
     
 private:
-    // Audio callback (static for C API)
-    static int paCallback(const void* inputBuffer, void* outputBuffer,
-                         unsigned long framesPerBuffer,
-                         const struct ::PaStreamCallbackTimeInfo* timeInfo,
-                         unsigned long statusFlags, void* userData);
+    // Device callback (static for the backend's C-style API)
+    static void deviceCallback(const float* inputBuffer, float* outputBuffer,
+                               int numFrames, void* userData);
     
     // Instance audio processing
-    void processAudio(const float* inputBuffer, float* outputBuffer, int numFrames);
+    void processAudio(const float* inputBuffer, float* outputBuffer, int numFrames,
+                      const AudioBuffer* mix = nullptr);
+    
+    // Rebuild the processor snapshot and hand it to the audio thread
+    // (caller holds processorMutex_)
+    void publishProcessorGraph();
+    
+    // Render one parallel chain (runs on a pool worker or the audio thread)
+    static void processChainTask(void* context, int chainIndex);
     
     // Audio metering
-    void updateMetering(const float* buffer, int numFrames);
     void resetMetering();
     
-    // PortAudio stream
-    PaStream* stream_;
+    // Device backend
+    std::unique_ptr<IAudioDeviceBackend> backend_;
     bool initialized_;
     int selectedDeviceIndex_;
     int selectedInputDeviceIndex_;
@@ -177,30 +240,58 @@ class AudioEngine {
     std::atomic<double> currentTime_;
     std::atomic<uint64_t> currentSample_;
     
+    // What initializeOffline() replaced, for leaveOfflineMode()
+    struct OfflineRestoreState {
+        int sampleRate;
+        int bufferSize;
+        int numChannels;
+        int numInputChannels;
+        bool hasInput;
+        int maxPreallocatedBufferSize;
+        uint64_t currentSample;
+        double currentTime;
+    };
+    OfflineRestoreState preOfflineState_;
+    
     // Master controls
     float masterVolume_;
     
-    // Audio processors
+    // Audio processors - edits go to processors_ under processorMutex_ and are
+    // published as snapshots; the audio thread only reads processorGraph_
     std::vector<std::shared_ptr<IAudioProcessor>> processors_;
-    std::mutex processorMutex_;
+    mutable std::mutex processorMutex_;
+    SnapshotPublisher<ProcessorGraph> processorGraph_;
+    std::map<int, std::vector<std::shared_ptr<IAudioProcessor>>> parallelChains_;
+    int nextChainId_;
     
-    // Metering
-    std::vector<float> peakLevels_;
-    std::vector<float> rmsLevels_;
-    std::mutex meteringMutex_;
+    // Workers for parallel chains, started by the first addParallelChain()
+    std::unique_ptr<RealtimeThreadPool> threadPool_;
+    int workerThreadCount_;  // < 0 for the default
+    std::atomic<int> parallelMinBlockSize_;
+    
+    // Metering (written by the audio thread only)
+    LevelMeter outputMeter_;
+    
+    // Profiling; processor stats outlive graph snapshots and are keyed by
+    // processor (guarded by processorMutex_)
+    std::atomic<bool> profilingEnabled_;
+    CallbackProfiler callbackProfiler_;
+    std::map<const IAudioProcessor*, std::shared_ptr<TimingStats>> processorStats_;
     
     // Latency info
     double inputLatency_;
     double outputLatency_;
     
-    // Internal buffers for processing
-    std::vector<std::vector<float>> internalBuffers_;
-    std::vector<std::vector<float>> inputBuffers_;
+    // Processing buffers (sized outside the callback)
+    int processingCapacity_;  // Max frames the callback can handle without allocating
+    ScratchArena scratchArena_;  // Mix and input buffers; bound to the callback thread, reset every block
+    
+    void allocateProcessingBuffers(int maxFrames);
+    void prepareProcessors();  // At sampleRate_ and bufferSize_
     
     // Recording
     std::atomic<bool> isRecording_;
-    std::shared_ptr<RecordingBuffer> recordingBuffer_;
-    std::mutex recordingMutex_;
+    DiskRecorder diskRecorder_;
     bool monitoringEnabled_;
     float inputGain_;
     bool overdubMode_;
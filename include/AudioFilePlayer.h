@@ -3,6 +3,7 @@
 
 #include "AudioEngine.h"
 #include "FileIO.h"
+#include "Resampler.h"
 #include <vector>
 #include <string>
 #include <memory>
@@ -50,6 +51,10 @@ class AudioFilePlayer : public IAudioProcessor {
     void setVolume(float volume);
     float getVolume() const { return volume_; }
     
+    // Sample rate conversion quality when the file rate differs from the engine's
+    void setResamplerQuality(ResamplerQuality quality);
+    ResamplerQuality getResamplerQuality() const { return resamplerQuality_; }
+    
     // IAudioProcessor interface
     void process(float** inputs, float** outputs, int numChannels, int numFrames) override;
     void prepare(int sampleRate, int maxBufferSize) override;
@@ -77,15 +82,26 @@ class AudioFilePlayer : public IAudioProcessor {
     int engineSampleRate_;
     int engineChannels_;
     
-    // Resampling
+    // Resampling (streams file audio through resampler_ into resampleBuffers_)
     bool needsResampling_;
     std::unique_ptr<Resampler> resampler_;
+    ResamplerQuality resamplerQuality_;
+    int maxBufferSize_;
+    std::vector<std::vector<float>> resampleBuffers_;
+    std::vector<float*> resampleOutputs_;
+    std::vector<const float*> resampleInputs_;
+    std::vector<float> silence_;              // Fed after the last frame to flush the filter
+    std::vector<const float*> silenceInputs_;
+    int drainFramesRemaining_;
+    std::atomic<bool> resamplerResetPending_;
     
     // Thread safety
     mutable std::mutex dataMutex_;
     
     // Helper functions
     void reset();
+    void configureResampler();  // Caller holds dataMutex_
+    void processResampled(float** outputs, int numChannels, int numFrames);
     float getSample(int channel, size_t position);
 };
 
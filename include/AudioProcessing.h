@@ -2,31 +2,22 @@
 #define OMEGA_DAW_AUDIO_PROCESSING_H
 
 #include "AudioEngine.h"
+#include "FFT.h"
+#include "STFT.h"
+#include "TimeStretch.h"
 #include <vector>
 #include <complex>
 #include <cmath>
 
 namespace OmegaDAW {
 
-// FFT-based audio processing utilities
-class FFTProcessor {
-public:
-    FFTProcessor(int fftSize);
-    ~FFTProcessor();
-    
-    void forward(const float* input, std::complex<float>* output);
-    void inverse(const std::complex<float>* input, float* output);
-    
-    int getFFTSize() const { return fftSize_; }
-    
-private:
-    int fftSize_;
-    std::vector<std::complex<float>> twiddles_;
-    void computeTwiddles();
-    void fft(std::complex<float>* data, int n, bool inverse);
-};
-
-// Phase vocoder for time-stretching and pitch-shifting
+// Phase-locked vocoder pitch shifter (STFT, 2048 points, overlap 4)
+//
+// Shifts a live stream by moving spectral peaks (see PhaseLockedVocoder),
+// with transient phase resets and optional formant preservation. A live
+// stream can't change length, so the time stretch factor only applies where
+// audio is read from a source: ClipVoice stretches and shifts a clip
+// together (TimeStretch.h).
 class PhaseVocoder : public IAudioProcessor {
 public:
     PhaseVocoder();
@@ -34,12 +25,15 @@ class PhaseVocoder : public IAudioProcessor {
     
     void prepare(int sampleRate, int maxBufferSize) override;
     void process(float** inputs, float** outputs, int numChannels, int numFrames) override;
+    std::string getName() const override { return "Phase Vocoder"; }
+    int getLatencySamples() const override { return stft_.getLatency(); }
     
-    // Time stretch factor (1.0 = normal, 2.0 = twice as slow, 0.5 = twice as fast)
+    // Time stretch factor (1.0 = normal, 2.0 = twice as slow, 0.5 = twice as
+    // fast), for ClipVoice and offline renders: see getStretchSettings()
     void setTimeStretchFactor(float factor) { timeStretchFactor_ = factor; }
     float getTimeStretchFactor() const { return timeStretchFactor_; }
     
-    // Pitch shift in semitones (-12 to +12)
+    // Pitch shift in semitones (-24 to +24)
     void setPitchShift(float semitones);
     float getPitchShift() const { return pitchShift_; }
     
@@ -47,6 +41,12 @@ class PhaseVocoder : public IAudioProcessor {
     void setFormantPreservation(bool enabled) { formantPreservation_ = enabled; }
     bool isFormantPreservationEnabled() const { return formantPreservation_; }
     
+    // Reset phases at attacks (on by default)
+    void setTransientHandling(bool enabled) { transientHandling_ = enabled; }
+    bool isTransientHandlingEnabled() const { return transientHandling_; }
+    
+    StretchSettings getStretchSettings() const;
+    
 private:
     int sampleRate_;
     int fftSize_;
@@ -54,47 +54,18 @@ class PhaseVocoder : public IAudioProcessor {
     float timeStretchFactor_;
     float pitchShift_;
     bool formantPreservation_;
+    bool transientHandling_;
     
-    std::unique_ptr<FFTProcessor> fft_;
-    std::vector<std::vector<float>> inputBuffer_;
-    std::vector<std::vector<float>> outputBuffer_;
-    std::vector<std::complex<float>> frequencyData_;
-    std::vector<float> lastPhase_;
-    std::vector<float> phaseSum_;
+    StreamingSTFT stft_;
+    std::vector<PhaseLockedVocoder> vocoders_;   // Per channel
+    std::vector<float> work_;
     
-    int inputPos_;
-    int outputPos_;
+    void processSpectrum(int channel, std::complex<float>* spectrum, int numBins);
 };
 
-// Convolution reverb
-class ConvolutionReverb : public IAudioProcessor {
-public:
-    ConvolutionReverb();
-    ~ConvolutionReverb();
-    
-    void prepare(int sampleRate, int maxBufferSize) override;
-    void process(float** inputs, float** outputs, int numChannels, int numFrames) override;
-    
-    // Load impulse response from file or buffer
-    bool loadImpulseResponse(const std::string& filename);
-    void setImpulseResponse(const float* ir, int irLength, int numChannels);
-    
-    void setWetDryMix(float mix) { wetDryMix_ = std::max(0.0f, std::min(1.0f, mix)); }
-    float getWetDryMix() const { return wetDryMix_; }
-    
-private:
-    int sampleRate_;
-    int maxBufferSize_;
-    
-    std::vector<std::vector<float>> impulseResponse_;
-    std::vector<std::vector<float>> inputHistory_;
-    int historyPos_;
-    float wetDryMix_;
-    
-    void convolve(const float* input, float* output, int numFrames, int channel);
-};
+// Convolution reverb: see ConvolutionReverb in AdvancedEffects.h
 
-// Spectral processor for advanced effects
+// Spectral processor for advanced effects (STFT, 2048 points, overlap 4)
 class SpectralProcessor : public IAudioProcessor {
 public:
     enum ProcessMode {
@@ -109,16 +80,23 @@ class SpectralProcessor : public IAudioProcessor {
     
     void prepare(int sampleRate, int maxBufferSize) override;
     void process(float** inputs, float** outputs, int numChannels, int numFrames) override;
+    std::string getName() const override { return "Spectral Processor"; }
+    int getLatencySamples() const override { return stft_.getLatency(); }
     
     void setProcessMode(ProcessMode mode) { processMode_ = mode; }
     ProcessMode getProcessMode() const { return processMode_; }
     
+    // dB relative to a full-scale sine in one bin
     void setThreshold(float threshold) { threshold_ = threshold; }
     float getThreshold() const { return threshold_; }
     
     void setAmount(float amount) { amount_ = std::max(0.0f, std::min(1.0f, amount)); }
     float getAmount() const { return amount_; }
     
+    // Spectral freeze: hold the spectrum from the moment freezing starts
+    void setFrozen(bool frozen) { spectrumFrozen_ = frozen; }
+    bool isFrozen() const { return spectrumFrozen_; }
+    
 private:
     int sampleRate_;
     int fftSize_;
@@ -127,16 +105,13 @@ class SpectralProcessor : public IAudioProcessor {
     float threshold_;
     float amount_;
     
-    std::unique_ptr<FFTProcessor> fft_;
-    std::vector<std::vector<float>> inputBuffer_;
-    std::vector<std::vector<float>> outputBuffer_;
-    std::vector<std::complex<float>> frequencyData_;
-    std::vector<std::complex<float>> frozenSpectrum_;
+    StreamingSTFT stft_;
+    std::vector<std::vector<std::complex<float>>> frozenSpectrum_;  // Per channel
+    std::vector<std::complex<float>> freezeAdvance_;               // Per bin phase step per hop
     
-    int bufferPos_;
     bool spectrumFrozen_;
     
-    void processSpectrum(std::complex<float>* spectrum, int numBins);
+    void processSpectrum(int channel, std::complex<float>* spectrum, int numBins);
 };
 
 // Real-time audio analyzer
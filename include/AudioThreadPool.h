@@ -0,0 +1,98 @@
+#ifndef OMEGA_DAW_AUDIO_THREAD_POOL_H
+#define OMEGA_DAW_AUDIO_THREAD_POOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace OmegaDAW {
+
+// Counting semaphore that is safe to post from the audio thread
+// (sem_t on POSIX, dispatch semaphores on macOS, kernel semaphores on Windows)
+class RealtimeSemaphore {
+public:
+    RealtimeSemaphore();
+    ~RealtimeSemaphore();
+
+    RealtimeSemaphore(const RealtimeSemaphore&) = delete;
+    RealtimeSemaphore& operator=(const RealtimeSemaphore&) = delete;
+
+    void post(int count = 1);
+    void wait();
+
+private:
+    void* handle_;
+};
+
+// Real-time worker pool for fork/join work inside the audio callback
+//
+// Workers request SCHED_FIFO (falling back to normal priority when the
+// process lacks permission) but are not pinned, so the scheduler can move a
+// worker off a core the audio callback is spinning on. parallelFor() splits
+// the task indices into one range per participant; a participant that
+// drains its own range steals from the others. The calling thread
+// participates and returns only when every task has finished, which acts as
+// the barrier before the results are combined.
+//
+// Each job carries a generation number. Workers join the open job as they
+// wake up; once the tasks are done the caller closes the job and waits only
+// for the workers that joined it. A worker that wakes after that sees a
+// closed or already-joined generation and goes back to sleep, so a block
+// never waits on a worker that had nothing to do. No allocation or locking
+// happens per call.
+class RealtimeThreadPool {
+public:
+    // Plain function pointer so dispatch never allocates
+    using Task = void (*)(void* context, int index);
+
+    // numWorkers < 0 picks hardware_concurrency() - 1
+    explicit RealtimeThreadPool(int numWorkers = -1);
+    ~RealtimeThreadPool();
+
+    RealtimeThreadPool(const RealtimeThreadPool&) = delete;
+    RealtimeThreadPool& operator=(const RealtimeThreadPool&) = delete;
+
+    // Not real-time safe; must not overlap with parallelFor()
+    void setWorkerCount(int numWorkers);
+    int getWorkerCount() const { return static_cast<int>(workers_.size()); }
+
+    // Runs task(context, i) for every i in [0, count). Single caller at a time.
+    void parallelFor(int count, Task task, void* context);
+
+    static int getDefaultWorkerCount();
+
+private:
+    struct alignas(64) WorkRange {
+        std::atomic<int> next;
+        int end;
+    };
+
+    void startWorkers(int numWorkers);
+    void stopWorkers();
+    void workerLoop(int workerIndex);
+    void runParticipant(int participant);
+
+    std::vector<std::thread> workers_;
+    std::unique_ptr<RealtimeSemaphore> wakeSemaphore_;
+    std::atomic<bool> running_;
+
+    // Current job (written by the caller before workers are woken)
+    Task task_;
+    void* context_;
+    int numParticipants_;
+    std::unique_ptr<WorkRange[]> ranges_;
+
+    std::atomic<int> remainingTasks_;
+
+    // Generation in the high 32 bits, then kJobOpen, then the number of
+    // workers inside the job
+    static constexpr uint64_t kJobOpen = uint64_t(1) << 31;
+    static constexpr uint64_t kJoinedMask = kJobOpen - 1;
+    std::atomic<uint64_t> job_;
+};
+
+} // namespace OmegaDAW
+
+#endif // OMEGA_DAW_AUDIO_THREAD_POOL_H
@@ -0,0 +1,86 @@
+#ifndef OMEGA_DAW_BIQUAD_CASCADE_H
+#define OMEGA_DAW_BIQUAD_CASCADE_H
+
+#include "SIMDKernels.h"
+#include <vector>
+
+namespace OmegaDAW {
+
+// One biquad section, normalized so a0 = 1 (the default passes through)
+struct BiquadCoefficients {
+    float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f;  // Numerator
+    float a1 = 0.0f, a2 = 0.0f;              // Denominator
+
+    bool operator==(const BiquadCoefficients& other) const {
+        return b0 == other.b0 && b1 == other.b1 && b2 == other.b2 && a1 == other.a1 && a2 == other.a2;
+    }
+    bool operator!=(const BiquadCoefficients& other) const { return !(*this == other); }
+};
+
+// Biquad sections in series on several channels, run on SIMD::biquadLanes
+//
+// Every channel goes through the same sections. Channels are packed into
+// lanes in groups of 1, 2, 4 or 8 (padded with silent channels), and each
+// pass of the kernel runs 8 / group size sections of one group, so a stereo
+// 4-band EQ is a single pass and 8 channels of one filter are too. The
+// packing is picked in prepare() for the fewest kernel steps per block.
+// Coefficients and state live in one aligned block per pass, lane by lane
+// (struct of arrays), in the layout the kernel loads.
+//
+// New coefficients glide linearly over the next block instead of jumping,
+// so parameter changes don't click; before the first block after prepare()
+// or reset() they apply at once. prepare() allocates; nothing else does,
+// and none of it is thread-safe (call setSection() from the thread that
+// calls process()).
+class BiquadCascade {
+public:
+    BiquadCascade();
+
+    void prepare(int numChannels, int numSections, int maxBlockSize);
+    void reset();
+
+    int getNumChannels() const { return numChannels_; }
+    int getNumSections() const { return static_cast<int>(targets_.size()); }
+
+    void setSection(int section, const BiquadCoefficients& coefficients);
+    const BiquadCoefficients& getSection(int section) const { return targets_[section]; }
+
+    // In place on planar buffers. Prepared channels past numChannels run on
+    // silence; channels past the prepared count are left alone. Blocks
+    // longer than maxBlockSize are split.
+    void process(float* const* channels, int numChannels, int numFrames);
+
+private:
+    static constexpr int kLanes = SIMD::kBiquadLanes;
+
+    struct alignas(32) Pass {
+        float coefficients[5 * kLanes];
+        float increments[5 * kLanes];
+        float state[2 * kLanes];
+        bool gliding;
+    };
+
+    const BiquadCoefficients& targetFor(int passInGroup, int lane) const;
+    void startGlides(int numFrames);
+    void finishGlides();
+
+    int numChannels_;
+    int maxBlockSize_;
+    int groupSize_;        // Channels per pass: 1, 2, 4 or 8
+    int passesPerGroup_;
+    std::vector<Pass> passes_;   // Group by group
+    std::vector<BiquadCoefficients> targets_;
+    bool targetsChanged_;
+    bool running_;         // A block has run since prepare() or reset()
+
+    // Scratch
+    std::vector<float> frames_;    // Interleaved group
+    std::vector<float> silence_;
+    std::vector<float> discard_;
+    std::vector<const float*> sources_;
+    std::vector<float*> dests_;
+};
+
+} // namespace OmegaDAW
+
+#endif // OMEGA_DAW_BIQUAD_CASCADE_H
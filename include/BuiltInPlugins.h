@@ -1,5 +1,6 @@
 #pragma once
 
+#include "BiquadCascade.h"
 #include "Plugin.h"
 #include <cmath>
 
@@ -58,13 +59,8 @@ class EQPlugin : public Plugin {
     void reset() override;
 
 private:
-    struct BiquadFilter {
-        float b0, b1, b2, a1, a2;
-        float x1, x2, y1, y2;
-    };
-    
-    std::vector<std::vector<BiquadFilter>> filters;
-    void calculateBiquadCoeffs(BiquadFilter& filter, float freq, float Q, float gain);
+    BiquadCascade cascade;   // Low, mid and high peaking sections, stereo
+    void calculateBiquadCoeffs(BiquadCoefficients& filter, float freq, float Q, float gain);
 };
 
 } // namespace OmegaDAW
@@ -60,6 +60,10 @@ class Clip {
 
 class AudioClip : public Clip {
 public:
+    // Range setTimeStretch() clamps to, the stretcher's own limits
+    static constexpr double kMinTimeStretch = 0.25;
+    static constexpr double kMaxTimeStretch = 4.0;
+
     AudioClip(double startTime, double duration);
     
     void setAudioData(std::shared_ptr<AudioBuffer> buffer);
@@ -68,8 +72,15 @@ class AudioClip : public Clip {
     void setSourceFile(const std::string& filepath) { m_sourceFile = filepath; }
     std::string getSourceFile() const { return m_sourceFile; }
     
+    // Played through a phase vocoder (see ClipVoice) when either is set.
+    // The offset stays in source seconds; a stretch of 2 plays the audio
+    // over twice the time. The arrangement does not render clips yet.
     void setPitch(float semitones) { m_pitchShift = semitones; }
     float getPitch() const { return m_pitchShift; }
+    void setTimeStretch(double factor);
+    double getTimeStretch() const { return m_timeStretch; }
+    void setFormantPreservation(bool enabled) { m_formantPreservation = enabled; }
+    bool isFormantPreservationEnabled() const { return m_formantPreservation; }
     
     void setReverse(bool reverse) { m_reverse = reverse; }
     bool isReversed() const { return m_reverse; }
@@ -78,6 +89,8 @@ class AudioClip : public Clip {
     std::shared_ptr<AudioBuffer> m_audioData;
     std::string m_sourceFile;
     float m_pitchShift;
+    double m_timeStretch;
+    bool m_formantPreservation;
     bool m_reverse;
 };
 
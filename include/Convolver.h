@@ -0,0 +1,160 @@
+#ifndef OMEGA_DAW_CONVOLVER_H
+#define OMEGA_DAW_CONVOLVER_H
+
+#include "FFT.h"
+#include "SnapshotPublisher.h"
+#include <complex>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace OmegaDAW {
+
+// How a Convolver cuts up its impulse responses
+struct ConvolverLayout {
+    int blockSize = 128;       // Smallest partition; a power of two, at least 16
+    int maxLength = 0;         // Longest response in samples (state is sized for it)
+    bool lowLatency = true;    // Convolve the first block directly: no added latency
+    bool nonUniform = false;   // Partitions grow 8x along the response (see Convolver)
+
+    bool operator==(const ConvolverLayout& other) const {
+        return blockSize == other.blockSize && maxLength == other.maxLength
+            && lowLatency == other.lowLatency && nonUniform == other.nonUniform;
+    }
+    bool operator!=(const ConvolverLayout& other) const { return !(*this == other); }
+};
+
+// An impulse response cut into partitions and transformed for one layout
+//
+// Built off the audio thread (it allocates and runs an FFT per partition),
+// never changed afterwards. Responses have 1 channel (applied to every input
+// channel on its own), 2 (left to left, right to right) or 4 (true stereo, in
+// the order LL, LR, RL, RR: left in to left out, left in to right out, ...).
+class ConvolverIR {
+public:
+    // channels are equal-length or shorter ones read as zero-padded; longer
+    // than layout.maxLength is truncated. nullptr on a bad channel count or
+    // layout.
+    static std::shared_ptr<const ConvolverIR> create(const std::vector<std::vector<float>>& channels,
+                                                     const ConvolverLayout& layout);
+
+    const ConvolverLayout& getLayout() const { return layout_; }
+    int getNumChannels() const { return static_cast<int>(channels_.size()); }
+    int getLength() const { return length_; }
+
+private:
+    friend class Convolver;
+
+    struct Stage {
+        int numPartitions;
+        std::vector<std::complex<float>> spectra;   // numPartitions * (size + 1)
+        std::vector<char> active;                   // Partition has a non-zero sample
+    };
+
+    struct Channel {
+        std::vector<float> reversedHead;   // First block, last tap first (low latency)
+        bool headActive;
+        std::vector<Stage> stages;
+    };
+
+    ConvolverLayout layout_;
+    int length_;
+    std::vector<Channel> channels_;
+};
+
+// Uniformly (or non-uniformly) partitioned overlap-save FFT convolution
+//
+// The response is cut into partitions of blockSize samples. Each block of
+// input is transformed once into a frequency-domain delay line, and each
+// output block is one inverse FFT of the delay line multiplied partition by
+// partition with the response's spectra - a few complex multiply-adds per
+// sample per partition instead of one multiply-add per sample per tap.
+//
+// Overlap-save delays every partition by one block. In low-latency mode the
+// first block of the response is convolved directly in the time domain, so
+// the partitions start one block in and the output has no added latency;
+// otherwise getLatency() is blockSize.
+//
+// Non-uniform mode uses 7 partitions of blockSize, then 7 of 8 * blockSize,
+// then 64 * blockSize for the rest. Long responses need far fewer multiplies
+// per sample, but the big partitions' transforms all land in the blocks where
+// they complete (every 8th and 64th), so the worst block costs about as much
+// as a uniform block for the same response while the average is much lower.
+//
+// setImpulseResponse() may be called from any thread but the audio thread
+// and takes effect at the next block: the head and every stage crossfade
+// from the old response to the new one over their next output block, both
+// computed from the same delay line, so a swap never clicks or drops the
+// tail already ringing. prepare() allocates every buffer for
+// layout.maxLength, and process() doesn't allocate or lock.
+class Convolver {
+public:
+    Convolver();
+    ~Convolver();
+
+    Convolver(const Convolver&) = delete;
+    Convolver& operator=(const Convolver&) = delete;
+
+    // Not concurrent with process(); responses built for another layout are
+    // ignored until replaced
+    void prepare(int numChannels, const ConvolverLayout& layout);
+    void reset();
+
+    const ConvolverLayout& getLayout() const { return layout_; }
+    int getNumChannels() const { return numChannels_; }
+    int getLatency() const { return layout_.lowLatency ? 0 : layout_.blockSize; }
+
+    // nullptr fades the output out
+    void setImpulseResponse(std::shared_ptr<const ConvolverIR> ir);
+
+    // Wet signal only; input and output may be the same buffers
+    void process(const float* const* input, float* const* output, int numFrames);
+
+private:
+    struct ImpulseResponses {
+        std::shared_ptr<const ConvolverIR> current;
+        std::shared_ptr<const ConvolverIR> previous;   // Faded out from
+        uint64_t generation;
+    };
+
+    struct Stage {
+        int size;
+        int delay;        // Extra blocks between the input and its partitions
+        int ringSize;     // Spectra kept per input channel
+        int filled;       // Samples of the current block received
+        int newest;       // Ring slot of the latest spectrum
+        uint64_t generation;
+        std::shared_ptr<const FFTPlan> fft;
+        std::vector<std::vector<float>> windows;                  // Per input: last 2 * size samples
+        std::vector<std::vector<std::complex<float>>> spectra;    // Per input: ringSize * (size + 1)
+        std::vector<std::vector<float>> outputs;                  // Per output: block being played
+    };
+
+    const ConvolverIR* usable(const std::shared_ptr<const ConvolverIR>& ir) const;
+    void runStage(int index, const ConvolverIR* ir, const ConvolverIR* previous, uint64_t generation);
+    void computeStage(int index, const ConvolverIR* ir, int outputChannel, float* dest);
+    void computeHead(const ConvolverIR* ir, int outputChannel, float* dest, int numFrames);
+
+    ConvolverLayout layout_;
+    int numChannels_;
+    std::vector<Stage> stages_;
+
+    uint64_t headGeneration_;
+    int headFadeRemaining_;   // Samples left in the head's crossfade
+
+    // Scratch
+    std::vector<std::complex<float>> accumulator_;
+    std::vector<float> time_;
+    std::vector<float> work_;
+    std::vector<float> fadeBlock_;
+    std::vector<float> headBlock_;
+
+    std::mutex publishMutex_;   // Serializes setImpulseResponse()
+    uint64_t publishedGeneration_;
+    SnapshotPublisher<ImpulseResponses> responses_;
+};
+
+} // namespace OmegaDAW
+
+#endif // OMEGA_DAW_CONVOLVER_H
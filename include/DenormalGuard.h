@@ -0,0 +1,98 @@
+#ifndef OMEGA_DAW_DENORMAL_GUARD_H
+#define OMEGA_DAW_DENORMAL_GUARD_H
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define OMEGA_DENORMALS_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace OmegaDAW {
+
+// Flush-to-zero control for the calling thread
+//
+// On x86 this sets FTZ and DAZ in MXCSR; on ARM it sets FZ in FPCR/FPSCR.
+// Denormal results and inputs are then treated as zero in hardware, so
+// decaying filter and reverb states never hit the slow path. The mode is
+// per thread: the audio callback, every pool worker and offline renders
+// each install it themselves.
+namespace DenormalMode {
+
+#if defined(OMEGA_DENORMALS_SSE)
+constexpr uint32_t kFlushBits = 0x8040;  // FTZ (bit 15) | DAZ (bit 6)
+
+inline uint32_t getControlWord() { return _mm_getcsr(); }
+inline void setControlWord(uint32_t word) { _mm_setcsr(word); }
+#elif defined(__aarch64__) && !defined(_MSC_VER)
+constexpr uint32_t kFlushBits = 1u << 24;  // FPCR.FZ
+
+inline uint32_t getControlWord() {
+    uint64_t word;
+    asm volatile("mrs %0, fpcr" : "=r"(word));
+    return static_cast<uint32_t>(word);
+}
+inline void setControlWord(uint32_t word) {
+    uint64_t value = word;
+    asm volatile("msr fpcr, %0" : : "r"(value));
+}
+#elif defined(__arm__) && defined(__ARM_FP) && !defined(_MSC_VER)
+constexpr uint32_t kFlushBits = 1u << 24;  // FPSCR.FZ
+
+inline uint32_t getControlWord() {
+    uint32_t word;
+    asm volatile("vmrs %0, fpscr" : "=r"(word));
+    return word;
+}
+inline void setControlWord(uint32_t word) {
+    asm volatile("vmsr fpscr, %0" : : "r"(word));
+}
+#else
+constexpr uint32_t kFlushBits = 0;
+
+inline uint32_t getControlWord() { return 0; }
+inline void setControlWord(uint32_t) {}
+#endif
+
+// False on targets where the mode can't be controlled
+inline bool isSupported() { return kFlushBits != 0; }
+
+inline bool isFlushToZeroEnabled() {
+    return isSupported() && (getControlWord() & kFlushBits) == kFlushBits;
+}
+
+// Leaves flush-to-zero on for the rest of the thread's life
+inline void enableFlushToZero() {
+    setControlWord(getControlWord() | kFlushBits);
+}
+
+} // namespace DenormalMode
+
+// Enables flush-to-zero for a scope and restores the previous mode after
+class ScopedNoDenormals {
+public:
+    explicit ScopedNoDenormals(bool enable = true)
+        : previous_(DenormalMode::getControlWord())
+        , enabled_(enable) {
+        if (enabled_) {
+            DenormalMode::setControlWord(previous_ | DenormalMode::kFlushBits);
+        }
+    }
+
+    ~ScopedNoDenormals() {
+        if (enabled_) {
+            DenormalMode::setControlWord(previous_);
+        }
+    }
+
+    ScopedNoDenormals(const ScopedNoDenormals&) = delete;
+    ScopedNoDenormals& operator=(const ScopedNoDenormals&) = delete;
+
+private:
+    uint32_t previous_;
+    bool enabled_;
+};
+
+} // namespace OmegaDAW
+
+#endif // OMEGA_DAW_DENORMAL_GUARD_H
@@ -0,0 +1,89 @@
+#ifndef OMEGA_DAW_DISK_RECORDER_H
+#define OMEGA_DAW_DISK_RECORDER_H
+
+#include "AudioThreadPool.h"
+#include "FileIO.h"
+#include "SpscRingBuffer.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace OmegaDAW {
+
+// One output file fed from a contiguous range of input channels
+struct RecordingTrack {
+    std::string path;
+    int firstChannel = 0;
+    int numChannels = 1;
+};
+
+// Streams input to disk at constant memory
+//
+// The audio thread pushes whole interleaved input blocks into a preallocated
+// SPSC ring; a writer thread drains it and writes each track's channels to
+// its own WAV file through AudioFileWriter. When the ring is full (the disk
+// fell behind) the block is dropped and counted rather than blocking.
+class DiskRecorder {
+public:
+    DiskRecorder();
+    ~DiskRecorder();
+
+    DiskRecorder(const DiskRecorder&) = delete;
+    DiskRecorder& operator=(const DiskRecorder&) = delete;
+
+    // Opens the track files and starts the writer thread (not real-time safe)
+    bool start(const std::vector<RecordingTrack>& tracks, int sampleRate,
+               int numInputChannels, double bufferSeconds = 2.0);
+
+    // Flushes everything still buffered and closes the files
+    void stop();
+
+    bool isRecording() const { return active_.load(); }
+
+    // Audio thread: queue one interleaved input block
+    void pushBlock(const float* input, int numFrames);
+
+    // Stats (any thread)
+    uint64_t getFramesRecorded() const { return framesRecorded_.load(); }
+    uint64_t getFramesWritten() const { return framesWritten_.load(); }
+    uint64_t getDroppedBlockCount() const { return droppedBlocks_.load(); }
+    uint64_t getDroppedFrameCount() const { return droppedFrames_.load(); }
+    uint64_t getWriteErrorCount() const { return writeErrors_.load(); }
+    double getRecordedSeconds() const;
+
+private:
+    struct TrackWriter {
+        RecordingTrack track;
+        AudioFileWriter writer;
+        std::vector<float> buffer;
+    };
+
+    void writerLoop();
+    void drain();
+
+    std::vector<std::unique_ptr<TrackWriter>> tracks_;
+    SpscRingBuffer<float> ring_;
+    std::vector<float> chunk_;
+
+    int sampleRate_;
+    int numInputChannels_;
+
+    std::thread writerThread_;
+    RealtimeSemaphore wakeSemaphore_;
+    std::atomic<bool> active_;
+    std::atomic<bool> stopRequested_;
+    std::atomic<int> activePushes_;
+
+    std::atomic<uint64_t> framesRecorded_;
+    std::atomic<uint64_t> framesWritten_;
+    std::atomic<uint64_t> droppedBlocks_;
+    std::atomic<uint64_t> droppedFrames_;
+    std::atomic<uint64_t> writeErrors_;
+};
+
+} // namespace OmegaDAW
+
+#endif // OMEGA_DAW_DISK_RECORDER_H
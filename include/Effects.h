@@ -20,6 +20,7 @@ class Delay : public IAudioProcessor {
     
     void prepare(int sampleRate, int maxBufferSize) override;
     void process(float** inputs, float** outputs, int numChannels, int numFrames) override;
+    double getTailLengthSeconds() const override;
     
     void clear();
     
@@ -52,6 +53,7 @@ class Reverb : public IAudioProcessor {
     
     void prepare(int sampleRate, int maxBufferSize) override;
     void process(float** inputs, float** outputs, int numChannels, int numFrames) override;
+    double getTailLengthSeconds() const override;
     
     void clear();
     
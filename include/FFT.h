@@ -0,0 +1,75 @@
+#ifndef OMEGA_DAW_FFT_H
+#define OMEGA_DAW_FFT_H
+
+#include <complex>
+#include <memory>
+#include <vector>
+
+namespace OmegaDAW {
+
+// Tables for a real FFT of one size, shared by every transform of that size
+//
+// A real transform of N points runs as a complex transform of N / 2 points
+// (even samples real, odd samples imaginary) plus one pass that separates
+// the two. The complex transform works on split real and imaginary arrays in
+// radix-4 passes (SIMD::fftRadix4) over precomputed twiddles. Plans never
+// change once built, and get() keeps one per size for the life of the
+// process; building one allocates, so get plans in prepare(), not on the
+// audio thread. The transforms themselves don't allocate or lock.
+class FFTPlan {
+public:
+    // size must be a power of two, at least 4; returns nullptr otherwise
+    static std::shared_ptr<const FFTPlan> get(int size);
+
+    int getSize() const { return size_; }
+    int getNumBins() const { return size_ / 2 + 1; }
+
+    // Scratch floats the caller passes to forward() and inverse()
+    int getWorkSize() const { return size_; }
+
+    // size samples -> size / 2 + 1 bins, DC to Nyquist (the bins above
+    // mirror these as complex conjugates)
+    void forward(const float* input, std::complex<float>* output, float* work) const;
+
+    // size / 2 + 1 bins -> size samples, scaled by 1 / size so that
+    // inverse(forward(x)) == x. The imaginary parts of the DC and Nyquist
+    // bins are ignored.
+    void inverse(const std::complex<float>* input, float* output, float* work) const;
+
+private:
+    explicit FFTPlan(int size);
+
+    // Complex transform of half_ points in place (bit-reversed input)
+    void transform(float* re, float* im) const;
+
+    int size_;
+    int half_;
+    std::vector<int> bitReverse_;               // half_ entries
+    std::vector<int> passQuarters_;             // Radix-4 passes, first to last
+    std::vector<float> passTwiddles_;           // 4 * quarter floats per pass
+    std::vector<std::complex<float>> split_;    // exp(-2 pi i k / size), k <= size / 4
+    bool radix2First_;                          // log2(half_) is odd
+};
+
+// One user's FFT: the shared plan for its size plus scratch space of its own
+class FFTProcessor {
+public:
+    FFTProcessor(int fftSize);
+    ~FFTProcessor();
+
+    // fftSize samples -> getNumBins() bins (see FFTPlan)
+    void forward(const float* input, std::complex<float>* output);
+    void inverse(const std::complex<float>* input, float* output);
+
+    int getFFTSize() const { return fftSize_; }
+    int getNumBins() const { return fftSize_ / 2 + 1; }
+
+private:
+    int fftSize_;
+    std::shared_ptr<const FFTPlan> plan_;
+    std::vector<float> work_;
+};
+
+} // namespace OmegaDAW
+
+#endif // OMEGA_DAW_FFT_H
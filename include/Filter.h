@@ -2,7 +2,7 @@
 #define OMEGA_DAW_FILTER_H
 
 #include "AudioEngine.h"
-#include <vector>
+#include "BiquadCascade.h"
 
 namespace OmegaDAW {
 
@@ -14,7 +14,8 @@ enum class FilterType {
     AllPass
 };
 
-// Simple biquad filter implementation
+// Biquad filter on up to 8 channels (a one-section BiquadCascade);
+// parameter changes glide over the next block
 class BiquadFilter : public IAudioProcessor {
 public:
     BiquadFilter(FilterType type = FilterType::LowPass);
@@ -31,12 +32,12 @@ class BiquadFilter : public IAudioProcessor {
     
     void prepare(int sampleRate, int maxBufferSize) override;
     void process(float** inputs, float** outputs, int numChannels, int numFrames) override;
+    double getTailLengthSeconds() const override;
     
     void reset();
     
 private:
     void updateCoefficients();
-    float processSample(float input, int channel);
     
     FilterType type_;
     float frequency_;
@@ -48,15 +49,7 @@ class BiquadFilter : public IAudioProcessor {
     float b0_, b1_, b2_;  // Numerator
     float a1_, a2_;       // Denominator (a0 is normalized to 1)
     
-    // State variables per channel
-    struct ChannelState {
-        float x1 = 0.0f;  // Input delayed by 1 sample
-        float x2 = 0.0f;  // Input delayed by 2 samples
-        float y1 = 0.0f;  // Output delayed by 1 sample
-        float y2 = 0.0f;  // Output delayed by 2 samples
-    };
-    
-    std::vector<ChannelState> channelStates_;
+    BiquadCascade cascade_;
     bool coefficientsNeedUpdate_;
 };
 
@@ -0,0 +1,77 @@
+#ifndef OMEGA_DAW_GRAPH_COMPILER_H
+#define OMEGA_DAW_GRAPH_COMPILER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace OmegaDAW {
+
+// Runs a graph's compile step on a background thread
+//
+// Editors change their shadow graph and call request(); a burst of edits
+// coalesces into one compile, which publishes the result for the audio
+// thread to pick up at its next block. Neither the editing thread nor the
+// audio thread waits for it. The compile callback always runs on one thread
+// at a time, so it may own the publishing side of a SnapshotPublisher.
+//
+// A published graph crossfades from the one before during its first block,
+// so it must not be replaced before it has run: the audio thread reports
+// each generation it runs with noteAdopted(), and the compile step calls
+// waitForAdoption() before publishing. The wait is skipped while no blocks
+// are being processed.
+class GraphCompiler {
+public:
+    explicit GraphCompiler(std::function<void()> compile);
+    ~GraphCompiler();
+
+    GraphCompiler(const GraphCompiler&) = delete;
+    GraphCompiler& operator=(const GraphCompiler&) = delete;
+
+    // Compile soon on the background thread (started on first use)
+    void request();
+
+    // Compile on the calling thread, now
+    void compileNow();
+
+    // Block until every request made so far has been compiled
+    void flush();
+
+    // Finish pending work and join the thread (the destructor does this;
+    // owners whose compile step touches their own members call it first)
+    void stop();
+
+    uint64_t getCompileCount() const;
+
+    // Audio thread, every block: the generation it is running (wait-free)
+    void noteAdopted(uint64_t generation);
+
+    // Compile step: give a running audio thread time to pick up this
+    // generation (returns at once if it already has, or isn't running)
+    void waitForAdoption(uint64_t generation);
+
+private:
+    void threadLoop();
+
+    std::function<void()> compile_;
+    std::mutex compileMutex_;  // Serializes compile_ between the thread and compileNow()
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::thread thread_;
+    uint64_t requested_;
+    uint64_t completed_;
+    uint64_t compileCount_;
+    bool stopping_;
+
+    std::atomic<uint64_t> adoptedGeneration_;
+    std::atomic<int64_t> lastBlockNanos_;  // steady_clock, 0 before the first block
+};
+
+} // namespace OmegaDAW
+
+#endif // OMEGA_DAW_GRAPH_COMPILER_H
@@ -0,0 +1,83 @@
+#ifndef OMEGA_DAW_METERING_H
+#define OMEGA_DAW_METERING_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace OmegaDAW {
+
+// One channel's meter values as seen by the UI
+struct MeterReading {
+    float peak = 0.0f;       // Block peak (linear)
+    float rms = 0.0f;        // Block RMS (linear)
+    float peakHold = 0.0f;   // Highest peak within the hold time
+    uint32_t clipCount = 0;  // Samples at or above full scale since the last reset
+};
+
+// Lock-free level meter
+//
+// The audio thread is the only writer. Each channel is published through a
+// sequence counter, so getReading() returns a consistent set of values from
+// a single block and any number of UI threads can poll at any rate without
+// blocking the writer. Resets from the UI are requests the writer applies on
+// its next block.
+class LevelMeter {
+public:
+    explicit LevelMeter(int numChannels = 2);
+    ~LevelMeter() = default;
+
+    LevelMeter(const LevelMeter&) = delete;
+    LevelMeter& operator=(const LevelMeter&) = delete;
+
+    // Setup (not while metering is running)
+    void setNumChannels(int numChannels);
+    int getNumChannels() const { return numChannels_; }
+    void prepare(int sampleRate, double peakHoldSeconds = 1.5);
+
+    // Writer side (audio thread)
+    void processInterleaved(const float* buffer, int numChannels, int numFrames);
+    void processChannel(int channel, const float* samples, int numFrames);
+    // A block of digital silence on every channel, without reading samples
+    void processSilence(int numFrames);
+
+    // Reader side (any thread)
+    MeterReading getReading(int channel) const;
+    float getPeak(int channel) const { return getReading(channel).peak; }
+    float getRMS(int channel) const { return getReading(channel).rms; }
+
+    void requestPeakHoldReset();
+    void requestClipReset();
+
+    // Clears everything immediately; only when the writer is idle
+    void reset();
+
+private:
+    struct alignas(64) ChannelState {
+        // Published values
+        std::atomic<uint32_t> sequence{0};
+        std::atomic<float> peak{0.0f};
+        std::atomic<float> rms{0.0f};
+        std::atomic<float> peakHold{0.0f};
+        std::atomic<uint32_t> clipCount{0};
+
+        // Writer-only state
+        float heldPeak = 0.0f;
+        int64_t holdSamplesRemaining = 0;
+        uint32_t clips = 0;
+    };
+
+    void applyResetRequests();
+    void publish(ChannelState& state, float peak, float sumSquares, uint32_t clips, int numFrames);
+
+    std::unique_ptr<ChannelState[]> channels_;
+    int numChannels_;
+    int64_t holdSamples_;
+
+    std::atomic<bool> peakHoldResetRequested_;
+    std::atomic<bool> clipResetRequested_;
+};
+
+} // namespace OmegaDAW
+
+#endif // OMEGA_DAW_METERING_H
@@ -2,8 +2,14 @@
 #define OMEGA_DAW_MIXER_H
 
 #include "AudioBuffer.h"
+#include "AudioThreadPool.h"
+#include "GraphCompiler.h"
 #include "MixerChannel.h"
+#include "Metering.h"
+#include "Profiler.h"
+#include "SnapshotPublisher.h"
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <map>
 #include <string>
@@ -23,9 +29,23 @@ class MixerBus {
     MixerBus(const std::string& name, ChannelType type);
     ~MixerBus() = default;
 
+    void prepare(int sampleRate);
     void process(AudioBuffer& buffer);
     void reset();
 
+    // Sum of the effects' tails; once the input has been silent this long
+    // the bus skips its effects, gain and pan until sound comes back
+    double getTailLengthSeconds() const;
+
+    // Post-fader meter; readable from any thread
+    LevelMeter& getMeter() { return meter_; }
+    const LevelMeter& getMeter() const { return meter_; }
+    void updateMeter(const AudioBuffer& buffer);
+
+    // Time spent in process() (effects, gain, pan); lock-free
+    TimingStats& getTimingStats() { return timingStats_; }
+    const TimingStats& getTimingStats() const { return timingStats_; }
+
     void setVolume(float volume);
     float getVolume() const { return volume_; }
 
@@ -43,6 +63,8 @@ class MixerBus {
     std::shared_ptr<Effect> getEffect(int index);
     int getNumEffects() const { return static_cast<int>(effects_.size()); }
 
+    // Sends are compiled into the owning Mixer's plan; change them through
+    // Mixer::routeAudio() and Mixer::removeRoute() so the plan follows
     void addSend(int targetBusId, float level);
     void removeSend(int targetBusId);
     void setSendLevel(int targetBusId, float level);
@@ -70,30 +92,80 @@ class MixerBus {
     
     std::vector<std::shared_ptr<Effect>> effects_;
     std::map<int, float> sends_;
+    
+    int sampleRate_;
+    TailTracker tailTracker_;
+    LevelMeter meter_;
+    TimingStats timingStats_;
+};
+
+// Flat bus processing order compiled from the routing whenever it changes
+//
+// Buses are grouped into dependency levels: every bus sits in a later level
+// than all the buses that send to it, and the master bus comes last. Buses
+// in one level are independent, so a level can run in parallel. Each bus
+// pulls its incoming sends (a contiguous range, in plan order) just before
+// it is processed, so nothing is written concurrently and the sums don't
+// depend on which worker ran what. A plan holds references to its buses and
+// buffers, so removing a bus never pulls them out from under a block.
+//
+// The first block a plan runs is a crossfade from the one before: each send
+// ramps from startLevel, sends that were removed ramp down to silence, and a
+// removed bus runs once more with its output faded out.
+struct MixerPlan {
+    struct Input {
+        int source;   // Index into buses/buffers
+        float level;
+        float startLevel;
+    };
+
+    std::vector<std::shared_ptr<MixerBus>> buses;
+    std::vector<std::shared_ptr<AudioBuffer>> buffers;
+    std::vector<int> inputOffsets;  // Sends into bus i: [inputOffsets[i], inputOffsets[i + 1])
+    std::vector<Input> inputs;
+    std::vector<int> levelOffsets;  // Level l: buses [levelOffsets[l], levelOffsets[l + 1])
+    std::vector<char> departing;    // Removed: runs only in the first block
+    int masterIndex = -1;
+    uint64_t generation = 0;
 };
 
+// Bus and routing edits must come from one thread; process() may run on
+// another and always sees a complete plan. Edits are compiled into a new
+// plan on a background thread and take effect at a later block boundary
+// (flushEdits() waits for that).
 class Mixer {
 public:
     Mixer();
-    ~Mixer() = default;
+    ~Mixer();
 
     void initialize(int sampleRate, int bufferSize);
     void process();
-    void process(AudioBuffer& buffer);
+    // Only the first numFrames (up to the buffer size), for a short last
+    // block; shrinks the bus buffers without reallocating
+    void process(int numFrames);
+    void process(AudioBufferView buffer);
     void reset();
     void shutdown();
 
+    // Block until every earlier edit is in the plan process() will use next
+    void flushEdits();
+
     int addBus(const std::string& name, ChannelType type);
     void removeBus(int busId);
     std::shared_ptr<MixerBus> getBus(int busId);
     
-    void routeAudio(int sourceBusId, int targetBusId, float level = 1.0f);
+    // Adds or updates a send. Fails (and changes nothing) if either bus is
+    // missing or the send would create a feedback loop.
+    bool routeAudio(int sourceBusId, int targetBusId, float level = 1.0f);
     void removeRoute(int sourceBusId, int targetBusId);
+    bool wouldCreateCycle(int sourceBusId, int targetBusId) const;
 
     void setBusInput(int busId, const AudioBuffer& buffer);
-    AudioBuffer getMasterOutput();
+    const AudioBuffer& getMasterOutput() const;
 
     int getMasterBusId() const { return masterBusId_; }
+    int getSampleRate() const { return sampleRate_; }
+    int getBufferSize() const { return bufferSize_; }
     
     // Channel access methods
     int getNumChannels() const { return static_cast<int>(buses_.size()); }
@@ -103,6 +175,16 @@ class Mixer {
     bool isSoloMode() const { return soloMode_; }
 
     std::vector<int> getBusIds() const;
+
+    // Worker pool for independent buses (0 processes every bus on the
+    // calling thread); not while process() may be running. Results are
+    // identical either way.
+    void setWorkerThreadCount(int numThreads);
+    int getWorkerThreadCount() const;
+
+    // Per-bus processing time, by bus id
+    std::vector<ProcessorProfile> getBusProfiles() const;
+    void resetBusProfiles();
     
     // Integration methods
     void loadFromProject(class Project* project);
@@ -111,12 +193,24 @@ class Mixer {
 
 private:
     std::function<void(const AudioBuffer&)> outputCallback_;
-    void processRoutingGraph();
-    void sortBusesTopologically();
+    void processRoutingGraph(bool clearBusBuffers, int numFrames = -1);
+    void compilePlan();
     
+    // Run one bus / one slice of the master sum (pool worker or caller)
+    struct BusTaskContext;
+    struct MasterSumContext;
+    static void processBusTask(void* context, int index);
+    static void sumToMasterTask(void* context, int index);
+    
+    // Shadow graph: edited by the caller, read by the compiler under editMutex_
     std::map<int, std::shared_ptr<MixerBus>> buses_;
-    std::vector<int> processingOrder_;
-    std::map<int, AudioBuffer> busBuffers_;
+    std::map<int, std::shared_ptr<AudioBuffer>> busBuffers_;
+    std::mutex editMutex_;
+    
+    SnapshotPublisher<MixerPlan> plan_;
+    std::map<std::pair<int, int>, float> compiledLevels_;  // Sends in the last plan (compiler only)
+    uint64_t planGeneration_;                              // Compiler only
+    uint64_t processedGeneration_;                         // Audio thread only
     
     int nextBusId_;
     int masterBusId_;
@@ -125,6 +219,9 @@ class Mixer {
     int sampleRate_;
     int bufferSize_;
     AudioBuffer masterOutput_;
+    
+    std::unique_ptr<RealtimeThreadPool> threadPool_;
+    GraphCompiler compiler_;
 };
 
 } // namespace OmegaDAW
@@ -2,6 +2,7 @@
 #define OMEGA_DAW_MIXER_CHANNEL_H
 
 #include "AudioBuffer.h"
+#include "TailTracker.h"
 #include <memory>
 #include <vector>
 
@@ -14,6 +15,10 @@ class Effect {
     virtual void reset() = 0;
     virtual bool isEnabled() const = 0;
     virtual void setEnabled(bool enabled) = 0;
+    
+    // How long output continues once input goes silent (kInfiniteTail:
+    // never skipped)
+    virtual double getTailLengthSeconds() const { return kInfiniteTail; }
 };
 
 class MixerChannel {
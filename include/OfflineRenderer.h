@@ -0,0 +1,90 @@
+#ifndef OMEGA_DAW_OFFLINE_RENDERER_H
+#define OMEGA_DAW_OFFLINE_RENDERER_H
+
+#include "FileIO.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace OmegaDAW {
+
+class AudioEngine;
+class Mixer;
+class Transport;
+
+struct OfflineRenderSettings {
+    std::string outputPath;
+    FileFormat format = FileFormat::WAV;
+    int sampleRate = 48000;
+    int numChannels = 2;
+    int bitDepth = 16;
+    int blockSize = 1024;
+    double startSeconds = 0.0;
+    double lengthSeconds = 0.0;
+};
+
+// Faster-than-realtime bounce
+//
+// Pulls the same processor graph, Mixer and Transport the audio callback
+// uses, one block at a time and as fast as the CPU allows, and streams the
+// result to an AudioFileWriter. The engine must not be running a device
+// stream while rendering; an uninitialized engine is put in offline mode.
+class OfflineRenderer {
+public:
+    // Progress in [0, 1], called from the rendering thread
+    using ProgressCallback = std::function<void(float progress)>;
+
+    // Called before each block so callers can feed mixer bus inputs
+    using BlockCallback = std::function<void(int64_t startSample, int numFrames)>;
+
+    OfflineRenderer();
+    ~OfflineRenderer() = default;
+
+    void setEngine(AudioEngine* engine) { engine_ = engine; }
+    void setMixer(Mixer* mixer) { mixer_ = mixer; }
+    void setTransport(Transport* transport) { transport_ = transport; }
+
+    void setProgressCallback(ProgressCallback callback) { progressCallback_ = callback; }
+    void setBlockCallback(BlockCallback callback) { blockCallback_ = callback; }
+
+    // Blocks until the render finishes, fails or is cancelled. An
+    // uninitialized engine is put in offline mode for the render and taken
+    // out again afterwards, with its processors kept.
+    FileIOResult render(const OfflineRenderSettings& settings);
+
+    // Safe to call from any thread while render() is running
+    void cancel() { cancelRequested_.store(true); }
+    bool isRendering() const { return rendering_.load(); }
+
+    // Stats for the most recent render
+    int64_t getFramesRendered() const { return framesRendered_; }
+    double getRenderSeconds() const { return renderSeconds_; }
+    double getRealtimeFactor() const;
+
+private:
+    FileIOResult renderBlocks(const OfflineRenderSettings& settings, AudioFileWriter& writer);
+    void reportProgress(float progress);
+
+    AudioEngine* engine_;
+    Mixer* mixer_;
+    Transport* transport_;
+
+    ProgressCallback progressCallback_;
+    BlockCallback blockCallback_;
+
+    std::atomic<bool> cancelRequested_;
+    std::atomic<bool> rendering_;
+
+    std::vector<float> interleavedBuffer_;
+
+    int64_t framesRendered_;
+    double renderSeconds_;
+    double renderedAudioSeconds_;
+    float lastReportedProgress_;
+};
+
+} // namespace OmegaDAW
+
+#endif // OMEGA_DAW_OFFLINE_RENDERER_H
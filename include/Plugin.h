@@ -34,7 +34,7 @@ class Plugin {
     virtual void process(float** inputs, float** outputs, int numChannels, int numSamples) = 0;
     virtual void reset() = 0;
 
-    std::string getName() const { return name; }
+    const std::string& getName() const { return name; }
     PluginType getType() const { return type; }
     std::string getVersion() const { return version; }
     std::string getVendor() const { return vendor; }
@@ -12,7 +12,8 @@ class PluginHost {
     PluginHost();
     ~PluginHost();
 
-    void initialize(int sampleRate, int maxBufferSize);
+    // Sizes the intermediate buffers; processPluginChain never allocates
+    void initialize(int sampleRate, int maxBufferSize, int maxChannels = 2);
     
     void addPlugin(std::shared_ptr<Plugin> plugin);
     void removePlugin(size_t index);
@@ -33,8 +34,10 @@ class PluginHost {
     std::vector<std::shared_ptr<Plugin>> pluginChain;
     int sampleRate;
     int maxBufferSize;
+    int maxChannels;
     
     std::vector<std::vector<float>> intermediateBuffers;
+    std::vector<float*> intermediatePointers;
     void allocateIntermediateBuffers(int numChannels, int numSamples);
 };
 
@@ -0,0 +1,142 @@
+#ifndef OMEGA_DAW_PROFILER_H
+#define OMEGA_DAW_PROFILER_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace OmegaDAW {
+
+// Cheap timestamps for the audio thread: the TSC on x86 (when invariant),
+// the virtual counter on AArch64, otherwise std::chrono::steady_clock.
+// The tick rate is measured from program start to the first use of
+// ticksPerSecond(), so that call doesn't block unless it comes within the
+// first 20 ms.
+namespace ProfilerClock {
+    uint64_t now();
+    double ticksPerSecond();
+    double ticksToNanoseconds(uint64_t ticks);
+    uint64_t secondsToTicks(double seconds);
+    const char* getSourceName();
+}
+
+// Aggregated timing, converted to nanoseconds
+struct TimingSummary {
+    uint64_t count = 0;
+    double minNs = 0.0;
+    double avgNs = 0.0;
+    double maxNs = 0.0;
+    double p99Ns = 0.0;   // Upper edge of the histogram bin holding the 99th percentile
+};
+
+// One histogram bin, [lowerNs, upperNs)
+struct HistogramBin {
+    double lowerNs = 0.0;
+    double upperNs = 0.0;
+    uint64_t count = 0;
+};
+
+// Lock-free duration statistics
+//
+// Writers (audio or worker threads) only do relaxed atomic adds into a
+// log-spaced histogram with four bins per octave, so recording never blocks
+// and concurrent writers are safe. Readers on any thread get a summary or
+// the histogram; resets are requests applied by the next writer.
+class TimingStats {
+public:
+    static constexpr int kNumBins = 128;
+
+    TimingStats();
+
+    TimingStats(const TimingStats&) = delete;
+    TimingStats& operator=(const TimingStats&) = delete;
+
+    // Writer side
+    void record(uint64_t ticks);
+
+    // Reader side
+    TimingSummary getSummary() const;
+    std::vector<HistogramBin> getHistogram() const;  // Non-empty bins only
+    void requestReset();
+
+private:
+    static int binForTicks(uint64_t ticks);
+    static uint64_t binLowerTicks(int bin);
+    void applyReset();
+
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> totalTicks_;
+    std::atomic<uint64_t> minTicks_;
+    std::atomic<uint64_t> maxTicks_;
+    std::atomic<uint64_t> bins_[kNumBins];
+    std::atomic<bool> resetRequested_;
+};
+
+// Times a scope into a TimingStats (no-op for nullptr)
+class ScopedTiming {
+public:
+    explicit ScopedTiming(TimingStats* stats)
+        : stats_(stats), start_(stats ? ProfilerClock::now() : 0) {}
+    ~ScopedTiming() {
+        if (stats_) {
+            stats_->record(ProfilerClock::now() - start_);
+        }
+    }
+
+    ScopedTiming(const ScopedTiming&) = delete;
+    ScopedTiming& operator=(const ScopedTiming&) = delete;
+
+private:
+    TimingStats* stats_;
+    uint64_t start_;
+};
+
+// Audio callback timing against the block deadline
+struct CallbackProfile {
+    TimingSummary timing;
+    std::vector<HistogramBin> histogram;
+    uint64_t xrunCount = 0;       // Callbacks that took longer than their block lasts
+    double lastBudgetNs = 0.0;    // Duration of the most recent block
+    double worstLoad = 0.0;       // Highest duration / budget seen
+};
+
+class CallbackProfiler {
+public:
+    CallbackProfiler();
+
+    CallbackProfiler(const CallbackProfiler&) = delete;
+    CallbackProfiler& operator=(const CallbackProfiler&) = delete;
+
+    // Not while the callback is running
+    void prepare(int sampleRate);
+
+    // Audio thread: one callback of numFrames took ticks
+    void recordCallback(uint64_t ticks, int numFrames);
+
+    CallbackProfile getProfile() const;
+    void requestReset();
+
+private:
+    TimingStats stats_;
+    double ticksPerFrame_;
+    std::atomic<uint64_t> xrunCount_;
+    std::atomic<uint64_t> lastBudgetTicks_;
+    std::atomic<double> worstLoad_;
+    std::atomic<bool> resetRequested_;
+};
+
+// Named timing for one processor or mixer bus
+struct ProcessorProfile {
+    std::string name;
+    TimingSummary timing;
+};
+
+// Plain-text report for the console
+void printProfileReport(std::ostream& out, const CallbackProfile& callback,
+                        const std::vector<ProcessorProfile>& processors);
+
+} // namespace OmegaDAW
+
+#endif // OMEGA_DAW_PROFILER_H
@@ -0,0 +1,85 @@
+#ifndef OMEGA_DAW_REALTIME_SAFETY_H
+#define OMEGA_DAW_REALTIME_SAFETY_H
+
+#include <cstddef>
+#include <ostream>
+
+namespace OmegaDAW {
+
+// Real-time safety checker
+//
+// Debug builds configured with OMEGA_RT_SAFETY_CHECKS interpose heap
+// allocation and mutex locking. Any such call made while the calling thread
+// is inside a real-time section (the audio callback) is recorded together
+// with a stack trace and the name of the processor that was running.
+// Without the define every scope helper below compiles to nothing.
+namespace RealtimeSafety {
+
+enum class ViolationKind {
+    Allocation,
+    Deallocation,
+    MutexLock
+};
+
+// True when the interposers are compiled in
+bool isEnabled();
+
+// Thread-local section tracking (called by the scope helpers)
+void enterRealtimeSection();
+void exitRealtimeSection();
+bool isInRealtimeSection();
+const char* setCurrentProcessor(const char* name);
+
+// Violation log - safe to query from any non-real-time thread
+size_t getViolationCount();
+void reportViolations(std::ostream& out);
+void clearViolations();
+
+// Abort the process on the first violation (useful in CI).
+// Also enabled by setting OMEGA_RT_SAFETY_ABORT=1 in the environment.
+void setAbortOnViolation(bool abortOnViolation);
+
+} // namespace RealtimeSafety
+
+#ifdef OMEGA_RT_SAFETY_CHECKS
+
+// Marks the current scope as real-time (no allocation, no locking)
+class ScopedRealtimeSection {
+public:
+    ScopedRealtimeSection() { RealtimeSafety::enterRealtimeSection(); }
+    ~ScopedRealtimeSection() { RealtimeSafety::exitRealtimeSection(); }
+    ScopedRealtimeSection(const ScopedRealtimeSection&) = delete;
+    ScopedRealtimeSection& operator=(const ScopedRealtimeSection&) = delete;
+};
+
+// Attributes violations in this scope to the named processor.
+// The name must outlive the scope; it is copied only when a violation fires.
+class ScopedRealtimeProcessor {
+public:
+    explicit ScopedRealtimeProcessor(const char* name)
+        : previous_(RealtimeSafety::setCurrentProcessor(name)) {}
+    ~ScopedRealtimeProcessor() { RealtimeSafety::setCurrentProcessor(previous_); }
+    ScopedRealtimeProcessor(const ScopedRealtimeProcessor&) = delete;
+    ScopedRealtimeProcessor& operator=(const ScopedRealtimeProcessor&) = delete;
+
+private:
+    const char* previous_;
+};
+
+#else
+
+class ScopedRealtimeSection {
+public:
+    ScopedRealtimeSection() {}
+};
+
+class ScopedRealtimeProcessor {
+public:
+    explicit ScopedRealtimeProcessor(const char*) {}
+};
+
+#endif // OMEGA_RT_SAFETY_CHECKS
+
+} // namespace OmegaDAW
+
+#endif // OMEGA_DAW_REALTIME_SAFETY_H
@@ -0,0 +1,86 @@
+#ifndef OMEGA_DAW_RESAMPLER_H
+#define OMEGA_DAW_RESAMPLER_H
+
+#include <atomic>
+#include <vector>
+
+namespace OmegaDAW {
+
+enum class ResamplerQuality {
+    Draft,      // 8 taps - previews, scrubbing
+    Realtime,   // 32 taps - playback
+    Mastering   // 128 taps - offline render and export
+};
+
+// Streaming polyphase windowed-sinc resampler
+//
+// A Kaiser-windowed sinc is tabulated at a fixed number of phases per input
+// sample; each output sample linearly interpolates between the two nearest
+// phases, so any ratio works and the ratio can change between blocks
+// without a discontinuity. The filter history carries over from one
+// process() call to the next. The cutoff is set for the ratio given to
+// initialize() (lowered when downsampling so nothing aliases).
+//
+// initialize() allocates; process() and setRatio() are real-time safe.
+class Resampler {
+public:
+    Resampler();
+    ~Resampler() = default;
+
+    Resampler(const Resampler&) = delete;
+    Resampler& operator=(const Resampler&) = delete;
+
+    void initialize(int inputSampleRate, int outputSampleRate, int numChannels,
+                    ResamplerQuality quality = ResamplerQuality::Realtime);
+
+    // Forget the history (after a seek); the next output starts at the next input
+    void reset();
+
+    // Output frames per input frame. Can be changed while streaming
+    // (varispeed); takes effect at the next process() call.
+    void setRatio(double ratio);
+    double getRatio() const { return ratio_.load(std::memory_order_relaxed); }
+
+    // Planar streaming: reads up to inputFrames, writes up to maxOutputFrames.
+    // Returns the frames written; inputFramesUsed receives the frames read.
+    int process(const float* const* input, int inputFrames,
+                float* const* output, int maxOutputFrames, int& inputFramesUsed);
+
+    // Estimates at the current ratio
+    int getOutputFrameCount(int inputFrames) const;
+    int getInputFramesNeeded(int outputFrames) const;
+
+    // Input frames of look-ahead the filter needs before the first output
+    int getLatency() const { return halfTaps_; }
+
+    ResamplerQuality getQuality() const { return quality_; }
+    int getNumTaps() const { return numTaps_; }
+    int getNumChannels() const { return numChannels_; }
+
+private:
+    void buildFilterBank(double cutoff, double kaiserBeta);
+    void compact();
+
+    ResamplerQuality quality_;
+    int numChannels_;
+    int numTaps_;
+    int halfTaps_;
+    int numPhases_;
+
+    // (numPhases_ + 1) rows of numTaps_ coefficients
+    std::vector<float> filterBank_;
+    std::vector<float> coefficients_;  // Interpolated row for the current output
+
+    // Per-channel input history: the filter window starts at floor(position_)
+    std::vector<std::vector<float>> history_;
+    int historyCapacity_;
+    int historyFrames_;
+    double position_;
+    long long framesToSkip_;  // Input the read position has already passed
+
+    std::atomic<double> ratio_;
+};
+
+} // namespace OmegaDAW
+
+#endif // OMEGA_DAW_RESAMPLER_H
@@ -2,10 +2,15 @@
 #define OMEGA_DAW_ROUTER_H
 
 #include "AudioBuffer.h"
+#include "GraphCompiler.h"
+#include "SnapshotPublisher.h"
+#include "TailTracker.h"
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <map>
 #include <set>
+#include <tuple>
 
 namespace OmegaDAW {
 
@@ -28,13 +33,36 @@ class AudioNode {
     AudioNode(int id, int numInputs, int numOutputs);
     virtual ~AudioNode() = default;
 
+    AudioNode(const AudioNode&) = delete;
+    AudioNode& operator=(const AudioNode&) = delete;
+
     virtual void process() = 0;
     virtual void reset() = 0;
 
+    // How long output continues once every input is silent. The built-in
+    // routing nodes are stateless; sources override this with kInfiniteTail.
+    virtual double getTailLengthSeconds() const { return 0.0; }
+    bool areInputsSilent() const;
+    TailTracker& getTailTracker() { return tailTracker_; }
+
     int getId() const { return id_; }
     int getNumInputs() const { return numInputs_; }
     int getNumOutputs() const { return numOutputs_; }
 
+    // Sources keep their own output buffers and sinks their own inputs, so
+    // data set before a block or read after it stays put. Every other port
+    // is bound by the router to a buffer shared with other nodes, and only
+    // holds meaningful data while the block runs.
+    bool isSource() const { return numInputs_ == 0; }
+    bool isSink() const { return numOutputs_ == 0; }
+    void allocateOwnBuffers(int numSamples);
+    AudioBuffer* getOwnInputBuffer(int channel) { return &inputBuffers_[channel]; }
+    AudioBuffer* getOwnOutputBuffer(int channel) { return &outputBuffers_[channel]; }
+
+    // Point the ports at other buffers (arrays of getNumInputs() and
+    // getNumOutputs() pointers); until then they use the node's own
+    void bindPorts(AudioBuffer* const* inputs, AudioBuffer* const* outputs);
+
     AudioBuffer& getInputBuffer(int channel);
     AudioBuffer& getOutputBuffer(int channel);
 
@@ -48,17 +76,72 @@ class AudioNode {
     
     std::vector<AudioBuffer> inputBuffers_;
     std::vector<AudioBuffer> outputBuffers_;
+    std::vector<AudioBuffer*> inputs_;   // Bound ports
+    std::vector<AudioBuffer*> outputs_;
+    TailTracker tailTracker_;
+};
+
+// Flat per-block work list compiled from the nodes and connections whenever
+// they change
+//
+// Nodes are in processing order, each with its enabled outgoing connections
+// resolved to buffer pointers and gains, so a block is one pass with no
+// lookups. The schedule holds references to its nodes, so removing a node
+// never pulls it out from under a block.
+//
+// Port buffers come from a shared pool by liveness: a buffer is cleared the
+// step its value is first written and handed to another port once the last
+// reader has run. An output with a single connection, into an input with no
+// other connection, shares that input's buffer and the send becomes an
+// in-place gain.
+//
+// The first block a schedule runs is a crossfade from the one before: each
+// connection ramps from startGain, connections that were removed ramp down
+// to silence, and a removed node runs once more to carry its fade-out.
+struct RouterSchedule {
+    struct Fanout {
+        const AudioBuffer* source;  // Output buffer of the scheduled node
+        AudioBuffer* target;        // Input buffer of the connected node (== source: in place)
+        float gain;
+        float startGain;
+    };
+
+    std::vector<std::shared_ptr<AudioNode>> nodes;
+    std::vector<int> fanoutOffsets;  // Node i: [fanoutOffsets[i], fanoutOffsets[i + 1])
+    std::vector<Fanout> fanouts;
+    std::vector<int> portOffsets;    // Node i: inputs then outputs from portOffsets[i]
+    std::vector<AudioBuffer*> ports;
+    std::vector<int> clearOffsets;   // Before node i: [clearOffsets[i], clearOffsets[i + 1])
+    std::vector<AudioBuffer*> clears;
+    std::vector<char> departing;     // Removed: runs only in the first block
+    uint64_t generation = 0;
+
+    int numPorts = 0;
+    int numBuffers = 0;              // Shared buffers plus sources' and sinks' own
+    int numAliasedConnections = 0;
 };
 
+// Node and connection edits must come from one thread; process() may run on
+// another and always sees a complete schedule. Edits are compiled into a new
+// schedule on a background thread and take effect at a later block boundary
+// (flushEdits() waits for that).
 class Router {
 public:
     Router();
-    ~Router() = default;
+    ~Router();
 
     void initialize(int sampleRate, int bufferSize);
     void process();
     void reset();
 
+    // Block until every earlier edit is in the schedule process() will use next
+    void flushEdits();
+
+    // Defer recompiling the schedule until the matching endUpdate(), for
+    // edits that touch many connections at once (calls may nest)
+    void beginUpdate();
+    void endUpdate();
+
     void addNode(std::shared_ptr<AudioNode> node);
     void removeNode(int nodeId);
     std::shared_ptr<AudioNode> getNode(int nodeId);
@@ -73,21 +156,48 @@ class Router {
     std::vector<Connection> getConnectionsFrom(int nodeId) const;
     std::vector<Connection> getConnectionsTo(int nodeId) const;
     std::vector<Connection> getAllConnections() const;
+    size_t getNumNodes() const { return nodes_.size(); }
+
+    // Off gives every port its own buffer (for comparison); on by default
+    void setBufferSharing(bool enabled);
+    bool isBufferSharing() const { return bufferSharing_; }
+
+    // Port and buffer counts of the current schedule
+    int getNumPorts() const;
+    int getNumPortBuffers() const;
+    int getNumAliasedConnections() const;
 
     bool hasConnection(int sourceId, int sourceChannel, int targetId, int targetChannel) const;
     bool detectCycle(int sourceId, int targetId) const;
 
 private:
     void updateProcessingOrder();
-    void topologicalSort();
+    void compileSchedule();
     bool hasCycleUtil(int nodeId, std::set<int>& visited, std::set<int>& recStack) const;
 
+    using ConnectionKey = std::tuple<int, int, int, int>;  // Source, channel, target, channel
+
+    // Shadow graph: edited by the caller, read by the compiler under editMutex_
     std::map<int, std::shared_ptr<AudioNode>> nodes_;
     std::vector<Connection> connections_;
-    std::vector<int> processingOrder_;
+    bool bufferSharing_;
+    std::mutex editMutex_;
+    int updateDepth_;
+    
+    SnapshotPublisher<RouterSchedule> schedule_;
+    std::map<ConnectionKey, float> compiledGains_;  // Connections in the last schedule (compiler only)
+    uint64_t scheduleGeneration_;                   // Compiler only
+    uint64_t processedGeneration_;                  // Audio thread only
+    
+    // Shared port buffers, reused by every schedule: nothing in them
+    // outlives a block, and only one schedule runs per block. The compiler
+    // holds poolMutex_ while it uses the pool or the schedule stats.
+    std::vector<std::unique_ptr<AudioBuffer>> bufferPool_;
+    mutable std::mutex poolMutex_;
     
     int sampleRate_;
     int bufferSize_;
+    GraphCompiler compiler_;
 };
 
 class InputNode : public AudioNode {
@@ -96,6 +206,7 @@ class InputNode : public AudioNode {
     
     void process() override;
     void reset() override;
+    double getTailLengthSeconds() const override { return kInfiniteTail; }
     
     void setInputBuffer(const AudioBuffer& buffer);
 };
@@ -107,7 +218,8 @@ class OutputNode : public AudioNode {
     void process() override;
     void reset() override;
     
-    AudioBuffer getOutputBuffer();
+    // Valid until the next process() or reset()
+    const AudioBuffer& getOutputBuffer() const;
 };
 
 class GainNode : public AudioNode {
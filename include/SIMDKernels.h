@@ -0,0 +1,101 @@
+#ifndef OMEGA_DAW_SIMD_KERNELS_H
+#define OMEGA_DAW_SIMD_KERNELS_H
+
+namespace OmegaDAW {
+
+// Vectorized block kernels for the engine's I/O, master stage and buffer math
+//
+// Every kernel has a scalar reference plus SSE2, AVX2, AVX-512 and NEON
+// versions where the target supports them. The best instruction set is picked
+// once at startup from CPUID (or OMEGA_SIMD=scalar|sse2|avx2|avx512|neon); all
+// versions use the same arithmetic so they agree to within float rounding.
+// Buffers need no particular alignment, and nothing here allocates or locks.
+namespace SIMD {
+
+enum class InstructionSet {
+    Scalar,
+    SSE2,
+    AVX2,
+    AVX512,
+    NEON
+};
+
+// Interleaved -> planar, scaling by gain
+void deinterleave(const float* source, float* const* dest, int numChannels, int numFrames, float gain = 1.0f);
+
+// Planar -> interleaved
+void interleave(const float* const* source, float* dest, int numChannels, int numFrames);
+
+// buffer *= gain
+void applyGain(float* buffer, int numSamples, float gain);
+
+// dest += source
+void add(float* dest, const float* source, int numSamples);
+
+// dest += source * gain
+void addWithGain(float* dest, const float* source, int numSamples, float gain);
+
+// buffer[i] *= gain ramped linearly from startGain (at i = 0) towards endGain
+// (reached at i = numSamples)
+void applyGainRamp(float* buffer, int numSamples, float startGain, float endGain);
+
+// dest[i] += source[i] * gain, with the gain ramped as in applyGainRamp
+void addWithGainRamp(float* dest, const float* source, int numSamples, float startGain, float endGain);
+
+// dest += a * b
+void multiplyAdd(float* dest, const float* a, const float* b, int numSamples);
+
+// Master clip stage: samples above 0.9 go through 2 * tanh(x / 2), then
+// everything is hard clipped to [-1, 1]
+void softClip(float* buffer, int numSamples);
+
+// Sum of a[i] * b[i] (summation order differs between instruction sets)
+float dotProduct(const float* a, const float* b, int numSamples);
+
+// dest = a + (b - a) * t
+void interpolate(float* dest, const float* a, const float* b, int numSamples, float t);
+
+// Largest |buffer[i]| (0 for an empty range); same result on every instruction set
+float peakAbs(const float* buffer, int numSamples);
+
+// One radix-4 pass (two radix-2 stages) of a forward FFT on split complex
+// data, in place, for every block of 4 * quarter points in n. At offset
+// j < quarter of a block, with x_k the point at j + k * quarter and twiddles
+// laid out as four runs of quarter floats (a re, a im, b re, b im):
+//   p = x0 + a x1, q = x0 - a x1, s = x2 + a x3, t = x2 - a x3
+//   x0 = p + b s, x2 = p - b s, x1 = q - i b t, x3 = q + i b t
+// Same result on every instruction set.
+void fftRadix4(float* re, float* im, int n, int quarter, const float* twiddles);
+
+// dest += a * b on interleaved complex numbers (re, im pairs), numComplex of
+// each; same result on every instruction set
+void complexMultiplyAdd(float* dest, const float* a, const float* b, int numComplex);
+
+// Lanes in a biquadLanes pass
+constexpr int kBiquadLanes = 8;
+
+// Transposed direct form II biquads, in place on numFrames interleaved
+// frames of channels = 1, 2, 4 or 8 samples. Lane l filters channel
+// l % channels through section l / channels, and each section feeds the
+// next, so one pass is a cascade of kBiquadLanes / channels sections. The
+// sections run one frame apart, which keeps every lane busy.
+//   y = b0 x + s1, s1 = (b1 x + s2) - a1 y, s2 = b2 x - a2 y
+// coefficients are five runs of kBiquadLanes floats (b0, b1, b2, a1, a2,
+// with a0 = 1) and state two runs (s1, s2); both are updated. If increments
+// (same layout as coefficients) is non-null, each lane's coefficients step
+// by it after every frame. Same result on every instruction set.
+void biquadLanes(float* frames, int numFrames, int channels, float* coefficients, const float* increments,
+                 float* state);
+
+// Dispatch control (not while the audio thread is running kernels)
+InstructionSet getInstructionSet();
+InstructionSet getBestInstructionSet();
+bool isSupported(InstructionSet set);
+bool setInstructionSet(InstructionSet set);
+const char* getInstructionSetName(InstructionSet set);
+
+} // namespace SIMD
+
+} // namespace OmegaDAW
+
+#endif // OMEGA_DAW_SIMD_KERNELS_H
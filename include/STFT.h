@@ -0,0 +1,87 @@
+#ifndef OMEGA_DAW_STFT_H
+#define OMEGA_DAW_STFT_H
+
+#include "FFT.h"
+#include <complex>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace OmegaDAW {
+
+// Streaming short-time Fourier transform: analysis, an in-place spectral
+// callback, and weighted overlap-add resynthesis
+//
+// Input is gathered a hop at a time. Every hop, the last fftSize samples of
+// each channel are windowed and transformed, the callback edits the bins in
+// place, and the inverse transform is windowed again and overlap-added into
+// the output. Output runs exactly getLatency() samples behind the input, for
+// any host block size; with an untouched spectrum it reproduces the input.
+//
+// prepare() allocates everything; process() doesn't allocate or lock and
+// works in place. Windowing and overlap-add use the SIMD kernels.
+class StreamingSTFT {
+public:
+    enum class Window {
+        Hann,       // Perfect reconstruction from overlap 4 up
+        SqrtHann,   // Perfect reconstruction from overlap 2 up
+        Hamming,    // Overlap 4 up
+        Blackman    // Overlap 8 up
+    };
+
+    // Called for every frame, once per channel in order; bins run DC to
+    // Nyquist (numBins = fftSize / 2 + 1)
+    using SpectrumCallback = std::function<void(int channel, std::complex<float>* bins, int numBins)>;
+
+    StreamingSTFT();
+    ~StreamingSTFT();
+
+    // fftSize a power of two, overlap (frames per fftSize) a power of two
+    // below it; not concurrent with process()
+    bool prepare(int numChannels, int fftSize, int overlap, Window window = Window::Hann);
+    void reset();
+
+    // Not concurrent with process()
+    void setCallback(SpectrumCallback callback) { callback_ = std::move(callback); }
+
+    int getNumChannels() const { return numChannels_; }
+    int getFFTSize() const { return fftSize_; }
+    int getHopSize() const { return hopSize_; }
+    int getNumBins() const { return fftSize_ / 2 + 1; }
+    int getLatency() const { return fftSize_; }
+
+    // Bin magnitude times this reads as the amplitude of a sine at the
+    // bin's centre frequency
+    float getAmplitudeScale() const { return amplitudeScale_; }
+
+    // Up to getNumChannels() channels (the others' state is left alone);
+    // input and output may be the same buffers
+    void process(const float* const* input, float* const* output, int numChannels, int numFrames);
+
+private:
+    void processFrame(int numChannels);
+
+    int numChannels_;
+    int fftSize_;
+    int hopSize_;
+    int filled_;              // Samples of the current hop received
+    float amplitudeScale_;
+    SpectrumCallback callback_;
+
+    std::shared_ptr<const FFTPlan> plan_;
+    std::vector<float> analysisWindow_;
+    std::vector<float> synthesisWindow_;   // Includes the overlap-add normalization
+
+    std::vector<std::vector<float>> input_;    // Per channel: last fftSize samples
+    std::vector<std::vector<float>> output_;   // Per channel: overlap-add accumulator
+    std::vector<std::vector<float>> ready_;    // Per channel: finished hop being played
+
+    // Scratch
+    std::vector<float> frame_;
+    std::vector<std::complex<float>> bins_;
+    std::vector<float> work_;
+};
+
+} // namespace OmegaDAW
+
+#endif // OMEGA_DAW_STFT_H
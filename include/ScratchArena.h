@@ -0,0 +1,107 @@
+#ifndef OMEGA_DAW_SCRATCH_ARENA_H
+#define OMEGA_DAW_SCRATCH_ARENA_H
+
+#include "AudioBuffer.h"
+#include <cstddef>
+#include <vector>
+
+namespace OmegaDAW {
+
+// Bump allocator for transient per-block audio buffers
+//
+// Allocations are 64-byte aligned, zeroed, and just advance an offset; a
+// ScratchScope rewinds to where it started when it closes, so everything
+// borrowed during a block is handed back at block end without touching the
+// heap. Each thread has its own arena (getForThread()).
+//
+// If a block needs more than the arena holds, the excess comes from the heap
+// and is counted in getOverflowCount(); once the outermost scope closes the
+// arena grows to the high-water mark, so only the first such block pays.
+// An arena must only be used by one thread.
+class ScratchArena {
+public:
+    static constexpr size_t kAlignment = 64;
+
+    ScratchArena();
+    explicit ScratchArena(size_t capacityBytes);
+    ~ScratchArena();
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    // Grow to at least this many bytes (only while nothing is borrowed)
+    void reserve(size_t bytes);
+
+    // Valid until the enclosing scope closes
+    float* allocateFloats(int count);
+    AudioBufferView allocateBuffer(int numChannels, int numSamples);
+
+    // Scope bookkeeping (ScratchScope is the usual way to use these).
+    // endScope() hands back everything allocated since the matching
+    // beginScope(); scopes must nest.
+    size_t beginScope();
+    void endScope(size_t mark);
+
+    size_t getCapacity() const { return capacity_; }
+    size_t getUsed() const { return used_; }
+    size_t getHighWaterMark() const { return highWaterMark_; }
+    size_t getOverflowCount() const { return overflowCount_; }
+
+    // The calling thread's arena: the one bound with ScopedThreadArena, or
+    // else a per-thread arena that starts empty and grows to fit
+    static ScratchArena& getForThread();
+
+private:
+    void* allocateBytes(size_t bytes);
+    void releaseOverflow();
+
+    unsigned char* data_;
+    size_t capacity_;
+    size_t used_;
+    size_t highWaterMark_;  // Including overflow
+    size_t overflowCount_;
+    size_t overflowBytes_;
+    std::vector<void*> overflowBlocks_;
+    int openScopes_;
+};
+
+// Makes an arena the calling thread's arena for the lifetime of the scope
+// (lets the engine hand its preallocated arena to the audio callback)
+class ScopedThreadArena {
+public:
+    explicit ScopedThreadArena(ScratchArena& arena);
+    ~ScopedThreadArena();
+
+    ScopedThreadArena(const ScopedThreadArena&) = delete;
+    ScopedThreadArena& operator=(const ScopedThreadArena&) = delete;
+
+private:
+    ScratchArena* previous_;
+};
+
+// Borrows from an arena for the lifetime of the scope
+class ScratchScope {
+public:
+    explicit ScratchScope(ScratchArena& arena = ScratchArena::getForThread())
+        : arena_(arena)
+        , mark_(arena.beginScope()) {}
+    ~ScratchScope() { arena_.endScope(mark_); }
+
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
+
+    float* allocateFloats(int count) { return arena_.allocateFloats(count); }
+    AudioBufferView allocateBuffer(int numChannels, int numSamples) {
+        return arena_.allocateBuffer(numChannels, numSamples);
+    }
+
+    ScratchArena& getArena() { return arena_; }
+
+private:
+    ScratchArena& arena_;
+    size_t mark_;
+};
+
+} // namespace OmegaDAW
+
+#endif // OMEGA_DAW_SCRATCH_ARENA_H
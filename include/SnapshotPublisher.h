@@ -0,0 +1,93 @@
+#ifndef OMEGA_DAW_SNAPSHOT_PUBLISHER_H
+#define OMEGA_DAW_SNAPSHOT_PUBLISHER_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+namespace OmegaDAW {
+
+// Publishes immutable snapshots from an editing thread to a single real-time
+// reader (the audio thread).
+//
+// The reader brackets every use with beginRead()/endRead(); both are a single
+// atomic increment plus a load, so the audio thread never blocks. Replaced
+// snapshots are retired together with the reader epoch observed at swap time
+// and are deleted by the editing thread once the reader has provably left the
+// section that could still see them. The audio thread never frees memory.
+//
+// All writer-side calls must be serialized by the owner (e.g. an edit mutex).
+template <typename T>
+class SnapshotPublisher {
+public:
+    SnapshotPublisher() : current_(nullptr), readerEpoch_(0) {}
+
+    ~SnapshotPublisher() {
+        delete current_.load();
+        for (auto& retired : retired_) {
+            delete retired.snapshot;
+        }
+    }
+
+    SnapshotPublisher(const SnapshotPublisher&) = delete;
+    SnapshotPublisher& operator=(const SnapshotPublisher&) = delete;
+
+    // Reader side (audio thread) - wait-free
+    const T* beginRead() {
+        readerEpoch_.fetch_add(1);
+        return current_.load();
+    }
+
+    void endRead() {
+        readerEpoch_.fetch_add(1);
+    }
+
+    // Writer side - swaps in a new snapshot and retires the previous one
+    void publish(std::unique_ptr<T> snapshot) {
+        T* previous = current_.exchange(snapshot.release());
+        if (previous) {
+            retired_.push_back({previous, readerEpoch_.load()});
+        }
+        reclaim();
+    }
+
+    // Writer-side view of the most recently published snapshot
+    const T* get() const { return current_.load(); }
+
+    // Delete retired snapshots the reader can no longer be using
+    void reclaim() {
+        if (retired_.empty()) {
+            return;
+        }
+
+        uint64_t epoch = readerEpoch_.load();
+        auto it = retired_.begin();
+        while (it != retired_.end()) {
+            // Even epoch at swap time: reader was outside a read section.
+            // Changed epoch: the section that might have seen it has ended.
+            if ((it->epoch & 1) == 0 || it->epoch != epoch) {
+                delete it->snapshot;
+                it = retired_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    size_t getRetiredCount() const { return retired_.size(); }
+
+private:
+    struct Retired {
+        T* snapshot;
+        uint64_t epoch;
+    };
+
+    std::atomic<T*> current_;
+    std::atomic<uint64_t> readerEpoch_;
+    std::vector<Retired> retired_;
+};
+
+} // namespace OmegaDAW
+
+#endif // OMEGA_DAW_SNAPSHOT_PUBLISHER_H
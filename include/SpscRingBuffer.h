@@ -0,0 +1,91 @@
+#ifndef OMEGA_DAW_SPSC_RING_BUFFER_H
+#define OMEGA_DAW_SPSC_RING_BUFFER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace OmegaDAW {
+
+// Bounded single-producer/single-consumer ring of trivially copyable values.
+// One thread writes, one thread reads; neither ever blocks or allocates.
+template <typename T>
+class SpscRingBuffer {
+public:
+    explicit SpscRingBuffer(size_t capacity = 0)
+        : capacity_(0), mask_(0), readIndex_(0), writeIndex_(0) {
+        reset(capacity);
+    }
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    // Reallocate (rounded up to a power of two); not concurrent with I/O
+    void reset(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        capacity_ = capacity > 0 ? size : 0;
+        mask_ = capacity_ > 0 ? capacity_ - 1 : 0;
+        data_.reset(capacity_ > 0 ? new T[capacity_] : nullptr);
+        readIndex_.store(0);
+        writeIndex_.store(0);
+    }
+
+    size_t getCapacity() const { return capacity_; }
+
+    size_t getNumReadable() const {
+        return writeIndex_.load(std::memory_order_acquire) - readIndex_.load(std::memory_order_acquire);
+    }
+
+    size_t getNumWritable() const {
+        return capacity_ - getNumReadable();
+    }
+
+    // Producer: writes all count values or nothing
+    bool tryWrite(const T* source, size_t count) {
+        size_t write = writeIndex_.load(std::memory_order_relaxed);
+        size_t read = readIndex_.load(std::memory_order_acquire);
+        if (capacity_ - (write - read) < count) {
+            return false;
+        }
+
+        size_t start = write & mask_;
+        size_t first = std::min(count, capacity_ - start);
+        std::copy(source, source + first, data_.get() + start);
+        std::copy(source + first, source + count, data_.get());
+
+        writeIndex_.store(write + count, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: reads up to maxCount values, returns how many were read
+    size_t read(T* dest, size_t maxCount) {
+        size_t read = readIndex_.load(std::memory_order_relaxed);
+        size_t write = writeIndex_.load(std::memory_order_acquire);
+        size_t count = std::min(maxCount, write - read);
+
+        size_t start = read & mask_;
+        size_t first = std::min(count, capacity_ - start);
+        std::copy(data_.get() + start, data_.get() + start + first, dest);
+        std::copy(data_.get(), data_.get() + (count - first), dest + first);
+
+        readIndex_.store(read + count, std::memory_order_release);
+        return count;
+    }
+
+private:
+    std::unique_ptr<T[]> data_;
+    size_t capacity_;
+    size_t mask_;
+
+    // Monotonic indices on separate cache lines
+    alignas(64) std::atomic<size_t> readIndex_;
+    alignas(64) std::atomic<size_t> writeIndex_;
+};
+
+} // namespace OmegaDAW
+
+#endif // OMEGA_DAW_SPSC_RING_BUFFER_H
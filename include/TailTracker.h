@@ -0,0 +1,74 @@
+#ifndef OMEGA_DAW_TAIL_TRACKER_H
+#define OMEGA_DAW_TAIL_TRACKER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace OmegaDAW {
+
+// Tail length for processors that make sound from silence (generators) or
+// don't know how long they ring; these are never skipped
+constexpr double kInfiniteTail = std::numeric_limits<double>::infinity();
+
+// Level a tail has to fall by before it counts as over (-120 dB)
+constexpr double kTailFloor = 1.0e-6;
+
+// Time for a feedback loop (gain per pass, seconds per pass) to ring down
+inline double feedbackTailSeconds(double loopGain, double loopSeconds) {
+    loopGain = std::abs(loopGain);
+    if (loopGain >= 1.0) {
+        return kInfiniteTail;
+    }
+    if (loopGain <= 0.0) {
+        return loopSeconds;
+    }
+    return loopSeconds * (1.0 + std::log(kTailFloor) / std::log(loopGain));
+}
+
+// Samples for a biquad with denominator 1 + a1 z^-1 + a2 z^-2 to ring down,
+// from the radius of its larger pole
+inline double biquadTailSamples(double a1, double a2) {
+    double discriminant = a1 * a1 - 4.0 * a2;
+    double radius = discriminant < 0.0
+        ? std::sqrt(std::abs(a2))
+        : 0.5 * std::max(std::abs(-a1 + std::sqrt(discriminant)), std::abs(-a1 - std::sqrt(discriminant)));
+    if (radius >= 1.0) {
+        return kInfiniteTail;
+    }
+    if (radius <= 0.0) {
+        return 2.0;
+    }
+    return 2.0 + std::log(kTailFloor) / std::log(radius);
+}
+
+// Decides when a processor fed silence has finished ringing out
+//
+// Ask once per block, before processing. The processor keeps running while
+// its tail plays; after tailSamples of unbroken silent input its output is
+// silent too, so it can be skipped until sound comes back.
+class TailTracker {
+public:
+    bool canSkip(bool inputSilent, double tailSamples, int numSamples) {
+        if (!inputSilent) {
+            silentSamples_ = 0;
+            return false;
+        }
+        if (static_cast<double>(silentSamples_) >= tailSamples) {
+            return true;
+        }
+        silentSamples_ += numSamples;
+        return false;
+    }
+
+    // Forget the silence seen so far (the processor runs again next block)
+    void reset() { silentSamples_ = 0; }
+
+private:
+    int64_t silentSamples_ = 0;
+};
+
+} // namespace OmegaDAW
+
+#endif // OMEGA_DAW_TAIL_TRACKER_H
@@ -0,0 +1,288 @@
+#ifndef OMEGA_DAW_TIME_STRETCH_H
+#define OMEGA_DAW_TIME_STRETCH_H
+
+#include "AudioBuffer.h"
+#include "FFT.h"
+#include "GraphCompiler.h"
+#include <atomic>
+#include <complex>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace OmegaDAW {
+
+class AudioClip;
+
+// How a clip (or stream) is stretched and shifted
+struct StretchSettings {
+    double timeStretch = 1.0;         // Output duration / input duration (0.25 to 4)
+    float pitchShift = 0.0f;          // Semitones (-24 to +24)
+    bool formantPreservation = false; // Keep the spectral envelope where it was
+
+    bool operator==(const StretchSettings& other) const {
+        return timeStretch == other.timeStretch && pitchShift == other.pitchShift
+            && formantPreservation == other.formantPreservation;
+    }
+    bool operator!=(const StretchSettings& other) const { return !(*this == other); }
+
+    bool isIdentity() const { return timeStretch == 1.0 && pitchShift == 0.0f; }
+};
+
+// One channel of a phase-locked vocoder: turns analysis frames taken
+// analysisHop samples apart into synthesis frames synthesisHop apart
+//
+// Identity phase locking (Laroche and Dolson): only spectral peaks get their
+// phase advanced from their measured frequency; every other bin keeps its
+// phase relative to the peak whose region it's in, so the partials stay
+// coherent instead of smearing into the "phasey" sound of a plain vocoder.
+// That costs a couple of atan2s per peak rather than per bin.
+//
+// Pitch is shifted in the spectrum: each peak's region moves to the peak's
+// bin times the pitch ratio and its phase advances at the shifted
+// frequency, so no resampling is needed. With formant preservation the
+// moved bins are rescaled by the cepstral envelope of the frame, so the
+// envelope stays put while the partials move under it.
+//
+// A frame where most bins jump by more than 3 dB is taken as a transient:
+// the output takes the analysis phases as they are, so attacks stay sharp
+// rather than being smeared across the frame.
+class PhaseLockedVocoder {
+public:
+    PhaseLockedVocoder();
+
+    // Allocates
+    void prepare(int fftSize, int sampleRate);
+
+    // The next frame starts afresh from its own phases
+    void reset();
+
+    // bins (DC to Nyquist, from a forward FFTPlan) are replaced in place.
+    // work needs FFTPlan::getWorkSize() floats (formant preservation only).
+    void processFrame(std::complex<float>* bins, int analysisHop, int synthesisHop,
+                      float pitchRatio, bool preserveFormants, bool detectTransients, float* work);
+
+    bool lastFrameWasTransient() const { return lastTransient_; }
+
+private:
+    void computeEnvelope(float* work);
+
+    int fftSize_;
+    int numBins_;
+    int lifter_;              // Cepstral coefficients kept for the envelope
+    bool first_;
+    bool lastTransient_;
+
+    std::shared_ptr<const FFTPlan> plan_;
+    std::vector<std::complex<float>> previousInput_;
+    std::vector<std::complex<float>> previousOutput_;
+    std::vector<std::complex<float>> output_;
+    std::vector<float> power_;
+    std::vector<float> previousPower_;
+    std::vector<int> peaks_;
+    std::vector<float> logEnvelope_;
+    std::vector<float> cepstrum_;
+    std::vector<std::complex<float>> envelopeBins_;
+};
+
+// Streaming time stretcher and pitch shifter
+//
+// Input is written in and stretched output read out, at different rates:
+// frames are analysed every timeStretch-th of the synthesis hop, so the
+// output runs timeStretch times as long as the input. Output frame j lines
+// up with input frame getPreRoll() + j / timeStretch - write getPreRoll()
+// frames of whatever precedes the start point (silence at the very start)
+// first.
+//
+// Settings can change at any time and take effect at the next frame.
+// prepare() allocates; everything else is real-time safe.
+class TimeStretcher {
+public:
+    enum class Quality {
+        Realtime,   // 2048-point frames (at 48 kHz), overlap 4: playback
+        Offline     // 4096-point frames (at 48 kHz), overlap 8: pre-rendered clips
+    };
+
+    TimeStretcher();
+    ~TimeStretcher();
+
+    TimeStretcher(const TimeStretcher&) = delete;
+    TimeStretcher& operator=(const TimeStretcher&) = delete;
+
+    bool prepare(int numChannels, int sampleRate, Quality quality = Quality::Realtime);
+
+    // Forget everything written; start again with the pre-roll
+    void reset();
+
+    void setSettings(const StretchSettings& settings);
+    StretchSettings getSettings() const;
+    void setTransientHandling(bool enabled) { transients_.store(enabled); }
+
+    int getNumChannels() const { return numChannels_; }
+    int getFFTSize() const { return fftSize_; }
+    int getHopSize() const { return hopSize_; }
+
+    // Frames of history before the start point, at the current stretch
+    int getPreRoll() const;
+
+    // Input needed before the next frame can run: 0 while the output is full
+    int getInputFramesNeeded() const;
+
+    // Takes up to numFrames (input nullptr: silence) and runs the frames it
+    // completes; returns the frames taken
+    int write(const float* const* input, int numFrames);
+
+    int getAvailable() const { return readyCount_; }
+    int read(float* const* output, int numFrames);
+
+    // The whole of source, stretched: round(length * timeStretch) frames
+    static void renderOffline(const AudioBuffer& source, int sampleRate, const StretchSettings& settings,
+                              AudioBuffer& destination);
+
+private:
+    void runFrame();
+
+    int numChannels_;
+    int sampleRate_;
+    int fftSize_;
+    int hopSize_;
+    int filled_;              // Input frames in the window
+    int skip_;                // Input frames still to drop (hop longer than the window)
+    int lastHop_;             // Analysis hop into the next frame
+    double analysisPhase_;    // Fractional part of the analysis position
+    int dropRemaining_;       // Output of the first frames (before the start point)
+    int readyStart_;
+    int readyCount_;
+
+    std::atomic<double> timeStretch_;
+    std::atomic<float> pitchShift_;
+    std::atomic<bool> formants_;
+    std::atomic<bool> transients_;
+
+    std::shared_ptr<const FFTPlan> plan_;
+    std::vector<float> analysisWindow_;
+    std::vector<float> synthesisWindow_;   // Includes the overlap-add normalization
+    std::vector<PhaseLockedVocoder> vocoders_;
+
+    std::vector<std::vector<float>> input_;         // Per channel: current window
+    std::vector<std::vector<float>> accumulator_;   // Per channel: overlap-add
+    std::vector<std::vector<float>> ready_;         // Per channel: finished output
+
+    // Scratch
+    std::vector<float> frame_;
+    std::vector<std::complex<float>> bins_;
+    std::vector<float> work_;
+};
+
+// A clip rendered offline at high quality, shared by every voice playing it
+class StretchedClip {
+public:
+    StretchedClip(std::shared_ptr<const AudioBuffer> source, const StretchSettings& settings, int sampleRate);
+
+    const StretchSettings& getSettings() const { return settings_; }
+    int getSampleRate() const { return sampleRate_; }
+
+    // Wait-free. Once true, getAudio() is complete and never changes.
+    bool isReady() const { return ready_.load(std::memory_order_acquire); }
+    const AudioBuffer& getAudio() const { return audio_; }
+
+private:
+    friend class ClipStretchCache;
+
+    std::shared_ptr<const AudioBuffer> source_;
+    StretchSettings settings_;
+    int sampleRate_;
+    AudioBuffer audio_;
+    std::atomic<bool> ready_;
+};
+
+// Offline-quality renders of stretched clips, made on a background thread
+//
+// acquire() returns at once; the render follows and the entry reports
+// ready when it's done. Entries nobody holds any more are dropped, oldest
+// first, once the cache is over its memory limit.
+class ClipStretchCache {
+public:
+    ClipStretchCache();
+    ~ClipStretchCache();
+
+    ClipStretchCache(const ClipStretchCache&) = delete;
+    ClipStretchCache& operator=(const ClipStretchCache&) = delete;
+
+    // Not on the audio thread (locks, may allocate)
+    std::shared_ptr<const StretchedClip> acquire(std::shared_ptr<const AudioBuffer> source,
+                                                 const StretchSettings& settings, int sampleRate);
+
+    // Block until every render requested so far is done
+    void flush();
+
+    void setMemoryLimit(size_t bytes);
+    size_t getMemoryUsage() const;
+    size_t getNumEntries() const;
+
+private:
+    void renderPending();
+    void evict();   // Caller holds mutex_
+
+    mutable std::mutex mutex_;
+    std::vector<std::shared_ptr<StretchedClip>> entries_;   // Least recently acquired first
+    std::vector<std::shared_ptr<StretchedClip>> pending_;
+    size_t memoryLimit_;
+    size_t memoryUsage_;
+
+    GraphCompiler renderer_;
+};
+
+// Plays one audio clip with its stretch, pitch and formant settings
+//
+// Starts on a realtime TimeStretcher reading the clip's audio. Given a
+// cache, it also asks for an offline render and crossfades over to it
+// within a block of it becoming ready. Stereo: a mono clip plays on both
+// sides, output channels past the second are silent.
+class ClipVoice {
+public:
+    ClipVoice();
+    ~ClipVoice();
+
+    // Allocates
+    void prepare(int sampleRate, int maxBufferSize);
+
+    // Off the audio thread (allocates, and locks the cache); starts at the
+    // clip's start. Settings changed on the clip later need another call.
+    // Not while render() may be running: stop the voice's audio first.
+    void setClip(const AudioClip& clip, ClipStretchCache* cache = nullptr);
+    void clearClip();
+
+    // Seconds from the clip's start; real-time safe
+    void seek(double clipTime);
+
+    // Replaces output with the next numFrames of the clip (silence past the
+    // end of its audio); real-time safe
+    void render(float* const* output, int numChannels, int numFrames);
+
+    bool isPlayingOfflineRender() const { return usingOffline_; }
+
+private:
+    void renderRealtime(float* const* output, int numFrames);
+    void copyAudio(const AudioBuffer& audio, float* const* output, int numFrames) const;
+    void feedSource(int numFrames);
+
+    int sampleRate_;
+    int maxBufferSize_;
+
+    std::shared_ptr<const AudioBuffer> source_;
+    std::shared_ptr<const StretchedClip> offline_;
+    StretchSettings settings_;
+    double offsetSeconds_;
+
+    TimeStretcher stretcher_;
+    long long sourcePosition_;   // Next source frame for the stretcher (may be before 0)
+    long long outputPosition_;   // Stretched frames from the source's start
+    bool usingOffline_;
+
+    std::vector<std::vector<float>> scratch_;
+};
+
+} // namespace OmegaDAW
+
+#endif // OMEGA_DAW_TIME_STRETCH_H
@@ -44,6 +44,11 @@ class Transport {
     
     void advance(int numSamples);
     
+    // Freewheel: advance() moves the playhead without play() being called,
+    // so offline renders don't fire the play/stop callbacks
+    void setFreewheel(bool enabled) { freewheel_ = enabled; }
+    bool isFreewheeling() const { return freewheel_; }
+    
     using TransportCallback = std::function<void()>;
     void setPlayCallback(TransportCallback callback) { playCallback_ = callback; }
     void setStopCallback(TransportCallback callback) { stopCallback_ = callback; }
@@ -55,6 +60,7 @@ class Transport {
     bool recording_;
     bool paused_;
     bool looping_;
+    bool freewheel_;
     
     double tempo_;
     int timeSignatureNumerator_;
@@ -1,4 +1,7 @@
 #include "AdvancedEffects.h"
+#include "FileIO.h"
+#include "SIMDKernels.h"
+#include <cstring>
 #include <iostream>
 #include <cmath>
 #include <algorithm>
@@ -191,18 +194,25 @@ ParametricEQ::ParametricEQ()
     bands_[3].enabled = true;
 }
 
+double ParametricEQ::getTailLengthSeconds() const {
+    // Bands run in series, so their tails add up
+    double tailSamples = 0.0;
+    for (const auto& band : bands_) {
+        if (band.enabled) {
+            tailSamples += biquadTailSamples(band.a1, band.a2);
+        }
+    }
+    return sampleRate_ > 0 ? tailSamples / sampleRate_ : 0.0;
+}
+
 void ParametricEQ::prepare(int sampleRate, int maxBufferSize) {
     sampleRate_ = sampleRate;
     numChannels_ = 2;
     
-    // Initialize filter state for each band
     for (auto& band : bands_) {
-        band.x1.resize(numChannels_, 0.0f);
-        band.x2.resize(numChannels_, 0.0f);
-        band.y1.resize(numChannels_, 0.0f);
-        band.y2.resize(numChannels_, 0.0f);
         calculateCoefficients(band);
     }
+    cascade_.prepare(numChannels_, static_cast<int>(bands_.size()), maxBufferSize);
 }
 
 void ParametricEQ::setBand(int index, FilterType type, float freq, float Q, float gainDB) {
@@ -291,35 +301,24 @@ void ParametricEQ::calculateCoefficients(EQBand& band) {
     }
 }
 
-float ParametricEQ::processSample(float input, EQBand& band, int channel) {
-    float output = band.b0 * input + band.b1 * band.x1[channel] + band.b2 * band.x2[channel]
-                   - band.a1 * band.y1[channel] - band.a2 * band.y2[channel];
-    
-    band.x2[channel] = band.x1[channel];
-    band.x1[channel] = input;
-    band.y2[channel] = band.y1[channel];
-    band.y1[channel] = output;
-    
-    return output;
-}
-
 void ParametricEQ::process(float** inputs, float** outputs, int numChannels, int numFrames) {
     if (isBypassed()) return;
     
-    for (int ch = 0; ch < numChannels; ++ch) {
-        for (int i = 0; i < numFrames; ++i) {
-            float sample = outputs[ch][i];
-            
-            // Process through each enabled band
-            for (auto& band : bands_) {
-                if (band.enabled) {
-                    sample = processSample(sample, band, ch);
-                }
-            }
-            
-            outputs[ch][i] = sample;
+    // Unchanged bands are ignored by setSection(); changed ones glide
+    for (size_t i = 0; i < bands_.size(); ++i) {
+        const EQBand& band = bands_[i];
+        BiquadCoefficients section;
+        if (band.enabled) {
+            section.b0 = band.b0;
+            section.b1 = band.b1;
+            section.b2 = band.b2;
+            section.a1 = band.a1;
+            section.a2 = band.a2;
         }
+        cascade_.setSection(static_cast<int>(i), section);
     }
+    
+    cascade_.process(outputs, numChannels, numFrames);
 }
 
 // ===== Tube Saturation =====
@@ -386,16 +385,63 @@ void TubeSaturation::process(float** inputs, float** outputs, int numChannels, i
 
 // ===== Convolution Reverb =====
 
+namespace {
+
+// State is sized for responses this long (or the loaded one, if longer)
+constexpr int kMaxImpulseSeconds = 10;
+
+} // anonymous namespace
+
 ConvolutionReverb::ConvolutionReverb()
-    : historyPosition_(0)
-    , dryWet_(0.3f)
+    : dryWet_(0.3f)
+    , sampleRate_(48000)
+    , maxBufferSize_(0)
+    , hasResponse_(false)
+    , tailFrames_(0)
     , preDelayFrames_(0)
-    , preDelayPosition_(0)
-    , sampleRate_(48000) {
+    , loader_([this]() { buildImpulseResponse(); }) {
+}
+
+ConvolutionReverb::~ConvolutionReverb() {
+    loader_.stop();
+}
+
+double ConvolutionReverb::getTailLengthSeconds() const {
+    if (sampleRate_ <= 0) {
+        return 0.0;
+    }
+    return static_cast<double>(tailFrames_.load()) / sampleRate_;
 }
 
 void ConvolutionReverb::prepare(int sampleRate, int maxBufferSize) {
-    sampleRate_ = sampleRate;
+    maxBufferSize_ = maxBufferSize;
+
+    ConvolverLayout layout;
+    bool rebuild = false;
+    {
+        std::lock_guard<std::mutex> lock(sourceMutex_);
+        sampleRate_ = sampleRate;
+        int length = preDelayFrames_;
+        for (const auto& channel : source_) {
+            length = std::max(length, preDelayFrames_ + static_cast<int>(channel.size()));
+        }
+        layout_.maxLength = std::max(kMaxImpulseSeconds * sampleRate, length);
+        layout = layout_;
+        rebuild = !source_.empty() || !pendingFile_.empty();
+    }
+    convolver_.prepare(2, layout);
+
+    wet_.assign(2, std::vector<float>(std::max(0, maxBufferSize), 0.0f));
+    wetPointers_.resize(2);
+    inputPointers_.resize(2);
+    for (int ch = 0; ch < 2; ++ch) {
+        wetPointers_[ch] = wet_[ch].data();
+    }
+
+    // Responses are partitioned for one layout; rebuild for this one
+    if (rebuild) {
+        loader_.request();
+    }
 }
 
 void ConvolutionReverb::setDryWetMix(float mix) {
@@ -403,68 +449,200 @@ void ConvolutionReverb::setDryWetMix(float mix) {
 }
 
 void ConvolutionReverb::setPreDelay(float delayMs) {
-    preDelayFrames_ = static_cast<int>(delayMs * sampleRate_ / 1000.0f);
-    preDelayBuffer_.resize(preDelayFrames_, 0.0f);
-    preDelayPosition_ = 0;
+    {
+        std::lock_guard<std::mutex> lock(sourceMutex_);
+        preDelayFrames_ = std::max(0, static_cast<int>(delayMs * sampleRate_ / 1000.0f));
+    }
+    updateTailLength();
+    loader_.request();
+}
+
+void ConvolutionReverb::setLowLatency(bool enabled) {
+    std::lock_guard<std::mutex> lock(sourceMutex_);
+    layout_.lowLatency = enabled;
+}
+
+void ConvolutionReverb::setNonUniformPartitions(bool enabled) {
+    std::lock_guard<std::mutex> lock(sourceMutex_);
+    layout_.nonUniform = enabled;
 }
 
 bool ConvolutionReverb::loadImpulseResponse(const std::string& filename) {
-    // TODO: Implement WAV file loading
-    // For now, create a simple synthetic impulse response
-    impulseResponse_.resize(sampleRate_ / 2); // 0.5 second reverb
-    
-    // Simple exponential decay with noise
-    for (size_t i = 0; i < impulseResponse_.size(); ++i) {
-        float decay = exp(-5.0f * i / impulseResponse_.size());
-        float noise = (rand() / (float)RAND_MAX) * 2.0f - 1.0f;
-        impulseResponse_[i] = noise * decay * 0.3f;
+    // Check the file here so callers hear about a bad one; the samples are
+    // read on the loader thread
+    AudioFileReader reader;
+    FileIOResult result = reader.open(filename);
+    if (!result.success) {
+        std::cerr << "Failed to open impulse response " << filename << ": " << result.errorMessage << std::endl;
+        return false;
     }
-    
-    inputHistory_.resize(impulseResponse_.size(), 0.0f);
-    historyPosition_ = 0;
-    
-    std::cout << "Loaded impulse response: " << impulseResponse_.size() << " samples" << std::endl;
+    int numChannels = reader.getNumChannels();
+    if (numChannels != 1 && numChannels != 2 && numChannels != 4) {
+        std::cerr << "Impulse response " << filename << " has " << numChannels
+                  << " channels; expected 1, 2 or 4" << std::endl;
+        return false;
+    }
+    reader.close();
+
+    {
+        std::lock_guard<std::mutex> lock(sourceMutex_);
+        pendingFile_ = filename;
+    }
+    loader_.request();
     return true;
 }
 
+void ConvolutionReverb::setImpulseResponse(const float* ir, int irLength, int numChannels) {
+    std::vector<std::vector<float>> channels;
+    if (ir && irLength > 0 && numChannels > 0) {
+        channels.assign(numChannels, std::vector<float>(irLength));
+        for (int i = 0; i < irLength; ++i) {
+            for (int ch = 0; ch < numChannels; ++ch) {
+                channels[ch][i] = ir[i * numChannels + ch];
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sourceMutex_);
+        pendingFile_.clear();
+        source_.swap(channels);
+    }
+    updateTailLength();
+    loader_.request();
+}
+
+void ConvolutionReverb::flushImpulseResponse() {
+    loader_.flush();
+}
+
+void ConvolutionReverb::updateTailLength() {
+    std::lock_guard<std::mutex> lock(sourceMutex_);
+    int length = 0;
+    for (const auto& channel : source_) {
+        length = std::max(length, static_cast<int>(channel.size()));
+    }
+    tailFrames_.store(length > 0 ? length + preDelayFrames_ : 0);
+}
+
+void ConvolutionReverb::buildImpulseResponse() {
+    std::string filename;
+    {
+        std::lock_guard<std::mutex> lock(sourceMutex_);
+        filename.swap(pendingFile_);
+    }
+
+    if (!filename.empty()) {
+        AudioFileReader reader;
+        std::vector<std::vector<float>> channels;
+        FileIOResult result = reader.open(filename);
+        if (result.success) {
+            result = reader.readAllSamples(channels);
+        }
+        if (!result.success) {
+            std::cerr << "Failed to read impulse response " << filename << ": " << result.errorMessage << std::endl;
+            return;
+        }
+        std::cout << "Loaded impulse response: " << reader.getTotalSamples() << " samples" << std::endl;
+
+        std::lock_guard<std::mutex> lock(sourceMutex_);
+        if (reader.getSampleRate() != sampleRate_) {
+            std::cerr << "Impulse response " << filename << " is " << reader.getSampleRate()
+                      << " Hz; playing it at " << sampleRate_ << " Hz" << std::endl;
+        }
+        source_.swap(channels);
+    }
+    updateTailLength();
+
+    std::vector<std::vector<float>> channels;
+    ConvolverLayout layout;
+    {
+        std::lock_guard<std::mutex> lock(sourceMutex_);
+        channels = source_;
+        layout = layout_;
+        for (auto& channel : channels) {
+            channel.insert(channel.begin(), preDelayFrames_, 0.0f);
+        }
+    }
+
+    // Not prepared yet: prepare() asks again
+    if (layout.maxLength == 0) {
+        return;
+    }
+
+    std::shared_ptr<const ConvolverIR> ir;
+    if (!channels.empty()) {
+        ir = ConvolverIR::create(channels, layout);
+    }
+    convolver_.setImpulseResponse(ir);
+    if (ir) {
+        hasResponse_.store(true);
+    }
+}
+
 void ConvolutionReverb::process(float** inputs, float** outputs, int numChannels, int numFrames) {
-    if (isBypassed() || impulseResponse_.empty()) return;
-    
-    for (int ch = 0; ch < numChannels; ++ch) {
-        for (int i = 0; i < numFrames; ++i) {
-            float dry = outputs[ch][i];
-            
-            // Store in history
-            inputHistory_[historyPosition_] = dry;
-            
-            // Convolution (simplified - real implementation would use FFT)
-            float wet = 0.0f;
-            for (size_t j = 0; j < impulseResponse_.size(); ++j) {
-                int historyIdx = (historyPosition_ - j + inputHistory_.size()) % inputHistory_.size();
-                wet += inputHistory_[historyIdx] * impulseResponse_[j];
+    if (isBypassed() || !hasResponse_.load() || wet_.empty() || maxBufferSize_ <= 0 || numChannels <= 0) return;
+
+    // Stereo convolver; a mono input feeds both sides, channels past the
+    // first two pass through
+    const int convolved = std::min(numChannels, 2);
+    for (int done = 0; done < numFrames; done += maxBufferSize_) {
+        int frames = std::min(maxBufferSize_, numFrames - done);
+        for (int ch = 0; ch < 2; ++ch) {
+            int source = std::min(ch, numChannels - 1);
+            const float* input = (inputs && inputs[source]) ? inputs[source] : outputs[source];
+            inputPointers_[ch] = input + done;
+        }
+        convolver_.process(inputPointers_.data(), wetPointers_.data(), frames);
+
+        for (int ch = 0; ch < convolved; ++ch) {
+            const float* dry = inputPointers_[ch];
+            float* output = outputs[ch] + done;
+            if (dry != output) {
+                std::memcpy(output, dry, frames * sizeof(float));
             }
-            
-            historyPosition_ = (historyPosition_ + 1) % inputHistory_.size();
-            
-            // Mix dry and wet
-            outputs[ch][i] = dry * (1.0f - dryWet_) + wet * dryWet_;
+            SIMD::applyGain(output, frames, 1.0f - dryWet_);
+            SIMD::addWithGain(output, wet_[ch].data(), frames, dryWet_);
+        }
+    }
+    for (int ch = convolved; ch < numChannels; ++ch) {
+        if (inputs && inputs[ch] && inputs[ch] != outputs[ch]) {
+            std::memcpy(outputs[ch], inputs[ch], numFrames * sizeof(float));
         }
     }
 }
 
 // ===== Spectral Gate =====
 
+namespace {
+
+constexpr int kSpectralGateFFTSize = 2048;
+constexpr int kSpectralGateOverlap = 4;
+
+} // anonymous namespace
+
 SpectralGate::SpectralGate()
     : threshold_(-40.0f)
     , reduction_(-60.0f)
-    , attackCoeff_(0.99f)
-    , releaseCoeff_(0.999f)
+    , attackMs_(2.0f)
+    , releaseMs_(20.0f)
+    , attackCoeff_(0.0f)
+    , releaseCoeff_(0.0f)
     , sampleRate_(48000) {
 }
 
 void SpectralGate::prepare(int sampleRate, int maxBufferSize) {
     sampleRate_ = sampleRate;
-    envelopes_.resize(2, 0.0f); // Stereo
+    stft_.prepare(2, kSpectralGateFFTSize, kSpectralGateOverlap); // Stereo
+    stft_.setCallback([this](int channel, std::complex<float>* bins, int numBins) {
+        gateSpectrum(channel, bins, numBins);
+    });
+    envelopes_.assign(2, std::vector<float>(stft_.getNumBins(), 0.0f));
+    updateCoefficients();
+}
+
+double SpectralGate::getTailLengthSeconds() const {
+    return sampleRate_ > 0 ? static_cast<double>(stft_.getLatency()) / sampleRate_ : 0.0;
 }
 
 void SpectralGate::setThreshold(float thresholdDB) {
@@ -476,36 +654,50 @@ void SpectralGate::setReduction(float reductionDB) {
 }
 
 void SpectralGate::setAttack(float attackMs) {
-    attackCoeff_ = exp(-1.0f / (attackMs * sampleRate_ * 0.001f));
+    attackMs_ = std::max(0.01f, attackMs);
+    updateCoefficients();
 }
 
 void SpectralGate::setRelease(float releaseMs) {
-    releaseCoeff_ = exp(-1.0f / (releaseMs * sampleRate_ * 0.001f));
+    releaseMs_ = std::max(0.01f, releaseMs);
+    updateCoefficients();
 }
 
-void SpectralGate::process(float** inputs, float** outputs, int numChannels, int numFrames) {
-    if (isBypassed()) return;
-    
-    float thresholdLin = pow(10.0f, threshold_ / 20.0f);
-    float reductionLin = pow(10.0f, reduction_ / 20.0f);
+void SpectralGate::updateCoefficients() {
+    // The envelopes move once per hop
+    float hop = static_cast<float>(kSpectralGateFFTSize / kSpectralGateOverlap);
+    attackCoeff_ = exp(-hop / (attackMs_ * sampleRate_ * 0.001f));
+    releaseCoeff_ = exp(-hop / (releaseMs_ * sampleRate_ * 0.001f));
+}
+
+void SpectralGate::gateSpectrum(int channel, std::complex<float>* bins, int numBins) {
+    const float scale = stft_.getAmplitudeScale();
+    const float thresholdLin = pow(10.0f, threshold_ / 20.0f);
+    const float reductionLin = pow(10.0f, reduction_ / 20.0f);
+    float* envelopes = envelopes_[channel].data();
     
-    for (int ch = 0; ch < numChannels && ch < static_cast<int>(envelopes_.size()); ++ch) {
-        for (int i = 0; i < numFrames; ++i) {
-            float input = std::abs(outputs[ch][i]);
-            
-            // Envelope follower
-            float coeff = (input > envelopes_[ch]) ? attackCoeff_ : releaseCoeff_;
-            envelopes_[ch] = input + coeff * (envelopes_[ch] - input);
-            
-            // Apply gate
-            float gain = 1.0f;
-            if (envelopes_[ch] < thresholdLin) {
-                gain = reductionLin;
-            }
-            
-            outputs[ch][i] *= gain;
+    for (int i = 0; i < numBins; ++i) {
+        float magnitude = std::sqrt(std::norm(bins[i])) * scale;
+        
+        // Envelope follower, one per bin
+        float coeff = (magnitude > envelopes[i]) ? attackCoeff_ : releaseCoeff_;
+        envelopes[i] = magnitude + coeff * (envelopes[i] - magnitude);
+        
+        if (envelopes[i] < thresholdLin) {
+            bins[i] *= reductionLin;
         }
     }
 }
 
+void SpectralGate::process(float** inputs, float** outputs, int numChannels, int numFrames) {
+    if (isBypassed() || envelopes_.empty()) return;
+    
+    const float* in[2];
+    int channels = std::min(numChannels, 2);
+    for (int ch = 0; ch < channels; ++ch) {
+        in[ch] = (inputs && inputs[ch]) ? inputs[ch] : outputs[ch];
+    }
+    stft_.process(in, outputs, channels, numFrames);
+}
+
 } // namespace OmegaDAW
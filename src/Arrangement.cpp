@@ -98,7 +98,10 @@ void Arrangement::splitClip(size_t trackIndex, size_t clipIndex, double splitTim
         auto newAudioClip = std::make_shared<AudioClip>(secondStart, secondDuration);
         newAudioClip->setAudioData(audioClip->getAudioData());
         newAudioClip->setSourceFile(audioClip->getSourceFile());
-        newAudioClip->setOffset(audioClip->getOffset() + firstDuration);
+        newAudioClip->setOffset(audioClip->getOffset() + firstDuration / audioClip->getTimeStretch());
+        newAudioClip->setPitch(audioClip->getPitch());
+        newAudioClip->setTimeStretch(audioClip->getTimeStretch());
+        newAudioClip->setFormantPreservation(audioClip->isFormantPreservationEnabled());
         newClip = newAudioClip;
     } else if (originalClip->getType() == ClipType::MIDI) {
         auto midiClip = std::static_pointer_cast<MIDIClip>(originalClip);
@@ -137,6 +140,8 @@ std::shared_ptr<Clip> Arrangement::duplicateClip(size_t trackIndex, size_t clipI
         newAudioClip->setSourceFile(audioClip->getSourceFile());
         newAudioClip->setOffset(audioClip->getOffset());
         newAudioClip->setPitch(audioClip->getPitch());
+        newAudioClip->setTimeStretch(audioClip->getTimeStretch());
+        newAudioClip->setFormantPreservation(audioClip->isFormantPreservationEnabled());
         newClip = newAudioClip;
     } else if (originalClip->getType() == ClipType::MIDI) {
         auto midiClip = std::static_pointer_cast<MIDIClip>(originalClip);
@@ -261,10 +266,10 @@ void Arrangement::shutdown() {
     clear();
 }
 
-AudioBuffer Arrangement::renderAtPosition(double position) {
-    // Create empty buffer for now
-    AudioBuffer buffer;
-    return buffer;
+AudioBufferView Arrangement::renderAtPosition(double position, int numSamples, ScratchArena& arena) {
+    // Silent stereo block for now: there is no clip renderer yet (audio
+    // clips are meant to play through a ClipVoice each)
+    return arena.allocateBuffer(2, numSamples);
 }
 
 void Arrangement::loadFromProject(Project* project) {
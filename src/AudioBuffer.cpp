@@ -1,106 +1,388 @@
 #include "AudioBuffer.h"
+#include "SIMDKernels.h"
 #include <algorithm>
+#include <new>
 #include <stdexcept>
 
 namespace OmegaDAW {
 
+namespace {
+
+// Round a channel length up to whole cache lines
+int paddedStride(int numSamples) {
+    const int floatsPerLine = static_cast<int>(AudioBuffer::kAlignment / sizeof(float));
+    return (std::max(0, numSamples) + floatsPerLine - 1) / floatsPerLine * floatsPerLine;
+}
+
+} // anonymous namespace
+
+// AudioBufferView implementation
+
+AudioBufferView::AudioBufferView()
+    : channels_()
+    , numChannels_(0)
+    , numSamples_(0) {
+}
+
+AudioBufferView::AudioBufferView(float* const* channels, int numChannels, int numSamples)
+    : channels_()
+    , numChannels_(std::max(0, std::min(numChannels, kMaxChannels)))
+    , numSamples_(std::max(0, numSamples)) {
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        channels_[ch] = channels[ch];
+    }
+}
+
+AudioBufferView AudioBufferView::getSubView(int startSample, int numSamples) const {
+    int start = std::max(0, std::min(startSample, numSamples_));
+    int length = std::max(0, std::min(numSamples, numSamples_ - start));
+
+    AudioBufferView view;
+    view.numChannels_ = numChannels_;
+    view.numSamples_ = length;
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        view.channels_[ch] = channels_[ch] + start;
+    }
+    return view;
+}
+
+void AudioBufferView::clear() {
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        std::memset(channels_[ch], 0, numSamples_ * sizeof(float));
+    }
+}
+
+void AudioBufferView::applyGain(float gain) {
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        SIMD::applyGain(channels_[ch], numSamples_, gain);
+    }
+}
+
+void AudioBufferView::applyGainRamp(float startGain, float endGain) {
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        SIMD::applyGainRamp(channels_[ch], numSamples_, startGain, endGain);
+    }
+}
+
+void AudioBufferView::copyFrom(const AudioBufferView& other) {
+    int channelsToCopy = std::min(numChannels_, other.numChannels_);
+    int samplesToCopy = std::min(numSamples_, other.numSamples_);
+
+    for (int ch = 0; ch < channelsToCopy; ++ch) {
+        std::memmove(channels_[ch], other.channels_[ch], samplesToCopy * sizeof(float));
+    }
+}
+
+void AudioBufferView::addFrom(const AudioBufferView& other, float gain) {
+    int channelsToCopy = std::min(numChannels_, other.numChannels_);
+    int samplesToCopy = std::min(numSamples_, other.numSamples_);
+
+    for (int ch = 0; ch < channelsToCopy; ++ch) {
+        if (gain == 1.0f) {
+            SIMD::add(channels_[ch], other.channels_[ch], samplesToCopy);
+        } else {
+            SIMD::addWithGain(channels_[ch], other.channels_[ch], samplesToCopy, gain);
+        }
+    }
+}
+
+void AudioBufferView::addFromWithRamp(const AudioBufferView& other, float startGain, float endGain) {
+    int channelsToCopy = std::min(numChannels_, other.numChannels_);
+    int samplesToCopy = std::min(numSamples_, other.numSamples_);
+
+    for (int ch = 0; ch < channelsToCopy; ++ch) {
+        SIMD::addWithGainRamp(channels_[ch], other.channels_[ch], samplesToCopy, startGain, endGain);
+    }
+}
+
+// AudioBuffer implementation
+
 AudioBuffer::AudioBuffer(int numChannels, int numSamples)
-    : numChannels_(numChannels)
-    , numSamples_(numSamples) {
-    channelData_.resize(numChannels_);
-    for (auto& channel : channelData_) {
-        channel.resize(numSamples_, 0.0f);
+    : numChannels_(0)
+    , numSamples_(0)
+    , channelStride_(0)
+    , capacity_(0)
+    , data_(nullptr)
+    , silent_(true) {
+    setSize(numChannels, numSamples);
+}
+
+AudioBuffer::~AudioBuffer() {
+    release();
+}
+
+AudioBuffer::AudioBuffer(const AudioBuffer& other)
+    : numChannels_(0)
+    , numSamples_(0)
+    , channelStride_(0)
+    , capacity_(0)
+    , data_(nullptr)
+    , silent_(true) {
+    *this = other;
+}
+
+AudioBuffer::AudioBuffer(AudioBuffer&& other) noexcept
+    : numChannels_(other.numChannels_)
+    , numSamples_(other.numSamples_)
+    , channelStride_(other.channelStride_)
+    , capacity_(other.capacity_)
+    , data_(other.data_)
+    , channelPointers_(std::move(other.channelPointers_))
+    , silent_(other.silent_) {
+    other.numChannels_ = 0;
+    other.numSamples_ = 0;
+    other.channelStride_ = 0;
+    other.capacity_ = 0;
+    other.data_ = nullptr;
+    other.channelPointers_.clear();
+}
+
+AudioBuffer& AudioBuffer::operator=(const AudioBuffer& other) {
+    if (this == &other) {
+        return *this;
+    }
+
+    // Reuse the allocation when it is big enough
+    size_t needed = static_cast<size_t>(other.numChannels_) * other.channelStride_;
+    if (needed > capacity_) {
+        release();
+        allocate(other.numChannels_, other.channelStride_);
     }
+
+    numChannels_ = other.numChannels_;
+    numSamples_ = other.numSamples_;
+    channelStride_ = other.channelStride_;
+    if (needed > 0) {
+        std::memcpy(data_, other.data_, needed * sizeof(float));
+    }
+    silent_ = other.silent_;
+    updateChannelPointers();
+    return *this;
 }
 
-void AudioBuffer::resize(int numSamples) {
-    numSamples_ = numSamples;
-    for (auto& channel : channelData_) {
-        channel.resize(numSamples_, 0.0f);
+AudioBuffer& AudioBuffer::operator=(AudioBuffer&& other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+
+    release();
+    numChannels_ = other.numChannels_;
+    numSamples_ = other.numSamples_;
+    channelStride_ = other.channelStride_;
+    capacity_ = other.capacity_;
+    data_ = other.data_;
+    channelPointers_ = std::move(other.channelPointers_);
+    silent_ = other.silent_;
+
+    other.numChannels_ = 0;
+    other.numSamples_ = 0;
+    other.channelStride_ = 0;
+    other.capacity_ = 0;
+    other.data_ = nullptr;
+    other.channelPointers_.clear();
+    return *this;
+}
+
+void AudioBuffer::allocate(int numChannels, int channelStride) {
+    capacity_ = static_cast<size_t>(std::max(0, numChannels)) * std::max(0, channelStride);
+    data_ = nullptr;
+    if (capacity_ > 0) {
+        data_ = static_cast<float*>(::operator new(capacity_ * sizeof(float), std::align_val_t(kAlignment)));
+        std::memset(data_, 0, capacity_ * sizeof(float));
     }
 }
 
+void AudioBuffer::release() {
+    if (data_) {
+        ::operator delete(data_, std::align_val_t(kAlignment));
+    }
+    data_ = nullptr;
+    capacity_ = 0;
+}
+
+void AudioBuffer::updateChannelPointers() {
+    channelPointers_.resize(numChannels_);
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        channelPointers_[ch] = data_ + static_cast<size_t>(ch) * channelStride_;
+    }
+}
+
+void AudioBuffer::resize(int numSamples) {
+    setSize(numChannels_, numSamples);
+}
+
 void AudioBuffer::setSize(int numChannels, int numSamples) {
+    numChannels = std::max(0, numChannels);
+    numSamples = std::max(0, numSamples);
+    int stride = paddedStride(numSamples);
+
+    if (stride <= channelStride_ && static_cast<size_t>(numChannels) * channelStride_ <= capacity_) {
+        // Fits the current layout: zero whatever becomes newly visible
+        for (int ch = 0; ch < numChannels; ++ch) {
+            float* channel = data_ + static_cast<size_t>(ch) * channelStride_;
+            int keep = ch < numChannels_ ? std::min(numSamples_, numSamples) : 0;
+            std::fill(channel + keep, channel + numSamples, 0.0f);
+        }
+    } else {
+        // Reallocate, keeping the overlapping samples
+        float* oldData = data_;
+        int oldStride = channelStride_;
+        int channelsToKeep = oldData ? std::min(numChannels_, numChannels) : 0;
+        int samplesToKeep = std::min(numSamples_, numSamples);
+
+        allocate(numChannels, stride);
+        for (int ch = 0; ch < channelsToKeep; ++ch) {
+            std::memcpy(data_ + static_cast<size_t>(ch) * stride,
+                        oldData + static_cast<size_t>(ch) * oldStride,
+                        samplesToKeep * sizeof(float));
+        }
+        if (oldData) {
+            ::operator delete(oldData, std::align_val_t(kAlignment));
+        }
+        channelStride_ = stride;
+    }
+
     numChannels_ = numChannels;
     numSamples_ = numSamples;
-    channelData_.resize(numChannels_);
-    for (auto& channel : channelData_) {
-        channel.resize(numSamples_, 0.0f);
-    }
+    updateChannelPointers();
 }
 
 void AudioBuffer::clear() {
-    for (auto& channel : channelData_) {
-        std::fill(channel.begin(), channel.end(), 0.0f);
+    if (data_) {
+        std::memset(data_, 0, static_cast<size_t>(numChannels_) * channelStride_ * sizeof(float));
     }
+    silent_ = true;
+}
+
+bool AudioBuffer::detectSilence() {
+    if (silent_) {
+        return true;
+    }
+
+    // Only exact zeros count: a quiet signal is still signal, and flagging
+    // it would let the skip paths drop it
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        if (SIMD::peakAbs(channelPointers_[ch], numSamples_) != 0.0f) {
+            return false;
+        }
+    }
+
+    silent_ = true;
+    return true;
 }
 
 float* AudioBuffer::getChannelData(int channel) {
     if (channel < 0 || channel >= numChannels_) {
         return nullptr;
     }
-    return channelData_[channel].data();
+    silent_ = false;
+    return channelPointers_[channel];
 }
 
 const float* AudioBuffer::getChannelData(int channel) const {
     if (channel < 0 || channel >= numChannels_) {
         return nullptr;
     }
-    return channelData_[channel].data();
+    return channelPointers_[channel];
+}
+
+AudioBufferView AudioBuffer::getView() {
+    silent_ = false;
+    return AudioBufferView(channelPointers_.data(), numChannels_, numSamples_);
+}
+
+AudioBufferView AudioBuffer::getSubView(int startSample, int numSamples) {
+    return getView().getSubView(startSample, numSamples);
 }
 
 void AudioBuffer::setSample(int channel, int sample, float value) {
     if (channel >= 0 && channel < numChannels_ && sample >= 0 && sample < numSamples_) {
-        channelData_[channel][sample] = value;
+        channelPointers_[channel][sample] = value;
+        if (value != 0.0f) {
+            silent_ = false;
+        }
     }
 }
 
 float AudioBuffer::getSample(int channel, int sample) const {
     if (channel >= 0 && channel < numChannels_ && sample >= 0 && sample < numSamples_) {
-        return channelData_[channel][sample];
+        return channelPointers_[channel][sample];
     }
     return 0.0f;
 }
 
 void AudioBuffer::copyFrom(const AudioBuffer& other) {
+    if (this == &other) {
+        return;
+    }
+
     int channelsToCopy = std::min(numChannels_, other.numChannels_);
     int samplesToCopy = std::min(numSamples_, other.numSamples_);
-    
+
     for (int ch = 0; ch < channelsToCopy; ++ch) {
-        std::copy_n(other.channelData_[ch].begin(), samplesToCopy, channelData_[ch].begin());
+        std::memcpy(channelPointers_[ch], other.channelPointers_[ch], samplesToCopy * sizeof(float));
     }
+
+    // Silent only if zeros replaced everything, or were copied into silence
+    bool coversAll = channelsToCopy == numChannels_ && samplesToCopy == numSamples_;
+    silent_ = other.silent_ && (silent_ || coversAll);
 }
 
 void AudioBuffer::addFrom(const AudioBuffer& other, float gain) {
+    if (other.silent_ || gain == 0.0f) {
+        return;
+    }
+    silent_ = false;
+
     int channelsToCopy = std::min(numChannels_, other.numChannels_);
     int samplesToCopy = std::min(numSamples_, other.numSamples_);
-    
+
     for (int ch = 0; ch < channelsToCopy; ++ch) {
-        for (int i = 0; i < samplesToCopy; ++i) {
-            channelData_[ch][i] += other.channelData_[ch][i] * gain;
+        if (gain == 1.0f) {
+            SIMD::add(channelPointers_[ch], other.channelPointers_[ch], samplesToCopy);
+        } else {
+            SIMD::addWithGain(channelPointers_[ch], other.channelPointers_[ch], samplesToCopy, gain);
         }
     }
 }
 
+void AudioBuffer::addFromWithRamp(const AudioBuffer& other, float startGain, float endGain) {
+    if (other.silent_ || (startGain == 0.0f && endGain == 0.0f)) {
+        return;
+    }
+    silent_ = false;
+
+    int channelsToCopy = std::min(numChannels_, other.numChannels_);
+    int samplesToCopy = std::min(numSamples_, other.numSamples_);
+
+    for (int ch = 0; ch < channelsToCopy; ++ch) {
+        SIMD::addWithGainRamp(channelPointers_[ch], other.channelPointers_[ch], samplesToCopy, startGain, endGain);
+    }
+}
+
+void AudioBuffer::addProductFrom(const AudioBuffer& a, const AudioBuffer& b) {
+    if (a.silent_ || b.silent_) {
+        return;
+    }
+    silent_ = false;
+
+    int channels = std::min(numChannels_, std::min(a.numChannels_, b.numChannels_));
+    int samples = std::min(numSamples_, std::min(a.numSamples_, b.numSamples_));
+
+    for (int ch = 0; ch < channels; ++ch) {
+        SIMD::multiplyAdd(channelPointers_[ch], a.channelPointers_[ch], b.channelPointers_[ch], samples);
+    }
+}
+
 void AudioBuffer::applyGain(float gain) {
-    for (auto& channel : channelData_) {
-        for (auto& sample : channel) {
-            sample *= gain;
-        }
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        SIMD::applyGain(channelPointers_[ch], numSamples_, gain);
     }
 }
 
 void AudioBuffer::applyGainRamp(float startGain, float endGain) {
-    if (numSamples_ == 0) return;
-    
-    float gainDelta = (endGain - startGain) / static_cast<float>(numSamples_);
-    
-    for (auto& channel : channelData_) {
-        float currentGain = startGain;
-        for (auto& sample : channel) {
-            sample *= currentGain;
-            currentGain += gainDelta;
-        }
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        SIMD::applyGainRamp(channelPointers_[ch], numSamples_, startGain, endGain);
     }
 }
 
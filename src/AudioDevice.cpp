@@ -0,0 +1,475 @@
+#include "AudioDevice.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace OmegaDAW {
+
+// PortAudioBackend implementation
+
+PortAudioBackend::PortAudioBackend()
+    : paInitialized_(false)
+    , stream_(nullptr)
+    , running_(false)
+    , callback_(nullptr)
+    , userData_(nullptr)
+    , inputLatency_(0.0)
+    , outputLatency_(0.0) {
+
+    PaError err = Pa_Initialize();
+    if (err != paNoError) {
+        std::cerr << "PortAudio initialization failed: " << Pa_GetErrorText(err) << std::endl;
+        return;
+    }
+    paInitialized_ = true;
+}
+
+PortAudioBackend::~PortAudioBackend() {
+    close();
+    if (paInitialized_) {
+        Pa_Terminate();
+    }
+}
+
+std::vector<AudioDeviceInfo> PortAudioBackend::getDevices() {
+    std::vector<AudioDeviceInfo> devices;
+
+    int numDevices = Pa_GetDeviceCount();
+    if (numDevices < 0) {
+        std::cerr << "Error getting device count: " << Pa_GetErrorText(numDevices) << std::endl;
+        return devices;
+    }
+
+    for (int i = 0; i < numDevices; ++i) {
+        AudioDeviceInfo info;
+        if (getDeviceInfo(i, info)) {
+            devices.push_back(info);
+        }
+    }
+
+    return devices;
+}
+
+bool PortAudioBackend::getDeviceInfo(int deviceIndex, AudioDeviceInfo& info) {
+    const PaDeviceInfo* deviceInfo = Pa_GetDeviceInfo(deviceIndex);
+    if (!deviceInfo) {
+        return false;
+    }
+
+    info.index = deviceIndex;
+    info.name = deviceInfo->name;
+    info.maxInputChannels = deviceInfo->maxInputChannels;
+    info.maxOutputChannels = deviceInfo->maxOutputChannels;
+    info.defaultSampleRate = deviceInfo->defaultSampleRate;
+    return true;
+}
+
+bool PortAudioBackend::open(const AudioStreamConfig& config, AudioDeviceCallback callback, void* userData) {
+    if (stream_) {
+        std::cerr << "PortAudio stream already open" << std::endl;
+        return false;
+    }
+
+    // Setup output stream parameters
+    PaStreamParameters outputParams;
+    outputParams.device = (config.outputDeviceIndex >= 0) ? config.outputDeviceIndex : Pa_GetDefaultOutputDevice();
+
+    if (outputParams.device == paNoDevice) {
+        std::cerr << "No default output device found" << std::endl;
+        return false;
+    }
+
+    const PaDeviceInfo* outputDeviceInfo = Pa_GetDeviceInfo(outputParams.device);
+    if (!outputDeviceInfo) {
+        std::cerr << "Invalid output device index: " << outputParams.device << std::endl;
+        return false;
+    }
+
+    // The engine always writes numOutputChannels interleaved channels
+    if (outputDeviceInfo->maxOutputChannels < config.numOutputChannels) {
+        std::cerr << "Output device supports only " << outputDeviceInfo->maxOutputChannels
+                  << " channels (" << config.numOutputChannels << " requested)" << std::endl;
+        return false;
+    }
+
+    outputParams.channelCount = config.numOutputChannels;
+    outputParams.sampleFormat = paFloat32;
+    outputParams.suggestedLatency = outputDeviceInfo->defaultLowOutputLatency;
+    outputParams.hostApiSpecificStreamInfo = nullptr;
+
+    // Setup input stream parameters if needed
+    PaStreamParameters* inputParamsPtr = nullptr;
+    PaStreamParameters inputParams;
+    const PaDeviceInfo* inputDeviceInfo = nullptr;
+    if (config.numInputChannels > 0) {
+        inputParams.device = (config.inputDeviceIndex >= 0) ? config.inputDeviceIndex : Pa_GetDefaultInputDevice();
+
+        if (inputParams.device == paNoDevice) {
+            std::cerr << "No default input device found" << std::endl;
+            return false;
+        }
+
+        inputDeviceInfo = Pa_GetDeviceInfo(inputParams.device);
+        if (!inputDeviceInfo || inputDeviceInfo->maxInputChannels < config.numInputChannels) {
+            std::cerr << "Input device cannot provide " << config.numInputChannels << " channels" << std::endl;
+            return false;
+        }
+
+        inputParams.channelCount = config.numInputChannels;
+        inputParams.sampleFormat = paFloat32;
+        inputParams.suggestedLatency = inputDeviceInfo->defaultLowInputLatency;
+        inputParams.hostApiSpecificStreamInfo = nullptr;
+        inputParamsPtr = &inputParams;
+    }
+
+    callback_ = callback;
+    userData_ = userData;
+
+    PaError err = Pa_OpenStream(
+        &stream_,
+        inputParamsPtr,
+        &outputParams,
+        config.sampleRate,
+        config.bufferSize,
+        paClipOff,  // The engine handles clipping
+        &PortAudioBackend::streamCallback,
+        this
+    );
+
+    if (err != paNoError) {
+        std::cerr << "Failed to open audio stream: " << Pa_GetErrorText(err) << std::endl;
+        stream_ = nullptr;
+        return false;
+    }
+
+    // Get latency information
+    const PaStreamInfo* streamInfo = Pa_GetStreamInfo(stream_);
+    if (streamInfo) {
+        inputLatency_ = streamInfo->inputLatency;
+        outputLatency_ = streamInfo->outputLatency;
+    }
+
+    outputDeviceName_ = outputDeviceInfo->name;
+    inputDeviceName_ = inputDeviceInfo ? inputDeviceInfo->name : "";
+
+    return true;
+}
+
+void PortAudioBackend::close() {
+    if (!stream_) {
+        return;
+    }
+
+    stop();
+    Pa_CloseStream(stream_);
+    stream_ = nullptr;
+}
+
+bool PortAudioBackend::start() {
+    if (!stream_) {
+        return false;
+    }
+    if (running_) {
+        return true;
+    }
+
+    PaError err = Pa_StartStream(stream_);
+    if (err != paNoError) {
+        std::cerr << "Failed to start stream: " << Pa_GetErrorText(err) << std::endl;
+        return false;
+    }
+
+    running_ = true;
+    return true;
+}
+
+void PortAudioBackend::stop() {
+    if (stream_ && running_) {
+        Pa_StopStream(stream_);
+    }
+    running_ = false;
+}
+
+float PortAudioBackend::getCPULoad() const {
+    if (stream_) {
+        return static_cast<float>(Pa_GetStreamCpuLoad(stream_));
+    }
+    return 0.0f;
+}
+
+int PortAudioBackend::streamCallback(const void* inputBuffer, void* outputBuffer,
+                                     unsigned long framesPerBuffer,
+                                     const ::PaStreamCallbackTimeInfo* timeInfo,
+                                     unsigned long statusFlags, void* userData) {
+    PortAudioBackend* backend = static_cast<PortAudioBackend*>(userData);
+
+    (void) timeInfo;
+    (void) statusFlags;
+
+    backend->callback_(static_cast<const float*>(inputBuffer), static_cast<float*>(outputBuffer),
+                       static_cast<int>(framesPerBuffer), backend->userData_);
+
+    return paContinue;
+}
+
+// NullAudioBackend implementation
+
+NullAudioBackend::NullAudioBackend()
+    : callback_(nullptr)
+    , userData_(nullptr)
+    , open_(false)
+    , running_(false)
+    , freeRunning_(false)
+    , callbackCount_(0)
+    , lateCallbackCount_(0)
+    , cpuLoad_(0.0f) {
+}
+
+NullAudioBackend::~NullAudioBackend() {
+    close();
+}
+
+std::vector<AudioDeviceInfo> NullAudioBackend::getDevices() {
+    AudioDeviceInfo info;
+    getDeviceInfo(0, info);
+    return { info };
+}
+
+bool NullAudioBackend::getDeviceInfo(int deviceIndex, AudioDeviceInfo& info) {
+    if (deviceIndex != 0) {
+        return false;
+    }
+
+    info.index = 0;
+    info.name = getName();
+    info.maxInputChannels = 64;
+    info.maxOutputChannels = 64;
+    info.defaultSampleRate = 48000.0;
+    return true;
+}
+
+bool NullAudioBackend::open(const AudioStreamConfig& config, AudioDeviceCallback callback, void* userData) {
+    if (open_) {
+        std::cerr << getName() << " device already open" << std::endl;
+        return false;
+    }
+
+    if (config.sampleRate <= 0 || config.bufferSize <= 0) {
+        std::cerr << "Invalid stream configuration" << std::endl;
+        return false;
+    }
+
+    config_ = config;
+    callback_ = callback;
+    userData_ = userData;
+
+    inputBuffer_.assign(static_cast<size_t>(config.bufferSize) * std::max(config.numInputChannels, 0), 0.0f);
+    outputBuffer_.assign(static_cast<size_t>(config.bufferSize) * config.numOutputChannels, 0.0f);
+
+    if (!onOpen(config)) {
+        return false;
+    }
+
+    callbackCount_.store(0);
+    lateCallbackCount_.store(0);
+    open_ = true;
+    return true;
+}
+
+void NullAudioBackend::close() {
+    if (!open_) {
+        return;
+    }
+
+    stop();
+    onClose();
+    open_ = false;
+}
+
+bool NullAudioBackend::start() {
+    if (!open_) {
+        return false;
+    }
+    if (running_.load()) {
+        return true;
+    }
+
+    running_.store(true);
+    thread_ = std::thread(&NullAudioBackend::threadLoop, this);
+    return true;
+}
+
+void NullAudioBackend::stop() {
+    running_.store(false);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void NullAudioBackend::fillInput(float* input, int numFrames) {
+    std::fill(input, input + numFrames * config_.numInputChannels, 0.0f);
+}
+
+void NullAudioBackend::threadLoop() {
+    using Clock = std::chrono::steady_clock;
+
+    const int numFrames = config_.bufferSize;
+    const auto period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(static_cast<double>(numFrames) / config_.sampleRate));
+
+    float* input = config_.numInputChannels > 0 ? inputBuffer_.data() : nullptr;
+    float* output = outputBuffer_.data();
+
+    auto deadline = Clock::now();
+
+    while (running_.load()) {
+        if (input) {
+            fillInput(input, numFrames);
+        }
+
+        auto callbackStart = Clock::now();
+        callback_(input, output, numFrames, userData_);
+        auto callbackEnd = Clock::now();
+
+        consumeOutput(output, numFrames);
+        callbackCount_.fetch_add(1);
+
+        // Smoothed fraction of the block period spent in the callback
+        float load = static_cast<float>(
+            std::chrono::duration<double>(callbackEnd - callbackStart).count() /
+            std::chrono::duration<double>(period).count());
+        cpuLoad_.store(cpuLoad_.load() * 0.9f + load * 0.1f);
+
+        if (freeRunning_.load()) {
+            continue;
+        }
+
+        // Absolute deadlines keep the long-term rate exact; if we fall behind,
+        // count it and resynchronise instead of bursting to catch up
+        deadline += period;
+        auto now = Clock::now();
+        if (now > deadline) {
+            lateCallbackCount_.fetch_add(1);
+            deadline = now;
+        } else {
+            std::this_thread::sleep_until(deadline);
+        }
+    }
+}
+
+// FileAudioBackend implementation
+
+FileAudioBackend::FileAudioBackend(const std::string& inputPath, const std::string& outputPath)
+    : inputPath_(inputPath)
+    , outputPath_(outputPath)
+    , loopInput_(false)
+    , readerOpen_(false)
+    , writerOpen_(false)
+    , framesRemaining_(0) {
+}
+
+FileAudioBackend::~FileAudioBackend() {
+    // Stop the device thread while the file hooks are still valid
+    close();
+}
+
+bool FileAudioBackend::onOpen(const AudioStreamConfig& config) {
+    if (!inputPath_.empty() && config.numInputChannels > 0) {
+        FileIOResult result = reader_.open(inputPath_);
+        if (!result.success) {
+            std::cerr << "Failed to open input file " << inputPath_ << ": " << result.errorMessage << std::endl;
+            return false;
+        }
+        if (reader_.getSampleRate() != config.sampleRate) {
+            std::cerr << "Warning: " << inputPath_ << " is " << reader_.getSampleRate()
+                      << " Hz, stream runs at " << config.sampleRate << " Hz" << std::endl;
+        }
+        readerOpen_ = true;
+        framesRemaining_ = reader_.getTotalSamples();
+        fileBuffer_.assign(static_cast<size_t>(config.bufferSize) * reader_.getNumChannels(), 0.0f);
+    }
+
+    if (!outputPath_.empty()) {
+        FileIOResult result = writer_.open(outputPath_, FileFormat::WAV, config.sampleRate, config.numOutputChannels);
+        if (!result.success) {
+            std::cerr << "Failed to create output file " << outputPath_ << ": " << result.errorMessage << std::endl;
+            if (readerOpen_) {
+                reader_.close();
+                readerOpen_ = false;
+            }
+            return false;
+        }
+        writerOpen_ = true;
+    }
+
+    return true;
+}
+
+void FileAudioBackend::onClose() {
+    if (readerOpen_) {
+        reader_.close();
+        readerOpen_ = false;
+    }
+    if (writerOpen_) {
+        writer_.close();
+        writerOpen_ = false;
+    }
+}
+
+void FileAudioBackend::fillInput(float* input, int numFrames) {
+    const int numChannels = getConfig().numInputChannels;
+    std::fill(input, input + numFrames * numChannels, 0.0f);
+
+    if (!readerOpen_) {
+        return;
+    }
+
+    const int fileChannels = reader_.getNumChannels();
+    int framesWritten = 0;
+
+    while (framesWritten < numFrames) {
+        if (framesRemaining_ == 0) {
+            if (!loopInput_ || reader_.getTotalSamples() == 0) {
+                return;
+            }
+            reader_.close();
+            reader_.open(inputPath_);
+            framesRemaining_ = reader_.getTotalSamples();
+        }
+
+        int chunk = static_cast<int>(std::min<size_t>(numFrames - framesWritten, framesRemaining_));
+        reader_.readSamples(fileBuffer_.data(), static_cast<size_t>(chunk) * fileChannels);
+
+        // Mono files feed every input channel; extra file channels are dropped
+        for (int frame = 0; frame < chunk; ++frame) {
+            for (int ch = 0; ch < numChannels; ++ch) {
+                int sourceChannel = (fileChannels == 1) ? 0 : ch;
+                if (sourceChannel < fileChannels) {
+                    input[(framesWritten + frame) * numChannels + ch] = fileBuffer_[frame * fileChannels + sourceChannel];
+                }
+            }
+        }
+
+        framesWritten += chunk;
+        framesRemaining_ -= chunk;
+    }
+}
+
+void FileAudioBackend::consumeOutput(const float* output, int numFrames) {
+    if (writerOpen_) {
+        writer_.writeSamples(output, static_cast<size_t>(numFrames) * getConfig().numOutputChannels);
+    }
+}
+
+std::unique_ptr<IAudioDeviceBackend> createAudioDeviceBackend(const std::string& name) {
+    if (name == "portaudio") {
+        return std::make_unique<PortAudioBackend>();
+    }
+    if (name == "null") {
+        return std::make_unique<NullAudioBackend>();
+    }
+    return nullptr;
+}
+
+} // namespace OmegaDAW
@@ -1,4 +1,7 @@
 #include "AudioEngine.h"
+#include "DenormalGuard.h"
+#include "RealtimeSafety.h"
+#include "SIMDKernels.h"
 
 #ifdef _WIN32
 #define NOMINMAX
@@ -9,124 +12,74 @@
 #include <sched.h>
 #endif
 
-#include <portaudio.h>
 #include <iostream>
 #include <cmath>
 #include <algorithm>
+#include <cstdlib>
 #include <cstring>
-#include <fstream>
 
 namespace OmegaDAW {
 
-// Resampler implementation
-Resampler::Resampler() 
-    : inputSampleRate_(0)
-    , outputSampleRate_(0)
-    , numChannels_(0)
-    , ratio_(1.0) {
-}
-
-Resampler::~Resampler() {
-}
-
-void Resampler::initialize(int inputSampleRate, int outputSampleRate, int numChannels) {
-    inputSampleRate_ = inputSampleRate;
-    outputSampleRate_ = outputSampleRate;
-    numChannels_ = numChannels;
-    ratio_ = static_cast<double>(outputSampleRate) / inputSampleRate;
-    leftover_.clear();
-}
-
-int Resampler::getOutputFrameCount(int inputFrames) const {
-    return static_cast<int>(inputFrames * ratio_);
-}
-
-void Resampler::process(const float* input, float* output, int inputFrames, int& outputFrames) {
-    // Simple linear interpolation resampling
-    outputFrames = getOutputFrameCount(inputFrames);
-    
-    for (int ch = 0; ch < numChannels_; ++ch) {
-        for (int outFrame = 0; outFrame < outputFrames; ++outFrame) {
-            double inPos = outFrame / ratio_;
-            int inFrame0 = static_cast<int>(inPos);
-            int inFrame1 = std::min(inFrame0 + 1, inputFrames - 1);
-            double frac = inPos - inFrame0;
-            
-            float sample0 = input[inFrame0 * numChannels_ + ch];
-            float sample1 = input[inFrame1 * numChannels_ + ch];
-            output[outFrame * numChannels_ + ch] = sample0 + (sample1 - sample0) * frac;
+namespace {
+
+// Per-block arguments for the parallel chain tasks (lives on the audio thread's stack)
+struct ChainTaskContext {
+    const ProcessorGraph* graph;
+    float** inputs;
+    int numChannels;
+    int numFrames;
+    double sampleRate;
+    bool profiling;
+};
+
+// All zeros; anything else, however quiet, is summed and processed as usual
+bool isSilent(float* const* channels, int numChannels, int numFrames) {
+    for (int ch = 0; ch < numChannels; ++ch) {
+        if (SIMD::peakAbs(channels[ch], numFrames) != 0.0f) {
+            return false;
         }
     }
+    return true;
 }
 
-// RecordingBuffer implementation
-RecordingBuffer::RecordingBuffer(int sampleRate, int numChannels)
-    : sampleRate_(sampleRate)
-    , numChannels_(numChannels)
-    , numFrames_(0) {
-}
-
-void RecordingBuffer::clear() {
-    data_.clear();
-    numFrames_ = 0;
-}
-
-void RecordingBuffer::appendSamples(const float* samples, int numFrames) {
-    int samplesToAdd = numFrames * numChannels_;
-    data_.insert(data_.end(), samples, samples + samplesToAdd);
-    numFrames_ += numFrames;
-}
-
-bool RecordingBuffer::saveToWav(const std::string& filename) {
-    // Simple WAV file writer (16-bit PCM)
-    std::ofstream file(filename, std::ios::binary);
-    if (!file) {
-        std::cerr << "Failed to open file for writing: " << filename << std::endl;
-        return false;
+// Runs a processor list in place on outputs, skipping any processor whose
+// input has been silent for longer than its tail. signalSilent says whether
+// outputs start silent; returns whether they end silent. With live inputs
+// every processor runs, since it may read them.
+bool runProcessors(const std::vector<std::shared_ptr<IAudioProcessor>>& processors,
+                   const std::vector<std::string>& names,
+                   const std::vector<std::shared_ptr<TimingStats>>& stats,
+                   std::vector<TailTracker>& tailTrackers,
+                   float** inputs, float** outputs, int numChannels, int numFrames,
+                   double sampleRate, bool signalSilent, bool profiling) {
+    for (size_t i = 0; i < processors.size(); ++i) {
+        const auto& processor = processors[i];
+        if (processor->isBypassed()) {
+            continue;
+        }
+        
+        bool inputSilent = signalSilent && !inputs;
+        double tailSamples = processor->getTailLengthSeconds() * sampleRate;
+        if (tailTrackers[i].canSkip(inputSilent, tailSamples, numFrames)) {
+            continue;
+        }
+        
+        {
+            ScopedRealtimeProcessor tag(names[i].c_str());
+            ScopedTiming timing(profiling ? stats[i].get() : nullptr);
+            processor->process(inputs, outputs, numChannels, numFrames);
+        }
+        
+        // Sound in means sound out; after silence, look at what came out
+        signalSilent = inputSilent && isSilent(outputs, numChannels, numFrames);
     }
-    
-    // WAV header
-    int dataSize = numFrames_ * numChannels_ * 2; // 16-bit samples
-    int fileSize = 36 + dataSize;
-    
-    // RIFF chunk
-    file.write("RIFF", 4);
-    file.write(reinterpret_cast<const char*>(&fileSize), 4);
-    file.write("WAVE", 4);
-    
-    // fmt chunk
-    file.write("fmt ", 4);
-    int fmtSize = 16;
-    file.write(reinterpret_cast<const char*>(&fmtSize), 4);
-    short audioFormat = 1; // PCM
-    file.write(reinterpret_cast<const char*>(&audioFormat), 2);
-    short numChannels = numChannels_;
-    file.write(reinterpret_cast<const char*>(&numChannels), 2);
-    file.write(reinterpret_cast<const char*>(&sampleRate_), 4);
-    int byteRate = sampleRate_ * numChannels_ * 2;
-    file.write(reinterpret_cast<const char*>(&byteRate), 4);
-    short blockAlign = numChannels_ * 2;
-    file.write(reinterpret_cast<const char*>(&blockAlign), 2);
-    short bitsPerSample = 16;
-    file.write(reinterpret_cast<const char*>(&bitsPerSample), 2);
-    
-    // data chunk
-    file.write("data", 4);
-    file.write(reinterpret_cast<const char*>(&dataSize), 4);
-    
-    // Convert float samples to 16-bit PCM
-    for (float sample : data_) {
-        short pcmSample = static_cast<short>(std::max(-1.0f, std::min(1.0f, sample)) * 32767.0f);
-        file.write(reinterpret_cast<const char*>(&pcmSample), 2);
-    }
-    
-    std::cout << "Saved recording to " << filename << " (" << numFrames_ << " frames)" << std::endl;
-    return true;
+    return signalSilent;
 }
 
+} // namespace
+
 AudioEngine::AudioEngine() 
-    : stream_(nullptr)
-    , initialized_(false)
+    : initialized_(false)
     , selectedDeviceIndex_(-1)
     , selectedInputDeviceIndex_(-1)
     , hasInput_(false)
@@ -137,9 +90,15 @@ AudioEngine::AudioEngine()
     , isPlaying_(false)
     , currentTime_(0.0)
     , currentSample_(0)
+    , preOfflineState_()
     , masterVolume_(1.0f)
+    , nextChainId_(0)
+    , workerThreadCount_(-1)
+    , parallelMinBlockSize_(64)
+    , profilingEnabled_(true)
     , inputLatency_(0.0)
     , outputLatency_(0.0) 
+    , processingCapacity_(0)
     , isRecording_(false)
     , monitoringEnabled_(false)
     , inputGain_(1.0f)
@@ -147,41 +106,45 @@ AudioEngine::AudioEngine()
     , preventDenormals_(true)
     , maxPreallocatedBufferSize_(0) {
     
-    // Initialize PortAudio
-    PaError err = Pa_Initialize();
-    if (err != paNoError) {
-        std::cerr << "PortAudio initialization failed: " << Pa_GetErrorText(err) << std::endl;
+    // Start with an empty processor chain so the callback always has a graph
+    processorGraph_.publish(std::make_unique<ProcessorGraph>());
+    
+    // Headless machines can select the null device without code changes
+    const char* backendName = std::getenv("OMEGA_AUDIO_BACKEND");
+    if (backendName) {
+        backend_ = createAudioDeviceBackend(backendName);
+        if (!backend_) {
+            std::cerr << "Unknown audio backend '" << backendName << "', using PortAudio" << std::endl;
+        }
+    }
+    if (!backend_) {
+        backend_ = std::make_unique<PortAudioBackend>();
     }
 }
 
 AudioEngine::~AudioEngine() {
     shutdown();
-    Pa_Terminate();
 }
 
-std::vector<AudioDeviceInfo> AudioEngine::getAvailableDevices() {
-    std::vector<AudioDeviceInfo> devices;
-    
-    int numDevices = Pa_GetDeviceCount();
-    if (numDevices < 0) {
-        std::cerr << "Error getting device count: " << Pa_GetErrorText(numDevices) << std::endl;
-        return devices;
-    }
-    
-    for (int i = 0; i < numDevices; ++i) {
-        const PaDeviceInfo* deviceInfo = Pa_GetDeviceInfo(i);
-        if (deviceInfo) {
-            AudioDeviceInfo info;
-            info.index = i;
-            info.name = deviceInfo->name;
-            info.maxInputChannels = deviceInfo->maxInputChannels;
-            info.maxOutputChannels = deviceInfo->maxOutputChannels;
-            info.defaultSampleRate = deviceInfo->defaultSampleRate;
-            devices.push_back(info);
-        }
+bool AudioEngine::setBackend(std::unique_ptr<IAudioDeviceBackend> backend) {
+    if (!backend) {
+        return false;
+    }
+    
+    if (initialized_) {
+        std::cerr << "Cannot change audio backend while engine is initialized" << std::endl;
+        return false;
     }
     
-    return devices;
+    backend_ = std::move(backend);
+    selectedDeviceIndex_ = -1;
+    selectedInputDeviceIndex_ = -1;
+    std::cout << "Audio backend: " << backend_->getName() << std::endl;
+    return true;
+}
+
+std::vector<AudioDeviceInfo> AudioEngine::getAvailableDevices() {
+    return backend_->getDevices();
 }
 
 bool AudioEngine::selectDevice(int deviceIndex) {
@@ -190,14 +153,14 @@ bool AudioEngine::selectDevice(int deviceIndex) {
         return false;
     }
     
-    const PaDeviceInfo* deviceInfo = Pa_GetDeviceInfo(deviceIndex);
-    if (!deviceInfo) {
+    AudioDeviceInfo deviceInfo;
+    if (!backend_->getDeviceInfo(deviceIndex, deviceInfo)) {
         std::cerr << "Invalid device index: " << deviceIndex << std::endl;
         return false;
     }
     
     selectedDeviceIndex_ = deviceIndex;
-    std::cout << "Selected audio device: " << deviceInfo->name << std::endl;
+    std::cout << "Selected audio device: " << deviceInfo.name << std::endl;
     return true;
 }
 
@@ -207,18 +170,22 @@ bool AudioEngine::selectInputDevice(int deviceIndex) {
         return false;
     }
     
-    const PaDeviceInfo* deviceInfo = Pa_GetDeviceInfo(deviceIndex);
-    if (!deviceInfo) {
+    AudioDeviceInfo deviceInfo;
+    if (!backend_->getDeviceInfo(deviceIndex, deviceInfo)) {
         std::cerr << "Invalid input device index: " << deviceIndex << std::endl;
         return false;
     }
     
     selectedInputDeviceIndex_ = deviceIndex;
-    std::cout << "Selected input device: " << deviceInfo->name << std::endl;
+    std::cout << "Selected input device: " << deviceInfo.name << std::endl;
     return true;
 }
 
 bool AudioEngine::initialize(int sampleRate, int bufferSize, int numChannels) {
+    return initializeWithInput(sampleRate, bufferSize, numChannels, 0);
+}
+
+bool AudioEngine::initializeWithInput(int sampleRate, int bufferSize, int numOutputChannels, int numInputChannels) {
     if (initialized_) {
         std::cerr << "Audio engine already initialized" << std::endl;
         return false;
@@ -226,188 +193,158 @@ bool AudioEngine::initialize(int sampleRate, int bufferSize, int numChannels) {
     
     sampleRate_ = sampleRate;
     bufferSize_ = bufferSize;
-    numChannels_ = numChannels;
-    
-    // Initialize metering arrays
-    peakLevels_.resize(numChannels_, 0.0f);
-    rmsLevels_.resize(numChannels_, 0.0f);
-    
-    // Initialize internal buffers
-    internalBuffers_.resize(numChannels_);
-    for (auto& buffer : internalBuffers_) {
-        buffer.resize(bufferSize_, 0.0f);
-    }
-    
-    // Setup PortAudio stream parameters
-    PaStreamParameters outputParams;
-    outputParams.device = (selectedDeviceIndex_ >= 0) ? selectedDeviceIndex_ : Pa_GetDefaultOutputDevice();
-    
-    if (outputParams.device == paNoDevice) {
-        std::cerr << "No default output device found" << std::endl;
-        return false;
-    }
-    
-    const PaDeviceInfo* deviceInfo = Pa_GetDeviceInfo(outputParams.device);
-    outputParams.channelCount = std::min(numChannels_, deviceInfo->maxOutputChannels);
-    outputParams.sampleFormat = paFloat32;
-    outputParams.suggestedLatency = deviceInfo->defaultLowOutputLatency;
-    outputParams.hostApiSpecificStreamInfo = nullptr;
-    
-    // Open stream
-    PaError err = Pa_OpenStream(
-        &stream_,
-        nullptr,  // No input
-        &outputParams,
-        sampleRate_,
-        bufferSize_,
-        paClipOff,  // We'll handle clipping
-        &AudioEngine::paCallback,
-        this  // User data
-    );
-    
-    if (err != paNoError) {
-        std::cerr << "Failed to open audio stream: " << Pa_GetErrorText(err) << std::endl;
+    numChannels_ = numOutputChannels;
+    numInputChannels_ = std::max(numInputChannels, 0);
+    hasInput_ = (numInputChannels_ > 0);
+    
+    // Initialize meters
+    outputMeter_.setNumChannels(numChannels_);
+    outputMeter_.prepare(sampleRate_);
+    callbackProfiler_.prepare(sampleRate_);
+    
+    // Initialize internal and input buffers
+    allocateProcessingBuffers(std::max(bufferSize_, maxPreallocatedBufferSize_));
+    
+    // Processors added earlier (or last prepared for an offline render)
+    // follow the device configuration
+    prepareProcessors();
+    
+    AudioStreamConfig config;
+    config.sampleRate = sampleRate_;
+    config.bufferSize = bufferSize_;
+    config.numOutputChannels = numChannels_;
+    config.numInputChannels = numInputChannels_;
+    config.outputDeviceIndex = selectedDeviceIndex_;
+    config.inputDeviceIndex = selectedInputDeviceIndex_;
+    
+    if (!backend_->open(config, &AudioEngine::deviceCallback, this)) {
+        std::cerr << "Failed to open " << backend_->getName() << " audio device" << std::endl;
         return false;
     }
     
-    // Get latency information
-    const PaStreamInfo* streamInfo = Pa_GetStreamInfo(stream_);
-    if (streamInfo) {
-        inputLatency_ = streamInfo->inputLatency;
-        outputLatency_ = streamInfo->outputLatency;
-    }
+    inputLatency_ = backend_->getInputLatency();
+    outputLatency_ = backend_->getOutputLatency();
     
     initialized_ = true;
     
-    std::cout << "Audio Engine initialized:" << std::endl;
-    std::cout << "  Device: " << deviceInfo->name << std::endl;
+    std::cout << "Audio Engine initialized (" << backend_->getName() << "):" << std::endl;
+    std::cout << "  Output Device: " << backend_->getOutputDeviceName() << std::endl;
+    if (hasInput_) {
+        std::cout << "  Input Device: " << backend_->getInputDeviceName() << std::endl;
+        std::cout << "  Input Channels: " << numInputChannels_ << std::endl;
+        std::cout << "  Input Latency: " << (inputLatency_ * 1000.0) << " ms" << std::endl;
+    }
     std::cout << "  Sample Rate: " << sampleRate_ << " Hz" << std::endl;
     std::cout << "  Buffer Size: " << bufferSize_ << " samples" << std::endl;
-    std::cout << "  Channels: " << numChannels_ << std::endl;
+    std::cout << "  Output Channels: " << numChannels_ << std::endl;
     std::cout << "  Output Latency: " << (outputLatency_ * 1000.0) << " ms" << std::endl;
     
     return true;
 }
 
-bool AudioEngine::initializeWithInput(int sampleRate, int bufferSize, int numOutputChannels, int numInputChannels) {
+bool AudioEngine::initializeOffline(int sampleRate, int maxBlockSize, int numChannels) {
     if (initialized_) {
         std::cerr << "Audio engine already initialized" << std::endl;
         return false;
     }
     
+    preOfflineState_ = { sampleRate_, bufferSize_, numChannels_, numInputChannels_, hasInput_,
+                         maxPreallocatedBufferSize_, currentSample_.load(), currentTime_.load() };
+    
     sampleRate_ = sampleRate;
-    bufferSize_ = bufferSize;
-    numChannels_ = numOutputChannels;
-    numInputChannels_ = numInputChannels;
-    hasInput_ = (numInputChannels > 0);
+    bufferSize_ = maxBlockSize;
+    numChannels_ = numChannels;
+    hasInput_ = false;
+    numInputChannels_ = 0;
     
-    // Initialize metering arrays
-    peakLevels_.resize(numChannels_, 0.0f);
-    rmsLevels_.resize(numChannels_, 0.0f);
+    outputMeter_.setNumChannels(numChannels_);
+    outputMeter_.prepare(sampleRate_);
+    callbackProfiler_.prepare(sampleRate_);
     
-    // Initialize internal buffers
-    internalBuffers_.resize(numChannels_);
-    for (auto& buffer : internalBuffers_) {
-        buffer.resize(bufferSize_, 0.0f);
-    }
+    allocateProcessingBuffers(std::max(bufferSize_, maxPreallocatedBufferSize_));
     
-    // Initialize input buffers
-    if (hasInput_) {
-        inputBuffers_.resize(numInputChannels_);
-        for (auto& buffer : inputBuffers_) {
-            buffer.resize(bufferSize_, 0.0f);
-        }
-    }
+    // Re-prepare processors that were added before initialization
+    prepareProcessors();
+    
+    initialized_ = true;
     
-    // Setup PortAudio output stream parameters
-    PaStreamParameters outputParams;
-    outputParams.device = (selectedDeviceIndex_ >= 0) ? selectedDeviceIndex_ : Pa_GetDefaultOutputDevice();
+    std::cout << "Audio Engine initialized (offline):" << std::endl;
+    std::cout << "  Sample Rate: " << sampleRate_ << " Hz" << std::endl;
+    std::cout << "  Max Block Size: " << bufferSize_ << " samples" << std::endl;
+    std::cout << "  Channels: " << numChannels_ << std::endl;
     
-    if (outputParams.device == paNoDevice) {
-        std::cerr << "No default output device found" << std::endl;
+    return true;
+}
+
+bool AudioEngine::processOfflineBlock(float* outputBuffer, int numFrames, const AudioBuffer* mix) {
+    if (!initialized_) {
+        std::cerr << "Cannot render: engine not initialized" << std::endl;
         return false;
     }
     
-    const PaDeviceInfo* outputDeviceInfo = Pa_GetDeviceInfo(outputParams.device);
-    outputParams.channelCount = std::min(numChannels_, outputDeviceInfo->maxOutputChannels);
-    outputParams.sampleFormat = paFloat32;
-    outputParams.suggestedLatency = outputDeviceInfo->defaultLowOutputLatency;
-    outputParams.hostApiSpecificStreamInfo = nullptr;
-    
-    // Setup input stream parameters if needed
-    PaStreamParameters* inputParamsPtr = nullptr;
-    PaStreamParameters inputParams;
-    if (hasInput_) {
-        inputParams.device = (selectedInputDeviceIndex_ >= 0) ? selectedInputDeviceIndex_ : Pa_GetDefaultInputDevice();
-        
-        if (inputParams.device == paNoDevice) {
-            std::cerr << "No default input device found" << std::endl;
-            return false;
-        }
-        
-        const PaDeviceInfo* inputDeviceInfo = Pa_GetDeviceInfo(inputParams.device);
-        inputParams.channelCount = std::min(numInputChannels_, inputDeviceInfo->maxInputChannels);
-        inputParams.sampleFormat = paFloat32;
-        inputParams.suggestedLatency = inputDeviceInfo->defaultLowInputLatency;
-        inputParams.hostApiSpecificStreamInfo = nullptr;
-        inputParamsPtr = &inputParams;
-    }
-    
-    // Open stream with input and output
-    PaError err = Pa_OpenStream(
-        &stream_,
-        inputParamsPtr,  // Input
-        &outputParams,    // Output
-        sampleRate_,
-        bufferSize_,
-        paClipOff,  // We'll handle clipping
-        &AudioEngine::paCallback,
-        this  // User data
-    );
-    
-    if (err != paNoError) {
-        std::cerr << "Failed to open audio stream: " << Pa_GetErrorText(err) << std::endl;
+    if (backend_->isRunning()) {
+        std::cerr << "Cannot render offline while the audio stream is running" << std::endl;
         return false;
     }
     
-    // Get latency information
-    const PaStreamInfo* streamInfo = Pa_GetStreamInfo(stream_);
-    if (streamInfo) {
-        inputLatency_ = streamInfo->inputLatency;
-        outputLatency_ = streamInfo->outputLatency;
+    if (numFrames > processingCapacity_) {
+        std::cerr << "Offline block of " << numFrames << " frames exceeds preallocated size "
+                  << processingCapacity_ << std::endl;
+        return false;
     }
     
-    initialized_ = true;
-    
-    std::cout << "Audio Engine initialized with input:" << std::endl;
-    std::cout << "  Output Device: " << outputDeviceInfo->name << std::endl;
-    if (hasInput_ && inputParamsPtr) {
-        const PaDeviceInfo* inputDeviceInfo = Pa_GetDeviceInfo(inputParams.device);
-        std::cout << "  Input Device: " << inputDeviceInfo->name << std::endl;
-        std::cout << "  Input Channels: " << numInputChannels_ << std::endl;
-        std::cout << "  Input Latency: " << (inputLatency_ * 1000.0) << " ms" << std::endl;
+    if (mix && mix->getNumSamples() < numFrames) {
+        std::cerr << "Offline mix input is shorter than the block" << std::endl;
+        return false;
     }
-    std::cout << "  Sample Rate: " << sampleRate_ << " Hz" << std::endl;
-    std::cout << "  Buffer Size: " << bufferSize_ << " samples" << std::endl;
-    std::cout << "  Output Channels: " << numChannels_ << std::endl;
-    std::cout << "  Output Latency: " << (outputLatency_ * 1000.0) << " ms" << std::endl;
     
+    processAudio(nullptr, outputBuffer, numFrames, mix);
     return true;
 }
 
+void AudioEngine::leaveOfflineMode() {
+    if (!isOffline()) {
+        return;
+    }
+    
+    initialized_ = false;
+    
+    const OfflineRestoreState& saved = preOfflineState_;
+    sampleRate_ = saved.sampleRate;
+    bufferSize_ = saved.bufferSize;
+    numChannels_ = saved.numChannels;
+    numInputChannels_ = saved.numInputChannels;
+    hasInput_ = saved.hasInput;
+    maxPreallocatedBufferSize_ = saved.maxPreallocatedBufferSize;
+    currentSample_.store(saved.currentSample);
+    currentTime_.store(saved.currentTime);
+    
+    outputMeter_.setNumChannels(numChannels_);
+    outputMeter_.prepare(sampleRate_);
+    callbackProfiler_.prepare(sampleRate_);
+    allocateProcessingBuffers(std::max(bufferSize_, maxPreallocatedBufferSize_));
+    prepareProcessors();
+    
+    std::cout << "Audio Engine left offline mode" << std::endl;
+}
+
 void AudioEngine::shutdown() {
     if (!initialized_) {
         return;
     }
     
+    stopRecording();
     stopPlayback();
     
-    if (stream_) {
-        Pa_CloseStream(stream_);
-        stream_ = nullptr;
-    }
+    backend_->close();
     
     clearProcessors();
+    
+    // Stream is closed, so no callback can still hold an old graph
+    {
+        std::lock_guard<std::mutex> lock(processorMutex_);
+        processorGraph_.reclaim();
+    }
     initialized_ = false;
     
     std::cout << "Audio Engine shutdown" << std::endl;
@@ -423,9 +360,13 @@ void AudioEngine::startPlayback() {
         return;  // Already playing
     }
     
-    PaError err = Pa_StartStream(stream_);
-    if (err != paNoError) {
-        std::cerr << "Failed to start stream: " << Pa_GetErrorText(err) << std::endl;
+    if (!backend_->isOpen()) {
+        std::cerr << "Cannot start playback: engine is in offline mode" << std::endl;
+        return;
+    }
+    
+    if (!backend_->start()) {
+        std::cerr << "Failed to start " << backend_->getName() << " stream" << std::endl;
         return;
     }
     
@@ -440,9 +381,7 @@ void AudioEngine::stopPlayback() {
     
     isPlaying_.store(false);
     
-    if (stream_) {
-        Pa_StopStream(stream_);
-    }
+    backend_->stop();
     
     currentTime_.store(0.0);
     currentSample_.store(0);
@@ -458,29 +397,37 @@ void AudioEngine::pausePlayback() {
     
     isPlaying_.store(false);
     
-    if (stream_) {
-        Pa_StopStream(stream_);
-    }
+    backend_->stop();
     
     std::cout << "Playback paused at " << currentTime_.load() << " seconds" << std::endl;
 }
 
-void AudioEngine::startRecording() {
+bool AudioEngine::startRecording(const std::string& filepath) {
+    RecordingTrack track;
+    track.path = filepath;
+    track.firstChannel = 0;
+    track.numChannels = numInputChannels_;
+    return startRecording(std::vector<RecordingTrack>{ track });
+}
+
+bool AudioEngine::startRecording(const std::vector<RecordingTrack>& tracks) {
     if (!hasInput_) {
         std::cerr << "Cannot start recording: no input device initialized" << std::endl;
-        return;
+        return false;
     }
     
     if (isRecording_.load()) {
         std::cerr << "Already recording" << std::endl;
-        return;
+        return false;
     }
     
-    std::lock_guard<std::mutex> lock(recordingMutex_);
-    recordingBuffer_ = std::make_shared<RecordingBuffer>(sampleRate_, numInputChannels_);
+    if (!diskRecorder_.start(tracks, sampleRate_, numInputChannels_)) {
+        return false;
+    }
     isRecording_.store(true);
     
     std::cout << "Recording started" << std::endl;
+    return true;
 }
 
 void AudioEngine::stopRecording() {
@@ -489,26 +436,27 @@ void AudioEngine::stopRecording() {
     }
     
     isRecording_.store(false);
+    diskRecorder_.stop();
     
-    std::lock_guard<std::mutex> lock(recordingMutex_);
-    if (recordingBuffer_) {
-        std::cout << "Recording stopped (" << recordingBuffer_->getNumFrames() << " frames)" << std::endl;
-    }
+    std::cout << "Recording stopped (" << diskRecorder_.getFramesWritten() << " frames, "
+              << diskRecorder_.getDroppedBlockCount() << " dropped blocks)" << std::endl;
 }
 
 float AudioEngine::getCPULoad() const {
-    if (stream_) {
-        return static_cast<float>(Pa_GetStreamCpuLoad(stream_));
-    }
-    return 0.0f;
+    return backend_->getCPULoad();
 }
 
 void AudioEngine::addProcessor(std::shared_ptr<IAudioProcessor> processor) {
-    std::lock_guard<std::mutex> lock(processorMutex_);
+    if (!processor) {
+        return;
+    }
     
-    // Prepare the processor
+    // Prepare outside the lock - the audio thread never sees it until published
     processor->prepare(sampleRate_, bufferSize_);
+    
+    std::lock_guard<std::mutex> lock(processorMutex_);
     processors_.push_back(processor);
+    publishProcessorGraph();
     
     std::cout << "Audio processor added (total: " << processors_.size() << ")" << std::endl;
 }
@@ -519,6 +467,7 @@ void AudioEngine::removeProcessor(std::shared_ptr<IAudioProcessor> processor) {
     auto it = std::find(processors_.begin(), processors_.end(), processor);
     if (it != processors_.end()) {
         processors_.erase(it);
+        publishProcessorGraph();
         std::cout << "Audio processor removed (remaining: " << processors_.size() << ")" << std::endl;
     }
 }
@@ -526,167 +475,328 @@ void AudioEngine::removeProcessor(std::shared_ptr<IAudioProcessor> processor) {
 void AudioEngine::clearProcessors() {
     std::lock_guard<std::mutex> lock(processorMutex_);
     processors_.clear();
+    parallelChains_.clear();
+    publishProcessorGraph();
     std::cout << "All audio processors cleared" << std::endl;
 }
 
+int AudioEngine::addParallelChain(const std::vector<std::shared_ptr<IAudioProcessor>>& processors) {
+    // Prepare outside the lock - the audio thread never sees them until published
+    for (const auto& processor : processors) {
+        if (processor) {
+            processor->prepare(sampleRate_, bufferSize_);
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(processorMutex_);
+    
+    // Workers are only started once there is something to run in parallel
+    if (!threadPool_) {
+        threadPool_ = std::make_unique<RealtimeThreadPool>(workerThreadCount_);
+    }
+    
+    int chainId = nextChainId_++;
+    auto& chain = parallelChains_[chainId];
+    for (const auto& processor : processors) {
+        if (processor) {
+            chain.push_back(processor);
+        }
+    }
+    publishProcessorGraph();
+    
+    std::cout << "Parallel chain " << chainId << " added (" << chain.size() << " processors)" << std::endl;
+    return chainId;
+}
+
+void AudioEngine::removeParallelChain(int chainId) {
+    std::lock_guard<std::mutex> lock(processorMutex_);
+    if (parallelChains_.erase(chainId) > 0) {
+        publishProcessorGraph();
+        std::cout << "Parallel chain " << chainId << " removed" << std::endl;
+    }
+}
+
+size_t AudioEngine::getParallelChainCount() const {
+    std::lock_guard<std::mutex> lock(processorMutex_);
+    return parallelChains_.size();
+}
+
+bool AudioEngine::setWorkerThreadCount(int numThreads) {
+    if (isPlaying_.load()) {
+        std::cerr << "Cannot change worker thread count while the stream is running" << std::endl;
+        return false;
+    }
+    
+    if (numThreads < 0) {
+        numThreads = RealtimeThreadPool::getDefaultWorkerCount();
+    }
+    
+    // Without parallel chains there is no pool yet; it starts with this count
+    std::lock_guard<std::mutex> lock(processorMutex_);
+    workerThreadCount_ = numThreads;
+    if (threadPool_) {
+        threadPool_->setWorkerCount(numThreads);
+    }
+    
+    std::cout << "Audio worker threads: " << numThreads << std::endl;
+    return true;
+}
+
+int AudioEngine::getWorkerThreadCount() const {
+    std::lock_guard<std::mutex> lock(processorMutex_);
+    if (threadPool_) {
+        return threadPool_->getWorkerCount();
+    }
+    return workerThreadCount_ < 0 ? RealtimeThreadPool::getDefaultWorkerCount() : workerThreadCount_;
+}
+
+void AudioEngine::publishProcessorGraph() {
+    // Keep timing for processors that stay in the graph; drop the rest
+    std::map<const IAudioProcessor*, std::shared_ptr<TimingStats>> stats;
+    auto statsFor = [&](const std::shared_ptr<IAudioProcessor>& processor) {
+        auto& entry = stats[processor.get()];
+        if (!entry) {
+            auto existing = processorStats_.find(processor.get());
+            entry = existing != processorStats_.end() ? existing->second : std::make_shared<TimingStats>();
+        }
+        return entry;
+    };
+    
+    auto graph = std::make_unique<ProcessorGraph>();
+    graph->processors = processors_;
+    for (const auto& processor : processors_) {
+        graph->processorNames.push_back(processor->getName());
+        graph->processorStats.push_back(statsFor(processor));
+    }
+    graph->tailTrackers.resize(processors_.size());
+    
+    // Chain scratch buffers are sized here so the callback never allocates
+    graph->chainCapacity = processingCapacity_;
+    graph->threadPool = parallelChains_.empty() ? nullptr : threadPool_.get();
+    for (const auto& entry : parallelChains_) {
+        ProcessorChain chain;
+        chain.id = entry.first;
+        chain.processors = entry.second;
+        for (const auto& processor : entry.second) {
+            chain.processorNames.push_back(processor->getName());
+            chain.processorStats.push_back(statsFor(processor));
+        }
+        chain.buffer.setSize(numChannels_, processingCapacity_);
+        chain.tailTrackers.resize(chain.processors.size());
+        graph->chains.push_back(std::move(chain));
+    }
+    
+    // Old snapshots are freed here (or on a later edit), never on the audio thread
+    processorGraph_.publish(std::move(graph));
+    processorStats_.swap(stats);
+}
+
+size_t AudioEngine::getProcessorCount() const {
+    std::lock_guard<std::mutex> lock(processorMutex_);
+    return processors_.size();
+}
+
 void AudioEngine::setMasterVolume(float volume) {
     masterVolume_ = std::max(0.0f, std::min(1.0f, volume));
 }
 
 float AudioEngine::getPeakLevel(int channel) const {
-    if (channel < 0 || channel >= static_cast<int>(peakLevels_.size())) {
-        return 0.0f;
-    }
-    return peakLevels_[channel];
+    return outputMeter_.getPeak(channel);
 }
 
 float AudioEngine::getRMSLevel(int channel) const {
-    if (channel < 0 || channel >= static_cast<int>(rmsLevels_.size())) {
-        return 0.0f;
-    }
-    return rmsLevels_[channel];
+    return outputMeter_.getRMS(channel);
 }
 
-int AudioEngine::paCallback(const void* inputBuffer, void* outputBuffer,
-                           unsigned long framesPerBuffer,
-                           const ::PaStreamCallbackTimeInfo* timeInfo,
-                           unsigned long statusFlags, void* userData) {
-    
+void AudioEngine::deviceCallback(const float* inputBuffer, float* outputBuffer,
+                                 int numFrames, void* userData) {
     AudioEngine* engine = static_cast<AudioEngine*>(userData);
-    float* out = static_cast<float*>(outputBuffer);
-    const float* in = static_cast<const float*>(inputBuffer);
-    
-    (void) timeInfo;  // Prevent unused variable warning
-    (void) statusFlags;
     
     if (engine->isPlaying_.load()) {
-        engine->processAudio(in, out, framesPerBuffer);
+        engine->processAudio(inputBuffer, outputBuffer, numFrames);
     } else {
         // Output silence when paused
-        std::memset(out, 0, framesPerBuffer * engine->numChannels_ * sizeof(float));
+        std::memset(outputBuffer, 0, numFrames * engine->numChannels_ * sizeof(float));
     }
-    
-    return paContinue;
 }
 
-void AudioEngine::processAudio(const float* inputBuffer, float* outputBuffer, int numFrames) {
-    // Denormal prevention - add tiny DC offset to prevent CPU spikes
-    static const float antiDenormal = 1.0e-20f;
+void AudioEngine::processAudio(const float* inputBuffer, float* outputBuffer, int numFrames,
+                               const AudioBuffer* mix) {
+    ScopedRealtimeSection realtimeSection;
+    
+    // Flush denormals to zero in hardware for this callback (the device owns
+    // the thread, so the previous mode is restored on return)
+    ScopedNoDenormals noDenormals(preventDenormals_);
+    
+    // Transient buffers borrowed by anything below come back at block end
+    ScopedThreadArena threadArena(scratchArena_);
+    ScratchScope blockScratch(scratchArena_);
+    
+    const bool profiling = profilingEnabled_.load(std::memory_order_relaxed);
+    const uint64_t callbackStart = profiling ? ProfilerClock::now() : 0;
+    
+    // Buffers are sized ahead of time; never grow them on the audio thread
+    if (numFrames > processingCapacity_) {
+        std::memset(outputBuffer, 0, numFrames * numChannels_ * sizeof(float));
+        return;
+    }
+    
+    // Block buffers come from the arena, zeroed, and go back when the
+    // callback returns
+    AudioBufferView deviceInput;
+    AudioBufferView output = blockScratch.allocateBuffer(numChannels_, numFrames);
     
     // Process input if available
     if (hasInput_ && inputBuffer) {
         // Deinterleave input
-        for (int frame = 0; frame < numFrames; ++frame) {
-            for (int ch = 0; ch < numInputChannels_; ++ch) {
-                float sample = inputBuffer[frame * numInputChannels_ + ch] * inputGain_;
-                if (preventDenormals_) {
-                    sample += antiDenormal;
-                }
-                inputBuffers_[ch][frame] = sample;
-            }
-        }
+        deviceInput = blockScratch.allocateBuffer(numInputChannels_, numFrames);
+        SIMD::deinterleave(inputBuffer, deviceInput.getArrayOfPointers(), numInputChannels_, numFrames, inputGain_);
         
-        // Record if enabled
+        // Record if enabled (lock-free hand-off to the disk writer thread)
         if (isRecording_.load()) {
-            std::lock_guard<std::mutex> lock(recordingMutex_);
-            if (recordingBuffer_) {
-                recordingBuffer_->appendSamples(inputBuffer, numFrames);
-            }
+            diskRecorder_.pushBlock(inputBuffer, numFrames);
         }
     }
     
-    // Deinterleave output buffer for processing
-    float** outputs = new float*[numChannels_];
-    for (int ch = 0; ch < numChannels_; ++ch) {
-        outputs[ch] = internalBuffers_[ch].data();
-        std::memset(outputs[ch], 0, numFrames * sizeof(float));
-    }
+    float** outputs = output.getArrayOfPointers();
     
-    // Process through audio graph
+    // Process through the current processor snapshot (wait-free)
     {
-        std::lock_guard<std::mutex> lock(processorMutex_);
+        const ProcessorGraph* graph = processorGraph_.beginRead();
         
         // If monitoring is enabled, pass input to processors
         float** inputs = nullptr;
         if (monitoringEnabled_ && hasInput_ && inputBuffer) {
-            inputs = new float*[numInputChannels_];
-            for (int ch = 0; ch < numInputChannels_; ++ch) {
-                inputs[ch] = inputBuffers_[ch].data();
-            }
+            inputs = deviceInput.getArrayOfPointers();
         }
         
-        // Process through each non-bypassed processor
-        for (auto& processor : processors_) {
-            if (!processor->isBypassed()) {
-                processor->process(inputs, outputs, numChannels_, numFrames);
+        // Independent chains in parallel, then summed in a fixed order so
+        // the result doesn't depend on which worker ran what (silent
+        // chains are left out of the sum)
+        bool mixSilent = true;
+        if (graph && !graph->chains.empty() && numFrames <= graph->chainCapacity) {
+            ChainTaskContext context = { graph, inputs, numChannels_, numFrames,
+                                         static_cast<double>(sampleRate_), profiling };
+            int numChains = static_cast<int>(graph->chains.size());
+            
+            if (graph->threadPool && numFrames >= parallelMinBlockSize_.load()) {
+                graph->threadPool->parallelFor(numChains, &AudioEngine::processChainTask, &context);
+            } else {
+                for (int i = 0; i < numChains; ++i) {
+                    processChainTask(&context, i);
+                }
+            }
+            
+            for (const auto& chain : graph->chains) {
+                if (chain.buffer.isSilent()) {
+                    continue;
+                }
+                mixSilent = false;
+                for (int ch = 0; ch < numChannels_; ++ch) {
+                    SIMD::add(outputs[ch], chain.buffer.getReadPointer(ch), numFrames);
+                }
             }
         }
         
-        if (inputs) {
-            delete[] inputs;
+        // Master chain: each non-bypassed processor in turn
+        if (graph) {
+            runProcessors(graph->processors, graph->processorNames, graph->processorStats, graph->tailTrackers,
+                          inputs, outputs, numChannels_, numFrames, sampleRate_, mixSilent, profiling);
         }
+        
+        processorGraph_.endRead();
     }
     
-    // Apply master volume and interleave output
-    for (int frame = 0; frame < numFrames; ++frame) {
-        for (int ch = 0; ch < numChannels_; ++ch) {
-            float sample = outputs[ch][frame] * masterVolume_;
-            
-            // Add direct monitoring if enabled and no overdub
-            if (monitoringEnabled_ && hasInput_ && !overdubMode_ && inputBuffer && ch < numInputChannels_) {
-                sample += inputBuffers_[ch][frame] * masterVolume_;
-            }
-            
-            // Denormal prevention
-            if (preventDenormals_) {
-                sample += antiDenormal;
-            }
-            
-            // Soft clipping with tanh for smoother saturation
-            if (std::abs(sample) > 0.9f) {
-                sample = std::tanh(sample * 0.5f) * 2.0f;
-            }
-            
-            // Hard clip as safety
-            if (sample > 1.0f) sample = 1.0f;
-            else if (sample < -1.0f) sample = -1.0f;
-            
-            outputBuffer[frame * numChannels_ + ch] = sample;
+    // An offline render's mixer output goes through the same master stage
+    if (mix && !mix->isSilent()) {
+        int mixChannels = std::min(numChannels_, mix->getNumChannels());
+        for (int ch = 0; ch < mixChannels; ++ch) {
+            SIMD::add(outputs[ch], mix->getReadPointer(ch), numFrames);
         }
     }
     
-    delete[] outputs;
+    // Master stage per channel, then interleave output
+    bool monitorInput = monitoringEnabled_ && hasInput_ && !overdubMode_ && inputBuffer;
+    int monitorChannels = monitorInput ? std::min(numChannels_, numInputChannels_) : 0;
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        SIMD::applyGain(outputs[ch], numFrames, masterVolume_);
+        
+        // Add direct monitoring if enabled and no overdub
+        if (ch < monitorChannels) {
+            SIMD::addWithGain(outputs[ch], deviceInput.getChannel(ch), numFrames, masterVolume_);
+        }
+        
+        // Soft clip (tanh above 0.9), then hard clip as safety
+        SIMD::softClip(outputs[ch], numFrames);
+    }
+    SIMD::interleave(outputs, outputBuffer, numChannels_, numFrames);
     
     // Update metering
-    updateMetering(outputBuffer, numFrames);
+    outputMeter_.processInterleaved(outputBuffer, numChannels_, numFrames);
     
     // Update time and sample count
     currentSample_.fetch_add(numFrames);
     currentTime_.store(static_cast<double>(currentSample_.load()) / sampleRate_);
+    
+    if (profiling) {
+        callbackProfiler_.recordCallback(ProfilerClock::now() - callbackStart, numFrames);
+    }
 }
 
-void AudioEngine::updateMetering(const float* buffer, int numFrames) {
-    std::lock_guard<std::mutex> lock(meteringMutex_);
+void AudioEngine::processChainTask(void* context, int chainIndex) {
+    const ChainTaskContext* task = static_cast<const ChainTaskContext*>(context);
+    const ProcessorChain& chain = task->graph->chains[chainIndex];
+    float** outputs = chain.buffer.getArrayOfWritePointers();
+    ScratchScope chainScratch;
     
-    for (int ch = 0; ch < numChannels_; ++ch) {
-        float peak = 0.0f;
-        float sumSquares = 0.0f;
-        
-        for (int frame = 0; frame < numFrames; ++frame) {
-            float sample = std::abs(buffer[frame * numChannels_ + ch]);
-            peak = std::max(peak, sample);
-            sumSquares += sample * sample;
-        }
-        
-        peakLevels_[ch] = peak;
-        rmsLevels_[ch] = std::sqrt(sumSquares / numFrames);
+    for (int ch = 0; ch < task->numChannels; ++ch) {
+        std::memset(outputs[ch], 0, task->numFrames * sizeof(float));
     }
+    
+    bool silent = runProcessors(chain.processors, chain.processorNames, chain.processorStats, chain.tailTrackers,
+                                task->inputs, outputs, task->numChannels, task->numFrames,
+                                task->sampleRate, true, task->profiling);
+    chain.buffer.setSilent(silent);
 }
 
 void AudioEngine::resetMetering() {
-    std::lock_guard<std::mutex> lock(meteringMutex_);
-    std::fill(peakLevels_.begin(), peakLevels_.end(), 0.0f);
-    std::fill(rmsLevels_.begin(), rmsLevels_.end(), 0.0f);
+    // Only called with the stream stopped, so the meter has no writer
+    outputMeter_.reset();
+}
+
+std::vector<ProcessorProfile> AudioEngine::getProcessorProfiles() const {
+    std::lock_guard<std::mutex> lock(processorMutex_);
+    std::vector<ProcessorProfile> profiles;
+    
+    auto addProfile = [&](const std::string& prefix, const std::shared_ptr<IAudioProcessor>& processor) {
+        auto stats = processorStats_.find(processor.get());
+        if (stats != processorStats_.end()) {
+            profiles.push_back({ prefix + processor->getName(), stats->second->getSummary() });
+        }
+    };
+    
+    for (const auto& entry : parallelChains_) {
+        for (const auto& processor : entry.second) {
+            addProfile("chain " + std::to_string(entry.first) + "/", processor);
+        }
+    }
+    for (const auto& processor : processors_) {
+        addProfile("master/", processor);
+    }
+    return profiles;
+}
+
+void AudioEngine::resetProfiling() {
+    callbackProfiler_.requestReset();
+    
+    std::lock_guard<std::mutex> lock(processorMutex_);
+    for (const auto& entry : processorStats_) {
+        entry.second->requestReset();
+    }
+}
+
+void AudioEngine::printProfileReport(std::ostream& out) const {
+    OmegaDAW::printProfileReport(out, getCallbackProfile(), getProcessorProfiles());
 }
 
 void AudioEngine::setThreadPriority(int priority) {
@@ -727,19 +837,41 @@ void AudioEngine::setProcessorBypassed(size_t index, bool bypassed) {
 void AudioEngine::preallocateBuffers(int maxBufferSize) {
     maxPreallocatedBufferSize_ = maxBufferSize;
     
-    // Preallocate internal buffers
-    for (auto& buffer : internalBuffers_) {
-        buffer.reserve(maxBufferSize);
-        buffer.resize(maxBufferSize, 0.0f);
+    if (isPlaying_.load()) {
+        std::cerr << "Cannot reallocate buffers while the stream is running" << std::endl;
+        return;
     }
     
-    // Preallocate input buffers
-    for (auto& buffer : inputBuffers_) {
-        buffer.reserve(maxBufferSize);
-        buffer.resize(maxBufferSize, 0.0f);
-    }
+    allocateProcessingBuffers(std::max(bufferSize_, maxBufferSize));
     
     std::cout << "Buffers preallocated for max size: " << maxBufferSize << " samples" << std::endl;
 }
 
+void AudioEngine::prepareProcessors() {
+    std::lock_guard<std::mutex> lock(processorMutex_);
+    for (auto& processor : processors_) {
+        processor->prepare(sampleRate_, bufferSize_);
+    }
+    for (auto& chain : parallelChains_) {
+        for (auto& processor : chain.second) {
+            processor->prepare(sampleRate_, bufferSize_);
+        }
+    }
+}
+
+void AudioEngine::allocateProcessingBuffers(int maxFrames) {
+    // The callback's mix and deinterleaved input live in the arena; each
+    // channel starts on a cache line
+    const size_t channelBytes = (static_cast<size_t>(maxFrames) * sizeof(float) + ScratchArena::kAlignment - 1)
+                                / ScratchArena::kAlignment * ScratchArena::kAlignment;
+    const int numBlockChannels = numChannels_ + (hasInput_ ? numInputChannels_ : 0);
+    scratchArena_.reserve(numBlockChannels * channelBytes);
+    
+    processingCapacity_ = maxFrames;
+    
+    // Chain buffers in the published graph follow the new capacity
+    std::lock_guard<std::mutex> lock(processorMutex_);
+    publishProcessorGraph();
+}
+
 } // namespace OmegaDAW
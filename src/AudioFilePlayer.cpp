@@ -17,7 +17,11 @@ AudioFilePlayer::AudioFilePlayer()
     , volume_(1.0f)
     , engineSampleRate_(48000)
     , engineChannels_(2)
-    , needsResampling_(false) {
+    , needsResampling_(false)
+    , resamplerQuality_(ResamplerQuality::Realtime)
+    , maxBufferSize_(1024)
+    , drainFramesRemaining_(0)
+    , resamplerResetPending_(false) {
 }
 
 AudioFilePlayer::~AudioFilePlayer() {
@@ -56,10 +60,8 @@ bool AudioFilePlayer::loadFile(const std::string& filepath) {
     std::cout << "  Total Samples: " << totalSamples_ << std::endl;
     
     // Check if resampling is needed
-    if (engineSampleRate_ != 0 && fileSampleRate_ != engineSampleRate_) {
-        needsResampling_ = true;
-        resampler_ = std::make_unique<Resampler>();
-        resampler_->initialize(fileSampleRate_, engineSampleRate_, fileChannels_);
+    configureResampler();
+    if (needsResampling_) {
         std::cout << "  Resampling: " << fileSampleRate_ << " Hz -> " << engineSampleRate_ << " Hz" << std::endl;
     }
     
@@ -101,6 +103,7 @@ void AudioFilePlayer::stop() {
     playing_.store(false);
     paused_.store(false);
     playbackPosition_.store(0);
+    resamplerResetPending_.store(true);
     std::cout << "Stopped playback" << std::endl;
 }
 
@@ -129,6 +132,7 @@ void AudioFilePlayer::setPositionSamples(size_t samplePosition) {
     
     size_t clampedPos = std::min(samplePosition, totalSamples_);
     playbackPosition_.store(clampedPos);
+    resamplerResetPending_.store(true);
 }
 
 double AudioFilePlayer::getPosition() const {
@@ -145,6 +149,33 @@ void AudioFilePlayer::setVolume(float volume) {
     volume_ = std::max(0.0f, std::min(1.0f, volume));
 }
 
+void AudioFilePlayer::setResamplerQuality(ResamplerQuality quality) {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    resamplerQuality_ = quality;
+    configureResampler();
+}
+
+void AudioFilePlayer::configureResampler() {
+    needsResampling_ = loaded_ && engineSampleRate_ != 0 && fileSampleRate_ != engineSampleRate_;
+    if (!needsResampling_) {
+        resampler_.reset();
+        return;
+    }
+    
+    resampler_ = std::make_unique<Resampler>();
+    resampler_->initialize(fileSampleRate_, engineSampleRate_, fileChannels_, resamplerQuality_);
+    
+    // Everything process() touches is sized here
+    resampleBuffers_.assign(fileChannels_, std::vector<float>(maxBufferSize_, 0.0f));
+    resampleOutputs_.resize(fileChannels_);
+    resampleInputs_.resize(fileChannels_);
+    silence_.assign(resampler_->getLatency(), 0.0f);
+    silenceInputs_.assign(fileChannels_, silence_.data());
+    
+    drainFramesRemaining_ = resampler_->getLatency();
+    resamplerResetPending_.store(false);
+}
+
 float AudioFilePlayer::getSample(int channel, size_t position) {
     if (!loaded_ || position >= totalSamples_) {
         return 0.0f;
@@ -156,14 +187,12 @@ float AudioFilePlayer::getSample(int channel, size_t position) {
 }
 
 void AudioFilePlayer::prepare(int sampleRate, int maxBufferSize) {
-    engineSampleRate_ = sampleRate;
-    
     // Update resampling if needed
     std::lock_guard<std::mutex> lock(dataMutex_);
-    if (loaded_ && fileSampleRate_ != engineSampleRate_) {
-        needsResampling_ = true;
-        resampler_ = std::make_unique<Resampler>();
-        resampler_->initialize(fileSampleRate_, engineSampleRate_, fileChannels_);
+    engineSampleRate_ = sampleRate;
+    maxBufferSize_ = std::max(1, maxBufferSize);
+    configureResampler();
+    if (needsResampling_) {
         std::cout << "Resampler prepared: " << fileSampleRate_ << " Hz -> " << engineSampleRate_ << " Hz" << std::endl;
     }
 }
@@ -181,68 +210,111 @@ void AudioFilePlayer::process(float** inputs, float** outputs, int numChannels,
     
     std::lock_guard<std::mutex> lock(dataMutex_);
     
+    if (needsResampling_ && resampler_) {
+        processResampled(outputs, numChannels, numFrames);
+        return;
+    }
+    
     size_t currentPos = playbackPosition_.load();
     
-    if (needsResampling_ && resampler_) {
-        // TODO: Implement proper resampling in process loop
-        // For now, use simple nearest-neighbor sampling
-        for (int frame = 0; frame < numFrames; ++frame) {
-            if (currentPos >= totalSamples_) {
-                if (looping_) {
-                    currentPos = 0;
-                } else {
-                    // Fill remaining with silence
-                    for (int ch = 0; ch < numChannels; ++ch) {
-                        for (int f = frame; f < numFrames; ++f) {
-                            outputs[ch][f] = 0.0f;
-                        }
+    // No resampling needed - direct playback
+    for (int frame = 0; frame < numFrames; ++frame) {
+        if (currentPos >= totalSamples_) {
+            if (looping_) {
+                currentPos = 0;
+            } else {
+                // Fill remaining with silence
+                for (int ch = 0; ch < numChannels; ++ch) {
+                    for (int f = frame; f < numFrames; ++f) {
+                        outputs[ch][f] = 0.0f;
                     }
-                    playing_.store(false);
-                    playbackPosition_.store(0);
-                    return;
                 }
+                playing_.store(false);
+                playbackPosition_.store(0);
+                return;
+            }
+        }
+        
+        // Read and output samples
+        for (int ch = 0; ch < numChannels; ++ch) {
+            float sample = getSample(ch, currentPos) * volume_;
+            outputs[ch][frame] = sample;
+        }
+        
+        currentPos++;
+    }
+    
+    playbackPosition_.store(currentPos);
+}
+
+void AudioFilePlayer::processResampled(float** outputs, int numChannels, int numFrames) {
+    if (resamplerResetPending_.exchange(false)) {
+        resampler_->reset();
+        drainFramesRemaining_ = resampler_->getLatency();
+    }
+    
+    size_t currentPos = playbackPosition_.load();
+    int produced = 0;
+    
+    while (produced < numFrames) {
+        int wanted = std::min(numFrames - produced, maxBufferSize_);
+        int got = 0;
+        bool finished = false;
+        
+        // Pull file audio through the resampler; its history carries over
+        // between blocks and across the loop point
+        while (got < wanted) {
+            const float* const* source;
+            int available;
+            bool fromFile = currentPos < totalSamples_;
+            if (fromFile) {
+                for (int ch = 0; ch < fileChannels_; ++ch) {
+                    resampleInputs_[ch] = audioData_[ch].data() + currentPos;
+                }
+                source = resampleInputs_.data();
+                available = static_cast<int>(std::min<size_t>(totalSamples_ - currentPos, 1 << 20));
+            } else if (looping_) {
+                currentPos = 0;
+                continue;
+            } else if (drainFramesRemaining_ > 0) {
+                source = silenceInputs_.data();
+                available = drainFramesRemaining_;
+            } else {
+                finished = true;
+                break;
             }
             
-            // Convert engine sample position to file sample position
-            double filePos = static_cast<double>(currentPos);
-            size_t fileSample = static_cast<size_t>(filePos);
-            
-            // Read and output samples
-            for (int ch = 0; ch < numChannels; ++ch) {
-                float sample = getSample(ch, fileSample) * volume_;
-                outputs[ch][frame] = sample;
+            for (int ch = 0; ch < fileChannels_; ++ch) {
+                resampleOutputs_[ch] = resampleBuffers_[ch].data() + got;
             }
             
-            // Advance playback position (accounting for sample rate difference)
-            double advance = static_cast<double>(fileSampleRate_) / engineSampleRate_;
-            currentPos = static_cast<size_t>(filePos + advance);
+            int used = 0;
+            got += resampler_->process(source, available, resampleOutputs_.data(), wanted - got, used);
+            if (fromFile) {
+                currentPos += used;
+            } else {
+                drainFramesRemaining_ -= used;
+            }
         }
-    } else {
-        // No resampling needed - direct playback
-        for (int frame = 0; frame < numFrames; ++frame) {
-            if (currentPos >= totalSamples_) {
-                if (looping_) {
-                    currentPos = 0;
-                } else {
-                    // Fill remaining with silence
-                    for (int ch = 0; ch < numChannels; ++ch) {
-                        for (int f = frame; f < numFrames; ++f) {
-                            outputs[ch][f] = 0.0f;
-                        }
-                    }
-                    playing_.store(false);
-                    playbackPosition_.store(0);
-                    return;
-                }
+        
+        // Handle channel mapping
+        for (int ch = 0; ch < numChannels; ++ch) {
+            const float* source = resampleBuffers_[std::min(ch, fileChannels_ - 1)].data();
+            for (int frame = 0; frame < got; ++frame) {
+                outputs[ch][produced + frame] = source[frame] * volume_;
             }
-            
-            // Read and output samples
+        }
+        produced += got;
+        
+        if (finished) {
+            // Fill remaining with silence
             for (int ch = 0; ch < numChannels; ++ch) {
-                float sample = getSample(ch, currentPos) * volume_;
-                outputs[ch][frame] = sample;
+                std::fill(outputs[ch] + produced, outputs[ch] + numFrames, 0.0f);
             }
-            
-            currentPos++;
+            playing_.store(false);
+            playbackPosition_.store(0);
+            resamplerResetPending_.store(true);
+            return;
         }
     }
     
@@ -9,70 +9,6 @@ namespace OmegaDAW {
 constexpr float PI = 3.14159265358979323846f;
 constexpr float TWO_PI = 2.0f * PI;
 
-// FFTProcessor implementation
-FFTProcessor::FFTProcessor(int fftSize) : fftSize_(fftSize) {
-    computeTwiddles();
-}
-
-FFTProcessor::~FFTProcessor() {
-}
-
-void FFTProcessor::computeTwiddles() {
-    twiddles_.resize(fftSize_);
-    for (int i = 0; i < fftSize_; ++i) {
-        float angle = -TWO_PI * i / fftSize_;
-        twiddles_[i] = std::complex<float>(std::cos(angle), std::sin(angle));
-    }
-}
-
-void FFTProcessor::forward(const float* input, std::complex<float>* output) {
-    for (int i = 0; i < fftSize_; ++i) {
-        output[i] = std::complex<float>(input[i], 0.0f);
-    }
-    fft(output, fftSize_, false);
-}
-
-void FFTProcessor::inverse(const std::complex<float>* input, float* output) {
-    std::vector<std::complex<float>> temp(input, input + fftSize_);
-    fft(temp.data(), fftSize_, true);
-    
-    for (int i = 0; i < fftSize_; ++i) {
-        output[i] = temp[i].real() / fftSize_;
-    }
-}
-
-void FFTProcessor::fft(std::complex<float>* data, int n, bool inverse) {
-    // Bit-reversal permutation
-    for (int i = 1, j = 0; i < n; ++i) {
-        int bit = n >> 1;
-        for (; j & bit; bit >>= 1) {
-            j ^= bit;
-        }
-        j ^= bit;
-        
-        if (i < j) {
-            std::swap(data[i], data[j]);
-        }
-    }
-    
-    // Cooley-Tukey FFT
-    for (int len = 2; len <= n; len <<= 1) {
-        float angle = (inverse ? TWO_PI : -TWO_PI) / len;
-        std::complex<float> wlen(std::cos(angle), std::sin(angle));
-        
-        for (int i = 0; i < n; i += len) {
-            std::complex<float> w(1.0f, 0.0f);
-            for (int j = 0; j < len / 2; ++j) {
-                std::complex<float> u = data[i + j];
-                std::complex<float> v = data[i + j + len / 2] * w;
-                data[i + j] = u + v;
-                data[i + j + len / 2] = u - v;
-                w *= wlen;
-            }
-        }
-    }
-}
-
 // PhaseVocoder implementation
 PhaseVocoder::PhaseVocoder() 
     : sampleRate_(48000)
@@ -81,8 +17,7 @@ PhaseVocoder::PhaseVocoder()
     , timeStretchFactor_(1.0f)
     , pitchShift_(0.0f)
     , formantPreservation_(false)
-    , inputPos_(0)
-    , outputPos_(0) {
+    , transientHandling_(true) {
 }
 
 PhaseVocoder::~PhaseVocoder() {
@@ -90,33 +25,52 @@ PhaseVocoder::~PhaseVocoder() {
 
 void PhaseVocoder::prepare(int sampleRate, int maxBufferSize) {
     sampleRate_ = sampleRate;
-    fft_ = std::make_unique<FFTProcessor>(fftSize_);
-    
-    inputBuffer_.resize(2);  // Stereo
-    outputBuffer_.resize(2);
-    for (int i = 0; i < 2; ++i) {
-        inputBuffer_[i].resize(fftSize_ * 4, 0.0f);
-        outputBuffer_[i].resize(fftSize_ * 4, 0.0f);
+    stft_.prepare(2, fftSize_, fftSize_ / hopSize_);
+    stft_.setCallback([this](int channel, std::complex<float>* bins, int numBins) {
+        processSpectrum(channel, bins, numBins);
+    });
+    vocoders_.resize(2);
+    for (auto& vocoder : vocoders_) {
+        vocoder.prepare(fftSize_, sampleRate);
     }
-    
-    frequencyData_.resize(fftSize_);
-    lastPhase_.resize(fftSize_, 0.0f);
-    phaseSum_.resize(fftSize_, 0.0f);
+    work_.assign(FFTPlan::get(fftSize_)->getWorkSize(), 0.0f);
 }
 
 void PhaseVocoder::setPitchShift(float semitones) {
-    pitchShift_ = semitones;
+    pitchShift_ = std::max(-24.0f, std::min(24.0f, semitones));
+}
+
+StretchSettings PhaseVocoder::getStretchSettings() const {
+    StretchSettings settings;
+    settings.timeStretch = timeStretchFactor_;
+    settings.pitchShift = pitchShift_;
+    settings.formantPreservation = formantPreservation_;
+    return settings;
 }
 
 void PhaseVocoder::process(float** inputs, float** outputs, int numChannels, int numFrames) {
-    if (!fft_) return;
+    if (isBypassed() || vocoders_.empty()) {
+        return;
+    }
     
-    // Simple passthrough for now - full implementation would be complex
-    if (inputs) {
-        for (int ch = 0; ch < numChannels; ++ch) {
-            std::memcpy(outputs[ch], inputs[ch], numFrames * sizeof(float));
-        }
+    const float* in[2];
+    int channels = std::min(numChannels, 2);
+    for (int ch = 0; ch < channels; ++ch) {
+        in[ch] = (inputs && inputs[ch]) ? inputs[ch] : outputs[ch];
     }
+    stft_.process(in, outputs, channels, numFrames);
+}
+
+void PhaseVocoder::processSpectrum(int channel, std::complex<float>* spectrum, int numBins) {
+    PhaseLockedVocoder& vocoder = vocoders_[channel];
+    if (pitchShift_ == 0.0f) {
+        // Untouched frames reconstruct the input; the next shifted frame
+        // starts from their phases, so switching on doesn't click
+        vocoder.reset();
+        return;
+    }
+    const float ratio = std::pow(2.0f, pitchShift_ / 12.0f);
+    vocoder.processFrame(spectrum, hopSize_, hopSize_, ratio, formantPreservation_, transientHandling_, work_.data());
 }
 
 // SpectralProcessor implementation
@@ -127,7 +81,6 @@ SpectralProcessor::SpectralProcessor()
     , processMode_(SPECTRAL_GATE)
     , threshold_(-40.0f)
     , amount_(1.0f)
-    , bufferPos_(0)
     , spectrumFrozen_(false) {
 }
 
@@ -136,58 +89,88 @@ SpectralProcessor::~SpectralProcessor() {
 
 void SpectralProcessor::prepare(int sampleRate, int maxBufferSize) {
     sampleRate_ = sampleRate;
-    fft_ = std::make_unique<FFTProcessor>(fftSize_);
-    
-    inputBuffer_.resize(2);
-    outputBuffer_.resize(2);
-    for (int i = 0; i < 2; ++i) {
-        inputBuffer_[i].resize(fftSize_ * 2, 0.0f);
-        outputBuffer_[i].resize(fftSize_ * 2, 0.0f);
+    stft_.prepare(2, fftSize_, fftSize_ / hopSize_);
+    stft_.setCallback([this](int channel, std::complex<float>* bins, int numBins) {
+        processSpectrum(channel, bins, numBins);
+    });
+    frozenSpectrum_.assign(2, std::vector<std::complex<float>>(stft_.getNumBins()));
+    freezeAdvance_.resize(stft_.getNumBins());
+    for (int i = 0; i < stft_.getNumBins(); ++i) {
+        freezeAdvance_[i] = std::polar(1.0f, TWO_PI * ((i * hopSize_) % fftSize_) / fftSize_);
     }
-    
-    frequencyData_.resize(fftSize_);
-    frozenSpectrum_.resize(fftSize_);
 }
 
 void SpectralProcessor::process(float** inputs, float** outputs, int numChannels, int numFrames) {
-    if (!fft_ || !inputs) {
+    if (isBypassed() || frozenSpectrum_.empty()) {
         return;
     }
     
-    // Simple passthrough for now
-    for (int ch = 0; ch < numChannels; ++ch) {
-        std::memcpy(outputs[ch], inputs[ch], numFrames * sizeof(float));
+    const float* in[2];
+    int channels = std::min(numChannels, 2);
+    for (int ch = 0; ch < channels; ++ch) {
+        in[ch] = (inputs && inputs[ch]) ? inputs[ch] : outputs[ch];
     }
+    stft_.process(in, outputs, channels, numFrames);
 }
 
-void SpectralProcessor::processSpectrum(std::complex<float>* spectrum, int numBins) {
+void SpectralProcessor::processSpectrum(int channel, std::complex<float>* spectrum, int numBins) {
+    // Compare powers rather than magnitudes in dB: no sqrt or log per bin
+    const float scale = stft_.getAmplitudeScale();
+    const float thresholdPower = std::pow(10.0f, threshold_ / 10.0f) / (scale * scale);
+    
     switch (processMode_) {
         case SPECTRAL_GATE: {
+            const float gain = 1.0f - amount_;
             for (int i = 0; i < numBins; ++i) {
-                float magnitude = std::abs(spectrum[i]);
-                float magnitudeDB = 20.0f * std::log10(magnitude + 1e-10f);
-                if (magnitudeDB < threshold_) {
-                    spectrum[i] *= (1.0f - amount_);
+                if (std::norm(spectrum[i]) < thresholdPower) {
+                    spectrum[i] *= gain;
+                }
+            }
+            break;
+        }
+        
+        case SPECTRAL_COMPRESSOR: {
+            // Up to 4:1 above the threshold, bin by bin
+            const float ratio = 1.0f + 3.0f * amount_;
+            const float exponent = 0.5f * (1.0f / ratio - 1.0f);
+            for (int i = 0; i < numBins; ++i) {
+                float power = std::norm(spectrum[i]);
+                if (power > thresholdPower) {
+                    spectrum[i] *= std::pow(power / thresholdPower, exponent);
                 }
             }
             break;
         }
         
         case SPECTRAL_FREEZE: {
+            std::complex<float>* frozen = frozenSpectrum_[channel].data();
             if (spectrumFrozen_) {
+                // Keep each bin turning at its own frequency, or every hop
+                // would repeat the same frame
                 for (int i = 0; i < numBins; ++i) {
-                    spectrum[i] = frozenSpectrum_[i];
+                    frozen[i] *= freezeAdvance_[i];
+                    spectrum[i] = frozen[i];
                 }
             } else {
                 for (int i = 0; i < numBins; ++i) {
-                    frozenSpectrum_[i] = spectrum[i];
+                    frozen[i] = spectrum[i];
                 }
             }
             break;
         }
         
-        default:
+        case HARMONIC_ENHANCER: {
+            // Each bin's second harmonic: double the phase, keep the
+            // magnitude. Top down, so no bin is read after it was added to.
+            const float gain = 0.25f * amount_;
+            for (int i = (numBins - 1) / 2; i >= 1; --i) {
+                float magnitude = std::abs(spectrum[i]);
+                if (magnitude > 0.0f) {
+                    spectrum[2 * i] += spectrum[i] * spectrum[i] * (gain / magnitude);
+                }
+            }
             break;
+        }
     }
 }
 
@@ -200,7 +183,7 @@ AudioAnalyzer::AudioAnalyzer(int sampleRate, int fftSize)
     
     fft_ = std::make_unique<FFTProcessor>(fftSize_);
     inputBuffer_.resize(fftSize_, 0.0f);
-    frequencyData_.resize(fftSize_);
+    frequencyData_.resize(fft_->getNumBins());
     spectrum_.resize(fftSize_ / 2);
     window_.resize(fftSize_);
     
@@ -0,0 +1,274 @@
+#include "AudioThreadPool.h"
+#include "DenormalGuard.h"
+#include "RealtimeSafety.h"
+#include "ScratchArena.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <dispatch/dispatch.h>
+#include <pthread.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <iostream>
+
+namespace OmegaDAW {
+
+namespace {
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// Raise the calling worker to real-time priority where allowed. Workers are
+// not pinned: a worker hard-pinned to the core the callback thread spins on
+// at a higher priority would never run.
+void configureWorkerThread(int workerIndex) {
+#ifdef _WIN32
+    (void)workerIndex;
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+#else
+    sched_param param;
+    param.sched_priority = sched_get_priority_max(SCHED_FIFO) - 1;
+    int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (result != 0 && workerIndex == 0) {
+        std::cerr << "Audio worker threads running without SCHED_FIFO (error " << result << ")" << std::endl;
+    }
+#endif
+}
+
+} // namespace
+
+// RealtimeSemaphore implementation
+
+RealtimeSemaphore::RealtimeSemaphore() {
+#ifdef _WIN32
+    handle_ = CreateSemaphore(nullptr, 0, 0x7fffffff, nullptr);
+#elif defined(__APPLE__)
+    handle_ = dispatch_semaphore_create(0);
+#else
+    sem_t* semaphore = new sem_t;
+    sem_init(semaphore, 0, 0);
+    handle_ = semaphore;
+#endif
+}
+
+RealtimeSemaphore::~RealtimeSemaphore() {
+#ifdef _WIN32
+    CloseHandle(static_cast<HANDLE>(handle_));
+#elif defined(__APPLE__)
+    dispatch_release(static_cast<dispatch_semaphore_t>(handle_));
+#else
+    sem_t* semaphore = static_cast<sem_t*>(handle_);
+    sem_destroy(semaphore);
+    delete semaphore;
+#endif
+}
+
+void RealtimeSemaphore::post(int count) {
+#ifdef _WIN32
+    ReleaseSemaphore(static_cast<HANDLE>(handle_), count, nullptr);
+#elif defined(__APPLE__)
+    for (int i = 0; i < count; ++i) {
+        dispatch_semaphore_signal(static_cast<dispatch_semaphore_t>(handle_));
+    }
+#else
+    for (int i = 0; i < count; ++i) {
+        sem_post(static_cast<sem_t*>(handle_));
+    }
+#endif
+}
+
+void RealtimeSemaphore::wait() {
+#ifdef _WIN32
+    WaitForSingleObject(static_cast<HANDLE>(handle_), INFINITE);
+#elif defined(__APPLE__)
+    dispatch_semaphore_wait(static_cast<dispatch_semaphore_t>(handle_), DISPATCH_TIME_FOREVER);
+#else
+    while (sem_wait(static_cast<sem_t*>(handle_)) != 0 && errno == EINTR) {
+    }
+#endif
+}
+
+// RealtimeThreadPool implementation
+
+RealtimeThreadPool::RealtimeThreadPool(int numWorkers)
+    : wakeSemaphore_(std::make_unique<RealtimeSemaphore>())
+    , running_(false)
+    , task_(nullptr)
+    , context_(nullptr)
+    , numParticipants_(1)
+    , remainingTasks_(0)
+    , job_(0) {
+    startWorkers(numWorkers < 0 ? getDefaultWorkerCount() : numWorkers);
+}
+
+RealtimeThreadPool::~RealtimeThreadPool() {
+    stopWorkers();
+}
+
+int RealtimeThreadPool::getDefaultWorkerCount() {
+    int numCores = static_cast<int>(std::thread::hardware_concurrency());
+    return std::max(0, numCores - 1);
+}
+
+void RealtimeThreadPool::setWorkerCount(int numWorkers) {
+    numWorkers = std::max(0, numWorkers);
+    if (numWorkers == getWorkerCount()) {
+        return;
+    }
+    stopWorkers();
+    startWorkers(numWorkers);
+}
+
+void RealtimeThreadPool::startWorkers(int numWorkers) {
+    numParticipants_ = numWorkers + 1;
+    ranges_.reset(new WorkRange[numParticipants_]);
+    for (int i = 0; i < numParticipants_; ++i) {
+        ranges_[i].next.store(0);
+        ranges_[i].end = 0;
+    }
+
+    running_.store(true);
+    for (int i = 0; i < numWorkers; ++i) {
+        workers_.emplace_back(&RealtimeThreadPool::workerLoop, this, i);
+    }
+}
+
+void RealtimeThreadPool::stopWorkers() {
+    running_.store(false);
+    wakeSemaphore_->post(static_cast<int>(workers_.size()));
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+}
+
+void RealtimeThreadPool::workerLoop(int workerIndex) {
+    configureWorkerThread(workerIndex);
+    DenormalMode::enableFlushToZero();
+    ScratchArena::getForThread();  // Set up outside any real-time section
+
+    uint64_t lastGeneration = 0;  // Jobs start at generation 1
+    while (true) {
+        wakeSemaphore_->wait();
+        if (!running_.load()) {
+            break;
+        }
+
+        // Join the open job unless this worker already ran it; a wake-up
+        // left over from a finished job finds it closed
+        uint64_t state = job_.load(std::memory_order_acquire);
+        bool joined = false;
+        while ((state & kJobOpen) != 0 && (state >> 32) != lastGeneration) {
+            if (job_.compare_exchange_weak(state, state + 1, std::memory_order_acq_rel,
+                                           std::memory_order_acquire)) {
+                joined = true;
+                break;
+            }
+        }
+        if (!joined) {
+            continue;
+        }
+        lastGeneration = state >> 32;
+
+        {
+            ScopedRealtimeSection realtimeSection;
+            runParticipant(workerIndex);
+        }
+
+        job_.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void RealtimeThreadPool::runParticipant(int participant) {
+    // Own range first, then steal from the others in turn
+    for (int offset = 0; offset < numParticipants_; ++offset) {
+        WorkRange& range = ranges_[(participant + offset) % numParticipants_];
+        while (true) {
+            int index = range.next.fetch_add(1, std::memory_order_relaxed);
+            if (index >= range.end) {
+                break;
+            }
+            task_(context_, index);
+            remainingTasks_.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+}
+
+void RealtimeThreadPool::parallelFor(int count, Task task, void* context) {
+    if (count <= 0) {
+        return;
+    }
+
+    int numWorkers = getWorkerCount();
+    if (numWorkers == 0 || count == 1) {
+        for (int i = 0; i < count; ++i) {
+            task(context, i);
+        }
+        return;
+    }
+
+    task_ = task;
+    context_ = context;
+    for (int p = 0; p < numParticipants_; ++p) {
+        ranges_[p].next.store(static_cast<int>(static_cast<int64_t>(count) * p / numParticipants_),
+                              std::memory_order_relaxed);
+        ranges_[p].end = static_cast<int>(static_cast<int64_t>(count) * (p + 1) / numParticipants_);
+    }
+    remainingTasks_.store(count, std::memory_order_relaxed);
+
+    // Open the next generation; the release publishes the job to workers
+    // that join it
+    uint64_t generation = ((job_.load(std::memory_order_relaxed) >> 32) + 1) & 0xffffffffu;
+    if (generation == 0) {
+        generation = 1;
+    }
+    job_.store((generation << 32) | kJobOpen, std::memory_order_release);
+
+    // No more helpers than there are tasks to share
+    wakeSemaphore_->post(std::min(numWorkers, count - 1));
+
+    // The caller takes the last range
+    runParticipant(numParticipants_ - 1);
+
+    // Barrier: all tasks done, then close the job and wait for the workers
+    // that joined it to leave, so the ranges can be rewritten by the next
+    // call. Yield after a while in case a joined worker shares this core.
+    int spins = 0;
+    auto wait = [&spins]() {
+        if (++spins < 4096) {
+            cpuRelax();
+        } else {
+            std::this_thread::yield();
+        }
+    };
+    while (remainingTasks_.load(std::memory_order_acquire) > 0) {
+        wait();
+    }
+    job_.fetch_and(~kJobOpen, std::memory_order_acq_rel);
+    while ((job_.load(std::memory_order_acquire) & kJoinedMask) != 0) {
+        wait();
+    }
+}
+
+} // namespace OmegaDAW
@@ -0,0 +1,172 @@
+#include "BiquadCascade.h"
+#include <algorithm>
+#include <cstring>
+
+namespace OmegaDAW {
+
+namespace {
+
+const BiquadCoefficients kPassThrough;
+
+void storeLane(float* runs, int lane, const BiquadCoefficients& c) {
+    runs[lane] = c.b0;
+    runs[SIMD::kBiquadLanes + lane] = c.b1;
+    runs[2 * SIMD::kBiquadLanes + lane] = c.b2;
+    runs[3 * SIMD::kBiquadLanes + lane] = c.a1;
+    runs[4 * SIMD::kBiquadLanes + lane] = c.a2;
+}
+
+} // anonymous namespace
+
+BiquadCascade::BiquadCascade()
+    : numChannels_(0)
+    , maxBlockSize_(0)
+    , groupSize_(1)
+    , passesPerGroup_(0)
+    , targetsChanged_(false)
+    , running_(false) {
+}
+
+void BiquadCascade::prepare(int numChannels, int numSections, int maxBlockSize) {
+    numChannels_ = std::max(0, numChannels);
+    maxBlockSize_ = std::max(1, maxBlockSize);
+    targets_.assign(std::max(0, numSections), BiquadCoefficients());
+
+    // Kernel steps per block for each group size: a pass of g-channel groups
+    // runs kLanes / g sections and takes that many steps - 1 to fill, and
+    // interleaving and deinterleaving g channels costs about g / 4 steps per
+    // frame
+    const int sections = getNumSections();
+    long long bestCost = -1;
+    for (int size = 1; size <= kLanes; size *= 2) {
+        int groups = (numChannels_ + size - 1) / size;
+        int passes = (sections + kLanes / size - 1) / (kLanes / size);
+        long long steps = static_cast<long long>(passes) * (maxBlockSize_ + kLanes / size - 1);
+        if (size > 1) {
+            steps += static_cast<long long>(maxBlockSize_) * size / 4;
+        }
+        long long cost = groups * steps;
+        if (bestCost < 0 || cost < bestCost) {
+            bestCost = cost;
+            groupSize_ = size;
+            passesPerGroup_ = passes;
+        }
+    }
+
+    int numGroups = (numChannels_ + groupSize_ - 1) / groupSize_;
+    passes_.assign(static_cast<size_t>(numGroups) * passesPerGroup_, Pass());
+    frames_.assign(static_cast<size_t>(maxBlockSize_) * groupSize_, 0.0f);
+    silence_.assign(maxBlockSize_, 0.0f);
+    discard_.assign(maxBlockSize_, 0.0f);
+    sources_.assign(groupSize_, nullptr);
+    dests_.assign(groupSize_, nullptr);
+
+    targetsChanged_ = true;
+    reset();
+}
+
+void BiquadCascade::reset() {
+    for (auto& pass : passes_) {
+        std::memset(pass.state, 0, sizeof(pass.state));
+    }
+    running_ = false;
+}
+
+void BiquadCascade::setSection(int section, const BiquadCoefficients& coefficients) {
+    if (section < 0 || section >= getNumSections() || targets_[section] == coefficients) {
+        return;
+    }
+    targets_[section] = coefficients;
+    targetsChanged_ = true;
+}
+
+const BiquadCoefficients& BiquadCascade::targetFor(int passInGroup, int lane) const {
+    int section = passInGroup * (kLanes / groupSize_) + lane / groupSize_;
+    return section < getNumSections() ? targets_[section] : kPassThrough;
+}
+
+void BiquadCascade::startGlides(int numFrames) {
+    const float perFrame = 1.0f / static_cast<float>(numFrames);
+    for (size_t p = 0; p < passes_.size(); ++p) {
+        Pass& pass = passes_[p];
+        int passInGroup = static_cast<int>(p) % passesPerGroup_;
+        float target[5 * kLanes];
+        for (int lane = 0; lane < kLanes; ++lane) {
+            storeLane(target, lane, targetFor(passInGroup, lane));
+        }
+        if (!running_) {
+            std::memcpy(pass.coefficients, target, sizeof(target));
+            continue;
+        }
+        pass.gliding = false;
+        for (int k = 0; k < 5 * kLanes; ++k) {
+            pass.increments[k] = (target[k] - pass.coefficients[k]) * perFrame;
+            pass.gliding = pass.gliding || pass.increments[k] != 0.0f;
+        }
+    }
+}
+
+// Land exactly on the targets, whatever the increments' rounding
+void BiquadCascade::finishGlides() {
+    for (size_t p = 0; p < passes_.size(); ++p) {
+        Pass& pass = passes_[p];
+        if (!pass.gliding) {
+            continue;
+        }
+        int passInGroup = static_cast<int>(p) % passesPerGroup_;
+        for (int lane = 0; lane < kLanes; ++lane) {
+            storeLane(pass.coefficients, lane, targetFor(passInGroup, lane));
+        }
+        pass.gliding = false;
+    }
+}
+
+void BiquadCascade::process(float* const* channels, int numChannels, int numFrames) {
+    if (numFrames <= 0 || passes_.empty()) {
+        return;
+    }
+    if (targetsChanged_) {
+        startGlides(numFrames);
+        targetsChanged_ = false;
+    }
+    running_ = true;
+
+    numChannels = std::min(numChannels, numChannels_);
+    const int numGroups = static_cast<int>(passes_.size()) / passesPerGroup_;
+    for (int group = 0; group < numGroups; ++group) {
+        const int first = group * groupSize_;
+        if (first >= numChannels) {
+            break;
+        }
+        Pass* passes = &passes_[static_cast<size_t>(group) * passesPerGroup_];
+
+        for (int offset = 0; offset < numFrames; offset += maxBlockSize_) {
+            const int count = std::min(maxBlockSize_, numFrames - offset);
+            float* frames;
+            if (groupSize_ == 1) {
+                frames = channels[first] + offset;
+            } else {
+                for (int i = 0; i < groupSize_; ++i) {
+                    bool active = first + i < numChannels;
+                    sources_[i] = active ? channels[first + i] + offset : silence_.data();
+                    dests_[i] = active ? channels[first + i] + offset : discard_.data();
+                }
+                frames = frames_.data();
+                SIMD::interleave(sources_.data(), frames, groupSize_, count);
+            }
+            for (int p = 0; p < passesPerGroup_; ++p) {
+                SIMD::biquadLanes(frames, count, groupSize_, passes[p].coefficients,
+                                  passes[p].gliding ? passes[p].increments : nullptr, passes[p].state);
+            }
+            if (groupSize_ > 1) {
+                SIMD::deinterleave(frames, dests_.data(), groupSize_, count);
+            }
+        }
+    }
+
+    // Groups past numChannels skipped their glide; they start from the
+    // targets next time they run
+    finishGlides();
+}
+
+} // namespace OmegaDAW
@@ -341,16 +341,10 @@ void EQPlugin::initialize(int sampleRate, int maxBufferSize) {
     this->sampleRate = sampleRate;
     this->maxBufferSize = maxBufferSize;
     
-    filters.resize(2);
-    for (int ch = 0; ch < 2; ++ch) {
-        filters[ch].resize(3);
-        for (int band = 0; band < 3; ++band) {
-            filters[ch][band] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
-        }
-    }
+    cascade.prepare(2, 3, maxBufferSize);
 }
 
-void EQPlugin::calculateBiquadCoeffs(BiquadFilter& filter, float freq, float Q, float gain) {
+void EQPlugin::calculateBiquadCoeffs(BiquadCoefficients& filter, float freq, float Q, float gain) {
     float K = std::tan(M_PI * freq / sampleRate);
     float V = std::pow(10.0f, std::abs(gain) / 20.0f);
     
@@ -376,39 +370,22 @@ void EQPlugin::process(float** inputs, float** outputs, int numChannels, int num
         float gain = getParameter(std::string(bands[band]) + "_gain");
         float freq = getParameter(std::string(bands[band]) + "_freq");
         
-        for (int ch = 0; ch < std::min(numChannels, 2); ++ch) {
-            calculateBiquadCoeffs(filters[ch][band], freq, 0.707f, gain);
-        }
+        BiquadCoefficients coeffs;
+        calculateBiquadCoeffs(coeffs, freq, 0.707f, gain);
+        cascade.setSection(band, coeffs);
     }
     
-    for (int ch = 0; ch < std::min(numChannels, 2); ++ch) {
-        for (int i = 0; i < numSamples; ++i) {
-            float sample = inputs[ch][i];
-            
-            for (int band = 0; band < 3; ++band) {
-                auto& f = filters[ch][band];
-                float output = f.b0 * sample + f.b1 * f.x1 + f.b2 * f.x2 
-                             - f.a1 * f.y1 - f.a2 * f.y2;
-                
-                f.x2 = f.x1;
-                f.x1 = sample;
-                f.y2 = f.y1;
-                f.y1 = output;
-                
-                sample = output;
-            }
-            
-            outputs[ch][i] = sample;
+    const int stereoChannels = std::min(numChannels, 2);
+    for (int ch = 0; ch < stereoChannels; ++ch) {
+        if (inputs[ch] != outputs[ch]) {
+            std::copy(inputs[ch], inputs[ch] + numSamples, outputs[ch]);
         }
     }
+    cascade.process(outputs, stereoChannels, numSamples);
 }
 
 void EQPlugin::reset() {
-    for (auto& channelFilters : filters) {
-        for (auto& filter : channelFilters) {
-            filter.x1 = filter.x2 = filter.y1 = filter.y2 = 0.0f;
-        }
-    }
+    cascade.reset();
 }
 
 } // namespace OmegaDAW
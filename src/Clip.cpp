@@ -43,6 +43,8 @@ float Clip::getEnvelopeAtTime(double time) const {
 AudioClip::AudioClip(double startTime, double duration)
     : Clip(ClipType::Audio, startTime, duration)
     , m_pitchShift(0.0f)
+    , m_timeStretch(1.0)
+    , m_formantPreservation(false)
     , m_reverse(false)
 {
 }
@@ -51,6 +53,11 @@ void AudioClip::setAudioData(std::shared_ptr<AudioBuffer> buffer) {
     m_audioData = buffer;
 }
 
+void AudioClip::setTimeStretch(double factor) {
+    // Also keeps split offsets, which divide by it, finite
+    m_timeStretch = std::max(kMinTimeStretch, std::min(kMaxTimeStretch, factor));
+}
+
 MIDIClip::MIDIClip(double startTime, double duration)
     : Clip(ClipType::MIDI, startTime, duration)
 {
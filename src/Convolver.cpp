@@ -0,0 +1,420 @@
+#include "Convolver.h"
+#include "SIMDKernels.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace OmegaDAW {
+
+namespace {
+
+// Each non-uniform size runs for this many partitions before the next takes over
+constexpr int kGrowth = 8;
+constexpr int kNonUniformSizes = 3;
+
+struct StagePlan {
+    int size;
+    int offset;          // First response sample
+    int numPartitions;
+    int delay;           // Extra blocks between the input and its partitions
+};
+
+bool isValidLayout(const ConvolverLayout& layout) {
+    return layout.blockSize >= 16 && (layout.blockSize & (layout.blockSize - 1)) == 0
+        && layout.maxLength >= 0;
+}
+
+// Partitions covering length samples of a response. With latency L and a
+// stage of size S starting at offset O, an output block computed when an
+// input block completes plays S samples later, so partition p must read the
+// input (O + L) / S - 1 blocks further back: every stage starts where
+// O + L is a multiple of its size.
+std::vector<StagePlan> planStages(const ConvolverLayout& layout, int length) {
+    std::vector<StagePlan> stages;
+    const int latency = layout.lowLatency ? 0 : layout.blockSize;
+    const int numSizes = layout.nonUniform ? kNonUniformSizes : 1;
+    int offset = layout.lowLatency ? layout.blockSize : 0;
+    int size = layout.blockSize;
+    while (offset < length) {
+        bool last = static_cast<int>(stages.size()) + 1 == numSizes;
+        int end = last ? length : std::min(length, kGrowth * size - latency);
+        StagePlan stage;
+        stage.size = size;
+        stage.offset = offset;
+        stage.numPartitions = (end - offset + size - 1) / size;
+        stage.delay = (offset + latency) / size - 1;
+        stages.push_back(stage);
+        offset += stage.numPartitions * size;
+        size *= kGrowth;
+    }
+    return stages;
+}
+
+// Input channels and response channels feeding one output channel; returns
+// how many (at most 2)
+int routesTo(int irChannels, int numChannels, int output, int* inputs, int* responses) {
+    if (irChannels == 1) {
+        inputs[0] = output;
+        responses[0] = 0;
+        return 1;
+    }
+    if (output >= 2) {
+        return 0;
+    }
+    if (irChannels == 2) {
+        inputs[0] = output;
+        responses[0] = output;
+        return 1;
+    }
+    // True stereo: LL, LR, RL, RR
+    int count = 0;
+    for (int input = 0; input < 2 && input < numChannels; ++input) {
+        inputs[count] = input;
+        responses[count] = 2 * input + output;
+        ++count;
+    }
+    return count;
+}
+
+} // anonymous namespace
+
+// ConvolverIR implementation
+
+std::shared_ptr<const ConvolverIR> ConvolverIR::create(const std::vector<std::vector<float>>& channels,
+                                                       const ConvolverLayout& layout) {
+    if (channels.size() != 1 && channels.size() != 2 && channels.size() != 4) {
+        std::cerr << "Convolver: impulse responses need 1, 2 or 4 channels, not "
+                  << channels.size() << std::endl;
+        return nullptr;
+    }
+    if (!isValidLayout(layout)) {
+        std::cerr << "Convolver: block size " << layout.blockSize
+                  << " is not a power of two of at least 16" << std::endl;
+        return nullptr;
+    }
+
+    int length = 0;
+    for (const auto& channel : channels) {
+        length = std::max(length, static_cast<int>(channel.size()));
+    }
+    if (length > layout.maxLength) {
+        std::cerr << "Convolver: impulse response truncated from " << length
+                  << " to " << layout.maxLength << " samples" << std::endl;
+        length = layout.maxLength;
+    }
+
+    std::shared_ptr<ConvolverIR> ir(new ConvolverIR());
+    ir->layout_ = layout;
+    ir->length_ = length;
+
+    const int blockSize = layout.blockSize;
+    std::vector<StagePlan> plans = planStages(layout, length);
+    std::vector<float> segment;
+    std::vector<float> work;
+
+    for (const auto& source : channels) {
+        auto sample = [&](int i) {
+            return i < length && i < static_cast<int>(source.size()) ? source[i] : 0.0f;
+        };
+
+        Channel channel;
+        channel.headActive = false;
+        if (layout.lowLatency) {
+            channel.reversedHead.resize(blockSize);
+            for (int i = 0; i < blockSize; ++i) {
+                channel.reversedHead[blockSize - 1 - i] = sample(i);
+                channel.headActive = channel.headActive || sample(i) != 0.0f;
+            }
+        }
+
+        for (const StagePlan& plan : plans) {
+            std::shared_ptr<const FFTPlan> fft = FFTPlan::get(2 * plan.size);
+            const int numBins = plan.size + 1;
+            segment.assign(2 * plan.size, 0.0f);
+            work.resize(fft->getWorkSize());
+
+            Stage stage;
+            stage.numPartitions = plan.numPartitions;
+            stage.spectra.resize(static_cast<size_t>(plan.numPartitions) * numBins);
+            stage.active.resize(plan.numPartitions, 0);
+            for (int p = 0; p < plan.numPartitions; ++p) {
+                // Partition in the first half, zeros in the second
+                bool nonZero = false;
+                for (int i = 0; i < plan.size; ++i) {
+                    segment[i] = sample(plan.offset + p * plan.size + i);
+                    nonZero = nonZero || segment[i] != 0.0f;
+                }
+                // Silent partitions (pre-delay, gated tails) cost nothing
+                if (nonZero) {
+                    fft->forward(segment.data(), &stage.spectra[static_cast<size_t>(p) * numBins], work.data());
+                    stage.active[p] = 1;
+                }
+            }
+            channel.stages.push_back(std::move(stage));
+        }
+        ir->channels_.push_back(std::move(channel));
+    }
+    return ir;
+}
+
+// Convolver implementation
+
+Convolver::Convolver()
+    : numChannels_(0)
+    , headGeneration_(0)
+    , headFadeRemaining_(0)
+    , publishedGeneration_(0) {
+}
+
+Convolver::~Convolver() {
+}
+
+void Convolver::prepare(int numChannels, const ConvolverLayout& layout) {
+    layout_ = layout;
+    if (!isValidLayout(layout_)) {
+        std::cerr << "Convolver: block size " << layout.blockSize
+                  << " is not a power of two of at least 16, using 128" << std::endl;
+        layout_.blockSize = 128;
+        layout_.maxLength = std::max(0, layout_.maxLength);
+    }
+    numChannels_ = std::max(0, numChannels);
+
+    std::vector<StagePlan> plans = planStages(layout_, layout_.maxLength);
+    if (plans.empty()) {
+        // Everything fits in the direct head; keep a block-sized stage for
+        // its input window
+        plans.push_back({ layout_.blockSize, 0, 0, 0 });
+    }
+
+    stages_.clear();
+    int maxSize = 0;
+    for (const StagePlan& plan : plans) {
+        Stage stage;
+        stage.size = plan.size;
+        stage.delay = plan.delay;
+        stage.ringSize = plan.numPartitions > 0 ? plan.numPartitions + plan.delay : 0;
+        stage.filled = 0;
+        stage.newest = 0;
+        stage.generation = headGeneration_;
+        stage.fft = FFTPlan::get(2 * plan.size);
+        stage.windows.assign(numChannels_, std::vector<float>(2 * plan.size, 0.0f));
+        stage.spectra.assign(numChannels_, std::vector<std::complex<float>>(
+            static_cast<size_t>(stage.ringSize) * (plan.size + 1)));
+        stage.outputs.assign(numChannels_, std::vector<float>(plan.size, 0.0f));
+        stages_.push_back(std::move(stage));
+        maxSize = std::max(maxSize, plan.size);
+    }
+
+    accumulator_.assign(maxSize + 1, std::complex<float>());
+    time_.assign(2 * maxSize, 0.0f);
+    work_.assign(2 * maxSize, 0.0f);
+    fadeBlock_.assign(maxSize, 0.0f);
+    headBlock_.assign(layout_.blockSize, 0.0f);
+    headFadeRemaining_ = 0;
+}
+
+void Convolver::reset() {
+    for (Stage& stage : stages_) {
+        for (auto& window : stage.windows) {
+            std::fill(window.begin(), window.end(), 0.0f);
+        }
+        for (auto& spectra : stage.spectra) {
+            std::fill(spectra.begin(), spectra.end(), std::complex<float>());
+        }
+        for (auto& output : stage.outputs) {
+            std::fill(output.begin(), output.end(), 0.0f);
+        }
+        stage.filled = 0;
+        stage.newest = 0;
+    }
+    headFadeRemaining_ = 0;
+}
+
+void Convolver::setImpulseResponse(std::shared_ptr<const ConvolverIR> ir) {
+    std::lock_guard<std::mutex> lock(publishMutex_);
+    std::unique_ptr<ImpulseResponses> responses(new ImpulseResponses());
+    const ImpulseResponses* published = responses_.get();
+    responses->previous = published ? published->current : nullptr;
+    responses->current = std::move(ir);
+    responses->generation = ++publishedGeneration_;
+    responses_.publish(std::move(responses));
+}
+
+const ConvolverIR* Convolver::usable(const std::shared_ptr<const ConvolverIR>& ir) const {
+    return ir && ir->layout_ == layout_ && ir->getNumChannels() > 0 ? ir.get() : nullptr;
+}
+
+void Convolver::process(const float* const* input, float* const* output, int numFrames) {
+    if (stages_.empty()) {
+        for (int ch = 0; ch < numChannels_; ++ch) {
+            std::fill(output[ch], output[ch] + numFrames, 0.0f);
+        }
+        return;
+    }
+
+    const ImpulseResponses* responses = responses_.beginRead();
+    const ConvolverIR* ir = responses ? usable(responses->current) : nullptr;
+    const ConvolverIR* previous = responses ? usable(responses->previous) : nullptr;
+    const uint64_t generation = responses ? responses->generation : 0;
+    if (generation != headGeneration_) {
+        headGeneration_ = generation;
+        headFadeRemaining_ = layout_.lowLatency ? layout_.blockSize : 0;
+    }
+
+    const int blockSize = layout_.blockSize;
+    int done = 0;
+    while (done < numFrames) {
+        // Up to the next stage boundary
+        int chunk = numFrames - done;
+        for (const Stage& stage : stages_) {
+            chunk = std::min(chunk, stage.size - stage.filled);
+        }
+
+        // Take the input first: output may be the same buffers
+        for (Stage& stage : stages_) {
+            for (int ch = 0; ch < numChannels_; ++ch) {
+                std::memcpy(stage.windows[ch].data() + stage.size + stage.filled,
+                            input[ch] + done, chunk * sizeof(float));
+            }
+        }
+
+        const int fadeFrames = std::min(chunk, headFadeRemaining_);
+        for (int ch = 0; ch < numChannels_; ++ch) {
+            float* dest = output[ch] + done;
+            std::fill(dest, dest + chunk, 0.0f);
+
+            if (layout_.lowLatency && (ir || (fadeFrames > 0 && previous))) {
+                computeHead(ir, ch, headBlock_.data(), chunk);
+                if (fadeFrames > 0) {
+                    float startGain = 1.0f - static_cast<float>(headFadeRemaining_) / blockSize;
+                    float endGain = 1.0f - static_cast<float>(headFadeRemaining_ - fadeFrames) / blockSize;
+                    computeHead(previous, ch, fadeBlock_.data(), fadeFrames);
+                    SIMD::applyGainRamp(headBlock_.data(), fadeFrames, startGain, endGain);
+                    SIMD::addWithGainRamp(headBlock_.data(), fadeBlock_.data(), fadeFrames,
+                                          1.0f - startGain, 1.0f - endGain);
+                }
+                SIMD::add(dest, headBlock_.data(), chunk);
+            }
+
+            for (const Stage& stage : stages_) {
+                SIMD::add(dest, stage.outputs[ch].data() + stage.filled, chunk);
+            }
+        }
+        headFadeRemaining_ -= fadeFrames;
+
+        for (int index = 0; index < static_cast<int>(stages_.size()); ++index) {
+            Stage& stage = stages_[index];
+            stage.filled += chunk;
+            if (stage.filled == stage.size) {
+                runStage(index, ir, previous, generation);
+            }
+        }
+        done += chunk;
+    }
+
+    responses_.endRead();
+}
+
+void Convolver::computeHead(const ConvolverIR* ir, int outputChannel, float* dest, int numFrames) {
+    std::fill(dest, dest + numFrames, 0.0f);
+    if (!ir) {
+        return;
+    }
+
+    // The first stage is always blockSize long, so its window holds the
+    // previous block and the samples of this one so far
+    const Stage& first = stages_[0];
+    const int blockSize = layout_.blockSize;
+    int inputs[2];
+    int responses[2];
+    int numRoutes = routesTo(ir->getNumChannels(), numChannels_, outputChannel, inputs, responses);
+    for (int route = 0; route < numRoutes; ++route) {
+        const ConvolverIR::Channel& channel = ir->channels_[responses[route]];
+        if (!channel.headActive) {
+            continue;
+        }
+        const float* window = first.windows[inputs[route]].data() + first.filled + 1;
+        for (int i = 0; i < numFrames; ++i) {
+            dest[i] += SIMD::dotProduct(channel.reversedHead.data(), window + i, blockSize);
+        }
+    }
+}
+
+void Convolver::runStage(int index, const ConvolverIR* ir, const ConvolverIR* previous, uint64_t generation) {
+    Stage& stage = stages_[index];
+    stage.filled = 0;
+
+    // Newest block into the delay line, then slide the window
+    if (stage.ringSize > 0) {
+        stage.newest = (stage.newest + 1) % stage.ringSize;
+        for (int ch = 0; ch < numChannels_; ++ch) {
+            stage.fft->forward(stage.windows[ch].data(),
+                               stage.spectra[ch].data() + static_cast<size_t>(stage.newest) * (stage.size + 1),
+                               work_.data());
+        }
+    }
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        std::memcpy(stage.windows[ch].data(), stage.windows[ch].data() + stage.size, stage.size * sizeof(float));
+    }
+
+    // A new response crossfades in over this stage's next block
+    const bool fading = stage.generation != generation;
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        float* dest = stage.outputs[ch].data();
+        computeStage(index, ir, ch, dest);
+        if (fading) {
+            computeStage(index, previous, ch, fadeBlock_.data());
+            SIMD::applyGainRamp(dest, stage.size, 0.0f, 1.0f);
+            SIMD::addWithGainRamp(dest, fadeBlock_.data(), stage.size, 1.0f, 0.0f);
+        }
+    }
+    stage.generation = generation;
+}
+
+void Convolver::computeStage(int index, const ConvolverIR* ir, int outputChannel, float* dest) {
+    const Stage& stage = stages_[index];
+    const int numBins = stage.size + 1;
+    bool any = false;
+
+    if (ir) {
+        int inputs[2];
+        int responses[2];
+        int numRoutes = routesTo(ir->getNumChannels(), numChannels_, outputChannel, inputs, responses);
+        for (int route = 0; route < numRoutes; ++route) {
+            const ConvolverIR::Channel& channel = ir->channels_[responses[route]];
+            if (index >= static_cast<int>(channel.stages.size())) {
+                continue;
+            }
+            const ConvolverIR::Stage& partitions = channel.stages[index];
+            const std::complex<float>* spectra = stage.spectra[inputs[route]].data();
+            for (int p = 0; p < partitions.numPartitions; ++p) {
+                if (!partitions.active[p]) {
+                    continue;
+                }
+                if (!any) {
+                    std::fill(accumulator_.begin(), accumulator_.begin() + numBins, std::complex<float>());
+                    any = true;
+                }
+                int slot = stage.newest - p - stage.delay;
+                if (slot < 0) {
+                    slot += stage.ringSize;
+                }
+                SIMD::complexMultiplyAdd(reinterpret_cast<float*>(accumulator_.data()),
+                                         reinterpret_cast<const float*>(spectra + static_cast<size_t>(slot) * numBins),
+                                         reinterpret_cast<const float*>(&partitions.spectra[static_cast<size_t>(p) * numBins]),
+                                         numBins);
+            }
+        }
+    }
+
+    if (!any) {
+        std::fill(dest, dest + stage.size, 0.0f);
+        return;
+    }
+
+    // Overlap-save: the first half of the result wrapped around; keep the second
+    stage.fft->inverse(accumulator_.data(), time_.data(), work_.data());
+    std::memcpy(dest, time_.data() + stage.size, stage.size * sizeof(float));
+}
+
+} // namespace OmegaDAW
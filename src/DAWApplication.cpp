@@ -179,8 +179,10 @@ void DAWApplication::processAudio() {
         midiSynth->processMIDIBuffer(midiBuffer);
     }
     
-    // Process arrangement
-    auto audioBuffer = arrangement->renderAtPosition(position);
+    // Process arrangement (block buffers come back when the scope closes)
+    ScratchScope scratch;
+    AudioBufferView audioBuffer = arrangement->renderAtPosition(position, audioEngine->getBufferSize(),
+                                                                scratch.getArena());
     
     // Route through mixer
     mixer->process(audioBuffer);
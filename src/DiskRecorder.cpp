@@ -0,0 +1,170 @@
+#include "DiskRecorder.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace OmegaDAW {
+
+namespace {
+constexpr int kWriteChunkFrames = 4096;
+}
+
+DiskRecorder::DiskRecorder()
+    : sampleRate_(48000)
+    , numInputChannels_(0)
+    , active_(false)
+    , stopRequested_(false)
+    , activePushes_(0)
+    , framesRecorded_(0)
+    , framesWritten_(0)
+    , droppedBlocks_(0)
+    , droppedFrames_(0)
+    , writeErrors_(0) {
+}
+
+DiskRecorder::~DiskRecorder() {
+    stop();
+}
+
+bool DiskRecorder::start(const std::vector<RecordingTrack>& tracks, int sampleRate,
+                         int numInputChannels, double bufferSeconds) {
+    if (active_.load() || writerThread_.joinable()) {
+        std::cerr << "Disk recorder already running" << std::endl;
+        return false;
+    }
+
+    if (tracks.empty() || numInputChannels <= 0 || sampleRate <= 0) {
+        std::cerr << "Disk recorder: nothing to record" << std::endl;
+        return false;
+    }
+
+    tracks_.clear();
+    for (const auto& track : tracks) {
+        if (track.firstChannel < 0 || track.numChannels <= 0 ||
+            track.firstChannel + track.numChannels > numInputChannels) {
+            std::cerr << "Disk recorder: channel range of " << track.path << " is outside the input" << std::endl;
+            tracks_.clear();
+            return false;
+        }
+
+        auto trackWriter = std::make_unique<TrackWriter>();
+        trackWriter->track = track;
+        FileIOResult result = trackWriter->writer.open(track.path, FileFormat::WAV, sampleRate, track.numChannels);
+        if (!result.success) {
+            std::cerr << "Disk recorder: cannot create " << track.path << ": " << result.errorMessage << std::endl;
+            tracks_.clear();
+            return false;
+        }
+        trackWriter->buffer.resize(static_cast<size_t>(kWriteChunkFrames) * track.numChannels);
+        tracks_.push_back(std::move(trackWriter));
+    }
+
+    sampleRate_ = sampleRate;
+    numInputChannels_ = numInputChannels;
+
+    ring_.reset(static_cast<size_t>(bufferSeconds * sampleRate) * numInputChannels);
+    chunk_.resize(static_cast<size_t>(kWriteChunkFrames) * numInputChannels);
+
+    framesRecorded_.store(0);
+    framesWritten_.store(0);
+    droppedBlocks_.store(0);
+    droppedFrames_.store(0);
+    writeErrors_.store(0);
+
+    stopRequested_.store(false);
+    writerThread_ = std::thread(&DiskRecorder::writerLoop, this);
+    active_.store(true);
+
+    std::cout << "Disk recording started (" << tracks_.size() << " tracks, "
+              << (ring_.getCapacity() / numInputChannels / static_cast<double>(sampleRate))
+              << " s buffer)" << std::endl;
+    return true;
+}
+
+void DiskRecorder::stop() {
+    if (!writerThread_.joinable()) {
+        return;
+    }
+
+    active_.store(false);
+
+    // Let a callback that saw active_ == true finish its push
+    while (activePushes_.load() > 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    stopRequested_.store(true);
+    wakeSemaphore_.post();
+    writerThread_.join();
+
+    for (auto& trackWriter : tracks_) {
+        trackWriter->writer.close();
+    }
+    tracks_.clear();
+
+    std::cout << "Disk recording stopped: " << getRecordedSeconds() << " s recorded, "
+              << droppedBlocks_.load() << " blocks dropped" << std::endl;
+}
+
+void DiskRecorder::pushBlock(const float* input, int numFrames) {
+    if (!input || numFrames <= 0) {
+        return;
+    }
+
+    activePushes_.fetch_add(1);
+    if (active_.load()) {
+        size_t numSamples = static_cast<size_t>(numFrames) * numInputChannels_;
+        if (ring_.tryWrite(input, numSamples)) {
+            framesRecorded_.fetch_add(numFrames, std::memory_order_relaxed);
+            wakeSemaphore_.post();
+        } else {
+            droppedBlocks_.fetch_add(1, std::memory_order_relaxed);
+            droppedFrames_.fetch_add(numFrames, std::memory_order_relaxed);
+        }
+    }
+    activePushes_.fetch_sub(1);
+}
+
+double DiskRecorder::getRecordedSeconds() const {
+    return static_cast<double>(framesRecorded_.load()) / sampleRate_;
+}
+
+void DiskRecorder::writerLoop() {
+    while (true) {
+        wakeSemaphore_.wait();
+        drain();
+
+        if (stopRequested_.load()) {
+            // The producer has stopped; pick up anything pushed before it did
+            drain();
+            break;
+        }
+    }
+}
+
+void DiskRecorder::drain() {
+    const size_t frameSize = static_cast<size_t>(numInputChannels_);
+
+    while (ring_.getNumReadable() >= frameSize) {
+        size_t numFrames = std::min(ring_.getNumReadable() / frameSize, static_cast<size_t>(kWriteChunkFrames));
+        ring_.read(chunk_.data(), numFrames * frameSize);
+
+        for (auto& trackWriter : tracks_) {
+            const RecordingTrack& track = trackWriter->track;
+            float* dest = trackWriter->buffer.data();
+            for (size_t frame = 0; frame < numFrames; ++frame) {
+                const float* source = chunk_.data() + frame * frameSize + track.firstChannel;
+                std::copy(source, source + track.numChannels, dest + frame * track.numChannels);
+            }
+
+            FileIOResult result = trackWriter->writer.writeSamples(dest, numFrames * track.numChannels);
+            if (!result.success) {
+                writeErrors_.fetch_add(1);
+            }
+        }
+
+        framesWritten_.fetch_add(numFrames);
+    }
+}
+
+} // namespace OmegaDAW
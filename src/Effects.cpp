@@ -86,6 +86,11 @@ void Delay::process(float** inputs, float** outputs, int numChannels, int numFra
     }
 }
 
+double Delay::getTailLengthSeconds() const {
+    // Echoes repeat every delay time, scaled by the feedback each pass
+    return feedbackTailSeconds(feedback_, delayTimeMs_ / 1000.0);
+}
+
 void Delay::clear() {
     for (auto& channelBuffer : channelBuffers_) {
         std::fill(channelBuffer.buffer.begin(), channelBuffer.buffer.end(), 0.0f);
@@ -178,6 +183,21 @@ void Reverb::process(float** inputs, float** outputs, int numChannels, int numFr
     }
 }
 
+double Reverb::getTailLengthSeconds() const {
+    // The longest comb rings longest
+    int longestComb = 0;
+    for (const auto& channelFilters : combFilters_) {
+        for (const auto& comb : channelFilters) {
+            longestComb = std::max(longestComb, comb.bufferSize);
+        }
+    }
+    if (longestComb == 0 || sampleRate_ <= 0) {
+        return 0.0;
+    }
+    return feedbackTailSeconds(0.7f + (roomSize_ * 0.28f),
+                               static_cast<double>(longestComb) / sampleRate_);
+}
+
 void Reverb::clear() {
     for (auto& channelFilters : combFilters_) {
         for (auto& comb : channelFilters) {
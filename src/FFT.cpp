@@ -0,0 +1,186 @@
+#include "FFT.h"
+#include "SIMDKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <mutex>
+
+namespace OmegaDAW {
+
+namespace {
+
+constexpr double kTwoPi = 6.283185307179586476925286766559;
+
+std::complex<float> unitRoot(int k, int n) {
+    double angle = -kTwoPi * k / n;
+    return std::complex<float>(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+}
+
+} // anonymous namespace
+
+// FFTPlan implementation
+
+std::shared_ptr<const FFTPlan> FFTPlan::get(int size) {
+    if (size < 4 || (size & (size - 1)) != 0) {
+        std::cerr << "FFTPlan: size " << size << " is not a power of two of at least 4" << std::endl;
+        return nullptr;
+    }
+
+    static std::mutex mutex;
+    static std::map<int, std::shared_ptr<const FFTPlan>> plans;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& plan = plans[size];
+    if (!plan) {
+        plan.reset(new FFTPlan(size));
+    }
+    return plan;
+}
+
+FFTPlan::FFTPlan(int size)
+    : size_(size)
+    , half_(size / 2) {
+
+    int bits = 0;
+    while ((1 << bits) < half_) {
+        ++bits;
+    }
+    bitReverse_.resize(half_);
+    for (int k = 0; k < half_; ++k) {
+        int reversed = 0;
+        for (int b = 0; b < bits; ++b) {
+            reversed |= ((k >> b) & 1) << (bits - 1 - b);
+        }
+        bitReverse_[k] = reversed;
+    }
+
+    // An odd number of radix-2 stages leaves the first one on its own
+    radix2First_ = (bits & 1) != 0;
+    for (int quarter = radix2First_ ? 2 : 1; 4 * quarter <= half_; quarter *= 4) {
+        passQuarters_.push_back(quarter);
+        size_t base = passTwiddles_.size();
+        passTwiddles_.resize(base + 4 * quarter);
+        for (int j = 0; j < quarter; ++j) {
+            std::complex<float> a = unitRoot(j, 2 * quarter);
+            std::complex<float> b = unitRoot(j, 4 * quarter);
+            passTwiddles_[base + j] = a.real();
+            passTwiddles_[base + quarter + j] = a.imag();
+            passTwiddles_[base + 2 * quarter + j] = b.real();
+            passTwiddles_[base + 3 * quarter + j] = b.imag();
+        }
+    }
+
+    split_.resize(half_ / 2 + 1);
+    for (int k = 0; k <= half_ / 2; ++k) {
+        split_[k] = unitRoot(k, size_);
+    }
+}
+
+void FFTPlan::transform(float* re, float* im) const {
+    if (radix2First_) {
+        for (int k = 0; k < half_; k += 2) {
+            float sumRe = re[k] + re[k + 1];
+            float sumIm = im[k] + im[k + 1];
+            re[k + 1] = re[k] - re[k + 1];
+            im[k + 1] = im[k] - im[k + 1];
+            re[k] = sumRe;
+            im[k] = sumIm;
+        }
+    }
+
+    const float* twiddles = passTwiddles_.data();
+    for (int quarter : passQuarters_) {
+        SIMD::fftRadix4(re, im, half_, quarter, twiddles);
+        twiddles += 4 * quarter;
+    }
+}
+
+void FFTPlan::forward(const float* input, std::complex<float>* output, float* work) const {
+    float* re = work;
+    float* im = work + half_;
+    for (int k = 0; k < half_; ++k) {
+        re[bitReverse_[k]] = input[2 * k];
+        im[bitReverse_[k]] = input[2 * k + 1];
+    }
+    transform(re, im);
+
+    // Z = E + iO, with E and O the spectra of the even and odd samples;
+    // X[k] = E[k] + w^k O[k] and X[half - k] = conj(E[k] - w^k O[k])
+    output[0] = std::complex<float>(re[0] + im[0], 0.0f);
+    output[half_] = std::complex<float>(re[0] - im[0], 0.0f);
+    for (int k = 1; k <= half_ / 2; ++k) {
+        int mirror = half_ - k;
+        float evenRe = 0.5f * (re[k] + re[mirror]);
+        float evenIm = 0.5f * (im[k] - im[mirror]);
+        float oddRe = 0.5f * (im[k] + im[mirror]);
+        float oddIm = -0.5f * (re[k] - re[mirror]);
+        const std::complex<float>& w = split_[k];
+        float tRe = w.real() * oddRe - w.imag() * oddIm;
+        float tIm = w.real() * oddIm + w.imag() * oddRe;
+        output[k] = std::complex<float>(evenRe + tRe, evenIm + tIm);
+        output[mirror] = std::complex<float>(evenRe - tRe, tIm - evenIm);
+    }
+}
+
+void FFTPlan::inverse(const std::complex<float>* input, float* output, float* work) const {
+    // The forward split run backwards, with the 1 / size scale folded in
+    float* re = work;
+    float* im = work + half_;
+    const float scale = 1.0f / static_cast<float>(size_);
+    re[0] = (input[0].real() + input[half_].real()) * scale;
+    im[0] = (input[0].real() - input[half_].real()) * scale;
+    for (int k = 1; k <= half_ / 2; ++k) {
+        int mirror = half_ - k;
+        const std::complex<float>& x = input[k];
+        const std::complex<float>& y = input[mirror];
+        float evenRe = (x.real() + y.real()) * scale;
+        float evenIm = (x.imag() - y.imag()) * scale;
+        float diffRe = (x.real() - y.real()) * scale;
+        float diffIm = (x.imag() + y.imag()) * scale;
+        const std::complex<float>& w = split_[k];
+        float oddRe = diffRe * w.real() + diffIm * w.imag();
+        float oddIm = diffIm * w.real() - diffRe * w.imag();
+        re[bitReverse_[k]] = evenRe - oddIm;
+        im[bitReverse_[k]] = evenIm + oddRe;
+        re[bitReverse_[mirror]] = evenRe + oddIm;
+        im[bitReverse_[mirror]] = oddRe - evenIm;
+    }
+
+    // Swapping the real and imaginary parts turns the forward transform
+    // into the inverse
+    transform(im, re);
+
+    const float* halves[2] = { re, im };
+    SIMD::interleave(halves, output, 2, half_);
+}
+
+// FFTProcessor implementation
+
+FFTProcessor::FFTProcessor(int fftSize)
+    : fftSize_(fftSize)
+    , plan_(FFTPlan::get(fftSize)) {
+    if (plan_) {
+        work_.resize(plan_->getWorkSize());
+    }
+}
+
+FFTProcessor::~FFTProcessor() {
+}
+
+void FFTProcessor::forward(const float* input, std::complex<float>* output) {
+    if (!plan_) {
+        std::fill(output, output + getNumBins(), std::complex<float>());
+        return;
+    }
+    plan_->forward(input, output, work_.data());
+}
+
+void FFTProcessor::inverse(const std::complex<float>* input, float* output) {
+    if (!plan_) {
+        std::fill(output, output + fftSize_, 0.0f);
+        return;
+    }
+    plan_->inverse(input, output, work_.data());
+}
+
+} // namespace OmegaDAW
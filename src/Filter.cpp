@@ -43,10 +43,13 @@ void BiquadFilter::setGain(float gainDB) {
     }
 }
 
+double BiquadFilter::getTailLengthSeconds() const {
+    return sampleRate_ > 0 ? biquadTailSamples(a1_, a2_) / sampleRate_ : 0.0;
+}
+
 void BiquadFilter::prepare(int sampleRate, int maxBufferSize) {
     sampleRate_ = sampleRate;
-    channelStates_.clear();
-    channelStates_.resize(8);  // Support up to 8 channels
+    cascade_.prepare(8, 1, maxBufferSize);  // Support up to 8 channels
     coefficientsNeedUpdate_ = true;
 }
 
@@ -57,17 +60,15 @@ void BiquadFilter::process(float** inputs, float** outputs, int numChannels, int
     }
     
     for (int ch = 0; ch < numChannels; ++ch) {
-        for (int frame = 0; frame < numFrames; ++frame) {
-            float input = (inputs && inputs[ch]) ? inputs[ch][frame] : outputs[ch][frame];
-            outputs[ch][frame] = processSample(input, ch);
+        if (inputs && inputs[ch] && inputs[ch] != outputs[ch]) {
+            std::copy(inputs[ch], inputs[ch] + numFrames, outputs[ch]);
         }
     }
+    cascade_.process(outputs, numChannels, numFrames);
 }
 
 void BiquadFilter::reset() {
-    for (auto& state : channelStates_) {
-        state.x1 = state.x2 = state.y1 = state.y2 = 0.0f;
-    }
+    cascade_.reset();
 }
 
 void BiquadFilter::updateCoefficients() {
@@ -138,26 +139,14 @@ void BiquadFilter::updateCoefficients() {
     b2_ = b2 / a0;
     a1_ = a1 / a0;
     a2_ = a2 / a0;
-}
-
-float BiquadFilter::processSample(float input, int channel) {
-    if (channel >= static_cast<int>(channelStates_.size())) {
-        return input;
-    }
-    
-    ChannelState& state = channelStates_[channel];
-    
-    // Direct Form II Transposed implementation
-    float output = b0_ * input + b1_ * state.x1 + b2_ * state.x2
-                 - a1_ * state.y1 - a2_ * state.y2;
-    
-    // Update state
-    state.x2 = state.x1;
-    state.x1 = input;
-    state.y2 = state.y1;
-    state.y1 = output;
     
-    return output;
+    BiquadCoefficients section;
+    section.b0 = b0_;
+    section.b1 = b1_;
+    section.b2 = b2_;
+    section.a1 = a1_;
+    section.a2 = a2_;
+    cascade_.setSection(0, section);
 }
 
 } // namespace OmegaDAW
@@ -0,0 +1,130 @@
+#include "GraphCompiler.h"
+#include <algorithm>
+#include <chrono>
+
+namespace OmegaDAW {
+
+namespace {
+
+// Longer than any block; past this without one the audio thread is idle
+constexpr std::chrono::milliseconds kIdleAfter(50);
+constexpr std::chrono::milliseconds kMaxAdoptionWait(200);
+
+int64_t nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // anonymous namespace
+
+GraphCompiler::GraphCompiler(std::function<void()> compile)
+    : compile_(std::move(compile))
+    , requested_(0)
+    , completed_(0)
+    , compileCount_(0)
+    , stopping_(false)
+    , adoptedGeneration_(0)
+    , lastBlockNanos_(0) {
+}
+
+GraphCompiler::~GraphCompiler() {
+    stop();
+}
+
+void GraphCompiler::request() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_) {
+        return;
+    }
+    ++requested_;
+    if (!thread_.joinable()) {
+        thread_ = std::thread(&GraphCompiler::threadLoop, this);
+    }
+    wake_.notify_one();
+}
+
+void GraphCompiler::compileNow() {
+    uint64_t target;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        target = requested_;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(compileMutex_);
+        compile_();
+    }
+
+    // This compile saw every edit requested before it started
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++compileCount_;
+    if (completed_ < target) {
+        completed_ = target;
+        idle_.notify_all();
+    }
+}
+
+void GraphCompiler::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t target = requested_;
+    idle_.wait(lock, [&]() { return completed_ >= target || stopping_; });
+}
+
+void GraphCompiler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        wake_.notify_one();
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    idle_.notify_all();
+}
+
+uint64_t GraphCompiler::getCompileCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return compileCount_;
+}
+
+void GraphCompiler::noteAdopted(uint64_t generation) {
+    adoptedGeneration_.store(generation, std::memory_order_release);
+    lastBlockNanos_.store(nowNanos(), std::memory_order_relaxed);
+}
+
+void GraphCompiler::waitForAdoption(uint64_t generation) {
+    const int64_t idleNanos = std::chrono::nanoseconds(kIdleAfter).count();
+    const int64_t deadline = nowNanos() + std::chrono::nanoseconds(kMaxAdoptionWait).count();
+    while (adoptedGeneration_.load(std::memory_order_acquire) < generation) {
+        int64_t now = nowNanos();
+        if (now - lastBlockNanos_.load(std::memory_order_relaxed) > idleNanos || now > deadline) {
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void GraphCompiler::threadLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [&]() { return completed_ < requested_ || stopping_; });
+        if (completed_ >= requested_) {
+            break;
+        }
+
+        // Everything requested up to here goes into this one compile
+        uint64_t target = requested_;
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> compileLock(compileMutex_);
+            compile_();
+        }
+        lock.lock();
+
+        ++compileCount_;
+        completed_ = std::max(completed_, target);
+        idle_.notify_all();
+    }
+}
+
+} // namespace OmegaDAW
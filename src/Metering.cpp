@@ -0,0 +1,173 @@
+#include "Metering.h"
+#include <algorithm>
+#include <cmath>
+
+namespace OmegaDAW {
+
+LevelMeter::LevelMeter(int numChannels)
+    : numChannels_(0)
+    , holdSamples_(static_cast<int64_t>(48000 * 1.5))
+    , peakHoldResetRequested_(false)
+    , clipResetRequested_(false) {
+    setNumChannels(numChannels);
+}
+
+void LevelMeter::setNumChannels(int numChannels) {
+    numChannels_ = std::max(0, numChannels);
+    channels_.reset(new ChannelState[numChannels_]);
+}
+
+void LevelMeter::prepare(int sampleRate, double peakHoldSeconds) {
+    holdSamples_ = static_cast<int64_t>(sampleRate * peakHoldSeconds);
+}
+
+void LevelMeter::processInterleaved(const float* buffer, int numChannels, int numFrames) {
+    if (numFrames <= 0) {
+        return;
+    }
+
+    bool resetHold = peakHoldResetRequested_.exchange(false, std::memory_order_acquire);
+    bool resetClips = clipResetRequested_.exchange(false, std::memory_order_acquire);
+
+    int channels = std::min(numChannels, numChannels_);
+    for (int ch = 0; ch < channels; ++ch) {
+        ChannelState& state = channels_[ch];
+        if (resetHold) {
+            state.heldPeak = 0.0f;
+            state.holdSamplesRemaining = 0;
+        }
+        if (resetClips) {
+            state.clips = 0;
+        }
+
+        float peak = 0.0f;
+        float sumSquares = 0.0f;
+        uint32_t clips = 0;
+        for (int frame = 0; frame < numFrames; ++frame) {
+            float sample = std::abs(buffer[frame * numChannels + ch]);
+            peak = std::max(peak, sample);
+            sumSquares += sample * sample;
+            clips += (sample >= 1.0f) ? 1u : 0u;
+        }
+
+        publish(state, peak, sumSquares, clips, numFrames);
+    }
+}
+
+void LevelMeter::processChannel(int channel, const float* samples, int numFrames) {
+    if (channel < 0 || channel >= numChannels_ || numFrames <= 0) {
+        return;
+    }
+
+    // Resets are picked up once per block (on channel 0) for every channel
+    ChannelState& state = channels_[channel];
+    if (channel == 0) {
+        applyResetRequests();
+    }
+
+    float peak = 0.0f;
+    float sumSquares = 0.0f;
+    uint32_t clips = 0;
+    for (int i = 0; i < numFrames; ++i) {
+        float sample = std::abs(samples[i]);
+        peak = std::max(peak, sample);
+        sumSquares += sample * sample;
+        clips += (sample >= 1.0f) ? 1u : 0u;
+    }
+
+    publish(state, peak, sumSquares, clips, numFrames);
+}
+
+void LevelMeter::processSilence(int numFrames) {
+    if (numFrames <= 0) {
+        return;
+    }
+
+    applyResetRequests();
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        publish(channels_[ch], 0.0f, 0.0f, 0, numFrames);
+    }
+}
+
+void LevelMeter::applyResetRequests() {
+    if (peakHoldResetRequested_.exchange(false, std::memory_order_acquire)) {
+        for (int ch = 0; ch < numChannels_; ++ch) {
+            channels_[ch].heldPeak = 0.0f;
+            channels_[ch].holdSamplesRemaining = 0;
+        }
+    }
+    if (clipResetRequested_.exchange(false, std::memory_order_acquire)) {
+        for (int ch = 0; ch < numChannels_; ++ch) {
+            channels_[ch].clips = 0;
+        }
+    }
+}
+
+void LevelMeter::publish(ChannelState& state, float peak, float sumSquares, uint32_t clips, int numFrames) {
+    // Peak hold: latch new maxima, fall back to the current peak once the hold expires
+    state.holdSamplesRemaining -= numFrames;
+    if (peak >= state.heldPeak || state.holdSamplesRemaining <= 0) {
+        state.heldPeak = peak;
+        state.holdSamplesRemaining = holdSamples_;
+    }
+    state.clips += clips;
+
+    // Odd sequence marks a write in progress
+    uint32_t sequence = state.sequence.load(std::memory_order_relaxed);
+    state.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    state.peak.store(peak, std::memory_order_relaxed);
+    state.rms.store(std::sqrt(sumSquares / numFrames), std::memory_order_relaxed);
+    state.peakHold.store(state.heldPeak, std::memory_order_relaxed);
+    state.clipCount.store(state.clips, std::memory_order_relaxed);
+
+    state.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+MeterReading LevelMeter::getReading(int channel) const {
+    MeterReading reading;
+    if (channel < 0 || channel >= numChannels_) {
+        return reading;
+    }
+
+    const ChannelState& state = channels_[channel];
+    uint32_t before;
+    uint32_t after;
+    do {
+        before = state.sequence.load(std::memory_order_acquire);
+        reading.peak = state.peak.load(std::memory_order_relaxed);
+        reading.rms = state.rms.load(std::memory_order_relaxed);
+        reading.peakHold = state.peakHold.load(std::memory_order_relaxed);
+        reading.clipCount = state.clipCount.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = state.sequence.load(std::memory_order_relaxed);
+    } while ((before & 1u) != 0 || before != after);
+
+    return reading;
+}
+
+void LevelMeter::requestPeakHoldReset() {
+    peakHoldResetRequested_.store(true, std::memory_order_release);
+}
+
+void LevelMeter::requestClipReset() {
+    clipResetRequested_.store(true, std::memory_order_release);
+}
+
+void LevelMeter::reset() {
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        ChannelState& state = channels_[ch];
+        state.heldPeak = 0.0f;
+        state.holdSamplesRemaining = 0;
+        state.clips = 0;
+        state.peak.store(0.0f);
+        state.rms.store(0.0f);
+        state.peakHold.store(0.0f);
+        state.clipCount.store(0);
+    }
+    peakHoldResetRequested_.store(false);
+    clipResetRequested_.store(false);
+}
+
+} // namespace OmegaDAW
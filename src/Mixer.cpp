@@ -1,9 +1,33 @@
 #include "Mixer.h"
+#include "SIMDKernels.h"
 #include <algorithm>
 #include <cmath>
+#include <iostream>
 
 namespace OmegaDAW {
 
+namespace {
+
+// Master sum work unit: one channel, this many frames
+constexpr int kMasterSumSliceFrames = 128;
+
+} // namespace
+
+// Per-block arguments for the parallel tasks (live on the caller's stack)
+struct Mixer::BusTaskContext {
+    const MixerPlan* plan;
+    int levelStart;
+    bool anySoloed;
+    bool firstBlock;  // First block of this plan: crossfade from the last
+};
+
+struct Mixer::MasterSumContext {
+    const MixerPlan* plan;
+    float** master;
+    int numSamples;
+    int numSlices;
+};
+
 // MixerBus implementation
 
 MixerBus::MixerBus(const std::string& name, ChannelType type)
@@ -13,12 +37,28 @@ MixerBus::MixerBus(const std::string& name, ChannelType type)
     , volume_(1.0f)
     , pan_(0.0f)
     , muted_(false)
-    , soloed_(false) {
+    , soloed_(false)
+    , sampleRate_(44100) {
+}
+
+void MixerBus::prepare(int sampleRate) {
+    sampleRate_ = sampleRate;
+    meter_.prepare(sampleRate);
 }
 
 void MixerBus::process(AudioBuffer& buffer) {
+    ScopedTiming timing(&timingStats_);
+
     if (muted_) {
         buffer.clear();
+        updateMeter(buffer);
+        return;
+    }
+    
+    // Gain and pan keep silence silent, so only the effects' tails matter
+    bool inputSilent = buffer.detectSilence();
+    if (tailTracker_.canSkip(inputSilent, getTailLengthSeconds() * sampleRate_, buffer.getNumSamples())) {
+        updateMeter(buffer);
         return;
     }
 
@@ -40,14 +80,32 @@ void MixerBus::process(AudioBuffer& buffer) {
             leftGain = 1.0f - pan_;
         }
         
-        float* leftChannel = buffer.getWritePointer(0);
-        float* rightChannel = buffer.getWritePointer(1);
-        
-        for (int i = 0; i < buffer.getNumSamples(); ++i) {
-            leftChannel[i] *= leftGain;
-            rightChannel[i] *= rightGain;
+        SIMD::applyGain(buffer.getWritePointer(0), buffer.getNumSamples(), leftGain);
+        SIMD::applyGain(buffer.getWritePointer(1), buffer.getNumSamples(), rightGain);
+    }
+    
+    updateMeter(buffer);
+}
+
+double MixerBus::getTailLengthSeconds() const {
+    double tail = 0.0;
+    for (const auto& effect : effects_) {
+        if (effect && effect->isEnabled()) {
+            tail += effect->getTailLengthSeconds();
         }
     }
+    return tail;
+}
+
+void MixerBus::updateMeter(const AudioBuffer& buffer) {
+    if (buffer.isSilent()) {
+        meter_.processSilence(buffer.getNumSamples());
+        return;
+    }
+    
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
+        meter_.processChannel(ch, buffer.getReadPointer(ch), buffer.getNumSamples());
+    }
 }
 
 void MixerBus::reset() {
@@ -56,6 +114,7 @@ void MixerBus::reset() {
             effect->reset();
         }
     }
+    tailTracker_.reset();
 }
 
 void MixerBus::setVolume(float volume) {
@@ -118,13 +177,28 @@ float MixerBus::getSendLevel(int targetBusId) const {
 // Mixer implementation
 
 Mixer::Mixer()
-    : nextBusId_(0)
+    : planGeneration_(0)
+    , processedGeneration_(0)
+    , nextBusId_(0)
     , masterBusId_(-1)
     , soloMode_(false)
     , sampleRate_(44100)
-    , bufferSize_(512) {
+    , bufferSize_(512)
+    , compiler_([this]() { compilePlan(); }) {
     
-    masterBusId_ = addBus("Master", ChannelType::Master);
+    // Set before the compiler can run
+    masterBusId_ = nextBusId_;
+    addBus("Master", ChannelType::Master);
+    compiler_.compileNow();
+}
+
+Mixer::~Mixer() {
+    // The compile step reads our members
+    compiler_.stop();
+}
+
+void Mixer::flushEdits() {
+    compiler_.flush();
 }
 
 void Mixer::initialize(int sampleRate, int bufferSize) {
@@ -133,81 +207,337 @@ void Mixer::initialize(int sampleRate, int bufferSize) {
     masterOutput_.setSize(2, bufferSize);
     
     for (auto& pair : busBuffers_) {
-        pair.second.setSize(2, bufferSize);
+        pair.second->setSize(2, bufferSize);
     }
+    
+    for (auto& pair : buses_) {
+        pair.second->prepare(sampleRate);
+    }
+    
+    flushEdits();
 }
 
 void Mixer::process() {
+    process(bufferSize_);
+}
+
+void Mixer::process(int numFrames) {
+    numFrames = std::max(0, std::min(numFrames, bufferSize_));
+    masterOutput_.setSize(masterOutput_.getNumChannels(), numFrames);
     masterOutput_.clear();
+    processRoutingGraph(true, numFrames);
+}
+
+void Mixer::processRoutingGraph(bool clearBusBuffers, int numFrames) {
+    const MixerPlan* plan = plan_.beginRead();
+    if (!plan) {
+        plan_.endRead();
+        return;
+    }
     
-    for (auto& pair : busBuffers_) {
-        pair.second.clear();
+    if (clearBusBuffers) {
+        for (const auto& buffer : plan->buffers) {
+            if (numFrames >= 0 && buffer->getNumSamples() != numFrames) {
+                buffer->setSize(buffer->getNumChannels(), numFrames);
+            }
+            buffer->clear();
+        }
     }
     
-    processRoutingGraph();
-}
-
-void Mixer::processRoutingGraph() {
     bool anySoloed = false;
-    for (const auto& pair : buses_) {
-        if (pair.second && pair.second->isSoloed()) {
+    for (const auto& bus : plan->buses) {
+        if (bus->isSoloed()) {
             anySoloed = true;
             break;
         }
     }
     
-    for (int busId : processingOrder_) {
-        auto busIt = buses_.find(busId);
-        if (busIt == buses_.end() || !busIt->second) {
-            continue;
-        }
-        
-        auto& bus = busIt->second;
-        auto& buffer = busBuffers_[busId];
+    bool firstBlock = plan->generation != processedGeneration_;
+    processedGeneration_ = plan->generation;
+    compiler_.noteAdopted(plan->generation);
+    
+    // One level at a time; the levels before have filled every input
+    BusTaskContext busContext = { plan, 0, anySoloed, firstBlock };
+    const int numLevels = static_cast<int>(plan->levelOffsets.size()) - 1;
+    for (int level = 0; level < numLevels; ++level) {
+        busContext.levelStart = plan->levelOffsets[level];
+        int levelSize = plan->levelOffsets[level + 1] - busContext.levelStart;
         
-        if (anySoloed && !bus->isSoloed() && bus->getType() != ChannelType::Master) {
-            buffer.clear();
-            continue;
+        if (threadPool_ && levelSize > 1) {
+            threadPool_->parallelFor(levelSize, &Mixer::processBusTask, &busContext);
+        } else {
+            for (int i = 0; i < levelSize; ++i) {
+                processBusTask(&busContext, i);
+            }
         }
-        
-        bus->process(buffer);
-        
-        const auto& sends = bus->getSends();
-        for (const auto& send : sends) {
-            int targetBusId = send.first;
-            float sendLevel = send.second;
-            
-            auto targetIt = busBuffers_.find(targetBusId);
-            if (targetIt != busBuffers_.end()) {
-                targetIt->second.addFrom(buffer, sendLevel);
+    }
+    
+    // Master sum split by channel and sample range; each sample still adds
+    // the buses in plan order. Silent buses are left out.
+    const int numBuses = static_cast<int>(plan->buses.size());
+    bool anySound = false;
+    for (int i = 0; i < numBuses && !anySound; ++i) {
+        anySound = i != plan->masterIndex && !plan->buffers[i]->isSilent();
+    }
+    if (anySound) {
+        int numChannels = masterOutput_.getNumChannels();
+        int numSamples = masterOutput_.getNumSamples();
+        int numSlices = (numSamples + kMasterSumSliceFrames - 1) / kMasterSumSliceFrames;
+        MasterSumContext sumContext = { plan, masterOutput_.getArrayOfWritePointers(), numSamples, numSlices };
+        if (threadPool_ && numChannels * numSlices > 1) {
+            threadPool_->parallelFor(numChannels * numSlices, &Mixer::sumToMasterTask, &sumContext);
+        } else {
+            for (int i = 0; i < numChannels * numSlices; ++i) {
+                sumToMasterTask(&sumContext, i);
             }
         }
-        
-        if (busId != masterBusId_) {
-            masterOutput_.addFrom(buffer, 1.0f);
+    }
+    
+    if (plan->masterIndex >= 0) {
+        plan->buses[plan->masterIndex]->process(masterOutput_);
+    }
+    
+    plan_.endRead();
+}
+
+void Mixer::processBusTask(void* context, int index) {
+    const BusTaskContext* task = static_cast<const BusTaskContext*>(context);
+    const MixerPlan& plan = *task->plan;
+    int busIndex = task->levelStart + index;
+    
+    MixerBus& bus = *plan.buses[busIndex];
+    AudioBuffer& buffer = *plan.buffers[busIndex];
+    bool departing = plan.departing[busIndex] != 0;
+    
+    // A removed bus is done after its fade-out block
+    if (departing && !task->firstBlock) {
+        if (!buffer.isSilent()) {
+            buffer.clear();
         }
+        return;
     }
     
-    if (masterBusId_ >= 0) {
-        auto masterBus = buses_[masterBusId_];
-        if (masterBus) {
-            masterBus->process(masterOutput_);
+    if (task->anySoloed && !bus.isSoloed() && bus.getType() != ChannelType::Master) {
+        buffer.clear();
+        bus.updateMeter(buffer);
+        return;
+    }
+    
+    for (int i = plan.inputOffsets[busIndex]; i < plan.inputOffsets[busIndex + 1]; ++i) {
+        const MixerPlan::Input& input = plan.inputs[i];
+        if (task->firstBlock && input.startLevel != input.level) {
+            buffer.addFromWithRamp(*plan.buffers[input.source], input.startLevel, input.level);
+        } else {
+            buffer.addFrom(*plan.buffers[input.source], input.level);
         }
     }
+    
+    bus.process(buffer);
+    
+    if (departing) {
+        buffer.applyGainRamp(1.0f, 0.0f);
+    }
 }
 
-void Mixer::sortBusesTopologically() {
-    processingOrder_.clear();
+void Mixer::sumToMasterTask(void* context, int index) {
+    const MasterSumContext* task = static_cast<const MasterSumContext*>(context);
+    const MixerPlan& plan = *task->plan;
+    int channel = index / task->numSlices;
+    int start = (index % task->numSlices) * kMasterSumSliceFrames;
+    int count = std::min(kMasterSumSliceFrames, task->numSamples - start);
+    float* dest = task->master[channel] + start;
     
-    for (const auto& pair : buses_) {
-        if (pair.first != masterBusId_) {
-            processingOrder_.push_back(pair.first);
+    const int numBuses = static_cast<int>(plan.buses.size());
+    for (int i = 0; i < numBuses; ++i) {
+        const AudioBuffer& buffer = *plan.buffers[i];
+        if (i == plan.masterIndex || buffer.isSilent() || channel >= buffer.getNumChannels()) {
+            continue;
+        }
+        int available = std::min(count, buffer.getNumSamples() - start);
+        if (available > 0) {
+            SIMD::add(dest, buffer.getReadPointer(channel) + start, available);
+        }
+    }
+}
+
+void Mixer::compilePlan() {
+    // Runs on the compiler thread: copy the shadow graph, then work unlocked
+    struct Node {
+        std::shared_ptr<MixerBus> bus;
+        std::shared_ptr<AudioBuffer> buffer;
+        std::map<int, float> sends;
+        bool departing;
+    };
+    std::map<int, Node> nodes;
+    {
+        std::lock_guard<std::mutex> lock(editMutex_);
+        for (const auto& pair : buses_) {
+            nodes[pair.first] = { pair.second, busBuffers_[pair.first], pair.second->getSends(), false };
+        }
+    }
+    
+    // Buses removed since the last plan stay for one block to fade out
+    if (const MixerPlan* previous = plan_.get()) {
+        for (size_t i = 0; i < previous->buses.size(); ++i) {
+            int busId = previous->buses[i]->getId();
+            if (!previous->departing[i] && !nodes.count(busId)) {
+                nodes[busId] = { previous->buses[i], previous->buffers[i], {}, true };
+            }
+        }
+    }
+    
+    // Sends into the master bus are dropped: every bus reaches it through
+    // the master sum. Sends gone since the last plan ramp down to silence.
+    struct Send {
+        int source;
+        int target;
+        float level;
+        float startLevel;
+    };
+    std::vector<Send> sends;
+    std::map<std::pair<int, int>, float> levels;
+    for (const auto& entry : nodes) {
+        for (const auto& send : entry.second.sends) {
+            if (send.first == masterBusId_ || !nodes.count(send.first)) {
+                continue;
+            }
+            auto key = std::make_pair(entry.first, send.first);
+            auto previous = compiledLevels_.find(key);
+            sends.push_back({ entry.first, send.first, send.second,
+                              previous != compiledLevels_.end() ? previous->second : 0.0f });
+            levels[key] = send.second;
+        }
+    }
+    const size_t numLiveSends = sends.size();
+    for (const auto& previous : compiledLevels_) {
+        if (!levels.count(previous.first) && nodes.count(previous.first.first) &&
+            nodes.count(previous.first.second)) {
+            sends.push_back({ previous.first.first, previous.first.second, 0.0f, previous.second });
+        }
+    }
+    
+    // Kahn's algorithm over the sends, one dependency level at a time. The
+    // master bus implicitly follows every other bus, so it stays out of the
+    // sort and goes last. If the fading sends would close a loop with the
+    // new ones, they are dropped and that change is abrupt.
+    std::vector<int> order;
+    std::vector<int> levelOffsets;
+    auto sortLevels = [&](size_t numSends) {
+        std::map<int, int> inDegree;
+        std::map<int, std::vector<int>> targetsOf;
+        for (const auto& entry : nodes) {
+            if (entry.first != masterBusId_) {
+                inDegree[entry.first] = 0;
+            }
         }
+        for (size_t i = 0; i < numSends; ++i) {
+            ++inDegree[sends[i].target];
+            targetsOf[sends[i].source].push_back(sends[i].target);
+        }
+        
+        order.clear();
+        levelOffsets = { 0 };
+        for (const auto& entry : inDegree) {
+            if (entry.second == 0) {
+                order.push_back(entry.first);
+            }
+        }
+        size_t levelStart = 0;
+        while (levelStart < order.size()) {
+            size_t levelEnd = order.size();
+            levelOffsets.push_back(static_cast<int>(levelEnd));
+            for (size_t i = levelStart; i < levelEnd; ++i) {
+                for (int target : targetsOf[order[i]]) {
+                    if (--inDegree[target] == 0) {
+                        order.push_back(target);
+                    }
+                }
+            }
+            levelStart = levelEnd;
+        }
+        return order.size() == inDegree.size();
+    };
+    
+    if (!sortLevels(sends.size())) {
+        sends.resize(numLiveSends);
+        if (!sortLevels(sends.size())) {
+            // routeAudio() refuses loops; only sends edited on a MixerBus directly get here
+            std::cerr << "Mixer: routing contains a feedback loop, keeping the previous plan" << std::endl;
+            return;
+        }
+    }
+    
+    std::map<int, int> indexOf;
+    for (int i = 0; i < static_cast<int>(order.size()); ++i) {
+        indexOf[order[i]] = i;
+    }
+    
+    // Incoming sends per bus, in source (plan) order
+    std::vector<std::vector<MixerPlan::Input>> incoming(order.size());
+    std::sort(sends.begin(), sends.end(), [&](const Send& a, const Send& b) {
+        return indexOf[a.source] < indexOf[b.source] ||
+               (a.source == b.source && a.target < b.target);
+    });
+    for (const Send& send : sends) {
+        incoming[indexOf[send.target]].push_back({ indexOf[send.source], send.level, send.startLevel });
+    }
+    
+    auto plan = std::make_unique<MixerPlan>();
+    for (int i = 0; i < static_cast<int>(order.size()); ++i) {
+        const Node& node = nodes[order[i]];
+        plan->buses.push_back(node.bus);
+        plan->buffers.push_back(node.buffer);
+        plan->departing.push_back(node.departing);
+        plan->inputOffsets.push_back(static_cast<int>(plan->inputs.size()));
+        plan->inputs.insert(plan->inputs.end(), incoming[i].begin(), incoming[i].end());
+    }
+    plan->levelOffsets = levelOffsets;
+    
+    if (nodes.count(masterBusId_)) {
+        const Node& master = nodes[masterBusId_];
+        plan->masterIndex = static_cast<int>(plan->buses.size());
+        plan->buses.push_back(master.bus);
+        plan->buffers.push_back(master.buffer);
+        plan->departing.push_back(master.departing);
+        plan->inputOffsets.push_back(static_cast<int>(plan->inputs.size()));
+    }
+    plan->inputOffsets.push_back(static_cast<int>(plan->inputs.size()));
+    
+    // Let the previous plan play its crossfade block first
+    compiler_.waitForAdoption(planGeneration_);
+    plan->generation = ++planGeneration_;
+    compiledLevels_ = levels;
+    plan_.publish(std::move(plan));
+}
+
+bool Mixer::wouldCreateCycle(int sourceBusId, int targetBusId) const {
+    // Everything feeds the master bus, so nothing can take a send from it
+    if (sourceBusId == targetBusId || sourceBusId == masterBusId_) {
+        return true;
     }
     
-    if (masterBusId_ >= 0) {
-        processingOrder_.push_back(masterBusId_);
+    // Loop if the source is already reachable from the target
+    std::vector<int> pending = { targetBusId };
+    std::vector<int> visited;
+    while (!pending.empty()) {
+        int busId = pending.back();
+        pending.pop_back();
+        if (busId == sourceBusId) {
+            return true;
+        }
+        if (busId == masterBusId_ || std::find(visited.begin(), visited.end(), busId) != visited.end()) {
+            continue;
+        }
+        visited.push_back(busId);
+        
+        auto it = buses_.find(busId);
+        if (it != buses_.end() && it->second) {
+            for (const auto& send : it->second->getSends()) {
+                pending.push_back(send.first);
+            }
+        }
     }
+    return false;
 }
 
 void Mixer::reset() {
@@ -218,7 +548,7 @@ void Mixer::reset() {
     }
     
     for (auto& pair : busBuffers_) {
-        pair.second.clear();
+        pair.second->clear();
     }
     
     masterOutput_.clear();
@@ -228,11 +558,15 @@ int Mixer::addBus(const std::string& name, ChannelType type) {
     int busId = nextBusId_++;
     auto bus = std::make_shared<MixerBus>(name, type);
     bus->setId(busId);
+    bus->prepare(sampleRate_);
     
-    buses_[busId] = bus;
-    busBuffers_[busId] = AudioBuffer(2, bufferSize_);
+    {
+        std::lock_guard<std::mutex> lock(editMutex_);
+        buses_[busId] = bus;
+        busBuffers_[busId] = std::make_shared<AudioBuffer>(2, bufferSize_);
+    }
     
-    sortBusesTopologically();
+    compiler_.request();
     
     return busId;
 }
@@ -242,16 +576,19 @@ void Mixer::removeBus(int busId) {
         return;
     }
     
-    buses_.erase(busId);
-    busBuffers_.erase(busId);
-    
-    for (auto& pair : buses_) {
-        if (pair.second) {
-            pair.second->removeSend(busId);
+    {
+        std::lock_guard<std::mutex> lock(editMutex_);
+        buses_.erase(busId);
+        busBuffers_.erase(busId);
+        
+        for (auto& pair : buses_) {
+            if (pair.second) {
+                pair.second->removeSend(busId);
+            }
         }
     }
     
-    sortBusesTopologically();
+    compiler_.request();
 }
 
 std::shared_ptr<MixerBus> Mixer::getBus(int busId) {
@@ -262,30 +599,45 @@ std::shared_ptr<MixerBus> Mixer::getBus(int busId) {
     return nullptr;
 }
 
-void Mixer::routeAudio(int sourceBusId, int targetBusId, float level) {
+bool Mixer::routeAudio(int sourceBusId, int targetBusId, float level) {
     auto sourceBus = getBus(sourceBusId);
-    if (sourceBus) {
+    if (!sourceBus || !getBus(targetBusId)) {
+        return false;
+    }
+    
+    if (wouldCreateCycle(sourceBusId, targetBusId)) {
+        std::cerr << "Mixer: send from bus " << sourceBusId << " to bus " << targetBusId
+                  << " would create a feedback loop" << std::endl;
+        return false;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(editMutex_);
         sourceBus->addSend(targetBusId, level);
-        sortBusesTopologically();
     }
+    compiler_.request();
+    return true;
 }
 
 void Mixer::removeRoute(int sourceBusId, int targetBusId) {
     auto sourceBus = getBus(sourceBusId);
     if (sourceBus) {
-        sourceBus->removeSend(targetBusId);
-        sortBusesTopologically();
+        {
+            std::lock_guard<std::mutex> lock(editMutex_);
+            sourceBus->removeSend(targetBusId);
+        }
+        compiler_.request();
     }
 }
 
 void Mixer::setBusInput(int busId, const AudioBuffer& buffer) {
     auto it = busBuffers_.find(busId);
     if (it != busBuffers_.end()) {
-        it->second.copyFrom(buffer);
+        it->second->copyFrom(buffer);
     }
 }
 
-AudioBuffer Mixer::getMasterOutput() {
+const AudioBuffer& Mixer::getMasterOutput() const {
     return masterOutput_;
 }
 
@@ -309,14 +661,56 @@ std::vector<int> Mixer::getBusIds() const {
     return ids;
 }
 
-void Mixer::process(AudioBuffer& buffer) {
+std::vector<ProcessorProfile> Mixer::getBusProfiles() const {
+    std::vector<ProcessorProfile> profiles;
+    for (const auto& pair : buses_) {
+        if (pair.second) {
+            profiles.push_back({ pair.second->getName(), pair.second->getTimingStats().getSummary() });
+        }
+    }
+    return profiles;
+}
+
+void Mixer::setWorkerThreadCount(int numThreads) {
+    if (numThreads < 0) {
+        numThreads = RealtimeThreadPool::getDefaultWorkerCount();
+    }
+    
+    if (numThreads == 0) {
+        threadPool_.reset();
+    } else if (!threadPool_) {
+        threadPool_ = std::make_unique<RealtimeThreadPool>(numThreads);
+    } else {
+        threadPool_->setWorkerCount(numThreads);
+    }
+}
+
+int Mixer::getWorkerThreadCount() const {
+    return threadPool_ ? threadPool_->getWorkerCount() : 0;
+}
+
+void Mixer::resetBusProfiles() {
+    for (auto& pair : buses_) {
+        if (pair.second) {
+            pair.second->getTimingStats().requestReset();
+        }
+    }
+}
+
+void Mixer::process(AudioBufferView buffer) {
     // Process mixer with provided buffer
-    processRoutingGraph();
+    processRoutingGraph(false);
 }
 
 void Mixer::shutdown() {
     // Shutdown mixer
-    buses_.clear();
+    {
+        std::lock_guard<std::mutex> lock(editMutex_);
+        buses_.clear();
+        busBuffers_.clear();
+    }
+    compiler_.request();
+    compiler_.flush();
 }
 
 void Mixer::loadFromProject(Project* project) {
@@ -0,0 +1,234 @@
+#include "OfflineRenderer.h"
+#include "AudioEngine.h"
+#include "DenormalGuard.h"
+#include "Mixer.h"
+#include "SIMDKernels.h"
+#include "Transport.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+namespace OmegaDAW {
+
+OfflineRenderer::OfflineRenderer()
+    : engine_(nullptr)
+    , mixer_(nullptr)
+    , transport_(nullptr)
+    , cancelRequested_(false)
+    , rendering_(false)
+    , framesRendered_(0)
+    , renderSeconds_(0.0)
+    , renderedAudioSeconds_(0.0)
+    , lastReportedProgress_(0.0f) {
+}
+
+double OfflineRenderer::getRealtimeFactor() const {
+    if (renderSeconds_ <= 0.0) {
+        return 0.0;
+    }
+    return renderedAudioSeconds_ / renderSeconds_;
+}
+
+FileIOResult OfflineRenderer::render(const OfflineRenderSettings& settings) {
+    if (settings.outputPath.empty()) {
+        return FileIOResult(FileIOError::UNKNOWN_ERROR, "No output path given");
+    }
+    if (settings.blockSize <= 0 || settings.numChannels <= 0 || settings.sampleRate <= 0) {
+        return FileIOResult(FileIOError::INVALID_FORMAT, "Invalid render configuration");
+    }
+    if (settings.lengthSeconds <= 0.0) {
+        return FileIOResult(FileIOError::INVALID_FORMAT, "Render length must be positive");
+    }
+    if (settings.bitDepth != 16) {
+        return FileIOResult(FileIOError::UNSUPPORTED_FORMAT, "Only 16-bit output is supported");
+    }
+
+    if (rendering_.exchange(true)) {
+        return FileIOResult(FileIOError::UNKNOWN_ERROR, "Render already in progress");
+    }
+    cancelRequested_.store(false);
+
+    // Put the engine in offline mode, or check the live configuration matches.
+    // An engine switched to offline mode here is switched back before returning.
+    bool enteredOfflineMode = false;
+    int livePreallocation = -1;  // Put back if raised for the render
+    if (engine_) {
+        if (!engine_->isInitialized()) {
+            if (!engine_->initializeOffline(settings.sampleRate, settings.blockSize, settings.numChannels)) {
+                rendering_.store(false);
+                return FileIOResult(FileIOError::UNKNOWN_ERROR, "Could not put the engine in offline mode");
+            }
+            enteredOfflineMode = true;
+        } else if (engine_->getSampleRate() != settings.sampleRate ||
+                   engine_->getNumChannels() != settings.numChannels) {
+            rendering_.store(false);
+            return FileIOResult(FileIOError::INVALID_FORMAT,
+                                "Render format does not match the engine configuration");
+        } else if (engine_->isPlaying()) {
+            rendering_.store(false);
+            return FileIOResult(FileIOError::UNKNOWN_ERROR, "Stop playback before rendering");
+        } else if (settings.blockSize > std::max(engine_->getBufferSize(), engine_->getPreallocatedBufferSize())) {
+            livePreallocation = engine_->getPreallocatedBufferSize();
+            engine_->preallocateBuffers(settings.blockSize);
+        }
+    }
+
+    AudioFileWriter writer;
+    FileIOResult result = writer.open(settings.outputPath, settings.format,
+                                      settings.sampleRate, settings.numChannels, settings.bitDepth);
+    if (!result.success) {
+        if (enteredOfflineMode) {
+            engine_->leaveOfflineMode();
+        } else if (livePreallocation >= 0) {
+            engine_->preallocateBuffers(livePreallocation);
+        }
+        rendering_.store(false);
+        return result;
+    }
+
+    // The mixer renders at the block size; restore its live size afterwards
+    int mixerSampleRate = 0;
+    int mixerBufferSize = 0;
+    if (mixer_) {
+        mixerSampleRate = mixer_->getSampleRate();
+        mixerBufferSize = mixer_->getBufferSize();
+        mixer_->initialize(settings.sampleRate, settings.blockSize);
+        mixer_->reset();
+    }
+
+    double transportPosition = 0.0;
+    int transportSampleRate = 0;
+    if (transport_) {
+        transportPosition = transport_->getPosition();
+        transportSampleRate = transport_->getSampleRate();
+        transport_->setSampleRate(settings.sampleRate);
+        transport_->setPosition(settings.startSeconds * transport_->getTempo() / 60.0);
+        transport_->setFreewheel(true);
+    }
+
+    std::cout << "Offline render started: " << settings.outputPath << std::endl;
+
+    auto startTime = std::chrono::steady_clock::now();
+    {
+        // Block callbacks and the mixer run on this thread too
+        ScopedNoDenormals noDenormals;
+        result = renderBlocks(settings, writer);
+    }
+    auto endTime = std::chrono::steady_clock::now();
+
+    writer.close();
+
+    renderSeconds_ = std::chrono::duration<double>(endTime - startTime).count();
+    renderedAudioSeconds_ = static_cast<double>(framesRendered_) / settings.sampleRate;
+
+    if (transport_) {
+        transport_->setFreewheel(false);
+        transport_->setSampleRate(transportSampleRate);
+        transport_->setPosition(transportPosition);
+    }
+
+    if (mixer_) {
+        mixer_->initialize(mixerSampleRate, mixerBufferSize);
+        mixer_->reset();
+    }
+
+    if (enteredOfflineMode) {
+        engine_->leaveOfflineMode();
+    } else if (livePreallocation >= 0) {
+        engine_->preallocateBuffers(livePreallocation);
+    }
+
+    if (result.success) {
+        std::cout << "Offline render finished: " << renderedAudioSeconds_ << " s of audio in "
+                  << renderSeconds_ << " s (" << getRealtimeFactor() << "x realtime)" << std::endl;
+    } else {
+        // Don't leave a truncated file behind
+        std::remove(settings.outputPath.c_str());
+        std::cerr << "Offline render stopped: " << result.errorMessage << std::endl;
+    }
+
+    rendering_.store(false);
+    return result;
+}
+
+FileIOResult OfflineRenderer::renderBlocks(const OfflineRenderSettings& settings, AudioFileWriter& writer) {
+    const int numChannels = settings.numChannels;
+    const int64_t totalFrames = static_cast<int64_t>(std::llround(settings.lengthSeconds * settings.sampleRate));
+    const int64_t startSample = static_cast<int64_t>(std::llround(settings.startSeconds * settings.sampleRate));
+
+    interleavedBuffer_.assign(static_cast<size_t>(settings.blockSize) * numChannels, 0.0f);
+    framesRendered_ = 0;
+    lastReportedProgress_ = 0.0f;
+    reportProgress(0.0f);
+
+    while (framesRendered_ < totalFrames) {
+        if (cancelRequested_.load()) {
+            return FileIOResult(FileIOError::UNKNOWN_ERROR, "Render cancelled");
+        }
+
+        int numFrames = static_cast<int>(std::min<int64_t>(settings.blockSize, totalFrames - framesRendered_));
+        float* output = interleavedBuffer_.data();
+
+        if (blockCallback_) {
+            blockCallback_(startSample + framesRendered_, numFrames);
+        }
+
+        // Mixer master bus, for this block's frames only
+        const AudioBuffer* master = nullptr;
+        if (mixer_) {
+            mixer_->process(numFrames);
+            master = &mixer_->getMasterOutput();
+        }
+
+        // Processor graph plus the mixer, through the engine's master stage
+        // (writes the whole interleaved block). Without an engine the mixer
+        // gets the same clip.
+        if (engine_) {
+            if (!engine_->processOfflineBlock(output, numFrames, master)) {
+                return FileIOResult(FileIOError::UNKNOWN_ERROR, "Engine failed to render a block");
+            }
+        } else {
+            std::fill(output, output + numFrames * numChannels, 0.0f);
+            if (master) {
+                int mixerChannels = std::min(numChannels, master->getNumChannels());
+                for (int ch = 0; ch < mixerChannels; ++ch) {
+                    const float* source = master->getReadPointer(ch);
+                    for (int frame = 0; frame < numFrames; ++frame) {
+                        output[frame * numChannels + ch] = source[frame];
+                    }
+                }
+                SIMD::softClip(output, numFrames * numChannels);
+            }
+        }
+
+        FileIOResult result = writer.writeSamples(output, static_cast<size_t>(numFrames) * numChannels);
+        if (!result.success) {
+            return result;
+        }
+
+        if (transport_) {
+            transport_->advance(numFrames);
+        }
+
+        framesRendered_ += numFrames;
+        reportProgress(static_cast<float>(framesRendered_) / static_cast<float>(totalFrames));
+    }
+
+    return FileIOResult();
+}
+
+void OfflineRenderer::reportProgress(float progress) {
+    if (!progressCallback_) {
+        return;
+    }
+
+    // Throttle to roughly one update per percent
+    if (progress >= 1.0f || progress == 0.0f || progress - lastReportedProgress_ >= 0.01f) {
+        lastReportedProgress_ = progress;
+        progressCallback_(progress);
+    }
+}
+
+} // namespace OmegaDAW
@@ -7,15 +7,19 @@ namespace OmegaDAW {
 PluginHost::PluginHost()
     : sampleRate(44100)
     , maxBufferSize(512)
+    , maxChannels(2)
 {
+    allocateIntermediateBuffers(maxChannels, maxBufferSize);
 }
 
 PluginHost::~PluginHost() {
 }
 
-void PluginHost::initialize(int sampleRate, int maxBufferSize) {
+void PluginHost::initialize(int sampleRate, int maxBufferSize, int maxChannels) {
     this->sampleRate = sampleRate;
     this->maxBufferSize = maxBufferSize;
+    this->maxChannels = maxChannels;
+    allocateIntermediateBuffers(maxChannels, maxBufferSize);
 }
 
 void PluginHost::addPlugin(std::shared_ptr<Plugin> plugin) {
@@ -47,12 +51,10 @@ std::shared_ptr<Plugin> PluginHost::getPlugin(size_t index) {
 }
 
 void PluginHost::allocateIntermediateBuffers(int numChannels, int numSamples) {
-    if (intermediateBuffers.size() != static_cast<size_t>(numChannels) ||
-        intermediateBuffers[0].size() != static_cast<size_t>(numSamples)) {
-        intermediateBuffers.clear();
-        for (int i = 0; i < numChannels; ++i) {
-            intermediateBuffers.push_back(std::vector<float>(numSamples, 0.0f));
-        }
+    intermediateBuffers.assign(numChannels, std::vector<float>(numSamples, 0.0f));
+    intermediatePointers.resize(numChannels);
+    for (int i = 0; i < numChannels; ++i) {
+        intermediatePointers[i] = intermediateBuffers[i].data();
     }
 }
 
@@ -64,13 +66,17 @@ void PluginHost::processPluginChain(float** inputs, float** outputs, int numChan
         return;
     }
     
-    allocateIntermediateBuffers(numChannels, numSamples);
+    // Called on the audio thread: fall back to passthrough rather than
+    // growing the intermediate buffers here
+    if (numChannels > maxChannels || numSamples > maxBufferSize) {
+        for (int ch = 0; ch < numChannels; ++ch) {
+            std::memcpy(outputs[ch], inputs[ch], numSamples * sizeof(float));
+        }
+        return;
+    }
     
     float** currentInput = inputs;
-    float** currentOutput = new float*[numChannels];
-    for (int ch = 0; ch < numChannels; ++ch) {
-        currentOutput[ch] = intermediateBuffers[ch].data();
-    }
+    float** currentOutput = intermediatePointers.data();
     
     for (size_t i = 0; i < pluginChain.size(); ++i) {
         auto& plugin = pluginChain[i];
@@ -91,8 +97,6 @@ void PluginHost::processPluginChain(float** inputs, float** outputs, int numChan
             }
         }
     }
-    
-    delete[] currentOutput;
 }
 
 void PluginHost::clearPlugins() {
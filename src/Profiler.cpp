@@ -0,0 +1,374 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define OMEGA_PROFILER_TSC 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace OmegaDAW {
+
+namespace {
+
+// SteadyClock first so a read before static init completes is still valid
+enum class ClockSource {
+    SteadyClock,
+    TSC,
+    ArmCounter
+};
+
+uint64_t readSteadyClock() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+#if defined(__aarch64__) && !defined(_MSC_VER)
+uint64_t readArmCounter() {
+    uint64_t value;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+}
+
+uint64_t readArmCounterFrequency() {
+    uint64_t value;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(value));
+    return value;
+}
+#endif
+
+// The TSC is only usable as a clock if it ticks at a constant rate across
+// frequency changes and sleep states
+bool hasInvariantTSC() {
+#if defined(OMEGA_PROFILER_TSC) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0x80000000);
+    if (static_cast<unsigned>(info[0]) < 0x80000007u) {
+        return false;
+    }
+    __cpuid(info, 0x80000007);
+    return (info[3] & (1 << 8)) != 0;
+#elif defined(OMEGA_PROFILER_TSC)
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007u) {
+        return false;
+    }
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    return (edx & (1u << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+ClockSource detectClockSource() {
+#if defined(__aarch64__) && !defined(_MSC_VER)
+    return ClockSource::ArmCounter;
+#else
+    return hasInvariantTSC() ? ClockSource::TSC : ClockSource::SteadyClock;
+#endif
+}
+
+const ClockSource clockSource = detectClockSource();
+
+#ifdef OMEGA_PROFILER_TSC
+// Start of the TSC calibration window, taken during static init so that by
+// the first ticksPerSecond() call the window has normally run its course
+struct CalibrationStart {
+    std::chrono::steady_clock::time_point time;
+    uint64_t ticks;
+};
+
+const CalibrationStart calibrationStart = { std::chrono::steady_clock::now(), __rdtsc() };
+#endif
+
+double calibrateTicksPerSecond() {
+    switch (clockSource) {
+#ifdef OMEGA_PROFILER_TSC
+        case ClockSource::TSC: {
+            // TSC ticks across at least 20 ms of steady_clock since startup;
+            // only a call within 20 ms of startup waits for the rest
+            auto end = std::chrono::steady_clock::now();
+            while (end - calibrationStart.time < std::chrono::milliseconds(20)) {
+                end = std::chrono::steady_clock::now();
+            }
+            uint64_t endTicks = __rdtsc();
+            double seconds = std::chrono::duration<double>(end - calibrationStart.time).count();
+            return static_cast<double>(endTicks - calibrationStart.ticks) / seconds;
+        }
+#endif
+#if defined(__aarch64__) && !defined(_MSC_VER)
+        case ClockSource::ArmCounter:
+            return static_cast<double>(readArmCounterFrequency());
+#endif
+        default:
+            return 1.0e9;
+    }
+}
+
+double toNanoseconds(uint64_t ticks) {
+    return ProfilerClock::ticksToNanoseconds(ticks);
+}
+
+} // anonymous namespace
+
+// ---------------------------------------------------------------------------
+// ProfilerClock
+
+namespace ProfilerClock {
+
+uint64_t now() {
+    switch (clockSource) {
+#ifdef OMEGA_PROFILER_TSC
+        case ClockSource::TSC:
+            return __rdtsc();
+#endif
+#if defined(__aarch64__) && !defined(_MSC_VER)
+        case ClockSource::ArmCounter:
+            return readArmCounter();
+#endif
+        default:
+            return readSteadyClock();
+    }
+}
+
+double ticksPerSecond() {
+    static const double rate = calibrateTicksPerSecond();
+    return rate;
+}
+
+double ticksToNanoseconds(uint64_t ticks) {
+    return static_cast<double>(ticks) * 1.0e9 / ticksPerSecond();
+}
+
+uint64_t secondsToTicks(double seconds) {
+    return static_cast<uint64_t>(seconds * ticksPerSecond());
+}
+
+const char* getSourceName() {
+    switch (clockSource) {
+        case ClockSource::TSC: return "tsc";
+        case ClockSource::ArmCounter: return "cntvct";
+        default: return "steady_clock";
+    }
+}
+
+} // namespace ProfilerClock
+
+// ---------------------------------------------------------------------------
+// TimingStats
+
+TimingStats::TimingStats()
+    : count_(0)
+    , totalTicks_(0)
+    , minTicks_(std::numeric_limits<uint64_t>::max())
+    , maxTicks_(0)
+    , resetRequested_(false) {
+    for (auto& bin : bins_) {
+        bin.store(0, std::memory_order_relaxed);
+    }
+}
+
+int TimingStats::binForTicks(uint64_t ticks) {
+    // Exact bins below 8 ticks, then four per octave
+    if (ticks < 8) {
+        return static_cast<int>(ticks);
+    }
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanReverse64(&index, ticks);
+    int msb = static_cast<int>(index);
+#else
+    int msb = 63 - __builtin_clzll(ticks);
+#endif
+    int bin = (msb - 1) * 4 + static_cast<int>((ticks >> (msb - 2)) & 3);
+    return std::min(bin, kNumBins - 1);
+}
+
+uint64_t TimingStats::binLowerTicks(int bin) {
+    if (bin < 8) {
+        return static_cast<uint64_t>(bin);
+    }
+    int msb = bin / 4 + 1;
+    uint64_t sub = static_cast<uint64_t>(bin % 4);
+    return (4 + sub) << (msb - 2);
+}
+
+void TimingStats::record(uint64_t ticks) {
+    if (resetRequested_.load(std::memory_order_relaxed) &&
+        resetRequested_.exchange(false, std::memory_order_acquire)) {
+        applyReset();
+    }
+
+    count_.fetch_add(1, std::memory_order_relaxed);
+    totalTicks_.fetch_add(ticks, std::memory_order_relaxed);
+    bins_[binForTicks(ticks)].fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t current = minTicks_.load(std::memory_order_relaxed);
+    while (ticks < current && !minTicks_.compare_exchange_weak(current, ticks, std::memory_order_relaxed)) {
+    }
+    current = maxTicks_.load(std::memory_order_relaxed);
+    while (ticks > current && !maxTicks_.compare_exchange_weak(current, ticks, std::memory_order_relaxed)) {
+    }
+}
+
+void TimingStats::applyReset() {
+    count_.store(0, std::memory_order_relaxed);
+    totalTicks_.store(0, std::memory_order_relaxed);
+    minTicks_.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    maxTicks_.store(0, std::memory_order_relaxed);
+    for (auto& bin : bins_) {
+        bin.store(0, std::memory_order_relaxed);
+    }
+}
+
+void TimingStats::requestReset() {
+    resetRequested_.store(true, std::memory_order_release);
+}
+
+TimingSummary TimingStats::getSummary() const {
+    TimingSummary summary;
+    summary.count = count_.load(std::memory_order_relaxed);
+    if (summary.count == 0) {
+        return summary;
+    }
+
+    // Fields are read independently, so a concurrent writer can leave them a
+    // sample apart; fine for diagnostics
+    summary.minNs = toNanoseconds(minTicks_.load(std::memory_order_relaxed));
+    summary.maxNs = toNanoseconds(maxTicks_.load(std::memory_order_relaxed));
+    summary.avgNs = toNanoseconds(totalTicks_.load(std::memory_order_relaxed)) / summary.count;
+    summary.minNs = std::min(summary.minNs, summary.maxNs);
+
+    uint64_t counts[kNumBins];
+    uint64_t total = 0;
+    for (int bin = 0; bin < kNumBins; ++bin) {
+        counts[bin] = bins_[bin].load(std::memory_order_relaxed);
+        total += counts[bin];
+    }
+
+    uint64_t target = static_cast<uint64_t>(std::ceil(total * 0.99));
+    uint64_t cumulative = 0;
+    summary.p99Ns = summary.maxNs;
+    for (int bin = 0; bin < kNumBins - 1; ++bin) {
+        cumulative += counts[bin];
+        if (cumulative >= target && cumulative > 0) {
+            summary.p99Ns = std::min(summary.maxNs, toNanoseconds(binLowerTicks(bin + 1)));
+            break;
+        }
+    }
+    return summary;
+}
+
+std::vector<HistogramBin> TimingStats::getHistogram() const {
+    std::vector<HistogramBin> histogram;
+    for (int bin = 0; bin < kNumBins; ++bin) {
+        uint64_t count = bins_[bin].load(std::memory_order_relaxed);
+        if (count == 0) {
+            continue;
+        }
+        HistogramBin entry;
+        entry.lowerNs = toNanoseconds(binLowerTicks(bin));
+        entry.upperNs = bin + 1 < kNumBins ? toNanoseconds(binLowerTicks(bin + 1))
+                                           : std::numeric_limits<double>::infinity();
+        entry.count = count;
+        histogram.push_back(entry);
+    }
+    return histogram;
+}
+
+// ---------------------------------------------------------------------------
+// CallbackProfiler
+
+CallbackProfiler::CallbackProfiler()
+    : ticksPerFrame_(0.0)
+    , xrunCount_(0)
+    , lastBudgetTicks_(0)
+    , worstLoad_(0.0)
+    , resetRequested_(false) {
+}
+
+void CallbackProfiler::prepare(int sampleRate) {
+    ticksPerFrame_ = ProfilerClock::ticksPerSecond() / std::max(1, sampleRate);
+}
+
+void CallbackProfiler::recordCallback(uint64_t ticks, int numFrames) {
+    if (resetRequested_.load(std::memory_order_relaxed) &&
+        resetRequested_.exchange(false, std::memory_order_acquire)) {
+        xrunCount_.store(0, std::memory_order_relaxed);
+        worstLoad_.store(0.0, std::memory_order_relaxed);
+    }
+
+    stats_.record(ticks);
+
+    uint64_t budget = static_cast<uint64_t>(ticksPerFrame_ * numFrames);
+    lastBudgetTicks_.store(budget, std::memory_order_relaxed);
+    if (budget == 0) {
+        return;
+    }
+
+    if (ticks > budget) {
+        xrunCount_.fetch_add(1, std::memory_order_relaxed);
+    }
+    double load = static_cast<double>(ticks) / budget;
+    if (load > worstLoad_.load(std::memory_order_relaxed)) {
+        worstLoad_.store(load, std::memory_order_relaxed);
+    }
+}
+
+CallbackProfile CallbackProfiler::getProfile() const {
+    CallbackProfile profile;
+    profile.timing = stats_.getSummary();
+    profile.histogram = stats_.getHistogram();
+    profile.xrunCount = xrunCount_.load(std::memory_order_relaxed);
+    profile.lastBudgetNs = toNanoseconds(lastBudgetTicks_.load(std::memory_order_relaxed));
+    profile.worstLoad = worstLoad_.load(std::memory_order_relaxed);
+    return profile;
+}
+
+void CallbackProfiler::requestReset() {
+    stats_.requestReset();
+    resetRequested_.store(true, std::memory_order_release);
+}
+
+// ---------------------------------------------------------------------------
+// Report
+
+void printProfileReport(std::ostream& out, const CallbackProfile& callback,
+                        const std::vector<ProcessorProfile>& processors) {
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(1);
+
+    const TimingSummary& timing = callback.timing;
+    out << "Audio callback (" << ProfilerClock::getSourceName() << ", times in us)" << std::endl;
+    out << "  callbacks " << timing.count << ", budget " << callback.lastBudgetNs / 1000.0
+        << ", min " << timing.minNs / 1000.0 << ", avg " << timing.avgNs / 1000.0
+        << ", p99 " << timing.p99Ns / 1000.0 << ", max " << timing.maxNs / 1000.0 << std::endl;
+    out << "  xruns " << callback.xrunCount << ", worst load " << callback.worstLoad * 100.0 << "%" << std::endl;
+
+    if (!processors.empty()) {
+        out << std::left << std::setw(32) << "  Processor" << std::right
+            << std::setw(10) << "calls" << std::setw(10) << "min" << std::setw(10) << "avg"
+            << std::setw(10) << "p99" << std::setw(10) << "max" << std::endl;
+        for (const auto& processor : processors) {
+            const TimingSummary& t = processor.timing;
+            out << "  " << std::left << std::setw(30) << processor.name.substr(0, 29) << std::right
+                << std::setw(10) << t.count << std::setw(10) << t.minNs / 1000.0
+                << std::setw(10) << t.avgNs / 1000.0 << std::setw(10) << t.p99Ns / 1000.0
+                << std::setw(10) << t.maxNs / 1000.0 << std::endl;
+        }
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+} // namespace OmegaDAW
@@ -0,0 +1,329 @@
+#include "RealtimeSafety.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#ifdef OMEGA_RT_SAFETY_CHECKS
+#include <new>
+#if defined(__GLIBC__)
+#include <dlfcn.h>
+#include <pthread.h>
+#endif
+#if defined(__GLIBC__) || defined(__APPLE__)
+#include <execinfo.h>
+#define OMEGA_RT_HAVE_BACKTRACE 1
+#elif defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+#endif
+
+namespace OmegaDAW {
+namespace RealtimeSafety {
+
+#ifdef OMEGA_RT_SAFETY_CHECKS
+
+namespace {
+
+constexpr int kMaxRecords = 64;
+constexpr int kMaxFrames = 32;
+constexpr int kMaxNameLength = 64;
+
+struct ViolationRecord {
+    std::atomic<bool> ready;
+    ViolationKind kind;
+    char processor[kMaxNameLength];
+    void* frames[kMaxFrames];
+    int numFrames;
+};
+
+ViolationRecord g_records[kMaxRecords];
+std::atomic<size_t> g_violationCount(0);
+std::atomic<bool> g_abortOnViolation(false);
+
+thread_local int t_realtimeDepth = 0;
+thread_local const char* t_processor = nullptr;
+thread_local bool t_inHook = false;
+
+const char* kindToString(ViolationKind kind) {
+    switch (kind) {
+        case ViolationKind::Allocation:   return "allocation";
+        case ViolationKind::Deallocation: return "deallocation";
+        case ViolationKind::MutexLock:    return "mutex lock";
+    }
+    return "unknown";
+}
+
+int captureStack(void** frames, int maxFrames) {
+#if defined(OMEGA_RT_HAVE_BACKTRACE)
+    return backtrace(frames, maxFrames);
+#elif defined(_WIN32)
+    return static_cast<int>(CaptureStackBackTrace(0, maxFrames, frames, nullptr));
+#else
+    (void)frames;
+    (void)maxFrames;
+    return 0;
+#endif
+}
+
+void recordViolation(ViolationKind kind) {
+    if (t_realtimeDepth == 0 || t_inHook) {
+        return;
+    }
+
+    // Anything allocated below (e.g. by the unwinder) is not re-reported
+    t_inHook = true;
+
+    size_t index = g_violationCount.fetch_add(1);
+    if (index < static_cast<size_t>(kMaxRecords)) {
+        ViolationRecord& record = g_records[index];
+        record.kind = kind;
+
+        const char* name = t_processor ? t_processor : "<engine>";
+        std::strncpy(record.processor, name, kMaxNameLength - 1);
+        record.processor[kMaxNameLength - 1] = '\0';
+
+        record.numFrames = captureStack(record.frames, kMaxFrames);
+        record.ready.store(true, std::memory_order_release);
+    }
+
+    if (g_abortOnViolation.load()) {
+        reportViolations(std::cerr);
+        std::abort();
+    }
+
+    t_inHook = false;
+}
+
+// Prime the unwinder (it may load libraries on first use) and read the
+// CI switch before the audio thread exists
+struct StartupInit {
+    StartupInit() {
+        void* frames[4];
+        captureStack(frames, 4);
+
+        const char* abortEnv = std::getenv("OMEGA_RT_SAFETY_ABORT");
+        if (abortEnv && abortEnv[0] == '1') {
+            g_abortOnViolation.store(true);
+        }
+    }
+};
+
+StartupInit g_startupInit;
+
+} // namespace
+
+bool isEnabled() {
+    return true;
+}
+
+void enterRealtimeSection() {
+    ++t_realtimeDepth;
+}
+
+void exitRealtimeSection() {
+    if (t_realtimeDepth > 0) {
+        --t_realtimeDepth;
+    }
+}
+
+bool isInRealtimeSection() {
+    return t_realtimeDepth > 0;
+}
+
+const char* setCurrentProcessor(const char* name) {
+    const char* previous = t_processor;
+    t_processor = name;
+    return previous;
+}
+
+size_t getViolationCount() {
+    return g_violationCount.load();
+}
+
+void reportViolations(std::ostream& out) {
+    size_t total = g_violationCount.load();
+    out << "Real-time safety violations: " << total << std::endl;
+
+    size_t recorded = std::min(total, static_cast<size_t>(kMaxRecords));
+    for (size_t i = 0; i < recorded; ++i) {
+        const ViolationRecord& record = g_records[i];
+        if (!record.ready.load(std::memory_order_acquire)) {
+            continue;
+        }
+
+        out << "  #" << i << " " << kindToString(record.kind)
+            << " in processor '" << record.processor << "'" << std::endl;
+
+#if defined(OMEGA_RT_HAVE_BACKTRACE)
+        char** symbols = backtrace_symbols(record.frames, record.numFrames);
+        for (int f = 0; f < record.numFrames; ++f) {
+            out << "      " << (symbols ? symbols[f] : "?") << std::endl;
+        }
+        std::free(symbols);
+#else
+        for (int f = 0; f < record.numFrames; ++f) {
+            out << "      " << record.frames[f] << std::endl;
+        }
+#endif
+    }
+
+    if (total > recorded) {
+        out << "  (" << (total - recorded) << " further violations not recorded)" << std::endl;
+    }
+}
+
+void clearViolations() {
+    for (auto& record : g_records) {
+        record.ready.store(false);
+    }
+    g_violationCount.store(0);
+}
+
+void setAbortOnViolation(bool abortOnViolation) {
+    g_abortOnViolation.store(abortOnViolation);
+}
+
+#else
+
+bool isEnabled() { return false; }
+void enterRealtimeSection() {}
+void exitRealtimeSection() {}
+bool isInRealtimeSection() { return false; }
+const char* setCurrentProcessor(const char* name) { (void)name; return nullptr; }
+size_t getViolationCount() { return 0; }
+
+void reportViolations(std::ostream& out) {
+    out << "Real-time safety checks not compiled in (define OMEGA_RT_SAFETY_CHECKS)" << std::endl;
+}
+
+void clearViolations() {}
+void setAbortOnViolation(bool abortOnViolation) { (void)abortOnViolation; }
+
+#endif // OMEGA_RT_SAFETY_CHECKS
+
+} // namespace RealtimeSafety
+} // namespace OmegaDAW
+
+#ifdef OMEGA_RT_SAFETY_CHECKS
+
+using OmegaDAW::RealtimeSafety::ViolationKind;
+using OmegaDAW::RealtimeSafety::recordViolation;
+
+#if defined(__GLIBC__)
+
+// glibc: interpose the C allocator and pthread mutexes directly, which also
+// covers operator new/delete and std::mutex
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(size_t size) {
+    recordViolation(ViolationKind::Allocation);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    recordViolation(ViolationKind::Allocation);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    recordViolation(ViolationKind::Allocation);
+    return __libc_realloc(ptr, size);
+}
+
+void* memalign(size_t alignment, size_t size) {
+    recordViolation(ViolationKind::Allocation);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    recordViolation(ViolationKind::Allocation);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** result, size_t alignment, size_t size) {
+    recordViolation(ViolationKind::Allocation);
+    void* ptr = __libc_memalign(alignment, size);
+    if (!ptr) {
+        return 12; // ENOMEM
+    }
+    *result = ptr;
+    return 0;
+}
+
+void free(void* ptr) {
+    if (ptr) {
+        recordViolation(ViolationKind::Deallocation);
+    }
+    __libc_free(ptr);
+}
+
+// Resolved on first use; no function-local static (its guard could lock)
+static int (*g_realMutexLock)(pthread_mutex_t*) = nullptr;
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) {
+    if (!g_realMutexLock) {
+        g_realMutexLock = reinterpret_cast<int (*)(pthread_mutex_t*)>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+    }
+
+    recordViolation(ViolationKind::MutexLock);
+    return g_realMutexLock(mutex);
+}
+} // extern "C"
+
+#else
+
+// Other platforms: replace the global allocation functions
+void* operator new(std::size_t size) {
+    recordViolation(ViolationKind::Allocation);
+    void* ptr = std::malloc(size ? size : 1);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    recordViolation(ViolationKind::Allocation);
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return ::operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept {
+    if (ptr) {
+        recordViolation(ViolationKind::Deallocation);
+    }
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    ::operator delete(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    ::operator delete(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    ::operator delete(ptr);
+}
+
+#endif // __GLIBC__
+
+#endif // OMEGA_RT_SAFETY_CHECKS
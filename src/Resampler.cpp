@@ -0,0 +1,224 @@
+#include "Resampler.h"
+#include "SIMDKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace OmegaDAW {
+
+namespace {
+
+// Input is copied into the history in chunks of at most this many frames
+constexpr int kInputChunkFrames = 1024;
+
+struct QualitySettings {
+    int halfTaps;
+    int numPhases;
+    double kaiserBeta;
+    double rolloff;  // Passband edge as a fraction of the (lower) Nyquist
+};
+
+QualitySettings settingsFor(ResamplerQuality quality) {
+    switch (quality) {
+        case ResamplerQuality::Draft:     return { 4, 64, 5.0, 0.85 };
+        case ResamplerQuality::Mastering: return { 64, 1024, 12.0, 0.96 };
+        case ResamplerQuality::Realtime:
+        default:                          return { 16, 256, 8.0, 0.92 };
+    }
+}
+
+// Zeroth-order modified Bessel function of the first kind (for the Kaiser window)
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    double halfX = x * 0.5;
+    for (int k = 1; k < 64; ++k) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < sum * 1.0e-12) {
+            break;
+        }
+    }
+    return sum;
+}
+
+} // anonymous namespace
+
+Resampler::Resampler()
+    : quality_(ResamplerQuality::Realtime)
+    , numChannels_(0)
+    , numTaps_(0)
+    , halfTaps_(0)
+    , numPhases_(0)
+    , historyCapacity_(0)
+    , historyFrames_(0)
+    , position_(0.0)
+    , framesToSkip_(0)
+    , ratio_(1.0) {
+}
+
+void Resampler::initialize(int inputSampleRate, int outputSampleRate, int numChannels,
+                           ResamplerQuality quality) {
+    QualitySettings settings = settingsFor(quality);
+    quality_ = quality;
+    numChannels_ = std::max(1, numChannels);
+    halfTaps_ = settings.halfTaps;
+    numTaps_ = settings.halfTaps * 2;
+    numPhases_ = settings.numPhases;
+
+    double ratio = (inputSampleRate > 0 && outputSampleRate > 0)
+        ? static_cast<double>(outputSampleRate) / inputSampleRate : 1.0;
+    ratio_.store(ratio);
+
+    buildFilterBank(settings.rolloff * std::min(1.0, ratio), settings.kaiserBeta);
+    coefficients_.assign(numTaps_, 0.0f);
+
+    historyCapacity_ = numTaps_ + kInputChunkFrames;
+    history_.assign(numChannels_, std::vector<float>(historyCapacity_, 0.0f));
+    reset();
+}
+
+void Resampler::buildFilterBank(double cutoff, double kaiserBeta) {
+    const double pi = 3.14159265358979323846;
+    // Kaiser window shifted to reach zero at +-halfTaps_, so the last phase
+    // of one input sample equals the first phase of the next
+    const double windowEdge = 1.0;  // I0(0)
+    const double windowNorm = besselI0(kaiserBeta) - windowEdge;
+
+    filterBank_.assign(static_cast<size_t>(numPhases_ + 1) * numTaps_, 0.0f);
+    std::vector<double> row(numTaps_);
+
+    for (int phase = 0; phase <= numPhases_; ++phase) {
+        double fraction = static_cast<double>(phase) / numPhases_;
+        double sum = 0.0;
+        for (int tap = 0; tap < numTaps_; ++tap) {
+            // Distance from the output instant to this input sample
+            double distance = tap - (halfTaps_ - 1) - fraction;
+            double x = std::min(1.0, std::abs(distance) / halfTaps_);
+            double window = (besselI0(kaiserBeta * std::sqrt(1.0 - x * x)) - windowEdge) / windowNorm;
+            double arg = pi * cutoff * distance;
+            double sinc = std::abs(arg) < 1.0e-9 ? 1.0 : std::sin(arg) / arg;
+            row[tap] = cutoff * sinc * window;
+            sum += row[tap];
+        }
+
+        // Unity gain at DC for every phase
+        float* dest = &filterBank_[static_cast<size_t>(phase) * numTaps_];
+        for (int tap = 0; tap < numTaps_; ++tap) {
+            dest[tap] = static_cast<float>(row[tap] / sum);
+        }
+    }
+}
+
+void Resampler::reset() {
+    for (auto& channel : history_) {
+        std::fill(channel.begin(), channel.end(), 0.0f);
+    }
+
+    // Zeros ahead of the first input so output 0 is centred on input 0
+    historyFrames_ = std::max(0, halfTaps_ - 1);
+    position_ = 0.0;
+    framesToSkip_ = 0;
+}
+
+void Resampler::setRatio(double ratio) {
+    if (ratio > 0.0) {
+        ratio_.store(ratio, std::memory_order_relaxed);
+    }
+}
+
+void Resampler::compact() {
+    int base = static_cast<int>(position_);
+    if (base <= 0) {
+        return;
+    }
+
+    if (base >= historyFrames_) {
+        // Downsampling past the end of the history: skip input not yet received
+        framesToSkip_ += base - historyFrames_;
+        historyFrames_ = 0;
+    } else {
+        int remaining = historyFrames_ - base;
+        for (auto& channel : history_) {
+            std::memmove(channel.data(), channel.data() + base, remaining * sizeof(float));
+        }
+        historyFrames_ = remaining;
+    }
+    position_ -= base;
+}
+
+int Resampler::process(const float* const* input, int inputFrames,
+                       float* const* output, int maxOutputFrames, int& inputFramesUsed) {
+    inputFramesUsed = 0;
+    if (numTaps_ == 0) {
+        return 0;
+    }
+
+    const double step = 1.0 / ratio_.load(std::memory_order_relaxed);
+    float* coefficients = coefficients_.data();
+    int produced = 0;
+
+    while (true) {
+        // Emit every output whose filter window is fully inside the history
+        while (produced < maxOutputFrames) {
+            int base = static_cast<int>(position_);
+            if (base + numTaps_ > historyFrames_) {
+                break;
+            }
+
+            double phase = (position_ - base) * numPhases_;
+            int row = std::min(static_cast<int>(phase), numPhases_ - 1);
+            const float* rowA = &filterBank_[static_cast<size_t>(row) * numTaps_];
+            SIMD::interpolate(coefficients, rowA, rowA + numTaps_, numTaps_, static_cast<float>(phase - row));
+
+            for (int ch = 0; ch < numChannels_; ++ch) {
+                output[ch][produced] = SIMD::dotProduct(history_[ch].data() + base, coefficients, numTaps_);
+            }
+
+            ++produced;
+            position_ += step;
+        }
+
+        if (produced == maxOutputFrames || inputFramesUsed == inputFrames) {
+            break;
+        }
+
+        compact();
+
+        if (framesToSkip_ > 0) {
+            int skip = static_cast<int>(std::min<long long>(framesToSkip_, inputFrames - inputFramesUsed));
+            inputFramesUsed += skip;
+            framesToSkip_ -= skip;
+            if (inputFramesUsed == inputFrames) {
+                break;
+            }
+        }
+
+        int count = std::min(inputFrames - inputFramesUsed, historyCapacity_ - historyFrames_);
+        for (int ch = 0; ch < numChannels_; ++ch) {
+            std::memcpy(history_[ch].data() + historyFrames_, input[ch] + inputFramesUsed, count * sizeof(float));
+        }
+        historyFrames_ += count;
+        inputFramesUsed += count;
+    }
+
+    return produced;
+}
+
+int Resampler::getOutputFrameCount(int inputFrames) const {
+    return static_cast<int>(inputFrames * getRatio());
+}
+
+int Resampler::getInputFramesNeeded(int outputFrames) const {
+    if (outputFrames <= 0) {
+        return 0;
+    }
+
+    // Last window start this many outputs from now, plus anything still to skip
+    double step = 1.0 / getRatio();
+    long long lastBase = static_cast<long long>(position_ + (outputFrames - 1) * step);
+    long long needed = lastBase + numTaps_ - historyFrames_ + framesToSkip_;
+    return static_cast<int>(std::max(0LL, needed));
+}
+
+} // namespace OmegaDAW
@@ -1,4 +1,5 @@
 #include "Router.h"
+#include "SIMDKernels.h"
 #include <algorithm>
 #include <cmath>
 #include <queue>
@@ -14,11 +15,35 @@ AudioNode::AudioNode(int id, int numInputs, int numOutputs)
     
     inputBuffers_.resize(numInputs);
     outputBuffers_.resize(numOutputs);
+    for (auto& buffer : inputBuffers_) {
+        inputs_.push_back(&buffer);
+    }
+    for (auto& buffer : outputBuffers_) {
+        outputs_.push_back(&buffer);
+    }
+}
+
+void AudioNode::allocateOwnBuffers(int numSamples) {
+    if (isSink()) {
+        for (auto& buffer : inputBuffers_) {
+            buffer.setSize(2, numSamples);
+        }
+    }
+    if (isSource()) {
+        for (auto& buffer : outputBuffers_) {
+            buffer.setSize(2, numSamples);
+        }
+    }
+}
+
+void AudioNode::bindPorts(AudioBuffer* const* inputs, AudioBuffer* const* outputs) {
+    std::copy(inputs, inputs + numInputs_, inputs_.begin());
+    std::copy(outputs, outputs + numOutputs_, outputs_.begin());
 }
 
 AudioBuffer& AudioNode::getInputBuffer(int channel) {
     if (channel >= 0 && channel < numInputs_) {
-        return inputBuffers_[channel];
+        return *inputs_[channel];
     }
     static AudioBuffer dummy;
     return dummy;
@@ -26,105 +51,164 @@ AudioBuffer& AudioNode::getInputBuffer(int channel) {
 
 AudioBuffer& AudioNode::getOutputBuffer(int channel) {
     if (channel >= 0 && channel < numOutputs_) {
-        return outputBuffers_[channel];
+        return *outputs_[channel];
     }
     static AudioBuffer dummy;
     return dummy;
 }
 
+bool AudioNode::areInputsSilent() const {
+    for (const AudioBuffer* buffer : inputs_) {
+        if (!buffer->isSilent()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void AudioNode::clearInputs() {
-    for (auto& buffer : inputBuffers_) {
-        buffer.clear();
+    for (AudioBuffer* buffer : inputs_) {
+        buffer->clear();
     }
 }
 
 void AudioNode::clearOutputs() {
-    for (auto& buffer : outputBuffers_) {
-        buffer.clear();
+    for (AudioBuffer* buffer : outputs_) {
+        buffer->clear();
     }
 }
 
 // Router implementation
 
 Router::Router()
-    : sampleRate_(44100)
-    , bufferSize_(512) {
+    : bufferSharing_(true)
+    , updateDepth_(0)
+    , scheduleGeneration_(0)
+    , processedGeneration_(0)
+    , sampleRate_(44100)
+    , bufferSize_(512)
+    , compiler_([this]() { compileSchedule(); }) {
+    compiler_.compileNow();
+}
+
+Router::~Router() {
+    // The compile step reads our members
+    compiler_.stop();
+}
+
+void Router::flushEdits() {
+    compiler_.flush();
 }
 
 void Router::initialize(int sampleRate, int bufferSize) {
     sampleRate_ = sampleRate;
-    bufferSize_ = bufferSize;
     
     for (auto& pair : nodes_) {
         if (pair.second) {
-            for (int i = 0; i < pair.second->getNumInputs(); ++i) {
-                pair.second->getInputBuffer(i).setSize(2, bufferSize);
-            }
-            for (int i = 0; i < pair.second->getNumOutputs(); ++i) {
-                pair.second->getOutputBuffer(i).setSize(2, bufferSize);
-            }
+            pair.second->allocateOwnBuffers(bufferSize);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(poolMutex_);
+        bufferSize_ = bufferSize;
+        for (auto& buffer : bufferPool_) {
+            buffer->setSize(2, bufferSize);
         }
     }
+    
+    flushEdits();
 }
 
 void Router::process() {
-    for (int nodeId : processingOrder_) {
-        auto it = nodes_.find(nodeId);
-        if (it != nodes_.end() && it->second) {
-            it->second->clearInputs();
-            it->second->clearOutputs();
-        }
+    const RouterSchedule* schedule = schedule_.beginRead();
+    if (!schedule) {
+        schedule_.endRead();
+        return;
     }
     
-    for (int nodeId : processingOrder_) {
-        auto it = nodes_.find(nodeId);
-        if (it == nodes_.end() || !it->second) {
-            continue;
+    bool firstBlock = schedule->generation != processedGeneration_;
+    processedGeneration_ = schedule->generation;
+    compiler_.noteAdopted(schedule->generation);
+    
+    const int numNodes = static_cast<int>(schedule->nodes.size());
+    for (int i = 0; i < numNodes; ++i) {
+        AudioNode* node = schedule->nodes[i].get();
+        AudioBuffer* const* ports = schedule->ports.data() + schedule->portOffsets[i];
+        node->bindPorts(ports, ports + node->getNumInputs());
+        
+        // Buffers whose values start here. Sources' outputs aren't among
+        // them: those were filled from outside before the block, e.g. by
+        // InputNode::setInputBuffer().
+        for (int c = schedule->clearOffsets[i]; c < schedule->clearOffsets[i + 1]; ++c) {
+            schedule->clears[c]->clear();
         }
         
-        auto& node = it->second;
-        node->process();
+        // Outputs were cleared above, so a skipped node passes on silence
+        // (and adding a silent output below costs nothing). A removed node
+        // only runs for its fade-out block.
+        double tailSamples = node->getTailLengthSeconds() * sampleRate_;
+        bool skip = (schedule->departing[i] && !firstBlock) ||
+                    node->getTailTracker().canSkip(node->areInputsSilent(), tailSamples, bufferSize_);
+        if (!skip) {
+            node->process();
+        }
         
-        for (const auto& conn : connections_) {
-            if (conn.sourceId == nodeId && conn.enabled) {
-                auto targetIt = nodes_.find(conn.targetId);
-                if (targetIt != nodes_.end() && targetIt->second) {
-                    auto& sourceBuffer = node->getOutputBuffer(conn.sourceChannel);
-                    auto& targetBuffer = targetIt->second->getInputBuffer(conn.targetChannel);
-                    targetBuffer.addFrom(sourceBuffer, conn.gain);
+        for (int f = schedule->fanoutOffsets[i]; f < schedule->fanoutOffsets[i + 1]; ++f) {
+            const RouterSchedule::Fanout& fanout = schedule->fanouts[f];
+            bool ramp = firstBlock && fanout.startGain != fanout.gain;
+            if (fanout.target != fanout.source) {
+                if (ramp) {
+                    fanout.target->addFromWithRamp(*fanout.source, fanout.startGain, fanout.gain);
+                } else {
+                    fanout.target->addFrom(*fanout.source, fanout.gain);
                 }
+            } else if (ramp) {
+                fanout.target->applyGainRamp(fanout.startGain, fanout.gain);
+            } else if (fanout.gain != 1.0f) {
+                fanout.target->applyGain(fanout.gain);
             }
         }
     }
+    
+    schedule_.endRead();
 }
 
 void Router::reset() {
     for (auto& pair : nodes_) {
         if (pair.second) {
             pair.second->reset();
+            pair.second->getTailTracker().reset();
         }
     }
 }
 
+void Router::beginUpdate() {
+    ++updateDepth_;
+}
+
+void Router::endUpdate() {
+    if (updateDepth_ > 0 && --updateDepth_ == 0) {
+        updateProcessingOrder();
+    }
+}
+
 void Router::addNode(std::shared_ptr<AudioNode> node) {
     if (node) {
-        nodes_[node->getId()] = node;
-        
-        for (int i = 0; i < node->getNumInputs(); ++i) {
-            node->getInputBuffer(i).setSize(2, bufferSize_);
+        node->allocateOwnBuffers(bufferSize_);
+        {
+            std::lock_guard<std::mutex> lock(editMutex_);
+            nodes_[node->getId()] = node;
         }
-        for (int i = 0; i < node->getNumOutputs(); ++i) {
-            node->getOutputBuffer(i).setSize(2, bufferSize_);
-        }
-        
         updateProcessingOrder();
     }
 }
 
 void Router::removeNode(int nodeId) {
-    nodes_.erase(nodeId);
+    {
+        std::lock_guard<std::mutex> lock(editMutex_);
+        nodes_.erase(nodeId);
+    }
     disconnectAll(nodeId);
-    updateProcessingOrder();
 }
 
 std::shared_ptr<AudioNode> Router::getNode(int nodeId) {
@@ -144,29 +228,38 @@ void Router::connect(int sourceId, int sourceChannel, int targetId, int targetCh
         return;
     }
     
-    connections_.emplace_back(sourceId, sourceChannel, targetId, targetChannel, gain);
+    {
+        std::lock_guard<std::mutex> lock(editMutex_);
+        connections_.emplace_back(sourceId, sourceChannel, targetId, targetChannel, gain);
+    }
     updateProcessingOrder();
 }
 
 void Router::disconnect(int sourceId, int sourceChannel, int targetId, int targetChannel) {
-    connections_.erase(
-        std::remove_if(connections_.begin(), connections_.end(),
-            [=](const Connection& conn) {
-                return conn.sourceId == sourceId && conn.sourceChannel == sourceChannel &&
-                       conn.targetId == targetId && conn.targetChannel == targetChannel;
-            }),
-        connections_.end());
+    {
+        std::lock_guard<std::mutex> lock(editMutex_);
+        connections_.erase(
+            std::remove_if(connections_.begin(), connections_.end(),
+                [=](const Connection& conn) {
+                    return conn.sourceId == sourceId && conn.sourceChannel == sourceChannel &&
+                           conn.targetId == targetId && conn.targetChannel == targetChannel;
+                }),
+            connections_.end());
+    }
     
     updateProcessingOrder();
 }
 
 void Router::disconnectAll(int nodeId) {
-    connections_.erase(
-        std::remove_if(connections_.begin(), connections_.end(),
-            [=](const Connection& conn) {
-                return conn.sourceId == nodeId || conn.targetId == nodeId;
-            }),
-        connections_.end());
+    {
+        std::lock_guard<std::mutex> lock(editMutex_);
+        connections_.erase(
+            std::remove_if(connections_.begin(), connections_.end(),
+                [=](const Connection& conn) {
+                    return conn.sourceId == nodeId || conn.targetId == nodeId;
+                }),
+            connections_.end());
+    }
     
     updateProcessingOrder();
 }
@@ -175,7 +268,11 @@ void Router::setConnectionGain(int sourceId, int sourceChannel, int targetId, in
     for (auto& conn : connections_) {
         if (conn.sourceId == sourceId && conn.sourceChannel == sourceChannel &&
             conn.targetId == targetId && conn.targetChannel == targetChannel) {
-            conn.gain = gain;
+            {
+                std::lock_guard<std::mutex> lock(editMutex_);
+                conn.gain = gain;
+            }
+            updateProcessingOrder();
             break;
         }
     }
@@ -185,12 +282,44 @@ void Router::setConnectionEnabled(int sourceId, int sourceChannel, int targetId,
     for (auto& conn : connections_) {
         if (conn.sourceId == sourceId && conn.sourceChannel == sourceChannel &&
             conn.targetId == targetId && conn.targetChannel == targetChannel) {
-            conn.enabled = enabled;
+            {
+                std::lock_guard<std::mutex> lock(editMutex_);
+                conn.enabled = enabled;
+            }
+            updateProcessingOrder();
             break;
         }
     }
 }
 
+void Router::setBufferSharing(bool enabled) {
+    if (bufferSharing_ != enabled) {
+        {
+            std::lock_guard<std::mutex> lock(editMutex_);
+            bufferSharing_ = enabled;
+        }
+        updateProcessingOrder();
+    }
+}
+
+int Router::getNumPorts() const {
+    std::lock_guard<std::mutex> lock(poolMutex_);
+    const RouterSchedule* schedule = schedule_.get();
+    return schedule ? schedule->numPorts : 0;
+}
+
+int Router::getNumPortBuffers() const {
+    std::lock_guard<std::mutex> lock(poolMutex_);
+    const RouterSchedule* schedule = schedule_.get();
+    return schedule ? schedule->numBuffers : 0;
+}
+
+int Router::getNumAliasedConnections() const {
+    std::lock_guard<std::mutex> lock(poolMutex_);
+    const RouterSchedule* schedule = schedule_.get();
+    return schedule ? schedule->numAliasedConnections : 0;
+}
+
 std::vector<Connection> Router::getConnectionsFrom(int nodeId) const {
     std::vector<Connection> result;
     for (const auto& conn : connections_) {
@@ -226,9 +355,12 @@ bool Router::hasConnection(int sourceId, int sourceChannel, int targetId, int ta
 }
 
 bool Router::detectCycle(int sourceId, int targetId) const {
-    std::set<int> visited;
-    std::set<int> recStack;
+    std::map<int, std::vector<int>> targetsOf;
+    for (const auto& conn : connections_) {
+        targetsOf[conn.sourceId].push_back(conn.targetId);
+    }
     
+    std::set<int> visited;
     std::queue<int> q;
     q.push(targetId);
     
@@ -240,14 +372,14 @@ bool Router::detectCycle(int sourceId, int targetId) const {
             return true;
         }
         
-        if (visited.find(current) != visited.end()) {
+        if (!visited.insert(current).second) {
             continue;
         }
-        visited.insert(current);
         
-        for (const auto& conn : connections_) {
-            if (conn.sourceId == current) {
-                q.push(conn.targetId);
+        auto it = targetsOf.find(current);
+        if (it != targetsOf.end()) {
+            for (int next : it->second) {
+                q.push(next);
             }
         }
     }
@@ -256,42 +388,274 @@ bool Router::detectCycle(int sourceId, int targetId) const {
 }
 
 void Router::updateProcessingOrder() {
-    topologicalSort();
+    if (updateDepth_ == 0) {
+        compiler_.request();
+    }
 }
 
-void Router::topologicalSort() {
-    processingOrder_.clear();
+void Router::compileSchedule() {
+    // Runs on the compiler thread: copy the shadow graph, then work unlocked
+    std::map<int, std::shared_ptr<AudioNode>> liveNodes;
+    std::vector<Connection> connections;
+    bool bufferSharing;
+    {
+        std::lock_guard<std::mutex> lock(editMutex_);
+        liveNodes = nodes_;
+        connections = connections_;
+        bufferSharing = bufferSharing_;
+    }
+    std::lock_guard<std::mutex> poolLock(poolMutex_);
     
-    std::map<int, int> inDegree;
-    for (const auto& pair : nodes_) {
-        inDegree[pair.first] = 0;
+    std::map<int, int> indexOf;
+    std::vector<std::shared_ptr<AudioNode>> nodes;
+    std::vector<char> departing;
+    for (const auto& pair : liveNodes) {
+        if (pair.second) {
+            indexOf[pair.first] = static_cast<int>(nodes.size());
+            nodes.push_back(pair.second);
+            departing.push_back(false);
+        }
     }
     
-    for (const auto& conn : connections_) {
-        inDegree[conn.targetId]++;
+    // Nodes removed since the last schedule stay for one block to fade out
+    if (const RouterSchedule* previous = schedule_.get()) {
+        for (size_t i = 0; i < previous->nodes.size(); ++i) {
+            int nodeId = previous->nodes[i]->getId();
+            if (!previous->departing[i] && !indexOf.count(nodeId)) {
+                indexOf[nodeId] = static_cast<int>(nodes.size());
+                nodes.push_back(previous->nodes[i]);
+                departing.push_back(true);
+            }
+        }
     }
     
-    std::queue<int> q;
-    for (const auto& pair : inDegree) {
-        if (pair.second == 0) {
-            q.push(pair.first);
+    // Connections that will carry audio: enabled, between scheduled nodes,
+    // on channels they have. Those gone since the last schedule ramp down
+    // to silence.
+    struct Link {
+        int source;
+        int target;
+        int sourceChannel;
+        int targetChannel;
+        float gain;
+        float startGain;
+    };
+    std::vector<Link> links;
+    std::map<ConnectionKey, float> gains;
+    for (const auto& conn : connections) {
+        auto source = indexOf.find(conn.sourceId);
+        auto target = indexOf.find(conn.targetId);
+        if (!conn.enabled || source == indexOf.end() || target == indexOf.end() ||
+            conn.sourceChannel < 0 || conn.sourceChannel >= nodes[source->second]->getNumOutputs() ||
+            conn.targetChannel < 0 || conn.targetChannel >= nodes[target->second]->getNumInputs()) {
+            continue;
+        }
+        ConnectionKey key(conn.sourceId, conn.sourceChannel, conn.targetId, conn.targetChannel);
+        auto previous = compiledGains_.find(key);
+        links.push_back({ source->second, target->second, conn.sourceChannel, conn.targetChannel, conn.gain,
+                          previous != compiledGains_.end() ? previous->second : 0.0f });
+        gains[key] = conn.gain;
+    }
+    const size_t numLiveLinks = links.size();
+    for (const auto& previous : compiledGains_) {
+        auto source = indexOf.find(std::get<0>(previous.first));
+        auto target = indexOf.find(std::get<2>(previous.first));
+        if (!gains.count(previous.first) && source != indexOf.end() && target != indexOf.end()) {
+            links.push_back({ source->second, target->second, std::get<1>(previous.first),
+                              std::get<3>(previous.first), 0.0f, previous.second });
         }
     }
     
-    while (!q.empty()) {
-        int nodeId = q.front();
-        q.pop();
-        processingOrder_.push_back(nodeId);
+    // Kahn's algorithm over the links. Nodes on a loop never reach in-degree
+    // zero and are left out, as before. If the fading links would close a
+    // loop with the new ones, they are dropped and that change is abrupt.
+    std::vector<int> order;
+    std::vector<std::vector<int>> outgoing;
+    auto sortNodes = [&](size_t numLinks) {
+        std::vector<int> inDegree(nodes.size(), 0);
+        outgoing.assign(nodes.size(), {});
+        for (size_t l = 0; l < numLinks; ++l) {
+            outgoing[links[l].source].push_back(static_cast<int>(l));
+            ++inDegree[links[l].target];
+        }
         
-        for (const auto& conn : connections_) {
-            if (conn.sourceId == nodeId) {
-                inDegree[conn.targetId]--;
-                if (inDegree[conn.targetId] == 0) {
-                    q.push(conn.targetId);
+        order.clear();
+        for (int i = 0; i < static_cast<int>(nodes.size()); ++i) {
+            if (inDegree[i] == 0) {
+                order.push_back(i);
+            }
+        }
+        for (size_t next = 0; next < order.size(); ++next) {
+            for (int l : outgoing[order[next]]) {
+                if (--inDegree[links[l].target] == 0) {
+                    order.push_back(links[l].target);
                 }
             }
         }
+        return order.size() == nodes.size();
+    };
+    if (!sortNodes(links.size()) && links.size() > numLiveLinks) {
+        links.resize(numLiveLinks);
+        sortNodes(links.size());
+    }
+    
+    // Per output and per input port
+    const int numSteps = static_cast<int>(order.size());
+    std::vector<int> stepOf(nodes.size(), -1);
+    std::vector<int> portBase(nodes.size(), 0);
+    int numPorts = 0;
+    for (int step = 0; step < numSteps; ++step) {
+        AudioNode* node = nodes[order[step]].get();
+        stepOf[order[step]] = step;
+        portBase[order[step]] = numPorts;
+        numPorts += node->getNumInputs() + node->getNumOutputs();
+    }
+    
+    struct Edge {
+        int sourcePort;
+        int targetPort;
+        int targetStep;
+        float gain;
+        float startGain;
+    };
+    std::vector<std::vector<Edge>> edgesOf(nodes.size());
+    std::vector<int> edgesFromPort(numPorts, 0);
+    std::vector<int> edgesIntoPort(numPorts, 0);
+    std::vector<int> firstWriteStep(numPorts, -1);
+    for (int step = 0; step < numSteps; ++step) {
+        int index = order[step];
+        AudioNode* node = nodes[index].get();
+        for (int l : outgoing[index]) {
+            const Link& link = links[l];
+            int sourcePort = portBase[index] + node->getNumInputs() + link.sourceChannel;
+            int targetPort = portBase[link.target] + link.targetChannel;
+            edgesOf[index].push_back({ sourcePort, targetPort, stepOf[link.target], link.gain, link.startGain });
+            ++edgesFromPort[sourcePort];
+            if (edgesIntoPort[targetPort]++ == 0) {
+                firstWriteStep[targetPort] = step;
+            }
+        }
     }
+    
+    // One value per buffer: written from its birth step, read up to its
+    // death step. An aliased output and input share one value.
+    struct Value {
+        int birth;
+        int death;
+        AudioBuffer* ownBuffer;  // Source output or sink input: never shared
+        bool filledOutside;      // Source output: not cleared
+    };
+    std::vector<Value> values;
+    std::vector<int> valueOf(numPorts, -1);
+    int numAliased = 0;
+    for (int step = 0; step < numSteps; ++step) {
+        int index = order[step];
+        AudioNode* node = nodes[index].get();
+        for (int ch = 0; ch < node->getNumInputs(); ++ch) {
+            int port = portBase[index] + ch;
+            if (valueOf[port] < 0) {
+                int birth = firstWriteStep[port] >= 0 ? firstWriteStep[port] : step;
+                valueOf[port] = static_cast<int>(values.size());
+                values.push_back({ birth, step, node->isSink() ? node->getOwnInputBuffer(ch) : nullptr, false });
+            }
+        }
+        for (int ch = 0; ch < node->getNumOutputs(); ++ch) {
+            int port = portBase[index] + node->getNumInputs() + ch;
+            valueOf[port] = static_cast<int>(values.size());
+            values.push_back({ step, step, node->isSource() ? node->getOwnOutputBuffer(ch) : nullptr,
+                               node->isSource() });
+        }
+        for (const Edge& edge : edgesOf[index]) {
+            Value& value = values[valueOf[edge.sourcePort]];
+            bool shareable = bufferSharing && !value.ownBuffer &&
+                             edgesFromPort[edge.sourcePort] == 1 && edgesIntoPort[edge.targetPort] == 1 &&
+                             !nodes[order[edge.targetStep]]->isSink();
+            if (shareable) {
+                valueOf[edge.targetPort] = valueOf[edge.sourcePort];
+                value.death = edge.targetStep;
+                ++numAliased;
+            }
+        }
+    }
+    
+    // Linear scan over the steps: values take buffers at birth and hand them
+    // back after death (without sharing, every value keeps its own)
+    std::vector<std::vector<int>> bornAt(numSteps);
+    std::vector<std::vector<int>> diesAt(numSteps);
+    for (int v = 0; v < static_cast<int>(values.size()); ++v) {
+        bornAt[values[v].birth].push_back(v);
+        diesAt[values[v].death].push_back(v);
+    }
+    
+    auto schedule = std::make_unique<RouterSchedule>();
+    std::vector<AudioBuffer*> bufferOf(values.size(), nullptr);
+    std::vector<int> poolIndexOf(values.size(), -1);
+    std::vector<int> freeBuffers;
+    int numPoolBuffers = 0;
+    int numOwnBuffers = 0;
+    for (int step = 0; step < numSteps; ++step) {
+        schedule->clearOffsets.push_back(static_cast<int>(schedule->clears.size()));
+        for (int v : bornAt[step]) {
+            if (values[v].ownBuffer) {
+                bufferOf[v] = values[v].ownBuffer;
+                ++numOwnBuffers;
+                if (!values[v].filledOutside) {
+                    schedule->clears.push_back(bufferOf[v]);
+                }
+                continue;
+            }
+            
+            if (!freeBuffers.empty()) {
+                poolIndexOf[v] = freeBuffers.back();
+                freeBuffers.pop_back();
+            } else {
+                poolIndexOf[v] = numPoolBuffers++;
+            }
+            if (poolIndexOf[v] >= static_cast<int>(bufferPool_.size())) {
+                bufferPool_.push_back(std::make_unique<AudioBuffer>(2, bufferSize_));
+            }
+            bufferOf[v] = bufferPool_[poolIndexOf[v]].get();
+            schedule->clears.push_back(bufferOf[v]);
+        }
+        if (bufferSharing) {
+            for (int v : diesAt[step]) {
+                if (poolIndexOf[v] >= 0) {
+                    freeBuffers.push_back(poolIndexOf[v]);
+                }
+            }
+        }
+    }
+    schedule->clearOffsets.push_back(static_cast<int>(schedule->clears.size()));
+    
+    for (int step = 0; step < numSteps; ++step) {
+        int index = order[step];
+        AudioNode* node = nodes[index].get();
+        schedule->nodes.push_back(nodes[index]);
+        schedule->departing.push_back(departing[index]);
+        schedule->portOffsets.push_back(static_cast<int>(schedule->ports.size()));
+        for (int ch = 0; ch < node->getNumInputs() + node->getNumOutputs(); ++ch) {
+            schedule->ports.push_back(bufferOf[valueOf[portBase[index] + ch]]);
+        }
+        
+        schedule->fanoutOffsets.push_back(static_cast<int>(schedule->fanouts.size()));
+        for (const Edge& edge : edgesOf[index]) {
+            schedule->fanouts.push_back({ bufferOf[valueOf[edge.sourcePort]],
+                                          bufferOf[valueOf[edge.targetPort]],
+                                          edge.gain,
+                                          edge.startGain });
+        }
+    }
+    schedule->portOffsets.push_back(static_cast<int>(schedule->ports.size()));
+    schedule->fanoutOffsets.push_back(static_cast<int>(schedule->fanouts.size()));
+    schedule->numPorts = numPorts;
+    schedule->numBuffers = numPoolBuffers + numOwnBuffers;
+    schedule->numAliasedConnections = numAliased;
+    
+    // Let the previous schedule play its crossfade block first
+    compiler_.waitForAdoption(scheduleGeneration_);
+    schedule->generation = ++scheduleGeneration_;
+    compiledGains_ = gains;
+    schedule_.publish(std::move(schedule));
 }
 
 bool Router::hasCycleUtil(int nodeId, std::set<int>& visited, std::set<int>& recStack) const {
@@ -331,6 +695,7 @@ void InputNode::reset() {
     clearOutputs();
 }
 
+// Writes the node's own output buffer, which the router never shares
 void InputNode::setInputBuffer(const AudioBuffer& buffer) {
     if (numOutputs_ > 0) {
         outputBuffers_[0].copyFrom(buffer);
@@ -350,11 +715,12 @@ void OutputNode::reset() {
     clearInputs();
 }
 
-AudioBuffer OutputNode::getOutputBuffer() {
+const AudioBuffer& OutputNode::getOutputBuffer() const {
+    static const AudioBuffer empty(0, 0);
     if (numInputs_ > 0) {
         return inputBuffers_[0];
     }
-    return AudioBuffer();
+    return empty;
 }
 
 // GainNode implementation
@@ -365,8 +731,8 @@ GainNode::GainNode(int id)
 }
 
 void GainNode::process() {
-    outputBuffers_[0].copyFrom(inputBuffers_[0]);
-    outputBuffers_[0].applyGain(gain_);
+    outputs_[0]->copyFrom(*inputs_[0]);
+    outputs_[0]->applyGain(gain_);
 }
 
 void GainNode::reset() {
@@ -382,19 +748,16 @@ PanNode::PanNode(int id)
 }
 
 void PanNode::process() {
-    outputBuffers_[0].copyFrom(inputBuffers_[0]);
+    AudioBuffer& output = *outputs_[0];
+    output.copyFrom(*inputs_[0]);
     
-    if (outputBuffers_[0].getNumChannels() >= 2 && std::abs(pan_) > 0.001f) {
+    if (output.getNumChannels() >= 2 && std::abs(pan_) > 0.001f) {
         float leftGain = pan_ < 0.0f ? 1.0f : 1.0f - pan_;
         float rightGain = pan_ > 0.0f ? 1.0f : 1.0f + pan_;
         
-        float* left = outputBuffers_[0].getWritePointer(0);
-        float* right = outputBuffers_[0].getWritePointer(1);
-        
-        for (int i = 0; i < outputBuffers_[0].getNumSamples(); ++i) {
-            left[i] *= leftGain;
-            right[i] *= rightGain;
-        }
+        int numSamples = output.getNumSamples();
+        SIMD::applyGain(output.getWritePointer(0), numSamples, leftGain);
+        SIMD::applyGain(output.getWritePointer(1), numSamples, rightGain);
     }
 }
 
@@ -414,10 +777,10 @@ MixNode::MixNode(int id, int numInputs)
 }
 
 void MixNode::process() {
-    outputBuffers_[0].clear();
+    outputs_[0]->clear();
     
     for (int i = 0; i < numInputs_; ++i) {
-        outputBuffers_[0].addFrom(inputBuffers_[i], 1.0f);
+        outputs_[0]->addFrom(*inputs_[i], 1.0f);
     }
 }
 
@@ -434,7 +797,7 @@ SplitNode::SplitNode(int id, int numOutputs)
 
 void SplitNode::process() {
     for (int i = 0; i < numOutputs_; ++i) {
-        outputBuffers_[i].copyFrom(inputBuffers_[0]);
+        outputs_[i]->copyFrom(*inputs_[0]);
     }
 }
 
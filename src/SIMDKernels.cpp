@@ -0,0 +1,2053 @@
+#include "SIMDKernels.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OMEGA_SIMD_SSE2 1
+#define OMEGA_SIMD_AVX2 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define OMEGA_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+// AVX2 and AVX-512 kernels are compiled for their instruction set regardless
+// of the baseline flags and only ever called after the CPU check
+#if defined(OMEGA_SIMD_AVX2) && defined(__clang__)
+#define OMEGA_TARGET_AVX2 __attribute__((target("avx2")))
+#define OMEGA_TARGET_AVX512 __attribute__((target("avx512f")))
+#elif defined(OMEGA_SIMD_AVX2) && defined(__GNUC__)
+// AVX-512 implies FMA; keep GCC from fusing multiplies and adds so the
+// results stay identical to the other paths
+#define OMEGA_TARGET_AVX2 __attribute__((target("avx2")))
+#define OMEGA_TARGET_AVX512 __attribute__((target("avx512f"), optimize("fp-contract=off")))
+#else
+#define OMEGA_TARGET_AVX2
+#define OMEGA_TARGET_AVX512
+#endif
+
+#if defined(OMEGA_SIMD_AVX2) && (defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1911))
+#define OMEGA_SIMD_AVX512 1
+#endif
+
+namespace OmegaDAW {
+namespace SIMD {
+
+namespace {
+
+struct KernelTable {
+    InstructionSet set;
+    void (*deinterleave)(const float*, float* const*, int, int, float);
+    void (*interleave)(const float* const*, float*, int, int);
+    void (*applyGain)(float*, int, float);
+    void (*add)(float*, const float*, int);
+    void (*addWithGain)(float*, const float*, int, float);
+    void (*softClip)(float*, int);
+    float (*dotProduct)(const float*, const float*, int);
+    void (*interpolate)(float*, const float*, const float*, int, float);
+    void (*applyGainRamp)(float*, int, float, float);
+    void (*addWithGainRamp)(float*, const float*, int, float, float);
+    void (*multiplyAdd)(float*, const float*, const float*, int);
+    float (*peakAbs)(const float*, int);
+    void (*fftRadix4)(float*, float*, int, int, const float*);
+    void (*complexMultiplyAdd)(float*, const float*, const float*, int);
+    void (*biquadLanes)(float*, int, int, float*, const float*, float*);
+};
+
+// Soft clip constants; tanh is a [7/6] Pade approximant, accurate to float
+// precision on [-1, 1], so the argument x / 2 is clamped to [-1, 1] first.
+// That loses nothing: 2 * tanh(x / 2) passes 1 near |x / 2| = 0.55 and the
+// final hard clip flattens everything beyond.
+constexpr float kSoftClipThreshold = 0.9f;
+constexpr float kP0 = 135135.0f;
+constexpr float kP1 = 17325.0f;
+constexpr float kP2 = 378.0f;
+constexpr float kQ1 = 62370.0f;
+constexpr float kQ2 = 3150.0f;
+constexpr float kQ3 = 28.0f;
+
+// ---------------------------------------------------------------------------
+// Scalar reference
+
+void deinterleaveScalar(const float* source, float* const* dest, int numChannels, int numFrames, float gain) {
+    for (int frame = 0; frame < numFrames; ++frame) {
+        for (int ch = 0; ch < numChannels; ++ch) {
+            dest[ch][frame] = source[frame * numChannels + ch] * gain;
+        }
+    }
+}
+
+void interleaveScalar(const float* const* source, float* dest, int numChannels, int numFrames) {
+    for (int frame = 0; frame < numFrames; ++frame) {
+        for (int ch = 0; ch < numChannels; ++ch) {
+            dest[frame * numChannels + ch] = source[ch][frame];
+        }
+    }
+}
+
+void applyGainScalar(float* buffer, int numSamples, float gain) {
+    for (int i = 0; i < numSamples; ++i) {
+        buffer[i] *= gain;
+    }
+}
+
+void addScalar(float* dest, const float* source, int numSamples) {
+    for (int i = 0; i < numSamples; ++i) {
+        dest[i] += source[i];
+    }
+}
+
+void addWithGainScalar(float* dest, const float* source, int numSamples, float gain) {
+    for (int i = 0; i < numSamples; ++i) {
+        dest[i] += source[i] * gain;
+    }
+}
+
+inline float softClipSample(float x) {
+    float y = std::min(1.0f, std::max(-1.0f, x * 0.5f));
+    float y2 = y * y;
+    float numerator = y * (kP0 + y2 * (kP1 + y2 * (kP2 + y2)));
+    float denominator = kP0 + y2 * (kQ1 + y2 * (kQ2 + y2 * kQ3));
+    float clipped = 2.0f * (numerator / denominator);
+    float result = std::abs(x) > kSoftClipThreshold ? clipped : x;
+    return std::min(1.0f, std::max(-1.0f, result));
+}
+
+void softClipScalar(float* buffer, int numSamples) {
+    for (int i = 0; i < numSamples; ++i) {
+        buffer[i] = softClipSample(buffer[i]);
+    }
+}
+
+float dotProductScalar(const float* a, const float* b, int numSamples) {
+    float sum = 0.0f;
+    for (int i = 0; i < numSamples; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+void interpolateScalar(float* dest, const float* a, const float* b, int numSamples, float t) {
+    for (int i = 0; i < numSamples; ++i) {
+        dest[i] = a[i] + (b[i] - a[i]) * t;
+    }
+}
+
+// Ramps compute gain i as start + i * increment (never accumulated), so every
+// instruction set produces the same gain for the same sample
+void applyGainRampScalar(float* buffer, int numSamples, float startGain, float increment) {
+    for (int i = 0; i < numSamples; ++i) {
+        buffer[i] *= startGain + static_cast<float>(i) * increment;
+    }
+}
+
+void addWithGainRampScalar(float* dest, const float* source, int numSamples, float startGain, float increment) {
+    for (int i = 0; i < numSamples; ++i) {
+        dest[i] += source[i] * (startGain + static_cast<float>(i) * increment);
+    }
+}
+
+void multiplyAddScalar(float* dest, const float* a, const float* b, int numSamples) {
+    for (int i = 0; i < numSamples; ++i) {
+        dest[i] += a[i] * b[i];
+    }
+}
+
+float peakAbsScalar(const float* buffer, int numSamples) {
+    float peak = 0.0f;
+    for (int i = 0; i < numSamples; ++i) {
+        peak = std::max(peak, std::abs(buffer[i]));
+    }
+    return peak;
+}
+
+// One radix-4 butterfly at offset j of a block; every instruction set does
+// the same multiplies and adds in the same order
+inline void radix4Butterfly(float* re, float* im, int quarter, const float* twiddles, int j) {
+    const float aRe = twiddles[j];
+    const float aIm = twiddles[quarter + j];
+    const float bRe = twiddles[2 * quarter + j];
+    const float bIm = twiddles[3 * quarter + j];
+    float* r = re + j;
+    float* i = im + j;
+
+    float t1Re = r[quarter] * aRe - i[quarter] * aIm;
+    float t1Im = r[quarter] * aIm + i[quarter] * aRe;
+    float t3Re = r[3 * quarter] * aRe - i[3 * quarter] * aIm;
+    float t3Im = r[3 * quarter] * aIm + i[3 * quarter] * aRe;
+    float a0Re = r[0] + t1Re;
+    float a0Im = i[0] + t1Im;
+    float a1Re = r[0] - t1Re;
+    float a1Im = i[0] - t1Im;
+    float a2Re = r[2 * quarter] + t3Re;
+    float a2Im = i[2 * quarter] + t3Im;
+    float a3Re = r[2 * quarter] - t3Re;
+    float a3Im = i[2 * quarter] - t3Im;
+
+    float u2Re = a2Re * bRe - a2Im * bIm;
+    float u2Im = a2Re * bIm + a2Im * bRe;
+    float u3Re = a3Re * bRe - a3Im * bIm;
+    float u3Im = a3Re * bIm + a3Im * bRe;
+    r[0] = a0Re + u2Re;
+    i[0] = a0Im + u2Im;
+    r[2 * quarter] = a0Re - u2Re;
+    i[2 * quarter] = a0Im - u2Im;
+    r[quarter] = a1Re + u3Im;
+    i[quarter] = a1Im - u3Re;
+    r[3 * quarter] = a1Re - u3Im;
+    i[3 * quarter] = a1Im + u3Re;
+}
+
+void fftRadix4Scalar(float* re, float* im, int n, int quarter, const float* twiddles) {
+    for (int block = 0; block < n; block += 4 * quarter) {
+        for (int j = 0; j < quarter; ++j) {
+            radix4Butterfly(re + block, im + block, quarter, twiddles, j);
+        }
+    }
+}
+
+void complexMultiplyAddScalar(float* dest, const float* a, const float* b, int numComplex) {
+    for (int k = 0; k < 2 * numComplex; k += 2) {
+        float re = a[k] * b[k] - a[k + 1] * b[k + 1];
+        float im = a[k] * b[k + 1] + a[k + 1] * b[k];
+        dest[k] += re;
+        dest[k + 1] += im;
+    }
+}
+
+// Biquad lanes: lane masks for the pipeline's first and last steps. Loaded
+// at kLaneMasks + 8 - k: lanes below k set; at kLaneMasks + 16 - k: lanes
+// from k up set.
+alignas(32) const uint32_t kLaneMasks[3 * kBiquadLanes] = {
+    ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u
+};
+
+// Section 0's input once the frames run out
+alignas(32) const float kSilentFrame[kBiquadLanes] = {};
+
+// Lanes whose frame is inside the block at this step (see biquadLanesScalar),
+// as offsets into kLaneMasks for the lanes-below and lanes-from masks
+inline void biquadActiveLanes(int step, int numFrames, int channels, int& below, int& from) {
+    below = kBiquadLanes - std::min(kBiquadLanes, (step + 1) * channels);
+    from = 2 * kBiquadLanes - std::min(kBiquadLanes, std::max(0, step - numFrames + 1) * channels);
+}
+
+// Lane l at step t runs frame t - l / channels of its section; outside the
+// block a lane keeps its state and coefficients
+void biquadLanesScalar(float* frames, int numFrames, int channels, float* coefficients,
+                       const float* increments, float* state) {
+    const int sections = kBiquadLanes / channels;
+    float* s1 = state;
+    float* s2 = state + kBiquadLanes;
+    float previous[kBiquadLanes] = {};
+    float output[kBiquadLanes] = {};
+    for (int step = 0; step < numFrames + sections - 1; ++step) {
+        for (int lane = 0; lane < kBiquadLanes; ++lane) {
+            int frame = step - lane / channels;
+            if (frame < 0 || frame >= numFrames) {
+                continue;
+            }
+            float x = lane < channels ? frames[step * channels + lane] : previous[lane - channels];
+            float* c = coefficients + lane;
+            float y = c[0] * x + s1[lane];
+            s1[lane] = (c[kBiquadLanes] * x + s2[lane]) - c[3 * kBiquadLanes] * y;
+            s2[lane] = c[2 * kBiquadLanes] * x - c[4 * kBiquadLanes] * y;
+            output[lane] = y;
+            if (increments) {
+                for (int k = 0; k < 5 * kBiquadLanes; k += kBiquadLanes) {
+                    c[k] += increments[k + lane];
+                }
+            }
+        }
+        std::memcpy(previous, output, sizeof(previous));
+        if (step >= sections - 1) {
+            std::memcpy(frames + (step - sections + 1) * channels, output + kBiquadLanes - channels,
+                        channels * sizeof(float));
+        }
+    }
+}
+
+const KernelTable scalarTable = {
+    InstructionSet::Scalar,
+    deinterleaveScalar,
+    interleaveScalar,
+    applyGainScalar,
+    addScalar,
+    addWithGainScalar,
+    softClipScalar,
+    dotProductScalar,
+    interpolateScalar,
+    applyGainRampScalar,
+    addWithGainRampScalar,
+    multiplyAddScalar,
+    peakAbsScalar,
+    fftRadix4Scalar,
+    complexMultiplyAddScalar,
+    biquadLanesScalar
+};
+
+// ---------------------------------------------------------------------------
+// SSE2
+
+#ifdef OMEGA_SIMD_SSE2
+
+void deinterleaveSSE2(const float* source, float* const* dest, int numChannels, int numFrames, float gain) {
+    const __m128 g = _mm_set1_ps(gain);
+    const int vectorFrames = numFrames & ~3;
+
+    if (numChannels == 2) {
+        float* left = dest[0];
+        float* right = dest[1];
+        for (int frame = 0; frame < vectorFrames; frame += 4) {
+            __m128 a = _mm_loadu_ps(source + frame * 2);
+            __m128 b = _mm_loadu_ps(source + frame * 2 + 4);
+            _mm_storeu_ps(left + frame, _mm_mul_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)), g));
+            _mm_storeu_ps(right + frame, _mm_mul_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)), g));
+        }
+        for (int frame = vectorFrames; frame < numFrames; ++frame) {
+            left[frame] = source[frame * 2] * gain;
+            right[frame] = source[frame * 2 + 1] * gain;
+        }
+        return;
+    }
+
+    // Four channels at a time through a 4x4 transpose; leftover channels scalar
+    int ch = 0;
+    for (; ch + 4 <= numChannels; ch += 4) {
+        for (int frame = 0; frame < vectorFrames; frame += 4) {
+            const float* base = source + frame * numChannels + ch;
+            __m128 r0 = _mm_loadu_ps(base);
+            __m128 r1 = _mm_loadu_ps(base + numChannels);
+            __m128 r2 = _mm_loadu_ps(base + 2 * numChannels);
+            __m128 r3 = _mm_loadu_ps(base + 3 * numChannels);
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            _mm_storeu_ps(dest[ch] + frame, _mm_mul_ps(r0, g));
+            _mm_storeu_ps(dest[ch + 1] + frame, _mm_mul_ps(r1, g));
+            _mm_storeu_ps(dest[ch + 2] + frame, _mm_mul_ps(r2, g));
+            _mm_storeu_ps(dest[ch + 3] + frame, _mm_mul_ps(r3, g));
+        }
+        for (int frame = vectorFrames; frame < numFrames; ++frame) {
+            for (int c = ch; c < ch + 4; ++c) {
+                dest[c][frame] = source[frame * numChannels + c] * gain;
+            }
+        }
+    }
+    for (; ch < numChannels; ++ch) {
+        for (int frame = 0; frame < numFrames; ++frame) {
+            dest[ch][frame] = source[frame * numChannels + ch] * gain;
+        }
+    }
+}
+
+void interleaveSSE2(const float* const* source, float* dest, int numChannels, int numFrames) {
+    const int vectorFrames = numFrames & ~3;
+
+    if (numChannels == 2) {
+        const float* left = source[0];
+        const float* right = source[1];
+        for (int frame = 0; frame < vectorFrames; frame += 4) {
+            __m128 l = _mm_loadu_ps(left + frame);
+            __m128 r = _mm_loadu_ps(right + frame);
+            _mm_storeu_ps(dest + frame * 2, _mm_unpacklo_ps(l, r));
+            _mm_storeu_ps(dest + frame * 2 + 4, _mm_unpackhi_ps(l, r));
+        }
+        for (int frame = vectorFrames; frame < numFrames; ++frame) {
+            dest[frame * 2] = left[frame];
+            dest[frame * 2 + 1] = right[frame];
+        }
+        return;
+    }
+
+    int ch = 0;
+    for (; ch + 4 <= numChannels; ch += 4) {
+        for (int frame = 0; frame < vectorFrames; frame += 4) {
+            __m128 r0 = _mm_loadu_ps(source[ch] + frame);
+            __m128 r1 = _mm_loadu_ps(source[ch + 1] + frame);
+            __m128 r2 = _mm_loadu_ps(source[ch + 2] + frame);
+            __m128 r3 = _mm_loadu_ps(source[ch + 3] + frame);
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            float* base = dest + frame * numChannels + ch;
+            _mm_storeu_ps(base, r0);
+            _mm_storeu_ps(base + numChannels, r1);
+            _mm_storeu_ps(base + 2 * numChannels, r2);
+            _mm_storeu_ps(base + 3 * numChannels, r3);
+        }
+        for (int frame = vectorFrames; frame < numFrames; ++frame) {
+            for (int c = ch; c < ch + 4; ++c) {
+                dest[frame * numChannels + c] = source[c][frame];
+            }
+        }
+    }
+    for (; ch < numChannels; ++ch) {
+        for (int frame = 0; frame < numFrames; ++frame) {
+            dest[frame * numChannels + ch] = source[ch][frame];
+        }
+    }
+}
+
+void applyGainSSE2(float* buffer, int numSamples, float gain) {
+    const __m128 g = _mm_set1_ps(gain);
+    int i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        _mm_storeu_ps(buffer + i, _mm_mul_ps(_mm_loadu_ps(buffer + i), g));
+    }
+    applyGainScalar(buffer + i, numSamples - i, gain);
+}
+
+void addSSE2(float* dest, const float* source, int numSamples) {
+    int i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        _mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(dest + i), _mm_loadu_ps(source + i)));
+    }
+    addScalar(dest + i, source + i, numSamples - i);
+}
+
+void addWithGainSSE2(float* dest, const float* source, int numSamples, float gain) {
+    const __m128 g = _mm_set1_ps(gain);
+    int i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        __m128 scaled = _mm_mul_ps(_mm_loadu_ps(source + i), g);
+        _mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(dest + i), scaled));
+    }
+    addWithGainScalar(dest + i, source + i, numSamples - i, gain);
+}
+
+void softClipSSE2(float* buffer, int numSamples) {
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 minusOne = _mm_set1_ps(-1.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 threshold = _mm_set1_ps(kSoftClipThreshold);
+
+    int i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        __m128 x = _mm_loadu_ps(buffer + i);
+        __m128 y = _mm_min_ps(one, _mm_max_ps(minusOne, _mm_mul_ps(x, half)));
+        __m128 y2 = _mm_mul_ps(y, y);
+        __m128 numerator = _mm_add_ps(_mm_set1_ps(kP2), y2);
+        numerator = _mm_add_ps(_mm_set1_ps(kP1), _mm_mul_ps(y2, numerator));
+        numerator = _mm_mul_ps(y, _mm_add_ps(_mm_set1_ps(kP0), _mm_mul_ps(y2, numerator)));
+        __m128 denominator = _mm_add_ps(_mm_set1_ps(kQ2), _mm_mul_ps(y2, _mm_set1_ps(kQ3)));
+        denominator = _mm_add_ps(_mm_set1_ps(kQ1), _mm_mul_ps(y2, denominator));
+        denominator = _mm_add_ps(_mm_set1_ps(kP0), _mm_mul_ps(y2, denominator));
+        __m128 clipped = _mm_mul_ps(two, _mm_div_ps(numerator, denominator));
+
+        __m128 mask = _mm_cmpgt_ps(_mm_and_ps(x, absMask), threshold);
+        __m128 result = _mm_or_ps(_mm_and_ps(mask, clipped), _mm_andnot_ps(mask, x));
+        _mm_storeu_ps(buffer + i, _mm_min_ps(one, _mm_max_ps(minusOne, result)));
+    }
+    softClipScalar(buffer + i, numSamples - i);
+}
+
+float dotProductSSE2(const float* a, const float* b, int numSamples) {
+    __m128 sum0 = _mm_setzero_ps();
+    __m128 sum1 = _mm_setzero_ps();
+    int i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    __m128 sum = _mm_add_ps(sum0, sum1);
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum) + dotProductScalar(a + i, b + i, numSamples - i);
+}
+
+void interpolateSSE2(float* dest, const float* a, const float* b, int numSamples, float t) {
+    const __m128 tv = _mm_set1_ps(t);
+    int i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        __m128 va = _mm_loadu_ps(a + i);
+        __m128 delta = _mm_sub_ps(_mm_loadu_ps(b + i), va);
+        _mm_storeu_ps(dest + i, _mm_add_ps(va, _mm_mul_ps(delta, tv)));
+    }
+    interpolateScalar(dest + i, a + i, b + i, numSamples - i, t);
+}
+
+void applyGainRampSSE2(float* buffer, int numSamples, float startGain, float increment) {
+    const __m128 start = _mm_set1_ps(startGain);
+    const __m128 step = _mm_set1_ps(increment);
+    const __m128 four = _mm_set1_ps(4.0f);
+    __m128 index = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    int i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        __m128 gain = _mm_add_ps(start, _mm_mul_ps(index, step));
+        _mm_storeu_ps(buffer + i, _mm_mul_ps(_mm_loadu_ps(buffer + i), gain));
+        index = _mm_add_ps(index, four);
+    }
+    for (; i < numSamples; ++i) {
+        buffer[i] *= startGain + static_cast<float>(i) * increment;
+    }
+}
+
+void addWithGainRampSSE2(float* dest, const float* source, int numSamples, float startGain, float increment) {
+    const __m128 start = _mm_set1_ps(startGain);
+    const __m128 step = _mm_set1_ps(increment);
+    const __m128 four = _mm_set1_ps(4.0f);
+    __m128 index = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    int i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        __m128 gain = _mm_add_ps(start, _mm_mul_ps(index, step));
+        __m128 scaled = _mm_mul_ps(_mm_loadu_ps(source + i), gain);
+        _mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(dest + i), scaled));
+        index = _mm_add_ps(index, four);
+    }
+    for (; i < numSamples; ++i) {
+        dest[i] += source[i] * (startGain + static_cast<float>(i) * increment);
+    }
+}
+
+void multiplyAddSSE2(float* dest, const float* a, const float* b, int numSamples) {
+    int i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        __m128 product = _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i));
+        _mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(dest + i), product));
+    }
+    multiplyAddScalar(dest + i, a + i, b + i, numSamples - i);
+}
+
+float peakAbsSSE2(const float* buffer, int numSamples) {
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 peak0 = _mm_setzero_ps();
+    __m128 peak1 = _mm_setzero_ps();
+    int i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        peak0 = _mm_max_ps(peak0, _mm_and_ps(_mm_loadu_ps(buffer + i), absMask));
+        peak1 = _mm_max_ps(peak1, _mm_and_ps(_mm_loadu_ps(buffer + i + 4), absMask));
+    }
+    __m128 peak = _mm_max_ps(peak0, peak1);
+    peak = _mm_max_ps(peak, _mm_movehl_ps(peak, peak));
+    peak = _mm_max_ss(peak, _mm_shuffle_ps(peak, peak, 1));
+    return std::max(_mm_cvtss_f32(peak), peakAbsScalar(buffer + i, numSamples - i));
+}
+
+void fftRadix4SSE2(float* re, float* im, int n, int quarter, const float* twiddles) {
+    if (quarter < 4) {
+        fftRadix4Scalar(re, im, n, quarter, twiddles);
+        return;
+    }
+    const int vectorQuarter = quarter & ~3;
+    for (int block = 0; block < n; block += 4 * quarter) {
+        float* r = re + block;
+        float* i = im + block;
+        int j = 0;
+        for (; j < vectorQuarter; j += 4) {
+            __m128 aRe = _mm_loadu_ps(twiddles + j);
+            __m128 aIm = _mm_loadu_ps(twiddles + quarter + j);
+            __m128 bRe = _mm_loadu_ps(twiddles + 2 * quarter + j);
+            __m128 bIm = _mm_loadu_ps(twiddles + 3 * quarter + j);
+            __m128 x0Re = _mm_loadu_ps(r + j);
+            __m128 x0Im = _mm_loadu_ps(i + j);
+            __m128 x1Re = _mm_loadu_ps(r + quarter + j);
+            __m128 x1Im = _mm_loadu_ps(i + quarter + j);
+            __m128 x2Re = _mm_loadu_ps(r + 2 * quarter + j);
+            __m128 x2Im = _mm_loadu_ps(i + 2 * quarter + j);
+            __m128 x3Re = _mm_loadu_ps(r + 3 * quarter + j);
+            __m128 x3Im = _mm_loadu_ps(i + 3 * quarter + j);
+
+            __m128 t1Re = _mm_sub_ps(_mm_mul_ps(x1Re, aRe), _mm_mul_ps(x1Im, aIm));
+            __m128 t1Im = _mm_add_ps(_mm_mul_ps(x1Re, aIm), _mm_mul_ps(x1Im, aRe));
+            __m128 t3Re = _mm_sub_ps(_mm_mul_ps(x3Re, aRe), _mm_mul_ps(x3Im, aIm));
+            __m128 t3Im = _mm_add_ps(_mm_mul_ps(x3Re, aIm), _mm_mul_ps(x3Im, aRe));
+            __m128 a0Re = _mm_add_ps(x0Re, t1Re);
+            __m128 a0Im = _mm_add_ps(x0Im, t1Im);
+            __m128 a1Re = _mm_sub_ps(x0Re, t1Re);
+            __m128 a1Im = _mm_sub_ps(x0Im, t1Im);
+            __m128 a2Re = _mm_add_ps(x2Re, t3Re);
+            __m128 a2Im = _mm_add_ps(x2Im, t3Im);
+            __m128 a3Re = _mm_sub_ps(x2Re, t3Re);
+            __m128 a3Im = _mm_sub_ps(x2Im, t3Im);
+
+            __m128 u2Re = _mm_sub_ps(_mm_mul_ps(a2Re, bRe), _mm_mul_ps(a2Im, bIm));
+            __m128 u2Im = _mm_add_ps(_mm_mul_ps(a2Re, bIm), _mm_mul_ps(a2Im, bRe));
+            __m128 u3Re = _mm_sub_ps(_mm_mul_ps(a3Re, bRe), _mm_mul_ps(a3Im, bIm));
+            __m128 u3Im = _mm_add_ps(_mm_mul_ps(a3Re, bIm), _mm_mul_ps(a3Im, bRe));
+            _mm_storeu_ps(r + j, _mm_add_ps(a0Re, u2Re));
+            _mm_storeu_ps(i + j, _mm_add_ps(a0Im, u2Im));
+            _mm_storeu_ps(r + 2 * quarter + j, _mm_sub_ps(a0Re, u2Re));
+            _mm_storeu_ps(i + 2 * quarter + j, _mm_sub_ps(a0Im, u2Im));
+            _mm_storeu_ps(r + quarter + j, _mm_add_ps(a1Re, u3Im));
+            _mm_storeu_ps(i + quarter + j, _mm_sub_ps(a1Im, u3Re));
+            _mm_storeu_ps(r + 3 * quarter + j, _mm_sub_ps(a1Re, u3Im));
+            _mm_storeu_ps(i + 3 * quarter + j, _mm_add_ps(a1Im, u3Re));
+        }
+        for (; j < quarter; ++j) {
+            radix4Butterfly(r, i, quarter, twiddles, j);
+        }
+    }
+}
+
+void complexMultiplyAddSSE2(float* dest, const float* a, const float* b, int numComplex) {
+    // (ar + i ai)(br + i bi): ar * (br, bi) + ai * (-bi, br), two bins per vector
+    const __m128 signs = _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+    const int numFloats = 2 * numComplex;
+    int k = 0;
+    for (; k + 4 <= numFloats; k += 4) {
+        __m128 va = _mm_loadu_ps(a + k);
+        __m128 vb = _mm_loadu_ps(b + k);
+        __m128 aRe = _mm_shuffle_ps(va, va, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 aIm = _mm_shuffle_ps(va, va, _MM_SHUFFLE(3, 3, 1, 1));
+        __m128 bSwapped = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128 cross = _mm_xor_ps(_mm_mul_ps(aIm, bSwapped), signs);
+        __m128 product = _mm_add_ps(_mm_mul_ps(aRe, vb), cross);
+        _mm_storeu_ps(dest + k, _mm_add_ps(_mm_loadu_ps(dest + k), product));
+    }
+    complexMultiplyAddScalar(dest + k, a + k, b + k, (numFloats - k) / 2);
+}
+
+// Lanes 0-3 and 4-7 as two vectors; lane l's input is lane l - Channels's
+// last output, or the frame for l < Channels
+template <int Channels>
+void biquadPipelineSSE2(float* frames, int numFrames, float* coefficients, const float* increments,
+                        float* state) {
+    constexpr int sections = kBiquadLanes / Channels;
+    __m128 cLo[5], cHi[5], dLo[5], dHi[5];
+    for (int k = 0; k < 5; ++k) {
+        cLo[k] = _mm_loadu_ps(coefficients + k * kBiquadLanes);
+        cHi[k] = _mm_loadu_ps(coefficients + k * kBiquadLanes + 4);
+        dLo[k] = increments ? _mm_loadu_ps(increments + k * kBiquadLanes) : _mm_setzero_ps();
+        dHi[k] = increments ? _mm_loadu_ps(increments + k * kBiquadLanes + 4) : _mm_setzero_ps();
+    }
+    __m128 s1Lo = _mm_loadu_ps(state);
+    __m128 s1Hi = _mm_loadu_ps(state + 4);
+    __m128 s2Lo = _mm_loadu_ps(state + kBiquadLanes);
+    __m128 s2Hi = _mm_loadu_ps(state + kBiquadLanes + 4);
+    __m128 outLo = _mm_setzero_ps();
+    __m128 outHi = _mm_setzero_ps();
+
+    for (int step = 0; step < numFrames + sections - 1; ++step) {
+        const float* in = step < numFrames ? frames + step * Channels : kSilentFrame;
+        __m128 xLo, xHi;
+        if constexpr (Channels == 1) {
+            xLo = _mm_move_ss(_mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(outLo), 4)), _mm_load_ss(in));
+            xHi = _mm_move_ss(_mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(outHi), 4)),
+                              _mm_shuffle_ps(outLo, outLo, _MM_SHUFFLE(3, 3, 3, 3)));
+        } else if constexpr (Channels == 2) {
+            xLo = _mm_movelh_ps(_mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(in))), outLo);
+            xHi = _mm_shuffle_ps(outLo, outHi, _MM_SHUFFLE(1, 0, 3, 2));
+        } else if constexpr (Channels == 4) {
+            xLo = _mm_loadu_ps(in);
+            xHi = outLo;
+        } else {
+            xLo = _mm_loadu_ps(in);
+            xHi = _mm_loadu_ps(in + 4);
+        }
+
+        __m128 yLo = _mm_add_ps(_mm_mul_ps(cLo[0], xLo), s1Lo);
+        __m128 yHi = _mm_add_ps(_mm_mul_ps(cHi[0], xHi), s1Hi);
+        __m128 n1Lo = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(cLo[1], xLo), s2Lo), _mm_mul_ps(cLo[3], yLo));
+        __m128 n1Hi = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(cHi[1], xHi), s2Hi), _mm_mul_ps(cHi[3], yHi));
+        __m128 n2Lo = _mm_sub_ps(_mm_mul_ps(cLo[2], xLo), _mm_mul_ps(cLo[4], yLo));
+        __m128 n2Hi = _mm_sub_ps(_mm_mul_ps(cHi[2], xHi), _mm_mul_ps(cHi[4], yHi));
+
+        if (step >= sections - 1 && step < numFrames) {
+            s1Lo = n1Lo;
+            s1Hi = n1Hi;
+            s2Lo = n2Lo;
+            s2Hi = n2Hi;
+            outLo = yLo;
+            outHi = yHi;
+            if (increments) {
+                for (int k = 0; k < 5; ++k) {
+                    cLo[k] = _mm_add_ps(cLo[k], dLo[k]);
+                    cHi[k] = _mm_add_ps(cHi[k], dHi[k]);
+                }
+            }
+        } else {
+            int below, from;
+            biquadActiveLanes(step, numFrames, Channels, below, from);
+            const __m128i* lowMask = reinterpret_cast<const __m128i*>(kLaneMasks + below);
+            const __m128i* highMask = reinterpret_cast<const __m128i*>(kLaneMasks + from);
+            __m128 maskLo = _mm_castsi128_ps(_mm_and_si128(_mm_loadu_si128(lowMask), _mm_loadu_si128(highMask)));
+            __m128 maskHi = _mm_castsi128_ps(_mm_and_si128(_mm_loadu_si128(lowMask + 1),
+                                                           _mm_loadu_si128(highMask + 1)));
+            auto select = [](__m128 mask, __m128 a, __m128 b) {
+                return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+            };
+            s1Lo = select(maskLo, n1Lo, s1Lo);
+            s1Hi = select(maskHi, n1Hi, s1Hi);
+            s2Lo = select(maskLo, n2Lo, s2Lo);
+            s2Hi = select(maskHi, n2Hi, s2Hi);
+            outLo = select(maskLo, yLo, outLo);
+            outHi = select(maskHi, yHi, outHi);
+            if (increments) {
+                for (int k = 0; k < 5; ++k) {
+                    cLo[k] = select(maskLo, _mm_add_ps(cLo[k], dLo[k]), cLo[k]);
+                    cHi[k] = select(maskHi, _mm_add_ps(cHi[k], dHi[k]), cHi[k]);
+                }
+            }
+        }
+
+        if (step >= sections - 1) {
+            float* out = frames + (step - sections + 1) * Channels;
+            if constexpr (Channels == 1) {
+                _mm_store_ss(out, _mm_shuffle_ps(outHi, outHi, _MM_SHUFFLE(3, 3, 3, 3)));
+            } else if constexpr (Channels == 2) {
+                _mm_storeh_pi(reinterpret_cast<__m64*>(out), outHi);
+            } else if constexpr (Channels == 4) {
+                _mm_storeu_ps(out, outHi);
+            } else {
+                _mm_storeu_ps(out, outLo);
+                _mm_storeu_ps(out + 4, outHi);
+            }
+        }
+    }
+
+    for (int k = 0; k < 5; ++k) {
+        _mm_storeu_ps(coefficients + k * kBiquadLanes, cLo[k]);
+        _mm_storeu_ps(coefficients + k * kBiquadLanes + 4, cHi[k]);
+    }
+    _mm_storeu_ps(state, s1Lo);
+    _mm_storeu_ps(state + 4, s1Hi);
+    _mm_storeu_ps(state + kBiquadLanes, s2Lo);
+    _mm_storeu_ps(state + kBiquadLanes + 4, s2Hi);
+}
+
+void biquadLanesSSE2(float* frames, int numFrames, int channels, float* coefficients, const float* increments,
+                     float* state) {
+    switch (channels) {
+    case 1: biquadPipelineSSE2<1>(frames, numFrames, coefficients, increments, state); break;
+    case 2: biquadPipelineSSE2<2>(frames, numFrames, coefficients, increments, state); break;
+    case 4: biquadPipelineSSE2<4>(frames, numFrames, coefficients, increments, state); break;
+    default: biquadPipelineSSE2<8>(frames, numFrames, coefficients, increments, state); break;
+    }
+}
+
+const KernelTable sse2Table = {
+    InstructionSet::SSE2,
+    deinterleaveSSE2,
+    interleaveSSE2,
+    applyGainSSE2,
+    addSSE2,
+    addWithGainSSE2,
+    softClipSSE2,
+    dotProductSSE2,
+    interpolateSSE2,
+    applyGainRampSSE2,
+    addWithGainRampSSE2,
+    multiplyAddSSE2,
+    peakAbsSSE2,
+    fftRadix4SSE2,
+    complexMultiplyAddSSE2,
+    biquadLanesSSE2
+};
+
+#endif // OMEGA_SIMD_SSE2
+
+// ---------------------------------------------------------------------------
+// AVX2 (stereo I/O and the per-sample kernels; other channel counts reuse the
+// SSE2 transposes). Tails stay inside each function and the upper halves are
+// cleared before returning, so no legacy SSE code runs with dirty YMM state.
+
+#ifdef OMEGA_SIMD_AVX2
+
+OMEGA_TARGET_AVX2
+void deinterleaveAVX2(const float* source, float* const* dest, int numChannels, int numFrames, float gain) {
+    if (numChannels != 2) {
+        deinterleaveSSE2(source, dest, numChannels, numFrames, gain);
+        return;
+    }
+
+    const __m256 g = _mm256_set1_ps(gain);
+    const int vectorFrames = numFrames & ~7;
+    float* left = dest[0];
+    float* right = dest[1];
+    for (int frame = 0; frame < vectorFrames; frame += 8) {
+        __m256 a = _mm256_loadu_ps(source + frame * 2);
+        __m256 b = _mm256_loadu_ps(source + frame * 2 + 8);
+        __m256 lo = _mm256_permute2f128_ps(a, b, 0x20);
+        __m256 hi = _mm256_permute2f128_ps(a, b, 0x31);
+        _mm256_storeu_ps(left + frame, _mm256_mul_ps(_mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)), g));
+        _mm256_storeu_ps(right + frame, _mm256_mul_ps(_mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)), g));
+    }
+    for (int frame = vectorFrames; frame < numFrames; ++frame) {
+        left[frame] = source[frame * 2] * gain;
+        right[frame] = source[frame * 2 + 1] * gain;
+    }
+    _mm256_zeroupper();
+}
+
+OMEGA_TARGET_AVX2
+void interleaveAVX2(const float* const* source, float* dest, int numChannels, int numFrames) {
+    if (numChannels != 2) {
+        interleaveSSE2(source, dest, numChannels, numFrames);
+        return;
+    }
+
+    const int vectorFrames = numFrames & ~7;
+    const float* left = source[0];
+    const float* right = source[1];
+    for (int frame = 0; frame < vectorFrames; frame += 8) {
+        __m256 l = _mm256_loadu_ps(left + frame);
+        __m256 r = _mm256_loadu_ps(right + frame);
+        __m256 lo = _mm256_unpacklo_ps(l, r);
+        __m256 hi = _mm256_unpackhi_ps(l, r);
+        _mm256_storeu_ps(dest + frame * 2, _mm256_permute2f128_ps(lo, hi, 0x20));
+        _mm256_storeu_ps(dest + frame * 2 + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+    for (int frame = vectorFrames; frame < numFrames; ++frame) {
+        dest[frame * 2] = left[frame];
+        dest[frame * 2 + 1] = right[frame];
+    }
+    _mm256_zeroupper();
+}
+
+OMEGA_TARGET_AVX2
+void applyGainAVX2(float* buffer, int numSamples, float gain) {
+    const __m256 g = _mm256_set1_ps(gain);
+    int i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        _mm256_storeu_ps(buffer + i, _mm256_mul_ps(_mm256_loadu_ps(buffer + i), g));
+    }
+    for (; i < numSamples; ++i) {
+        buffer[i] *= gain;
+    }
+    _mm256_zeroupper();
+}
+
+OMEGA_TARGET_AVX2
+void addAVX2(float* dest, const float* source, int numSamples) {
+    int i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        _mm256_storeu_ps(dest + i, _mm256_add_ps(_mm256_loadu_ps(dest + i), _mm256_loadu_ps(source + i)));
+    }
+    for (; i < numSamples; ++i) {
+        dest[i] += source[i];
+    }
+    _mm256_zeroupper();
+}
+
+OMEGA_TARGET_AVX2
+void addWithGainAVX2(float* dest, const float* source, int numSamples, float gain) {
+    // Separate multiply and add (no FMA) so results match the other paths
+    const __m256 g = _mm256_set1_ps(gain);
+    int i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        __m256 scaled = _mm256_mul_ps(_mm256_loadu_ps(source + i), g);
+        _mm256_storeu_ps(dest + i, _mm256_add_ps(_mm256_loadu_ps(dest + i), scaled));
+    }
+    for (; i < numSamples; ++i) {
+        dest[i] += source[i] * gain;
+    }
+    _mm256_zeroupper();
+}
+
+OMEGA_TARGET_AVX2
+void softClipAVX2(float* buffer, int numSamples) {
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 minusOne = _mm256_set1_ps(-1.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const __m256 threshold = _mm256_set1_ps(kSoftClipThreshold);
+
+    int i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        __m256 x = _mm256_loadu_ps(buffer + i);
+        __m256 y = _mm256_min_ps(one, _mm256_max_ps(minusOne, _mm256_mul_ps(x, half)));
+        __m256 y2 = _mm256_mul_ps(y, y);
+        __m256 numerator = _mm256_add_ps(_mm256_set1_ps(kP2), y2);
+        numerator = _mm256_add_ps(_mm256_set1_ps(kP1), _mm256_mul_ps(y2, numerator));
+        numerator = _mm256_mul_ps(y, _mm256_add_ps(_mm256_set1_ps(kP0), _mm256_mul_ps(y2, numerator)));
+        __m256 denominator = _mm256_add_ps(_mm256_set1_ps(kQ2), _mm256_mul_ps(y2, _mm256_set1_ps(kQ3)));
+        denominator = _mm256_add_ps(_mm256_set1_ps(kQ1), _mm256_mul_ps(y2, denominator));
+        denominator = _mm256_add_ps(_mm256_set1_ps(kP0), _mm256_mul_ps(y2, denominator));
+        __m256 clipped = _mm256_mul_ps(two, _mm256_div_ps(numerator, denominator));
+
+        __m256 mask = _mm256_cmp_ps(_mm256_and_ps(x, absMask), threshold, _CMP_GT_OQ);
+        __m256 result = _mm256_blendv_ps(x, clipped, mask);
+        _mm256_storeu_ps(buffer + i, _mm256_min_ps(one, _mm256_max_ps(minusOne, result)));
+    }
+    for (; i < numSamples; ++i) {
+        buffer[i] = softClipSample(buffer[i]);
+    }
+    _mm256_zeroupper();
+}
+
+OMEGA_TARGET_AVX2
+float dotProductAVX2(const float* a, const float* b, int numSamples) {
+    __m256 sum0 = _mm256_setzero_ps();
+    __m256 sum1 = _mm256_setzero_ps();
+    int i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8)));
+    }
+    if (i + 8 <= numSamples) {
+        sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        i += 8;
+    }
+    __m256 sum8 = _mm256_add_ps(sum0, sum1);
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(sum8), _mm256_extractf128_ps(sum8, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    float result = _mm_cvtss_f32(sum);
+    for (; i < numSamples; ++i) {
+        result += a[i] * b[i];
+    }
+    _mm256_zeroupper();
+    return result;
+}
+
+OMEGA_TARGET_AVX2
+void interpolateAVX2(float* dest, const float* a, const float* b, int numSamples, float t) {
+    const __m256 tv = _mm256_set1_ps(t);
+    int i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        __m256 va = _mm256_loadu_ps(a + i);
+        __m256 delta = _mm256_sub_ps(_mm256_loadu_ps(b + i), va);
+        _mm256_storeu_ps(dest + i, _mm256_add_ps(va, _mm256_mul_ps(delta, tv)));
+    }
+    for (; i < numSamples; ++i) {
+        dest[i] = a[i] + (b[i] - a[i]) * t;
+    }
+    _mm256_zeroupper();
+}
+
+OMEGA_TARGET_AVX2
+void applyGainRampAVX2(float* buffer, int numSamples, float startGain, float increment) {
+    const __m256 start = _mm256_set1_ps(startGain);
+    const __m256 step = _mm256_set1_ps(increment);
+    const __m256 eight = _mm256_set1_ps(8.0f);
+    __m256 index = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+    int i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        __m256 gain = _mm256_add_ps(start, _mm256_mul_ps(index, step));
+        _mm256_storeu_ps(buffer + i, _mm256_mul_ps(_mm256_loadu_ps(buffer + i), gain));
+        index = _mm256_add_ps(index, eight);
+    }
+    for (; i < numSamples; ++i) {
+        buffer[i] *= startGain + static_cast<float>(i) * increment;
+    }
+    _mm256_zeroupper();
+}
+
+OMEGA_TARGET_AVX2
+void addWithGainRampAVX2(float* dest, const float* source, int numSamples, float startGain, float increment) {
+    const __m256 start = _mm256_set1_ps(startGain);
+    const __m256 step = _mm256_set1_ps(increment);
+    const __m256 eight = _mm256_set1_ps(8.0f);
+    __m256 index = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+    int i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        __m256 gain = _mm256_add_ps(start, _mm256_mul_ps(index, step));
+        __m256 scaled = _mm256_mul_ps(_mm256_loadu_ps(source + i), gain);
+        _mm256_storeu_ps(dest + i, _mm256_add_ps(_mm256_loadu_ps(dest + i), scaled));
+        index = _mm256_add_ps(index, eight);
+    }
+    for (; i < numSamples; ++i) {
+        dest[i] += source[i] * (startGain + static_cast<float>(i) * increment);
+    }
+    _mm256_zeroupper();
+}
+
+OMEGA_TARGET_AVX2
+void multiplyAddAVX2(float* dest, const float* a, const float* b, int numSamples) {
+    int i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        __m256 product = _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        _mm256_storeu_ps(dest + i, _mm256_add_ps(_mm256_loadu_ps(dest + i), product));
+    }
+    for (; i < numSamples; ++i) {
+        dest[i] += a[i] * b[i];
+    }
+    _mm256_zeroupper();
+}
+
+OMEGA_TARGET_AVX2
+float peakAbsAVX2(const float* buffer, int numSamples) {
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 peak0 = _mm256_setzero_ps();
+    __m256 peak1 = _mm256_setzero_ps();
+    int i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        peak0 = _mm256_max_ps(peak0, _mm256_and_ps(_mm256_loadu_ps(buffer + i), absMask));
+        peak1 = _mm256_max_ps(peak1, _mm256_and_ps(_mm256_loadu_ps(buffer + i + 8), absMask));
+    }
+    __m256 peak8 = _mm256_max_ps(peak0, peak1);
+    __m128 peak = _mm_max_ps(_mm256_castps256_ps128(peak8), _mm256_extractf128_ps(peak8, 1));
+    peak = _mm_max_ps(peak, _mm_movehl_ps(peak, peak));
+    peak = _mm_max_ss(peak, _mm_shuffle_ps(peak, peak, 1));
+    float result = _mm_cvtss_f32(peak);
+    for (; i < numSamples; ++i) {
+        result = std::max(result, std::abs(buffer[i]));
+    }
+    _mm256_zeroupper();
+    return result;
+}
+
+OMEGA_TARGET_AVX2
+void fftRadix4AVX2(float* re, float* im, int n, int quarter, const float* twiddles) {
+    if (quarter < 8) {
+        fftRadix4SSE2(re, im, n, quarter, twiddles);
+        return;
+    }
+    const int vectorQuarter = quarter & ~7;
+    for (int block = 0; block < n; block += 4 * quarter) {
+        float* r = re + block;
+        float* i = im + block;
+        int j = 0;
+        for (; j < vectorQuarter; j += 8) {
+            __m256 aRe = _mm256_loadu_ps(twiddles + j);
+            __m256 aIm = _mm256_loadu_ps(twiddles + quarter + j);
+            __m256 bRe = _mm256_loadu_ps(twiddles + 2 * quarter + j);
+            __m256 bIm = _mm256_loadu_ps(twiddles + 3 * quarter + j);
+            __m256 x0Re = _mm256_loadu_ps(r + j);
+            __m256 x0Im = _mm256_loadu_ps(i + j);
+            __m256 x1Re = _mm256_loadu_ps(r + quarter + j);
+            __m256 x1Im = _mm256_loadu_ps(i + quarter + j);
+            __m256 x2Re = _mm256_loadu_ps(r + 2 * quarter + j);
+            __m256 x2Im = _mm256_loadu_ps(i + 2 * quarter + j);
+            __m256 x3Re = _mm256_loadu_ps(r + 3 * quarter + j);
+            __m256 x3Im = _mm256_loadu_ps(i + 3 * quarter + j);
+
+            __m256 t1Re = _mm256_sub_ps(_mm256_mul_ps(x1Re, aRe), _mm256_mul_ps(x1Im, aIm));
+            __m256 t1Im = _mm256_add_ps(_mm256_mul_ps(x1Re, aIm), _mm256_mul_ps(x1Im, aRe));
+            __m256 t3Re = _mm256_sub_ps(_mm256_mul_ps(x3Re, aRe), _mm256_mul_ps(x3Im, aIm));
+            __m256 t3Im = _mm256_add_ps(_mm256_mul_ps(x3Re, aIm), _mm256_mul_ps(x3Im, aRe));
+            __m256 a0Re = _mm256_add_ps(x0Re, t1Re);
+            __m256 a0Im = _mm256_add_ps(x0Im, t1Im);
+            __m256 a1Re = _mm256_sub_ps(x0Re, t1Re);
+            __m256 a1Im = _mm256_sub_ps(x0Im, t1Im);
+            __m256 a2Re = _mm256_add_ps(x2Re, t3Re);
+            __m256 a2Im = _mm256_add_ps(x2Im, t3Im);
+            __m256 a3Re = _mm256_sub_ps(x2Re, t3Re);
+            __m256 a3Im = _mm256_sub_ps(x2Im, t3Im);
+
+            __m256 u2Re = _mm256_sub_ps(_mm256_mul_ps(a2Re, bRe), _mm256_mul_ps(a2Im, bIm));
+            __m256 u2Im = _mm256_add_ps(_mm256_mul_ps(a2Re, bIm), _mm256_mul_ps(a2Im, bRe));
+            __m256 u3Re = _mm256_sub_ps(_mm256_mul_ps(a3Re, bRe), _mm256_mul_ps(a3Im, bIm));
+            __m256 u3Im = _mm256_add_ps(_mm256_mul_ps(a3Re, bIm), _mm256_mul_ps(a3Im, bRe));
+            _mm256_storeu_ps(r + j, _mm256_add_ps(a0Re, u2Re));
+            _mm256_storeu_ps(i + j, _mm256_add_ps(a0Im, u2Im));
+            _mm256_storeu_ps(r + 2 * quarter + j, _mm256_sub_ps(a0Re, u2Re));
+            _mm256_storeu_ps(i + 2 * quarter + j, _mm256_sub_ps(a0Im, u2Im));
+            _mm256_storeu_ps(r + quarter + j, _mm256_add_ps(a1Re, u3Im));
+            _mm256_storeu_ps(i + quarter + j, _mm256_sub_ps(a1Im, u3Re));
+            _mm256_storeu_ps(r + 3 * quarter + j, _mm256_sub_ps(a1Re, u3Im));
+            _mm256_storeu_ps(i + 3 * quarter + j, _mm256_add_ps(a1Im, u3Re));
+        }
+        for (; j < quarter; ++j) {
+            radix4Butterfly(r, i, quarter, twiddles, j);
+        }
+    }
+    _mm256_zeroupper();
+}
+
+OMEGA_TARGET_AVX2
+void complexMultiplyAddAVX2(float* dest, const float* a, const float* b, int numComplex) {
+    const __m256 signs = _mm256_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f);
+    const int numFloats = 2 * numComplex;
+    int k = 0;
+    for (; k + 8 <= numFloats; k += 8) {
+        __m256 va = _mm256_loadu_ps(a + k);
+        __m256 vb = _mm256_loadu_ps(b + k);
+        __m256 aRe = _mm256_shuffle_ps(va, va, _MM_SHUFFLE(2, 2, 0, 0));
+        __m256 aIm = _mm256_shuffle_ps(va, va, _MM_SHUFFLE(3, 3, 1, 1));
+        __m256 bSwapped = _mm256_shuffle_ps(vb, vb, _MM_SHUFFLE(2, 3, 0, 1));
+        __m256 cross = _mm256_xor_ps(_mm256_mul_ps(aIm, bSwapped), signs);
+        __m256 product = _mm256_add_ps(_mm256_mul_ps(aRe, vb), cross);
+        _mm256_storeu_ps(dest + k, _mm256_add_ps(_mm256_loadu_ps(dest + k), product));
+    }
+    for (; k < numFloats; k += 2) {
+        float re = a[k] * b[k] - a[k + 1] * b[k + 1];
+        float im = a[k] * b[k + 1] + a[k + 1] * b[k];
+        dest[k] += re;
+        dest[k + 1] += im;
+    }
+    _mm256_zeroupper();
+}
+
+// All eight lanes in one vector; the shift between sections is a lane
+// permute, blended with the frame for lanes below Channels
+template <int Channels>
+OMEGA_TARGET_AVX2
+void biquadPipelineAVX2(float* frames, int numFrames, float* coefficients, const float* increments,
+                        float* state) {
+    constexpr int sections = kBiquadLanes / Channels;
+    const __m256i shift = _mm256_setr_epi32((0 - Channels) & 7, (1 - Channels) & 7, (2 - Channels) & 7,
+                                            (3 - Channels) & 7, (4 - Channels) & 7, (5 - Channels) & 7,
+                                            (6 - Channels) & 7, (7 - Channels) & 7);
+    const __m256 inputLanes = _mm256_castsi256_ps(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kLaneMasks + kBiquadLanes - Channels)));
+    __m256 c[5], d[5];
+    for (int k = 0; k < 5; ++k) {
+        c[k] = _mm256_loadu_ps(coefficients + k * kBiquadLanes);
+        d[k] = increments ? _mm256_loadu_ps(increments + k * kBiquadLanes) : _mm256_setzero_ps();
+    }
+    __m256 s1 = _mm256_loadu_ps(state);
+    __m256 s2 = _mm256_loadu_ps(state + kBiquadLanes);
+    __m256 out = _mm256_setzero_ps();
+
+    for (int step = 0; step < numFrames + sections - 1; ++step) {
+        const float* in = step < numFrames ? frames + step * Channels : kSilentFrame;
+        __m256 x;
+        if constexpr (Channels == 1) {
+            x = _mm256_blendv_ps(_mm256_permutevar8x32_ps(out, shift), _mm256_castps128_ps256(_mm_load_ss(in)),
+                                 inputLanes);
+        } else if constexpr (Channels == 2) {
+            __m128 pair = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(in)));
+            x = _mm256_blendv_ps(_mm256_permutevar8x32_ps(out, shift), _mm256_castps128_ps256(pair), inputLanes);
+        } else if constexpr (Channels == 4) {
+            x = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(in)), _mm256_castps256_ps128(out), 1);
+        } else {
+            x = _mm256_loadu_ps(in);
+        }
+
+        __m256 y = _mm256_add_ps(_mm256_mul_ps(c[0], x), s1);
+        __m256 n1 = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(c[1], x), s2), _mm256_mul_ps(c[3], y));
+        __m256 n2 = _mm256_sub_ps(_mm256_mul_ps(c[2], x), _mm256_mul_ps(c[4], y));
+
+        if (step >= sections - 1 && step < numFrames) {
+            s1 = n1;
+            s2 = n2;
+            out = y;
+            if (increments) {
+                for (int k = 0; k < 5; ++k) {
+                    c[k] = _mm256_add_ps(c[k], d[k]);
+                }
+            }
+        } else {
+            int below, from;
+            biquadActiveLanes(step, numFrames, Channels, below, from);
+            __m256 mask = _mm256_castsi256_ps(
+                _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(kLaneMasks + below)),
+                                 _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kLaneMasks + from))));
+            s1 = _mm256_blendv_ps(s1, n1, mask);
+            s2 = _mm256_blendv_ps(s2, n2, mask);
+            out = _mm256_blendv_ps(out, y, mask);
+            if (increments) {
+                for (int k = 0; k < 5; ++k) {
+                    c[k] = _mm256_blendv_ps(c[k], _mm256_add_ps(c[k], d[k]), mask);
+                }
+            }
+        }
+
+        if (step >= sections - 1) {
+            float* dest = frames + (step - sections + 1) * Channels;
+            __m128 high = _mm256_extractf128_ps(out, 1);
+            if constexpr (Channels == 1) {
+                _mm_store_ss(dest, _mm_shuffle_ps(high, high, _MM_SHUFFLE(3, 3, 3, 3)));
+            } else if constexpr (Channels == 2) {
+                _mm_storeh_pi(reinterpret_cast<__m64*>(dest), high);
+            } else if constexpr (Channels == 4) {
+                _mm_storeu_ps(dest, high);
+            } else {
+                _mm256_storeu_ps(dest, out);
+            }
+        }
+    }
+
+    for (int k = 0; k < 5; ++k) {
+        _mm256_storeu_ps(coefficients + k * kBiquadLanes, c[k]);
+    }
+    _mm256_storeu_ps(state, s1);
+    _mm256_storeu_ps(state + kBiquadLanes, s2);
+    _mm256_zeroupper();
+}
+
+OMEGA_TARGET_AVX2
+void biquadLanesAVX2(float* frames, int numFrames, int channels, float* coefficients, const float* increments,
+                     float* state) {
+    switch (channels) {
+    case 1: biquadPipelineAVX2<1>(frames, numFrames, coefficients, increments, state); break;
+    case 2: biquadPipelineAVX2<2>(frames, numFrames, coefficients, increments, state); break;
+    case 4: biquadPipelineAVX2<4>(frames, numFrames, coefficients, increments, state); break;
+    default: biquadPipelineAVX2<8>(frames, numFrames, coefficients, increments, state); break;
+    }
+}
+
+const KernelTable avx2Table = {
+    InstructionSet::AVX2,
+    deinterleaveAVX2,
+    interleaveAVX2,
+    applyGainAVX2,
+    addAVX2,
+    addWithGainAVX2,
+    softClipAVX2,
+    dotProductAVX2,
+    interpolateAVX2,
+    applyGainRampAVX2,
+    addWithGainRampAVX2,
+    multiplyAddAVX2,
+    peakAbsAVX2,
+    fftRadix4AVX2,
+    complexMultiplyAddAVX2,
+    biquadLanesAVX2
+};
+
+#endif // OMEGA_SIMD_AVX2
+
+// ---------------------------------------------------------------------------
+// AVX-512 (the streaming gain/sum kernels used for buffer math; tails use
+// masked loads and stores). Interleaving, soft clip and the dot product gain
+// little from 512-bit vectors and reuse the AVX2 versions.
+
+#ifdef OMEGA_SIMD_AVX512
+
+OMEGA_TARGET_AVX512
+inline __mmask16 tailMask(int remaining) {
+    return static_cast<__mmask16>((1u << remaining) - 1u);
+}
+
+OMEGA_TARGET_AVX512
+void applyGainAVX512(float* buffer, int numSamples, float gain) {
+    const __m512 g = _mm512_set1_ps(gain);
+    int i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        _mm512_storeu_ps(buffer + i, _mm512_mul_ps(_mm512_loadu_ps(buffer + i), g));
+    }
+    if (i < numSamples) {
+        __mmask16 mask = tailMask(numSamples - i);
+        _mm512_mask_storeu_ps(buffer + i, mask, _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, buffer + i), g));
+    }
+    _mm256_zeroupper();
+}
+
+OMEGA_TARGET_AVX512
+void addAVX512(float* dest, const float* source, int numSamples) {
+    int i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        _mm512_storeu_ps(dest + i, _mm512_add_ps(_mm512_loadu_ps(dest + i), _mm512_loadu_ps(source + i)));
+    }
+    if (i < numSamples) {
+        __mmask16 mask = tailMask(numSamples - i);
+        __m512 sum = _mm512_add_ps(_mm512_maskz_loadu_ps(mask, dest + i), _mm512_maskz_loadu_ps(mask, source + i));
+        _mm512_mask_storeu_ps(dest + i, mask, sum);
+    }
+    _mm256_zeroupper();
+}
+
+OMEGA_TARGET_AVX512
+void addWithGainAVX512(float* dest, const float* source, int numSamples, float gain) {
+    const __m512 g = _mm512_set1_ps(gain);
+    int i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        __m512 scaled = _mm512_mul_ps(_mm512_loadu_ps(source + i), g);
+        _mm512_storeu_ps(dest + i, _mm512_add_ps(_mm512_loadu_ps(dest + i), scaled));
+    }
+    if (i < numSamples) {
+        __mmask16 mask = tailMask(numSamples - i);
+        __m512 scaled = _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, source + i), g);
+        _mm512_mask_storeu_ps(dest + i, mask, _mm512_add_ps(_mm512_maskz_loadu_ps(mask, dest + i), scaled));
+    }
+    _mm256_zeroupper();
+}
+
+OMEGA_TARGET_AVX512
+void applyGainRampAVX512(float* buffer, int numSamples, float startGain, float increment) {
+    const __m512 start = _mm512_set1_ps(startGain);
+    const __m512 step = _mm512_set1_ps(increment);
+    const __m512 sixteen = _mm512_set1_ps(16.0f);
+    __m512 index = _mm512_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f,
+                                  8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f);
+    int i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        __m512 gain = _mm512_add_ps(start, _mm512_mul_ps(index, step));
+        _mm512_storeu_ps(buffer + i, _mm512_mul_ps(_mm512_loadu_ps(buffer + i), gain));
+        index = _mm512_add_ps(index, sixteen);
+    }
+    if (i < numSamples) {
+        __mmask16 mask = tailMask(numSamples - i);
+        __m512 gain = _mm512_add_ps(start, _mm512_mul_ps(index, step));
+        _mm512_mask_storeu_ps(buffer + i, mask, _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, buffer + i), gain));
+    }
+    _mm256_zeroupper();
+}
+
+OMEGA_TARGET_AVX512
+void addWithGainRampAVX512(float* dest, const float* source, int numSamples, float startGain, float increment) {
+    const __m512 start = _mm512_set1_ps(startGain);
+    const __m512 step = _mm512_set1_ps(increment);
+    const __m512 sixteen = _mm512_set1_ps(16.0f);
+    __m512 index = _mm512_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f,
+                                  8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f);
+    int i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        __m512 gain = _mm512_add_ps(start, _mm512_mul_ps(index, step));
+        __m512 scaled = _mm512_mul_ps(_mm512_loadu_ps(source + i), gain);
+        _mm512_storeu_ps(dest + i, _mm512_add_ps(_mm512_loadu_ps(dest + i), scaled));
+        index = _mm512_add_ps(index, sixteen);
+    }
+    if (i < numSamples) {
+        __mmask16 mask = tailMask(numSamples - i);
+        __m512 gain = _mm512_add_ps(start, _mm512_mul_ps(index, step));
+        __m512 scaled = _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, source + i), gain);
+        _mm512_mask_storeu_ps(dest + i, mask, _mm512_add_ps(_mm512_maskz_loadu_ps(mask, dest + i), scaled));
+    }
+    _mm256_zeroupper();
+}
+
+OMEGA_TARGET_AVX512
+void multiplyAddAVX512(float* dest, const float* a, const float* b, int numSamples) {
+    int i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        __m512 product = _mm512_mul_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+        _mm512_storeu_ps(dest + i, _mm512_add_ps(_mm512_loadu_ps(dest + i), product));
+    }
+    if (i < numSamples) {
+        __mmask16 mask = tailMask(numSamples - i);
+        __m512 product = _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i));
+        _mm512_mask_storeu_ps(dest + i, mask, _mm512_add_ps(_mm512_maskz_loadu_ps(mask, dest + i), product));
+    }
+    _mm256_zeroupper();
+}
+
+OMEGA_TARGET_AVX512
+void fftRadix4AVX512(float* re, float* im, int n, int quarter, const float* twiddles) {
+    if (quarter < 16) {
+        fftRadix4AVX2(re, im, n, quarter, twiddles);
+        return;
+    }
+    const int vectorQuarter = quarter & ~15;
+    for (int block = 0; block < n; block += 4 * quarter) {
+        float* r = re + block;
+        float* i = im + block;
+        int j = 0;
+        for (; j < vectorQuarter; j += 16) {
+            __m512 aRe = _mm512_loadu_ps(twiddles + j);
+            __m512 aIm = _mm512_loadu_ps(twiddles + quarter + j);
+            __m512 bRe = _mm512_loadu_ps(twiddles + 2 * quarter + j);
+            __m512 bIm = _mm512_loadu_ps(twiddles + 3 * quarter + j);
+            __m512 x0Re = _mm512_loadu_ps(r + j);
+            __m512 x0Im = _mm512_loadu_ps(i + j);
+            __m512 x1Re = _mm512_loadu_ps(r + quarter + j);
+            __m512 x1Im = _mm512_loadu_ps(i + quarter + j);
+            __m512 x2Re = _mm512_loadu_ps(r + 2 * quarter + j);
+            __m512 x2Im = _mm512_loadu_ps(i + 2 * quarter + j);
+            __m512 x3Re = _mm512_loadu_ps(r + 3 * quarter + j);
+            __m512 x3Im = _mm512_loadu_ps(i + 3 * quarter + j);
+
+            __m512 t1Re = _mm512_sub_ps(_mm512_mul_ps(x1Re, aRe), _mm512_mul_ps(x1Im, aIm));
+            __m512 t1Im = _mm512_add_ps(_mm512_mul_ps(x1Re, aIm), _mm512_mul_ps(x1Im, aRe));
+            __m512 t3Re = _mm512_sub_ps(_mm512_mul_ps(x3Re, aRe), _mm512_mul_ps(x3Im, aIm));
+            __m512 t3Im = _mm512_add_ps(_mm512_mul_ps(x3Re, aIm), _mm512_mul_ps(x3Im, aRe));
+            __m512 a0Re = _mm512_add_ps(x0Re, t1Re);
+            __m512 a0Im = _mm512_add_ps(x0Im, t1Im);
+            __m512 a1Re = _mm512_sub_ps(x0Re, t1Re);
+            __m512 a1Im = _mm512_sub_ps(x0Im, t1Im);
+            __m512 a2Re = _mm512_add_ps(x2Re, t3Re);
+            __m512 a2Im = _mm512_add_ps(x2Im, t3Im);
+            __m512 a3Re = _mm512_sub_ps(x2Re, t3Re);
+            __m512 a3Im = _mm512_sub_ps(x2Im, t3Im);
+
+            __m512 u2Re = _mm512_sub_ps(_mm512_mul_ps(a2Re, bRe), _mm512_mul_ps(a2Im, bIm));
+            __m512 u2Im = _mm512_add_ps(_mm512_mul_ps(a2Re, bIm), _mm512_mul_ps(a2Im, bRe));
+            __m512 u3Re = _mm512_sub_ps(_mm512_mul_ps(a3Re, bRe), _mm512_mul_ps(a3Im, bIm));
+            __m512 u3Im = _mm512_add_ps(_mm512_mul_ps(a3Re, bIm), _mm512_mul_ps(a3Im, bRe));
+            _mm512_storeu_ps(r + j, _mm512_add_ps(a0Re, u2Re));
+            _mm512_storeu_ps(i + j, _mm512_add_ps(a0Im, u2Im));
+            _mm512_storeu_ps(r + 2 * quarter + j, _mm512_sub_ps(a0Re, u2Re));
+            _mm512_storeu_ps(i + 2 * quarter + j, _mm512_sub_ps(a0Im, u2Im));
+            _mm512_storeu_ps(r + quarter + j, _mm512_add_ps(a1Re, u3Im));
+            _mm512_storeu_ps(i + quarter + j, _mm512_sub_ps(a1Im, u3Re));
+            _mm512_storeu_ps(r + 3 * quarter + j, _mm512_sub_ps(a1Re, u3Im));
+            _mm512_storeu_ps(i + 3 * quarter + j, _mm512_add_ps(a1Im, u3Re));
+        }
+        for (; j < quarter; ++j) {
+            radix4Butterfly(r, i, quarter, twiddles, j);
+        }
+    }
+    _mm256_zeroupper();
+}
+
+OMEGA_TARGET_AVX512
+void complexMultiplyAddAVX512(float* dest, const float* a, const float* b, int numComplex) {
+    // Subtract the cross term in the real lanes, add it in the imaginary ones
+    const __mmask16 realLanes = 0x5555;
+    const int numFloats = 2 * numComplex;
+    int k = 0;
+    for (; k < numFloats; k += 16) {
+        __mmask16 mask = k + 16 <= numFloats ? static_cast<__mmask16>(0xffff) : tailMask(numFloats - k);
+        __m512 va = _mm512_maskz_loadu_ps(mask, a + k);
+        __m512 vb = _mm512_maskz_loadu_ps(mask, b + k);
+        __m512 aRe = _mm512_shuffle_ps(va, va, _MM_SHUFFLE(2, 2, 0, 0));
+        __m512 aIm = _mm512_shuffle_ps(va, va, _MM_SHUFFLE(3, 3, 1, 1));
+        __m512 bSwapped = _mm512_shuffle_ps(vb, vb, _MM_SHUFFLE(2, 3, 0, 1));
+        __m512 direct = _mm512_mul_ps(aRe, vb);
+        __m512 cross = _mm512_mul_ps(aIm, bSwapped);
+        __m512 product = _mm512_mask_sub_ps(_mm512_add_ps(direct, cross), realLanes, direct, cross);
+        _mm512_mask_storeu_ps(dest + k, mask, _mm512_add_ps(_mm512_maskz_loadu_ps(mask, dest + k), product));
+    }
+    _mm256_zeroupper();
+}
+
+const KernelTable avx512Table = {
+    InstructionSet::AVX512,
+    deinterleaveAVX2,
+    interleaveAVX2,
+    applyGainAVX512,
+    addAVX512,
+    addWithGainAVX512,
+    softClipAVX2,
+    dotProductAVX2,
+    interpolateAVX2,
+    applyGainRampAVX512,
+    addWithGainRampAVX512,
+    multiplyAddAVX512,
+    peakAbsAVX2,
+    fftRadix4AVX512,
+    complexMultiplyAddAVX512,
+    biquadLanesAVX2
+};
+
+#endif // OMEGA_SIMD_AVX512
+
+// ---------------------------------------------------------------------------
+// NEON (AArch64)
+
+#ifdef OMEGA_SIMD_NEON
+
+inline void transpose4(float32x4_t& r0, float32x4_t& r1, float32x4_t& r2, float32x4_t& r3) {
+    float32x4x2_t t01 = vtrnq_f32(r0, r1);
+    float32x4x2_t t23 = vtrnq_f32(r2, r3);
+    r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+    r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+    r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+    r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+}
+
+void deinterleaveNEON(const float* source, float* const* dest, int numChannels, int numFrames, float gain) {
+    const float32x4_t g = vdupq_n_f32(gain);
+    const int vectorFrames = numFrames & ~3;
+
+    if (numChannels == 2) {
+        float* left = dest[0];
+        float* right = dest[1];
+        for (int frame = 0; frame < vectorFrames; frame += 4) {
+            float32x4x2_t lr = vld2q_f32(source + frame * 2);
+            vst1q_f32(left + frame, vmulq_f32(lr.val[0], g));
+            vst1q_f32(right + frame, vmulq_f32(lr.val[1], g));
+        }
+        for (int frame = vectorFrames; frame < numFrames; ++frame) {
+            left[frame] = source[frame * 2] * gain;
+            right[frame] = source[frame * 2 + 1] * gain;
+        }
+        return;
+    }
+
+    int ch = 0;
+    for (; ch + 4 <= numChannels; ch += 4) {
+        for (int frame = 0; frame < vectorFrames; frame += 4) {
+            const float* base = source + frame * numChannels + ch;
+            float32x4_t r0 = vld1q_f32(base);
+            float32x4_t r1 = vld1q_f32(base + numChannels);
+            float32x4_t r2 = vld1q_f32(base + 2 * numChannels);
+            float32x4_t r3 = vld1q_f32(base + 3 * numChannels);
+            transpose4(r0, r1, r2, r3);
+            vst1q_f32(dest[ch] + frame, vmulq_f32(r0, g));
+            vst1q_f32(dest[ch + 1] + frame, vmulq_f32(r1, g));
+            vst1q_f32(dest[ch + 2] + frame, vmulq_f32(r2, g));
+            vst1q_f32(dest[ch + 3] + frame, vmulq_f32(r3, g));
+        }
+        for (int frame = vectorFrames; frame < numFrames; ++frame) {
+            for (int c = ch; c < ch + 4; ++c) {
+                dest[c][frame] = source[frame * numChannels + c] * gain;
+            }
+        }
+    }
+    for (; ch < numChannels; ++ch) {
+        for (int frame = 0; frame < numFrames; ++frame) {
+            dest[ch][frame] = source[frame * numChannels + ch] * gain;
+        }
+    }
+}
+
+void interleaveNEON(const float* const* source, float* dest, int numChannels, int numFrames) {
+    const int vectorFrames = numFrames & ~3;
+
+    if (numChannels == 2) {
+        const float* left = source[0];
+        const float* right = source[1];
+        for (int frame = 0; frame < vectorFrames; frame += 4) {
+            float32x4x2_t lr;
+            lr.val[0] = vld1q_f32(left + frame);
+            lr.val[1] = vld1q_f32(right + frame);
+            vst2q_f32(dest + frame * 2, lr);
+        }
+        for (int frame = vectorFrames; frame < numFrames; ++frame) {
+            dest[frame * 2] = left[frame];
+            dest[frame * 2 + 1] = right[frame];
+        }
+        return;
+    }
+
+    int ch = 0;
+    for (; ch + 4 <= numChannels; ch += 4) {
+        for (int frame = 0; frame < vectorFrames; frame += 4) {
+            float32x4_t r0 = vld1q_f32(source[ch] + frame);
+            float32x4_t r1 = vld1q_f32(source[ch + 1] + frame);
+            float32x4_t r2 = vld1q_f32(source[ch + 2] + frame);
+            float32x4_t r3 = vld1q_f32(source[ch + 3] + frame);
+            transpose4(r0, r1, r2, r3);
+            float* base = dest + frame * numChannels + ch;
+            vst1q_f32(base, r0);
+            vst1q_f32(base + numChannels, r1);
+            vst1q_f32(base + 2 * numChannels, r2);
+            vst1q_f32(base + 3 * numChannels, r3);
+        }
+        for (int frame = vectorFrames; frame < numFrames; ++frame) {
+            for (int c = ch; c < ch + 4; ++c) {
+                dest[frame * numChannels + c] = source[c][frame];
+            }
+        }
+    }
+    for (; ch < numChannels; ++ch) {
+        for (int frame = 0; frame < numFrames; ++frame) {
+            dest[frame * numChannels + ch] = source[ch][frame];
+        }
+    }
+}
+
+void applyGainNEON(float* buffer, int numSamples, float gain) {
+    const float32x4_t g = vdupq_n_f32(gain);
+    int i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        vst1q_f32(buffer + i, vmulq_f32(vld1q_f32(buffer + i), g));
+    }
+    applyGainScalar(buffer + i, numSamples - i, gain);
+}
+
+void addNEON(float* dest, const float* source, int numSamples) {
+    int i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        vst1q_f32(dest + i, vaddq_f32(vld1q_f32(dest + i), vld1q_f32(source + i)));
+    }
+    addScalar(dest + i, source + i, numSamples - i);
+}
+
+void addWithGainNEON(float* dest, const float* source, int numSamples, float gain) {
+    const float32x4_t g = vdupq_n_f32(gain);
+    int i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        float32x4_t scaled = vmulq_f32(vld1q_f32(source + i), g);
+        vst1q_f32(dest + i, vaddq_f32(vld1q_f32(dest + i), scaled));
+    }
+    addWithGainScalar(dest + i, source + i, numSamples - i, gain);
+}
+
+void softClipNEON(float* buffer, int numSamples) {
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t minusOne = vdupq_n_f32(-1.0f);
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    const float32x4_t two = vdupq_n_f32(2.0f);
+    const float32x4_t threshold = vdupq_n_f32(kSoftClipThreshold);
+
+    int i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        float32x4_t x = vld1q_f32(buffer + i);
+        float32x4_t y = vminq_f32(one, vmaxq_f32(minusOne, vmulq_f32(x, half)));
+        float32x4_t y2 = vmulq_f32(y, y);
+        float32x4_t numerator = vaddq_f32(vdupq_n_f32(kP2), y2);
+        numerator = vaddq_f32(vdupq_n_f32(kP1), vmulq_f32(y2, numerator));
+        numerator = vmulq_f32(y, vaddq_f32(vdupq_n_f32(kP0), vmulq_f32(y2, numerator)));
+        float32x4_t denominator = vaddq_f32(vdupq_n_f32(kQ2), vmulq_f32(y2, vdupq_n_f32(kQ3)));
+        denominator = vaddq_f32(vdupq_n_f32(kQ1), vmulq_f32(y2, denominator));
+        denominator = vaddq_f32(vdupq_n_f32(kP0), vmulq_f32(y2, denominator));
+        float32x4_t clipped = vmulq_f32(two, vdivq_f32(numerator, denominator));
+
+        uint32x4_t mask = vcgtq_f32(vabsq_f32(x), threshold);
+        float32x4_t result = vbslq_f32(mask, clipped, x);
+        vst1q_f32(buffer + i, vminq_f32(one, vmaxq_f32(minusOne, result)));
+    }
+    softClipScalar(buffer + i, numSamples - i);
+}
+
+float dotProductNEON(const float* a, const float* b, int numSamples) {
+    float32x4_t sum0 = vdupq_n_f32(0.0f);
+    float32x4_t sum1 = vdupq_n_f32(0.0f);
+    int i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        sum0 = vaddq_f32(sum0, vmulq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+        sum1 = vaddq_f32(sum1, vmulq_f32(vld1q_f32(a + i + 4), vld1q_f32(b + i + 4)));
+    }
+    return vaddvq_f32(vaddq_f32(sum0, sum1)) + dotProductScalar(a + i, b + i, numSamples - i);
+}
+
+void interpolateNEON(float* dest, const float* a, const float* b, int numSamples, float t) {
+    const float32x4_t tv = vdupq_n_f32(t);
+    int i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        float32x4_t va = vld1q_f32(a + i);
+        float32x4_t delta = vsubq_f32(vld1q_f32(b + i), va);
+        vst1q_f32(dest + i, vaddq_f32(va, vmulq_f32(delta, tv)));
+    }
+    interpolateScalar(dest + i, a + i, b + i, numSamples - i, t);
+}
+
+void applyGainRampNEON(float* buffer, int numSamples, float startGain, float increment) {
+    const float32x4_t start = vdupq_n_f32(startGain);
+    const float32x4_t step = vdupq_n_f32(increment);
+    const float32x4_t four = vdupq_n_f32(4.0f);
+    const float indices[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+    float32x4_t index = vld1q_f32(indices);
+    int i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        float32x4_t gain = vaddq_f32(start, vmulq_f32(index, step));
+        vst1q_f32(buffer + i, vmulq_f32(vld1q_f32(buffer + i), gain));
+        index = vaddq_f32(index, four);
+    }
+    for (; i < numSamples; ++i) {
+        buffer[i] *= startGain + static_cast<float>(i) * increment;
+    }
+}
+
+void addWithGainRampNEON(float* dest, const float* source, int numSamples, float startGain, float increment) {
+    const float32x4_t start = vdupq_n_f32(startGain);
+    const float32x4_t step = vdupq_n_f32(increment);
+    const float32x4_t four = vdupq_n_f32(4.0f);
+    const float indices[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+    float32x4_t index = vld1q_f32(indices);
+    int i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        float32x4_t gain = vaddq_f32(start, vmulq_f32(index, step));
+        float32x4_t scaled = vmulq_f32(vld1q_f32(source + i), gain);
+        vst1q_f32(dest + i, vaddq_f32(vld1q_f32(dest + i), scaled));
+        index = vaddq_f32(index, four);
+    }
+    for (; i < numSamples; ++i) {
+        dest[i] += source[i] * (startGain + static_cast<float>(i) * increment);
+    }
+}
+
+void multiplyAddNEON(float* dest, const float* a, const float* b, int numSamples) {
+    int i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        float32x4_t product = vmulq_f32(vld1q_f32(a + i), vld1q_f32(b + i));
+        vst1q_f32(dest + i, vaddq_f32(vld1q_f32(dest + i), product));
+    }
+    multiplyAddScalar(dest + i, a + i, b + i, numSamples - i);
+}
+
+float peakAbsNEON(const float* buffer, int numSamples) {
+    float32x4_t peak0 = vdupq_n_f32(0.0f);
+    float32x4_t peak1 = vdupq_n_f32(0.0f);
+    int i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        peak0 = vmaxq_f32(peak0, vabsq_f32(vld1q_f32(buffer + i)));
+        peak1 = vmaxq_f32(peak1, vabsq_f32(vld1q_f32(buffer + i + 4)));
+    }
+    return std::max(vmaxvq_f32(vmaxq_f32(peak0, peak1)), peakAbsScalar(buffer + i, numSamples - i));
+}
+
+void fftRadix4NEON(float* re, float* im, int n, int quarter, const float* twiddles) {
+    if (quarter < 4) {
+        fftRadix4Scalar(re, im, n, quarter, twiddles);
+        return;
+    }
+    const int vectorQuarter = quarter & ~3;
+    for (int block = 0; block < n; block += 4 * quarter) {
+        float* r = re + block;
+        float* i = im + block;
+        int j = 0;
+        for (; j < vectorQuarter; j += 4) {
+            float32x4_t aRe = vld1q_f32(twiddles + j);
+            float32x4_t aIm = vld1q_f32(twiddles + quarter + j);
+            float32x4_t bRe = vld1q_f32(twiddles + 2 * quarter + j);
+            float32x4_t bIm = vld1q_f32(twiddles + 3 * quarter + j);
+            float32x4_t x0Re = vld1q_f32(r + j);
+            float32x4_t x0Im = vld1q_f32(i + j);
+            float32x4_t x1Re = vld1q_f32(r + quarter + j);
+            float32x4_t x1Im = vld1q_f32(i + quarter + j);
+            float32x4_t x2Re = vld1q_f32(r + 2 * quarter + j);
+            float32x4_t x2Im = vld1q_f32(i + 2 * quarter + j);
+            float32x4_t x3Re = vld1q_f32(r + 3 * quarter + j);
+            float32x4_t x3Im = vld1q_f32(i + 3 * quarter + j);
+
+            float32x4_t t1Re = vsubq_f32(vmulq_f32(x1Re, aRe), vmulq_f32(x1Im, aIm));
+            float32x4_t t1Im = vaddq_f32(vmulq_f32(x1Re, aIm), vmulq_f32(x1Im, aRe));
+            float32x4_t t3Re = vsubq_f32(vmulq_f32(x3Re, aRe), vmulq_f32(x3Im, aIm));
+            float32x4_t t3Im = vaddq_f32(vmulq_f32(x3Re, aIm), vmulq_f32(x3Im, aRe));
+            float32x4_t a0Re = vaddq_f32(x0Re, t1Re);
+            float32x4_t a0Im = vaddq_f32(x0Im, t1Im);
+            float32x4_t a1Re = vsubq_f32(x0Re, t1Re);
+            float32x4_t a1Im = vsubq_f32(x0Im, t1Im);
+            float32x4_t a2Re = vaddq_f32(x2Re, t3Re);
+            float32x4_t a2Im = vaddq_f32(x2Im, t3Im);
+            float32x4_t a3Re = vsubq_f32(x2Re, t3Re);
+            float32x4_t a3Im = vsubq_f32(x2Im, t3Im);
+
+            float32x4_t u2Re = vsubq_f32(vmulq_f32(a2Re, bRe), vmulq_f32(a2Im, bIm));
+            float32x4_t u2Im = vaddq_f32(vmulq_f32(a2Re, bIm), vmulq_f32(a2Im, bRe));
+            float32x4_t u3Re = vsubq_f32(vmulq_f32(a3Re, bRe), vmulq_f32(a3Im, bIm));
+            float32x4_t u3Im = vaddq_f32(vmulq_f32(a3Re, bIm), vmulq_f32(a3Im, bRe));
+            vst1q_f32(r + j, vaddq_f32(a0Re, u2Re));
+            vst1q_f32(i + j, vaddq_f32(a0Im, u2Im));
+            vst1q_f32(r + 2 * quarter + j, vsubq_f32(a0Re, u2Re));
+            vst1q_f32(i + 2 * quarter + j, vsubq_f32(a0Im, u2Im));
+            vst1q_f32(r + quarter + j, vaddq_f32(a1Re, u3Im));
+            vst1q_f32(i + quarter + j, vsubq_f32(a1Im, u3Re));
+            vst1q_f32(r + 3 * quarter + j, vsubq_f32(a1Re, u3Im));
+            vst1q_f32(i + 3 * quarter + j, vaddq_f32(a1Im, u3Re));
+        }
+        for (; j < quarter; ++j) {
+            radix4Butterfly(r, i, quarter, twiddles, j);
+        }
+    }
+}
+
+void complexMultiplyAddNEON(float* dest, const float* a, const float* b, int numComplex) {
+    int k = 0;
+    for (; k + 4 <= numComplex; k += 4) {
+        float32x4x2_t va = vld2q_f32(a + 2 * k);
+        float32x4x2_t vb = vld2q_f32(b + 2 * k);
+        float32x4x2_t acc = vld2q_f32(dest + 2 * k);
+        float32x4_t re = vsubq_f32(vmulq_f32(va.val[0], vb.val[0]), vmulq_f32(va.val[1], vb.val[1]));
+        float32x4_t im = vaddq_f32(vmulq_f32(va.val[0], vb.val[1]), vmulq_f32(va.val[1], vb.val[0]));
+        acc.val[0] = vaddq_f32(acc.val[0], re);
+        acc.val[1] = vaddq_f32(acc.val[1], im);
+        vst2q_f32(dest + 2 * k, acc);
+    }
+    complexMultiplyAddScalar(dest + 2 * k, a + 2 * k, b + 2 * k, numComplex - k);
+}
+
+// Lanes 0-3 and 4-7 as two vectors, shifted between sections with vext
+template <int Channels>
+void biquadPipelineNEON(float* frames, int numFrames, float* coefficients, const float* increments,
+                        float* state) {
+    constexpr int sections = kBiquadLanes / Channels;
+    float32x4_t cLo[5], cHi[5], dLo[5], dHi[5];
+    for (int k = 0; k < 5; ++k) {
+        cLo[k] = vld1q_f32(coefficients + k * kBiquadLanes);
+        cHi[k] = vld1q_f32(coefficients + k * kBiquadLanes + 4);
+        dLo[k] = increments ? vld1q_f32(increments + k * kBiquadLanes) : vdupq_n_f32(0.0f);
+        dHi[k] = increments ? vld1q_f32(increments + k * kBiquadLanes + 4) : vdupq_n_f32(0.0f);
+    }
+    float32x4_t s1Lo = vld1q_f32(state);
+    float32x4_t s1Hi = vld1q_f32(state + 4);
+    float32x4_t s2Lo = vld1q_f32(state + kBiquadLanes);
+    float32x4_t s2Hi = vld1q_f32(state + kBiquadLanes + 4);
+    float32x4_t outLo = vdupq_n_f32(0.0f);
+    float32x4_t outHi = vdupq_n_f32(0.0f);
+
+    for (int step = 0; step < numFrames + sections - 1; ++step) {
+        const float* in = step < numFrames ? frames + step * Channels : kSilentFrame;
+        float32x4_t xLo, xHi;
+        if constexpr (Channels == 1) {
+            xLo = vextq_f32(vld1q_dup_f32(in), outLo, 3);
+            xHi = vextq_f32(outLo, outHi, 3);
+        } else if constexpr (Channels == 2) {
+            xLo = vcombine_f32(vld1_f32(in), vget_low_f32(outLo));
+            xHi = vextq_f32(outLo, outHi, 2);
+        } else if constexpr (Channels == 4) {
+            xLo = vld1q_f32(in);
+            xHi = outLo;
+        } else {
+            xLo = vld1q_f32(in);
+            xHi = vld1q_f32(in + 4);
+        }
+
+        float32x4_t yLo = vaddq_f32(vmulq_f32(cLo[0], xLo), s1Lo);
+        float32x4_t yHi = vaddq_f32(vmulq_f32(cHi[0], xHi), s1Hi);
+        float32x4_t n1Lo = vsubq_f32(vaddq_f32(vmulq_f32(cLo[1], xLo), s2Lo), vmulq_f32(cLo[3], yLo));
+        float32x4_t n1Hi = vsubq_f32(vaddq_f32(vmulq_f32(cHi[1], xHi), s2Hi), vmulq_f32(cHi[3], yHi));
+        float32x4_t n2Lo = vsubq_f32(vmulq_f32(cLo[2], xLo), vmulq_f32(cLo[4], yLo));
+        float32x4_t n2Hi = vsubq_f32(vmulq_f32(cHi[2], xHi), vmulq_f32(cHi[4], yHi));
+
+        if (step >= sections - 1 && step < numFrames) {
+            s1Lo = n1Lo;
+            s1Hi = n1Hi;
+            s2Lo = n2Lo;
+            s2Hi = n2Hi;
+            outLo = yLo;
+            outHi = yHi;
+            if (increments) {
+                for (int k = 0; k < 5; ++k) {
+                    cLo[k] = vaddq_f32(cLo[k], dLo[k]);
+                    cHi[k] = vaddq_f32(cHi[k], dHi[k]);
+                }
+            }
+        } else {
+            int below, from;
+            biquadActiveLanes(step, numFrames, Channels, below, from);
+            uint32x4_t maskLo = vandq_u32(vld1q_u32(kLaneMasks + below), vld1q_u32(kLaneMasks + from));
+            uint32x4_t maskHi = vandq_u32(vld1q_u32(kLaneMasks + below + 4), vld1q_u32(kLaneMasks + from + 4));
+            s1Lo = vbslq_f32(maskLo, n1Lo, s1Lo);
+            s1Hi = vbslq_f32(maskHi, n1Hi, s1Hi);
+            s2Lo = vbslq_f32(maskLo, n2Lo, s2Lo);
+            s2Hi = vbslq_f32(maskHi, n2Hi, s2Hi);
+            outLo = vbslq_f32(maskLo, yLo, outLo);
+            outHi = vbslq_f32(maskHi, yHi, outHi);
+            if (increments) {
+                for (int k = 0; k < 5; ++k) {
+                    cLo[k] = vbslq_f32(maskLo, vaddq_f32(cLo[k], dLo[k]), cLo[k]);
+                    cHi[k] = vbslq_f32(maskHi, vaddq_f32(cHi[k], dHi[k]), cHi[k]);
+                }
+            }
+        }
+
+        if (step >= sections - 1) {
+            float* out = frames + (step - sections + 1) * Channels;
+            if constexpr (Channels == 1) {
+                vst1q_lane_f32(out, outHi, 3);
+            } else if constexpr (Channels == 2) {
+                vst1_f32(out, vget_high_f32(outHi));
+            } else if constexpr (Channels == 4) {
+                vst1q_f32(out, outHi);
+            } else {
+                vst1q_f32(out, outLo);
+                vst1q_f32(out + 4, outHi);
+            }
+        }
+    }
+
+    for (int k = 0; k < 5; ++k) {
+        vst1q_f32(coefficients + k * kBiquadLanes, cLo[k]);
+        vst1q_f32(coefficients + k * kBiquadLanes + 4, cHi[k]);
+    }
+    vst1q_f32(state, s1Lo);
+    vst1q_f32(state + 4, s1Hi);
+    vst1q_f32(state + kBiquadLanes, s2Lo);
+    vst1q_f32(state + kBiquadLanes + 4, s2Hi);
+}
+
+void biquadLanesNEON(float* frames, int numFrames, int channels, float* coefficients, const float* increments,
+                     float* state) {
+    switch (channels) {
+    case 1: biquadPipelineNEON<1>(frames, numFrames, coefficients, increments, state); break;
+    case 2: biquadPipelineNEON<2>(frames, numFrames, coefficients, increments, state); break;
+    case 4: biquadPipelineNEON<4>(frames, numFrames, coefficients, increments, state); break;
+    default: biquadPipelineNEON<8>(frames, numFrames, coefficients, increments, state); break;
+    }
+}
+
+const KernelTable neonTable = {
+    InstructionSet::NEON,
+    deinterleaveNEON,
+    interleaveNEON,
+    applyGainNEON,
+    addNEON,
+    addWithGainNEON,
+    softClipNEON,
+    dotProductNEON,
+    interpolateNEON,
+    applyGainRampNEON,
+    addWithGainRampNEON,
+    multiplyAddNEON,
+    peakAbsNEON,
+    fftRadix4NEON,
+    complexMultiplyAddNEON,
+    biquadLanesNEON
+};
+
+#endif // OMEGA_SIMD_NEON
+
+// ---------------------------------------------------------------------------
+// Dispatch
+
+bool cpuHasAVX2() {
+#if defined(OMEGA_SIMD_AVX2) && defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif defined(OMEGA_SIMD_AVX2)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+bool cpuHasAVX512() {
+#if defined(OMEGA_SIMD_AVX512) && defined(_MSC_VER) && !defined(__clang__)
+    if (!cpuHasAVX2()) {
+        return false;
+    }
+    int info[4];
+    __cpuidex(info, 7, 0);
+    // AVX512F, plus opmask and both ZMM halves enabled by the OS
+    return (info[1] & (1 << 16)) != 0 && (_xgetbv(0) & 0xe6) == 0xe6;
+#elif defined(OMEGA_SIMD_AVX512)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f");
+#else
+    return false;
+#endif
+}
+
+const KernelTable* tableFor(InstructionSet set) {
+    switch (set) {
+#ifdef OMEGA_SIMD_SSE2
+        case InstructionSet::SSE2: return &sse2Table;
+#endif
+#ifdef OMEGA_SIMD_AVX2
+        case InstructionSet::AVX2: return cpuHasAVX2() ? &avx2Table : nullptr;
+#endif
+#ifdef OMEGA_SIMD_AVX512
+        case InstructionSet::AVX512: return cpuHasAVX512() ? &avx512Table : nullptr;
+#endif
+#ifdef OMEGA_SIMD_NEON
+        case InstructionSet::NEON: return &neonTable;
+#endif
+        case InstructionSet::Scalar: return &scalarTable;
+        default: return nullptr;
+    }
+}
+
+const KernelTable* selectInitialTable() {
+    const char* requested = std::getenv("OMEGA_SIMD");
+    if (requested) {
+        const InstructionSet sets[] = { InstructionSet::Scalar, InstructionSet::SSE2,
+                                        InstructionSet::AVX2, InstructionSet::AVX512,
+                                        InstructionSet::NEON };
+        for (InstructionSet set : sets) {
+            if (std::strcmp(requested, getInstructionSetName(set)) == 0 && tableFor(set)) {
+                return tableFor(set);
+            }
+        }
+    }
+    return tableFor(getBestInstructionSet());
+}
+
+// Constant-initialized so kernels called during other static initializers
+// still work; upgraded to the detected instruction set at startup
+std::atomic<const KernelTable*> activeTable(&scalarTable);
+
+struct DispatchInitializer {
+    DispatchInitializer() { activeTable.store(selectInitialTable()); }
+} dispatchInitializer;
+
+inline const KernelTable& kernels() {
+    return *activeTable.load(std::memory_order_relaxed);
+}
+
+} // anonymous namespace
+
+void deinterleave(const float* source, float* const* dest, int numChannels, int numFrames, float gain) {
+    if (numChannels <= 0 || numFrames <= 0) {
+        return;
+    }
+    kernels().deinterleave(source, dest, numChannels, numFrames, gain);
+}
+
+void interleave(const float* const* source, float* dest, int numChannels, int numFrames) {
+    if (numChannels <= 0 || numFrames <= 0) {
+        return;
+    }
+    kernels().interleave(source, dest, numChannels, numFrames);
+}
+
+void applyGain(float* buffer, int numSamples, float gain) {
+    kernels().applyGain(buffer, numSamples, gain);
+}
+
+void add(float* dest, const float* source, int numSamples) {
+    kernels().add(dest, source, numSamples);
+}
+
+void addWithGain(float* dest, const float* source, int numSamples, float gain) {
+    kernels().addWithGain(dest, source, numSamples, gain);
+}
+
+void softClip(float* buffer, int numSamples) {
+    kernels().softClip(buffer, numSamples);
+}
+
+float dotProduct(const float* a, const float* b, int numSamples) {
+    return kernels().dotProduct(a, b, numSamples);
+}
+
+void interpolate(float* dest, const float* a, const float* b, int numSamples, float t) {
+    kernels().interpolate(dest, a, b, numSamples, t);
+}
+
+void applyGainRamp(float* buffer, int numSamples, float startGain, float endGain) {
+    if (numSamples <= 0) {
+        return;
+    }
+    kernels().applyGainRamp(buffer, numSamples, startGain, (endGain - startGain) / static_cast<float>(numSamples));
+}
+
+void addWithGainRamp(float* dest, const float* source, int numSamples, float startGain, float endGain) {
+    if (numSamples <= 0) {
+        return;
+    }
+    float increment = (endGain - startGain) / static_cast<float>(numSamples);
+    kernels().addWithGainRamp(dest, source, numSamples, startGain, increment);
+}
+
+void multiplyAdd(float* dest, const float* a, const float* b, int numSamples) {
+    kernels().multiplyAdd(dest, a, b, numSamples);
+}
+
+float peakAbs(const float* buffer, int numSamples) {
+    return kernels().peakAbs(buffer, numSamples);
+}
+
+void fftRadix4(float* re, float* im, int n, int quarter, const float* twiddles) {
+    kernels().fftRadix4(re, im, n, quarter, twiddles);
+}
+
+void complexMultiplyAdd(float* dest, const float* a, const float* b, int numComplex) {
+    kernels().complexMultiplyAdd(dest, a, b, numComplex);
+}
+
+void biquadLanes(float* frames, int numFrames, int channels, float* coefficients, const float* increments,
+                 float* state) {
+    if (numFrames <= 0) {
+        return;
+    }
+    kernels().biquadLanes(frames, numFrames, channels, coefficients, increments, state);
+}
+
+InstructionSet getInstructionSet() {
+    return kernels().set;
+}
+
+InstructionSet getBestInstructionSet() {
+#if defined(OMEGA_SIMD_NEON)
+    return InstructionSet::NEON;
+#elif defined(OMEGA_SIMD_AVX2)
+    if (cpuHasAVX512()) {
+        return InstructionSet::AVX512;
+    }
+    return cpuHasAVX2() ? InstructionSet::AVX2 : InstructionSet::SSE2;
+#else
+    return InstructionSet::Scalar;
+#endif
+}
+
+bool isSupported(InstructionSet set) {
+    return tableFor(set) != nullptr;
+}
+
+bool setInstructionSet(InstructionSet set) {
+    const KernelTable* table = tableFor(set);
+    if (!table) {
+        return false;
+    }
+    activeTable.store(table, std::memory_order_relaxed);
+    return true;
+}
+
+const char* getInstructionSetName(InstructionSet set) {
+    switch (set) {
+        case InstructionSet::Scalar: return "scalar";
+        case InstructionSet::SSE2: return "sse2";
+        case InstructionSet::AVX2: return "avx2";
+        case InstructionSet::AVX512: return "avx512";
+        case InstructionSet::NEON: return "neon";
+    }
+    return "unknown";
+}
+
+} // namespace SIMD
+} // namespace OmegaDAW
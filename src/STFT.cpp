@@ -0,0 +1,161 @@
+#include "STFT.h"
+#include "SIMDKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace OmegaDAW {
+
+namespace {
+
+constexpr double kTwoPi = 6.283185307179586476925286766559;
+
+// Periodic windows, so that shifted copies sum evenly
+double windowValue(StreamingSTFT::Window window, int n, int size) {
+    double phase = kTwoPi * n / size;
+    switch (window) {
+        case StreamingSTFT::Window::Hann:
+            return 0.5 - 0.5 * std::cos(phase);
+        case StreamingSTFT::Window::SqrtHann:
+            return std::sqrt(0.5 - 0.5 * std::cos(phase));
+        case StreamingSTFT::Window::Hamming:
+            return 0.54 - 0.46 * std::cos(phase);
+        case StreamingSTFT::Window::Blackman:
+            return 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+    }
+    return 1.0;
+}
+
+} // anonymous namespace
+
+StreamingSTFT::StreamingSTFT()
+    : numChannels_(0)
+    , fftSize_(0)
+    , hopSize_(0)
+    , filled_(0)
+    , amplitudeScale_(1.0f) {
+}
+
+StreamingSTFT::~StreamingSTFT() {
+}
+
+bool StreamingSTFT::prepare(int numChannels, int fftSize, int overlap, Window window) {
+    if (overlap < 1 || (overlap & (overlap - 1)) != 0 || overlap >= fftSize) {
+        std::cerr << "StreamingSTFT: overlap " << overlap << " is not a power of two below "
+                  << fftSize << std::endl;
+        return false;
+    }
+    plan_ = FFTPlan::get(fftSize);
+    if (!plan_) {
+        return false;
+    }
+
+    numChannels_ = std::max(0, numChannels);
+    fftSize_ = fftSize;
+    hopSize_ = fftSize / overlap;
+
+    // Weighted overlap-add: the same window on both sides, scaled so the
+    // squared windows of overlapping frames sum to 1
+    analysisWindow_.resize(fftSize_);
+    double windowSum = 0.0;
+    for (int n = 0; n < fftSize_; ++n) {
+        analysisWindow_[n] = static_cast<float>(windowValue(window, n, fftSize_));
+        windowSum += analysisWindow_[n];
+    }
+    double minGain = 1.0e30;
+    double maxGain = 0.0;
+    double meanGain = 0.0;
+    for (int n = 0; n < hopSize_; ++n) {
+        double gain = 0.0;
+        for (int k = n; k < fftSize_; k += hopSize_) {
+            gain += static_cast<double>(analysisWindow_[k]) * analysisWindow_[k];
+        }
+        minGain = std::min(minGain, gain);
+        maxGain = std::max(maxGain, gain);
+        meanGain += gain / hopSize_;
+    }
+    if (maxGain > minGain * 1.001) {
+        std::cerr << "StreamingSTFT: window doesn't overlap-add evenly at overlap " << overlap
+                  << " (gain ripple " << 20.0 * std::log10(maxGain / minGain) << " dB)" << std::endl;
+    }
+    synthesisWindow_.resize(fftSize_);
+    for (int n = 0; n < fftSize_; ++n) {
+        synthesisWindow_[n] = static_cast<float>(analysisWindow_[n] / meanGain);
+    }
+    amplitudeScale_ = static_cast<float>(2.0 / windowSum);
+
+    input_.assign(numChannels_, std::vector<float>(fftSize_, 0.0f));
+    output_.assign(numChannels_, std::vector<float>(fftSize_, 0.0f));
+    ready_.assign(numChannels_, std::vector<float>(hopSize_, 0.0f));
+    frame_.assign(fftSize_, 0.0f);
+    bins_.assign(plan_->getNumBins(), std::complex<float>());
+    work_.assign(plan_->getWorkSize(), 0.0f);
+    filled_ = 0;
+    return true;
+}
+
+void StreamingSTFT::reset() {
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        std::fill(input_[ch].begin(), input_[ch].end(), 0.0f);
+        std::fill(output_[ch].begin(), output_[ch].end(), 0.0f);
+        std::fill(ready_[ch].begin(), ready_[ch].end(), 0.0f);
+    }
+    filled_ = 0;
+}
+
+void StreamingSTFT::process(const float* const* input, float* const* output, int numChannels, int numFrames) {
+    numChannels = std::min(numChannels, numChannels_);
+    if (!plan_) {
+        for (int ch = 0; ch < numChannels; ++ch) {
+            if (output[ch] != input[ch]) {
+                std::memcpy(output[ch], input[ch], numFrames * sizeof(float));
+            }
+        }
+        return;
+    }
+
+    int done = 0;
+    while (done < numFrames) {
+        int chunk = std::min(numFrames - done, hopSize_ - filled_);
+        for (int ch = 0; ch < numChannels; ++ch) {
+            // Take the input first: output may be the same buffer
+            std::memcpy(input_[ch].data() + fftSize_ - hopSize_ + filled_, input[ch] + done, chunk * sizeof(float));
+            std::memcpy(output[ch] + done, ready_[ch].data() + filled_, chunk * sizeof(float));
+        }
+        filled_ += chunk;
+        done += chunk;
+
+        if (filled_ == hopSize_) {
+            processFrame(numChannels);
+            filled_ = 0;
+        }
+    }
+}
+
+void StreamingSTFT::processFrame(int numChannels) {
+    const int numBins = plan_->getNumBins();
+    const int kept = fftSize_ - hopSize_;
+    for (int ch = 0; ch < numChannels; ++ch) {
+        std::fill(frame_.begin(), frame_.end(), 0.0f);
+        SIMD::multiplyAdd(frame_.data(), input_[ch].data(), analysisWindow_.data(), fftSize_);
+        plan_->forward(frame_.data(), bins_.data(), work_.data());
+
+        if (callback_) {
+            callback_(ch, bins_.data(), numBins);
+        }
+
+        plan_->inverse(bins_.data(), frame_.data(), work_.data());
+        std::vector<float>& accumulator = output_[ch];
+        SIMD::multiplyAdd(accumulator.data(), frame_.data(), synthesisWindow_.data(), fftSize_);
+
+        // The accumulator's first hop is complete: play it during the next
+        // hop, and slide both buffers along
+        std::memcpy(ready_[ch].data(), accumulator.data(), hopSize_ * sizeof(float));
+        std::memmove(accumulator.data(), accumulator.data() + hopSize_, kept * sizeof(float));
+        std::fill(accumulator.begin() + kept, accumulator.end(), 0.0f);
+        std::memmove(input_[ch].data(), input_[ch].data() + hopSize_, kept * sizeof(float));
+    }
+}
+
+} // namespace OmegaDAW
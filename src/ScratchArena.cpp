@@ -0,0 +1,144 @@
+#include "ScratchArena.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace OmegaDAW {
+
+namespace {
+
+size_t alignUp(size_t bytes) {
+    return (bytes + ScratchArena::kAlignment - 1) / ScratchArena::kAlignment * ScratchArena::kAlignment;
+}
+
+void* allocateAligned(size_t bytes) {
+    return ::operator new(bytes, std::align_val_t(ScratchArena::kAlignment));
+}
+
+void freeAligned(void* block) {
+    ::operator delete(block, std::align_val_t(ScratchArena::kAlignment));
+}
+
+// Plain pointer, so reading it never runs thread_local initialization
+thread_local ScratchArena* t_boundArena = nullptr;
+
+} // anonymous namespace
+
+ScratchArena::ScratchArena()
+    : data_(nullptr)
+    , capacity_(0)
+    , used_(0)
+    , highWaterMark_(0)
+    , overflowCount_(0)
+    , overflowBytes_(0)
+    , openScopes_(0) {
+}
+
+ScratchArena::ScratchArena(size_t capacityBytes)
+    : ScratchArena() {
+    reserve(capacityBytes);
+}
+
+ScratchArena::~ScratchArena() {
+    releaseOverflow();
+    if (data_) {
+        freeAligned(data_);
+    }
+}
+
+void ScratchArena::reserve(size_t bytes) {
+    bytes = alignUp(bytes);
+    if (bytes <= capacity_ || used_ != 0) {
+        return;
+    }
+
+    if (data_) {
+        freeAligned(data_);
+    }
+    data_ = static_cast<unsigned char*>(allocateAligned(bytes));
+    capacity_ = bytes;
+}
+
+void* ScratchArena::allocateBytes(size_t bytes) {
+    bytes = alignUp(std::max<size_t>(bytes, 1));
+
+    void* block;
+    if (used_ + bytes <= capacity_) {
+        block = data_ + used_;
+        used_ += bytes;
+    } else {
+        // Arena exhausted: fall back to the heap for this block only
+        block = allocateAligned(bytes);
+        overflowBlocks_.push_back(block);
+        overflowBytes_ += bytes;
+        ++overflowCount_;
+    }
+
+    highWaterMark_ = std::max(highWaterMark_, used_ + overflowBytes_);
+    std::memset(block, 0, bytes);
+    return block;
+}
+
+float* ScratchArena::allocateFloats(int count) {
+    return static_cast<float*>(allocateBytes(static_cast<size_t>(std::max(0, count)) * sizeof(float)));
+}
+
+AudioBufferView ScratchArena::allocateBuffer(int numChannels, int numSamples) {
+    numChannels = std::max(0, std::min(numChannels, AudioBufferView::kMaxChannels));
+    numSamples = std::max(0, numSamples);
+
+    // One block, every channel starting on its own cache line
+    size_t stride = alignUp(numSamples * sizeof(float)) / sizeof(float);
+    float* data = static_cast<float*>(allocateBytes(numChannels * stride * sizeof(float)));
+
+    float* channels[AudioBufferView::kMaxChannels];
+    for (int ch = 0; ch < numChannels; ++ch) {
+        channels[ch] = data + ch * stride;
+    }
+    return AudioBufferView(channels, numChannels, numSamples);
+}
+
+size_t ScratchArena::beginScope() {
+    ++openScopes_;
+    return used_;
+}
+
+void ScratchArena::endScope(size_t mark) {
+    used_ = std::min(mark, used_);
+    openScopes_ = std::max(0, openScopes_ - 1);
+
+    // Everything handed back: absorb any overflow so the next block fits
+    if (openScopes_ == 0 && used_ == 0 && !overflowBlocks_.empty()) {
+        releaseOverflow();
+        reserve(highWaterMark_);
+    }
+}
+
+void ScratchArena::releaseOverflow() {
+    for (void* block : overflowBlocks_) {
+        freeAligned(block);
+    }
+    overflowBlocks_.clear();
+    overflowBytes_ = 0;
+}
+
+ScratchArena& ScratchArena::getForThread() {
+    if (t_boundArena) {
+        return *t_boundArena;
+    }
+    thread_local ScratchArena arena;
+    return arena;
+}
+
+// ScopedThreadArena implementation
+
+ScopedThreadArena::ScopedThreadArena(ScratchArena& arena)
+    : previous_(t_boundArena) {
+    t_boundArena = &arena;
+}
+
+ScopedThreadArena::~ScopedThreadArena() {
+    t_boundArena = previous_;
+}
+
+} // namespace OmegaDAW
@@ -0,0 +1,717 @@
+#include "TimeStretch.h"
+#include "Clip.h"
+#include "SIMDKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace OmegaDAW {
+
+namespace {
+
+constexpr double kTwoPi = 6.283185307179586476925286766559;
+
+constexpr double kMinStretch = AudioClip::kMinTimeStretch;
+constexpr double kMaxStretch = AudioClip::kMaxTimeStretch;
+constexpr float kMaxPitchShift = 24.0f;
+
+// Envelope detail kept for formant preservation: 1 ms of quefrency resolves
+// formants while leaving out the harmonics of voices up to about 1 kHz
+constexpr double kLifterSeconds = 0.001;
+
+// Largest boost formant correction applies to a bin (+24 dB)
+constexpr float kMaxFormantGain = 16.0f;
+
+// A transient: this fraction of the audible bins rose by 3 dB or more, and
+// the frame as a whole got louder
+constexpr float kTransientBinFraction = 0.35f;
+constexpr float kTransientPowerRise = 1.5f;
+
+constexpr size_t kDefaultCacheBytes = size_t(512) << 20;
+
+double wrapPhase(double phase) {
+    return phase - kTwoPi * std::floor(phase / kTwoPi + 0.5);
+}
+
+double clampStretch(double stretch) {
+    return std::max(kMinStretch, std::min(kMaxStretch, stretch));
+}
+
+size_t renderBytes(const StretchedClip& clip) {
+    const AudioBuffer& audio = clip.getAudio();
+    return static_cast<size_t>(audio.getNumChannels()) * audio.getNumSamples() * sizeof(float);
+}
+
+} // anonymous namespace
+
+// PhaseLockedVocoder implementation
+
+PhaseLockedVocoder::PhaseLockedVocoder()
+    : fftSize_(0)
+    , numBins_(0)
+    , lifter_(0)
+    , first_(true)
+    , lastTransient_(false) {
+}
+
+void PhaseLockedVocoder::prepare(int fftSize, int sampleRate) {
+    plan_ = FFTPlan::get(fftSize);
+    fftSize_ = fftSize;
+    numBins_ = fftSize / 2 + 1;
+    lifter_ = std::max(4, std::min(fftSize / 4, static_cast<int>(kLifterSeconds * sampleRate)));
+
+    previousInput_.assign(numBins_, std::complex<float>());
+    previousOutput_.assign(numBins_, std::complex<float>());
+    output_.assign(numBins_, std::complex<float>());
+    power_.assign(numBins_, 0.0f);
+    previousPower_.assign(numBins_, 0.0f);
+    peaks_.reserve(numBins_);
+    logEnvelope_.assign(numBins_, 0.0f);
+    cepstrum_.assign(fftSize, 0.0f);
+    envelopeBins_.assign(numBins_, std::complex<float>());
+    reset();
+}
+
+void PhaseLockedVocoder::reset() {
+    first_ = true;
+    lastTransient_ = false;
+    std::fill(previousPower_.begin(), previousPower_.end(), 0.0f);
+}
+
+void PhaseLockedVocoder::computeEnvelope(float* work) {
+    // Real cepstrum of the log magnitudes, low quefrencies only, back to a
+    // smoothed log-magnitude spectrum
+    for (int k = 0; k < numBins_; ++k) {
+        envelopeBins_[k] = std::complex<float>(0.5f * std::log(power_[k] + 1.0e-20f), 0.0f);
+    }
+    plan_->inverse(envelopeBins_.data(), cepstrum_.data(), work);
+    std::fill(cepstrum_.begin() + lifter_, cepstrum_.end() - lifter_ + 1, 0.0f);
+    plan_->forward(cepstrum_.data(), envelopeBins_.data(), work);
+    for (int k = 0; k < numBins_; ++k) {
+        logEnvelope_[k] = envelopeBins_[k].real();
+    }
+}
+
+void PhaseLockedVocoder::processFrame(std::complex<float>* bins, int analysisHop, int synthesisHop,
+                                      float pitchRatio, bool preserveFormants, bool detectTransients,
+                                      float* work) {
+    if (!plan_) {
+        return;
+    }
+
+    float maxPower = 0.0f;
+    float totalPower = 0.0f;
+    float previousTotal = 0.0f;
+    for (int k = 0; k < numBins_; ++k) {
+        power_[k] = std::norm(bins[k]);
+        maxPower = std::max(maxPower, power_[k]);
+        totalPower += power_[k];
+        previousTotal += previousPower_[k];
+    }
+
+    bool transient = false;
+    if (detectTransients && !first_ && !lastTransient_ && totalPower > kTransientPowerRise * previousTotal) {
+        const float floor = maxPower * 1.0e-6f;
+        int audible = 0;
+        int rising = 0;
+        for (int k = 0; k < numBins_; ++k) {
+            if (power_[k] > floor) {
+                ++audible;
+                if (power_[k] > 2.0f * previousPower_[k]) {
+                    ++rising;
+                }
+            }
+        }
+        transient = rising > kTransientBinFraction * audible;
+    }
+
+    // Peaks: louder than two bins either side
+    peaks_.clear();
+    const float peakFloor = maxPower * 1.0e-10f;
+    for (int k = 1; k < numBins_ - 1; ++k) {
+        float p = power_[k];
+        if (p > peakFloor && p > power_[k - 1] && p >= power_[k + 1]
+            && (k < 2 || p > power_[k - 2]) && (k + 2 >= numBins_ || p >= power_[k + 2])) {
+            peaks_.push_back(k);
+        }
+    }
+    if (peaks_.empty() && maxPower > 0.0f) {
+        peaks_.push_back(static_cast<int>(std::max_element(power_.begin(), power_.end()) - power_.begin()));
+    }
+
+    const bool shifting = pitchRatio != 1.0f;
+    const bool formants = preserveFormants && shifting;
+    if (formants) {
+        computeEnvelope(work);
+    }
+
+    std::fill(output_.begin(), output_.end(), std::complex<float>());
+    const bool resetPhases = first_ || transient;
+    const double binFrequency = kTwoPi / fftSize_;
+    int regionStart = 0;
+    for (size_t i = 0; i < peaks_.size(); ++i) {
+        const int peak = peaks_[i];
+
+        // A peak's region runs to the quietest bin before the next peak
+        int regionEnd = numBins_ - 1;
+        if (i + 1 < peaks_.size()) {
+            regionEnd = peak;
+            for (int k = peak + 1; k < peaks_[i + 1]; ++k) {
+                if (power_[k] < power_[regionEnd]) {
+                    regionEnd = k;
+                }
+            }
+        }
+
+        const int target = shifting ? static_cast<int>(std::lround(peak * pitchRatio)) : peak;
+        const int shift = target - peak;
+
+        std::complex<float> rotor(1.0f, 0.0f);
+        if (!resetPhases && target < numBins_ && std::norm(previousOutput_[target]) > 0.0f
+            && std::norm(previousInput_[peak]) > 0.0f) {
+            // Measured frequency from the phase change since the last frame,
+            // then the target bin's phase advanced at the shifted frequency
+            const double expected = binFrequency * ((static_cast<long long>(peak) * analysisHop) % fftSize_);
+            const double advance = std::arg(bins[peak] * std::conj(previousInput_[peak]));
+            const double frequency = binFrequency * peak + wrapPhase(advance - expected) / analysisHop;
+            const double phase = std::arg(previousOutput_[target]) + wrapPhase(frequency * pitchRatio * synthesisHop)
+                               - std::arg(bins[peak]);
+            rotor = std::polar(1.0f, static_cast<float>(phase));
+        }
+
+        const int first = std::max(regionStart, -shift);
+        const int last = std::min(regionEnd, numBins_ - 1 - shift);
+        for (int k = first; k <= last; ++k) {
+            std::complex<float> value = bins[k] * rotor;
+            if (formants) {
+                value *= std::min(kMaxFormantGain, std::exp(logEnvelope_[k + shift] - logEnvelope_[k]));
+            }
+            output_[k + shift] += value;
+        }
+        regionStart = regionEnd + 1;
+    }
+
+    std::copy(bins, bins + numBins_, previousInput_.begin());
+    std::copy(output_.begin(), output_.end(), bins);
+    previousOutput_.swap(output_);
+    previousPower_.swap(power_);
+    first_ = false;
+    lastTransient_ = transient;
+}
+
+// TimeStretcher implementation
+
+TimeStretcher::TimeStretcher()
+    : numChannels_(0)
+    , sampleRate_(48000)
+    , fftSize_(0)
+    , hopSize_(0)
+    , filled_(0)
+    , skip_(0)
+    , lastHop_(0)
+    , analysisPhase_(0.0)
+    , dropRemaining_(0)
+    , readyStart_(0)
+    , readyCount_(0)
+    , timeStretch_(1.0)
+    , pitchShift_(0.0f)
+    , formants_(false)
+    , transients_(true) {
+}
+
+TimeStretcher::~TimeStretcher() {
+}
+
+bool TimeStretcher::prepare(int numChannels, int sampleRate, Quality quality) {
+    // Frames of about the same duration at any rate
+    int fftSize = quality == Quality::Offline ? 4096 : 2048;
+    const int overlap = quality == Quality::Offline ? 8 : 4;
+    for (int rate = 72000; sampleRate >= rate && fftSize < 16384; rate *= 2) {
+        fftSize *= 2;
+    }
+    plan_ = FFTPlan::get(fftSize);
+    if (!plan_) {
+        return false;
+    }
+
+    numChannels_ = std::max(0, numChannels);
+    sampleRate_ = sampleRate;
+    fftSize_ = fftSize;
+    hopSize_ = fftSize / overlap;
+
+    // Hann both sides, scaled so the squared windows overlap-add to 1 at
+    // the synthesis hop
+    analysisWindow_.resize(fftSize_);
+    for (int n = 0; n < fftSize_; ++n) {
+        analysisWindow_[n] = static_cast<float>(0.5 - 0.5 * std::cos(kTwoPi * n / fftSize_));
+    }
+    double gain = 0.0;
+    for (int n = 0; n < fftSize_; n += hopSize_) {
+        gain += static_cast<double>(analysisWindow_[n]) * analysisWindow_[n];
+    }
+    synthesisWindow_.resize(fftSize_);
+    for (int n = 0; n < fftSize_; ++n) {
+        synthesisWindow_[n] = static_cast<float>(analysisWindow_[n] / gain);
+    }
+
+    vocoders_.resize(numChannels_);
+    for (auto& vocoder : vocoders_) {
+        vocoder.prepare(fftSize_, sampleRate);
+    }
+    input_.assign(numChannels_, std::vector<float>(fftSize_, 0.0f));
+    accumulator_.assign(numChannels_, std::vector<float>(fftSize_, 0.0f));
+    ready_.assign(numChannels_, std::vector<float>(2 * hopSize_, 0.0f));
+    frame_.assign(fftSize_, 0.0f);
+    bins_.assign(plan_->getNumBins(), std::complex<float>());
+    work_.assign(plan_->getWorkSize(), 0.0f);
+    reset();
+    return true;
+}
+
+void TimeStretcher::reset() {
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        std::fill(input_[ch].begin(), input_[ch].end(), 0.0f);
+        std::fill(accumulator_[ch].begin(), accumulator_[ch].end(), 0.0f);
+        vocoders_[ch].reset();
+    }
+    filled_ = 0;
+    skip_ = 0;
+    lastHop_ = hopSize_;
+    analysisPhase_ = 0.0;
+    // Output before this point had fewer frames overlapping than the rest
+    dropRemaining_ = fftSize_ - hopSize_;
+    readyStart_ = 0;
+    readyCount_ = 0;
+}
+
+void TimeStretcher::setSettings(const StretchSettings& settings) {
+    timeStretch_.store(clampStretch(settings.timeStretch));
+    pitchShift_.store(std::max(-kMaxPitchShift, std::min(kMaxPitchShift, settings.pitchShift)));
+    formants_.store(settings.formantPreservation);
+}
+
+StretchSettings TimeStretcher::getSettings() const {
+    StretchSettings settings;
+    settings.timeStretch = timeStretch_.load();
+    settings.pitchShift = pitchShift_.load();
+    settings.formantPreservation = formants_.load();
+    return settings;
+}
+
+int TimeStretcher::getPreRoll() const {
+    // Frame centres map input time t to output time t * stretch: with the
+    // first (fftSize - hop) output frames dropped, that takes this much
+    // input ahead of the start
+    return fftSize_ / 2 + static_cast<int>(std::lround((fftSize_ / 2 - hopSize_) / timeStretch_.load()));
+}
+
+int TimeStretcher::getInputFramesNeeded() const {
+    if (!plan_ || readyCount_ > hopSize_) {
+        return 0;
+    }
+    return skip_ + fftSize_ - filled_;
+}
+
+int TimeStretcher::write(const float* const* input, int numFrames) {
+    if (!plan_) {
+        return numFrames;
+    }
+
+    int done = 0;
+    while (done < numFrames) {
+        if (skip_ > 0) {
+            int dropped = std::min(skip_, numFrames - done);
+            skip_ -= dropped;
+            done += dropped;
+            continue;
+        }
+        if (filled_ == fftSize_) {
+            if (readyCount_ > hopSize_) {
+                break;
+            }
+            runFrame();
+            continue;
+        }
+
+        int chunk = std::min(fftSize_ - filled_, numFrames - done);
+        for (int ch = 0; ch < numChannels_; ++ch) {
+            float* dest = input_[ch].data() + filled_;
+            if (input) {
+                std::memcpy(dest, input[ch] + done, chunk * sizeof(float));
+            } else {
+                std::fill(dest, dest + chunk, 0.0f);
+            }
+        }
+        filled_ += chunk;
+        done += chunk;
+        if (filled_ == fftSize_ && readyCount_ <= hopSize_) {
+            runFrame();
+        }
+    }
+    return done;
+}
+
+int TimeStretcher::read(float* const* output, int numFrames) {
+    int count = std::min(numFrames, readyCount_);
+    if (count <= 0) {
+        return 0;
+    }
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        std::memcpy(output[ch], ready_[ch].data() + readyStart_, count * sizeof(float));
+    }
+    readyStart_ += count;
+    readyCount_ -= count;
+    if (readyCount_ == 0) {
+        readyStart_ = 0;
+    }
+    return count;
+}
+
+void TimeStretcher::runFrame() {
+    const double stretch = timeStretch_.load();
+    const float ratio = std::pow(2.0f, pitchShift_.load() / 12.0f);
+    const bool formants = formants_.load();
+    const bool transients = transients_.load();
+
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        std::fill(frame_.begin(), frame_.end(), 0.0f);
+        SIMD::multiplyAdd(frame_.data(), input_[ch].data(), analysisWindow_.data(), fftSize_);
+        plan_->forward(frame_.data(), bins_.data(), work_.data());
+        vocoders_[ch].processFrame(bins_.data(), lastHop_, hopSize_, ratio, formants, transients, work_.data());
+        plan_->inverse(bins_.data(), frame_.data(), work_.data());
+        SIMD::multiplyAdd(accumulator_[ch].data(), frame_.data(), synthesisWindow_.data(), fftSize_);
+    }
+
+    // The accumulator's first hop is finished
+    const int dropped = std::min(dropRemaining_, hopSize_);
+    dropRemaining_ -= dropped;
+    const int finished = hopSize_ - dropped;
+    const int kept = fftSize_ - hopSize_;
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        std::vector<float>& ready = ready_[ch];
+        if (readyStart_ > 0 && readyCount_ > 0) {
+            std::memmove(ready.data(), ready.data() + readyStart_, readyCount_ * sizeof(float));
+        }
+        std::vector<float>& accumulator = accumulator_[ch];
+        std::memcpy(ready.data() + readyCount_, accumulator.data() + dropped, finished * sizeof(float));
+        std::memmove(accumulator.data(), accumulator.data() + hopSize_, kept * sizeof(float));
+        std::fill(accumulator.begin() + kept, accumulator.end(), 0.0f);
+    }
+    readyStart_ = 0;
+    readyCount_ += finished;
+
+    // Next analysis frame: the synthesis hop over the stretch, with the
+    // fraction carried so the average is exact
+    double advance = analysisPhase_ + hopSize_ / stretch;
+    int hop = std::max(1, static_cast<int>(advance));
+    analysisPhase_ = advance - hop;
+    lastHop_ = hop;
+    if (hop < fftSize_) {
+        for (int ch = 0; ch < numChannels_; ++ch) {
+            std::memmove(input_[ch].data(), input_[ch].data() + hop, (fftSize_ - hop) * sizeof(float));
+        }
+        filled_ = fftSize_ - hop;
+    } else {
+        filled_ = 0;
+        skip_ = hop - fftSize_;
+    }
+}
+
+void TimeStretcher::renderOffline(const AudioBuffer& source, int sampleRate, const StretchSettings& settings,
+                                  AudioBuffer& destination) {
+    const int numChannels = source.getNumChannels();
+    const int length = source.getNumSamples();
+    const int outputLength = static_cast<int>(std::lround(length * clampStretch(settings.timeStretch)));
+    destination.setSize(numChannels, outputLength);
+
+    TimeStretcher stretcher;
+    if (numChannels == 0 || !stretcher.prepare(numChannels, sampleRate, Quality::Offline)) {
+        destination.clear();
+        return;
+    }
+    stretcher.setSettings(settings);
+    for (int preRoll = stretcher.getPreRoll(); preRoll > 0;) {
+        preRoll -= stretcher.write(nullptr, preRoll);
+    }
+
+    std::vector<const float*> input(numChannels);
+    std::vector<float*> output(numChannels);
+    int read = 0;
+    int written = 0;
+    while (written < outputLength) {
+        for (int ch = 0; ch < numChannels; ++ch) {
+            output[ch] = destination.getWritePointer(ch) + written;
+        }
+        written += stretcher.read(output.data(), outputLength - written);
+        if (written == outputLength) {
+            break;
+        }
+
+        // Past the end, silence lets the last frames finish
+        int needed = stretcher.getInputFramesNeeded();
+        if (read < length) {
+            int chunk = std::min(needed, length - read);
+            for (int ch = 0; ch < numChannels; ++ch) {
+                input[ch] = source.getReadPointer(ch) + read;
+            }
+            read += stretcher.write(input.data(), chunk);
+        } else {
+            stretcher.write(nullptr, needed);
+        }
+    }
+}
+
+// StretchedClip implementation
+
+StretchedClip::StretchedClip(std::shared_ptr<const AudioBuffer> source, const StretchSettings& settings, int sampleRate)
+    : source_(std::move(source))
+    , settings_(settings)
+    , sampleRate_(sampleRate)
+    , audio_(0, 0)
+    , ready_(false) {
+}
+
+// ClipStretchCache implementation
+
+ClipStretchCache::ClipStretchCache()
+    : memoryLimit_(kDefaultCacheBytes)
+    , memoryUsage_(0)
+    , renderer_([this]() { renderPending(); }) {
+}
+
+ClipStretchCache::~ClipStretchCache() {
+    renderer_.stop();
+}
+
+std::shared_ptr<const StretchedClip> ClipStretchCache::acquire(std::shared_ptr<const AudioBuffer> source,
+                                                               const StretchSettings& settings, int sampleRate) {
+    if (!source) {
+        return nullptr;
+    }
+
+    std::shared_ptr<StretchedClip> entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+            const StretchedClip& candidate = **it;
+            if (candidate.source_ == source && candidate.settings_ == settings && candidate.sampleRate_ == sampleRate) {
+                // Most recently used goes last
+                entry = *it;
+                entries_.erase(it);
+                entries_.push_back(entry);
+                return entry;
+            }
+        }
+        entry = std::make_shared<StretchedClip>(std::move(source), settings, sampleRate);
+        entries_.push_back(entry);
+        pending_.push_back(entry);
+    }
+    renderer_.request();
+    return entry;
+}
+
+void ClipStretchCache::flush() {
+    renderer_.flush();
+}
+
+void ClipStretchCache::setMemoryLimit(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    memoryLimit_ = bytes;
+    evict();
+}
+
+size_t ClipStretchCache::getMemoryUsage() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return memoryUsage_;
+}
+
+size_t ClipStretchCache::getNumEntries() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+void ClipStretchCache::renderPending() {
+    for (;;) {
+        std::shared_ptr<StretchedClip> entry;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (pending_.empty()) {
+                return;
+            }
+            entry = pending_.front();
+            pending_.erase(pending_.begin());
+        }
+
+        TimeStretcher::renderOffline(*entry->source_, entry->sampleRate_, entry->settings_, entry->audio_);
+        entry->ready_.store(true, std::memory_order_release);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        memoryUsage_ += renderBytes(*entry);
+        entry.reset();
+        evict();
+    }
+}
+
+void ClipStretchCache::evict() {
+    for (size_t i = 0; i < entries_.size() && memoryUsage_ > memoryLimit_;) {
+        const std::shared_ptr<StretchedClip>& entry = entries_[i];
+        if (entry.use_count() == 1 && entry->isReady()) {
+            memoryUsage_ -= renderBytes(*entry);
+            entries_.erase(entries_.begin() + i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+// ClipVoice implementation
+
+ClipVoice::ClipVoice()
+    : sampleRate_(48000)
+    , maxBufferSize_(0)
+    , offsetSeconds_(0.0)
+    , sourcePosition_(0)
+    , outputPosition_(0)
+    , usingOffline_(false) {
+}
+
+ClipVoice::~ClipVoice() {
+}
+
+void ClipVoice::prepare(int sampleRate, int maxBufferSize) {
+    sampleRate_ = sampleRate;
+    maxBufferSize_ = std::max(1, maxBufferSize);
+    stretcher_.prepare(2, sampleRate, TimeStretcher::Quality::Realtime);
+    stretcher_.setSettings(settings_);
+    // Two for the outgoing side of a crossfade, two for missing output channels
+    scratch_.assign(4, std::vector<float>(maxBufferSize_, 0.0f));
+    seek(0.0);
+}
+
+void ClipVoice::setClip(const AudioClip& clip, ClipStretchCache* cache) {
+    source_ = clip.getAudioData();
+    settings_.timeStretch = clampStretch(clip.getTimeStretch());
+    settings_.pitchShift = std::max(-kMaxPitchShift, std::min(kMaxPitchShift, clip.getPitch()));
+    settings_.formantPreservation = clip.isFormantPreservationEnabled();
+    offsetSeconds_ = clip.getOffset();
+
+    offline_.reset();
+    if (cache && source_ && !settings_.isIdentity()) {
+        offline_ = cache->acquire(source_, settings_, sampleRate_);
+    }
+    stretcher_.setSettings(settings_);
+    seek(0.0);
+}
+
+void ClipVoice::clearClip() {
+    source_.reset();
+    offline_.reset();
+}
+
+void ClipVoice::seek(double clipTime) {
+    clipTime = std::max(0.0, clipTime);
+    const double stretch = settings_.timeStretch;
+    outputPosition_ = std::llround((offsetSeconds_ * stretch + clipTime) * sampleRate_);
+
+    stretcher_.reset();
+    sourcePosition_ = std::llround((offsetSeconds_ + clipTime / stretch) * sampleRate_) - stretcher_.getPreRoll();
+    usingOffline_ = offline_ && offline_->isReady();
+}
+
+void ClipVoice::render(float* const* output, int numChannels, int numFrames) {
+    if (maxBufferSize_ <= 0) {
+        return;
+    }
+
+    for (int done = 0; done < numFrames; done += maxBufferSize_) {
+        const int frames = std::min(maxBufferSize_, numFrames - done);
+        float* dest[2];
+        for (int ch = 0; ch < 2; ++ch) {
+            dest[ch] = ch < numChannels ? output[ch] + done : scratch_[2 + ch].data();
+        }
+
+        if (!source_ || source_->getNumChannels() == 0) {
+            for (int ch = 0; ch < 2; ++ch) {
+                std::fill(dest[ch], dest[ch] + frames, 0.0f);
+            }
+        } else if (settings_.isIdentity()) {
+            // Nothing to stretch: output frames are source frames
+            copyAudio(*source_, dest, frames);
+        } else if (offline_ && offline_->isReady()) {
+            if (!usingOffline_) {
+                // The two renders line up sample for sample but not in phase:
+                // crossfade from the realtime one over this block
+                float* outgoing[2] = { scratch_[0].data(), scratch_[1].data() };
+                renderRealtime(outgoing, frames);
+                copyAudio(offline_->getAudio(), dest, frames);
+                for (int ch = 0; ch < 2; ++ch) {
+                    SIMD::applyGainRamp(dest[ch], frames, 0.0f, 1.0f);
+                    SIMD::addWithGainRamp(dest[ch], outgoing[ch], frames, 1.0f, 0.0f);
+                }
+                usingOffline_ = true;
+            } else {
+                copyAudio(offline_->getAudio(), dest, frames);
+            }
+        } else {
+            renderRealtime(dest, frames);
+        }
+        outputPosition_ += frames;
+    }
+
+    for (int ch = 2; ch < numChannels; ++ch) {
+        std::fill(output[ch], output[ch] + numFrames, 0.0f);
+    }
+}
+
+void ClipVoice::renderRealtime(float* const* output, int numFrames) {
+    int done = 0;
+    while (done < numFrames) {
+        float* dest[2] = { output[0] + done, output[1] + done };
+        done += stretcher_.read(dest, numFrames - done);
+        if (done < numFrames) {
+            feedSource(stretcher_.getInputFramesNeeded());
+        }
+    }
+}
+
+void ClipVoice::copyAudio(const AudioBuffer& audio, float* const* output, int numFrames) const {
+    // Frames [outputPosition_, + numFrames) of audio, silence outside it
+    const long long length = audio.getNumSamples();
+    const long long start = std::min(length, outputPosition_);
+    const int count = static_cast<int>(std::max(0LL, std::min<long long>(numFrames, length - start)));
+    for (int ch = 0; ch < 2; ++ch) {
+        if (count > 0) {
+            const float* source = audio.getReadPointer(std::min(ch, audio.getNumChannels() - 1));
+            std::memcpy(output[ch], source + start, count * sizeof(float));
+        }
+        std::fill(output[ch] + count, output[ch] + numFrames, 0.0f);
+    }
+}
+
+void ClipVoice::feedSource(int numFrames) {
+    const AudioBuffer& source = *source_;
+    const long long length = source.getNumSamples();
+    const int lastChannel = source.getNumChannels() - 1;
+    while (numFrames > 0) {
+        int written;
+        if (sourcePosition_ < 0 || sourcePosition_ >= length) {
+            // Silence before the start and after the end
+            long long gap = sourcePosition_ < 0 ? -sourcePosition_ : numFrames;
+            written = stretcher_.write(nullptr, static_cast<int>(std::min<long long>(numFrames, gap)));
+        } else {
+            const float* input[2];
+            for (int ch = 0; ch < 2; ++ch) {
+                input[ch] = source.getReadPointer(std::min(ch, lastChannel)) + sourcePosition_;
+            }
+            written = stretcher_.write(input, static_cast<int>(std::min<long long>(numFrames, length - sourcePosition_)));
+        }
+        if (written == 0) {
+            break;
+        }
+        sourcePosition_ += written;
+        numFrames -= written;
+    }
+}
+
+} // namespace OmegaDAW
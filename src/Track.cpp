@@ -32,12 +32,19 @@ void Track::process(AudioBuffer& buffer, int numSamples) {
         leftGain *= (1.0f - pan_);
     }
     
+    if (buffer.getNumChannels() < 2) {
+        return;
+    }
+    
+    numSamples = std::min(numSamples, buffer.getNumSamples());
+    const float* trackLeft = trackBuffer_.getReadPointer(0);
+    const float* trackRight = trackBuffer_.getReadPointer(1);
+    float* left = buffer.getWritePointer(0);
+    float* right = buffer.getWritePointer(1);
+    
     for (int i = 0; i < numSamples; ++i) {
-        float left = trackBuffer_.getSample(0, i) * leftGain;
-        float right = trackBuffer_.getSample(1, i) * rightGain;
-        
-        buffer.setSample(0, i, buffer.getSample(0, i) + left);
-        buffer.setSample(1, i, buffer.getSample(1, i) + right);
+        left[i] += trackLeft[i] * leftGain;
+        right[i] += trackRight[i] * rightGain;
     }
 }
 
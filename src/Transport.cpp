@@ -8,6 +8,7 @@ Transport::Transport()
     , recording_(false)
     , paused_(false)
     , looping_(false)
+    , freewheel_(false)
     , tempo_(120.0)
     , timeSignatureNumerator_(4)
     , timeSignatureDenominator_(4)
@@ -94,7 +95,7 @@ void Transport::setSampleRate(int sampleRate) {
 }
 
 void Transport::advance(int numSamples) {
-    if (!playing_) {
+    if (!playing_ && !freewheel_) {
         return;
     }
     
@@ -0,0 +1,256 @@
+#include "AdvancedEffects.h"
+#include "AudioEngine.h"
+#include "AudioProcessing.h"
+#include "BuiltInPlugins.h"
+#include "DenormalGuard.h"
+#include "Effects.h"
+#include "Filter.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace OmegaDAW;
+
+namespace {
+
+const int kSampleRate = 48000;
+const int kBlockSize = 256;
+const int kNumChannels = 2;
+const int kSignalBlocks = 200;   // Noise, to fill every recursive state
+const int kTailBlocks = 2000;    // ~10 s of silence while the states decay
+
+// Runs a Plugin through the IAudioProcessor interface (in place)
+class PluginProcessor : public IAudioProcessor {
+public:
+    explicit PluginProcessor(std::unique_ptr<Plugin> plugin) : plugin_(std::move(plugin)) {}
+    void prepare(int sampleRate, int maxBufferSize) override { plugin_->initialize(sampleRate, maxBufferSize); }
+    void process(float** inputs, float** outputs, int numChannels, int numFrames) override {
+        plugin_->process(outputs, outputs, numChannels, numFrames);
+    }
+    std::string getName() const override { return plugin_->getName(); }
+
+private:
+    std::unique_ptr<Plugin> plugin_;
+};
+
+// ConvolutionReverb with a short decaying noise response, loaded before the
+// first block (prepare() rebuilds it on the loader thread)
+class LoadedConvolutionReverb : public IAudioProcessor {
+public:
+    LoadedConvolutionReverb() {
+        const int length = kSampleRate / 4;
+        std::vector<float> ir(static_cast<size_t>(length) * 2);
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+        for (int i = 0; i < length; ++i) {
+            float envelope = std::exp(-6.9f * i / length);  // -60 dB at the end
+            ir[2 * i] = noise(rng) * envelope;
+            ir[2 * i + 1] = noise(rng) * envelope;
+        }
+        reverb_.setImpulseResponse(ir.data(), length, 2);
+        reverb_.setDryWetMix(0.5f);
+    }
+    void prepare(int sampleRate, int maxBufferSize) override {
+        reverb_.prepare(sampleRate, maxBufferSize);
+        reverb_.flushImpulseResponse();
+    }
+    void process(float** inputs, float** outputs, int numChannels, int numFrames) override {
+        reverb_.process(inputs, outputs, numChannels, numFrames);
+    }
+    std::string getName() const override { return reverb_.getName(); }
+
+private:
+    ConvolutionReverb reverb_;
+};
+
+// Records whether FTZ was on whenever it runs
+class ModeProbe : public IAudioProcessor {
+public:
+    void prepare(int, int) override {}
+    void process(float**, float**, int, int) override {
+        calls.fetch_add(1);
+        if (!DenormalMode::isFlushToZeroEnabled()) {
+            callsWithoutFlush.fetch_add(1);
+        }
+    }
+    std::atomic<int> calls{0};
+    std::atomic<int> callsWithoutFlush{0};
+};
+
+struct DecayResult {
+    long subnormalSamples = 0;
+    double signalMicros = 0.0;  // Average per block while fed noise
+    double tailMicros = 0.0;    // Average per block over the second half of the tail
+};
+
+DecayResult runDecay(IAudioProcessor& processor) {
+    std::vector<std::vector<float>> buffers(kNumChannels, std::vector<float>(kBlockSize));
+    float* outputs[kNumChannels] = { buffers[0].data(), buffers[1].data() };
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+
+    processor.prepare(kSampleRate, kBlockSize);
+
+    DecayResult result;
+    double tailTotal = 0.0;
+    int tailCounted = 0;
+    for (int block = 0; block < kSignalBlocks + kTailBlocks; ++block) {
+        bool signal = block < kSignalBlocks;
+        for (auto& buffer : buffers) {
+            for (float& sample : buffer) {
+                sample = signal ? noise(rng) : 0.0f;
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        processor.process(nullptr, outputs, kNumChannels, kBlockSize);
+        double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        if (signal) {
+            result.signalMicros += micros / kSignalBlocks;
+        } else if (block >= kSignalBlocks + kTailBlocks / 2) {
+            tailTotal += micros;
+            ++tailCounted;
+        }
+
+        for (const auto& buffer : buffers) {
+            for (float sample : buffer) {
+                if (std::fpclassify(sample) == FP_SUBNORMAL) {
+                    ++result.subnormalSamples;
+                }
+            }
+        }
+    }
+    result.tailMicros = tailTotal / tailCounted;
+    return result;
+}
+
+} // anonymous namespace
+
+int main() {
+    std::cout << "=== Denormal Handling Test ===" << std::endl;
+
+    int failures = 0;
+    auto check = [&](bool condition, const std::string& what) {
+        std::cout << "  " << (condition ? "PASS" : "FAIL") << ": " << what << std::endl;
+        if (!condition) {
+            ++failures;
+        }
+    };
+
+    if (!DenormalMode::isSupported()) {
+        std::cout << "Flush-to-zero is not controllable on this target; skipping" << std::endl;
+        return 0;
+    }
+
+    // Test 1: the guard sets and restores the mode
+    std::cout << "\nTest 1: ScopedNoDenormals" << std::endl;
+    bool before = DenormalMode::isFlushToZeroEnabled();
+    {
+        ScopedNoDenormals noDenormals;
+        check(DenormalMode::isFlushToZeroEnabled(), "flush-to-zero enabled inside the scope");
+        volatile float tiny = 1.0e-30f;
+        volatile float product = tiny * 1.0e-10f;
+        check(product == 0.0f, "denormal result flushed to zero");
+    }
+    check(DenormalMode::isFlushToZeroEnabled() == before, "previous mode restored");
+
+    // Test 2: every built-in effect decays without producing denormals
+    std::cout << "\nTest 2: Decaying signals through the built-in effects" << std::endl;
+    std::vector<std::pair<std::string, std::function<std::shared_ptr<IAudioProcessor>()>>> effects = {
+        { "Delay", [] { return std::make_shared<Delay>(250.0f, 0.7f, 0.5f); } },
+        { "Reverb", [] { return std::make_shared<Reverb>(0.9f, 0.2f, 0.5f); } },
+        { "BiquadFilter", [] { return std::make_shared<BiquadFilter>(FilterType::LowPass); } },
+        { "StereoEnhancer", [] { return std::make_shared<StereoEnhancer>(1.5f); } },
+        { "MultibandCompressor", [] { return std::make_shared<MultibandCompressor>(); } },
+        { "ConvolutionReverb", [] { return std::make_shared<LoadedConvolutionReverb>(); } },
+        { "ParametricEQ", [] { return std::make_shared<ParametricEQ>(); } },
+        { "SpectralGate", [] { return std::make_shared<SpectralGate>(); } },
+        { "PhaseVocoder", [] {
+            auto vocoder = std::make_shared<PhaseVocoder>();
+            vocoder->setPitchShift(7.0f);
+            vocoder->setFormantPreservation(true);
+            return vocoder;
+        } },
+        { "SpectralProcessor", [] {
+            auto spectral = std::make_shared<SpectralProcessor>();
+            spectral->setProcessMode(SpectralProcessor::SPECTRAL_COMPRESSOR);
+            return spectral;
+        } },
+        { "TubeSaturation", [] { return std::make_shared<TubeSaturation>(2.0f); } },
+        { "GainPlugin", [] { return std::make_shared<PluginProcessor>(std::make_unique<GainPlugin>()); } },
+        { "DelayPlugin", [] { return std::make_shared<PluginProcessor>(std::make_unique<DelayPlugin>()); } },
+        { "ReverbPlugin", [] { return std::make_shared<PluginProcessor>(std::make_unique<ReverbPlugin>()); } },
+        { "CompressorPlugin", [] { return std::make_shared<PluginProcessor>(std::make_unique<CompressorPlugin>()); } },
+        { "EQPlugin", [] { return std::make_shared<PluginProcessor>(std::make_unique<EQPlugin>()); } },
+    };
+
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& effect : effects) {
+        // Without the guard, for reference
+        auto reference = effect.second();
+        DecayResult unguarded = runDecay(*reference);
+
+        auto processor = effect.second();
+        DecayResult guarded;
+        {
+            ScopedNoDenormals noDenormals;
+            guarded = runDecay(*processor);
+        }
+
+        std::cout << "  " << std::left << std::setw(20) << effect.first << std::right
+                  << " signal " << std::setw(7) << guarded.signalMicros << " us"
+                  << "  tail " << std::setw(7) << guarded.tailMicros << " us"
+                  << "  (unguarded tail " << unguarded.tailMicros << " us, "
+                  << unguarded.subnormalSamples << " subnormal samples)" << std::endl;
+
+        check(guarded.subnormalSamples == 0, effect.first + " output has no denormals");
+
+        // The slow path costs 10-100x; silence should never cost much more than signal
+        check(guarded.tailMicros <= guarded.signalMicros * 4.0 + 5.0, effect.first + " tail stays on the fast path");
+    }
+
+    // Test 3: the engine enables it on the callback and on every worker
+    std::cout << "\nTest 3: Engine callback and worker threads" << std::endl;
+    {
+        AudioEngine engine;
+        engine.initializeOffline(kSampleRate, kBlockSize, kNumChannels);
+        engine.setWorkerThreadCount(2);
+        engine.setParallelMinBlockSize(1);
+
+        auto masterProbe = std::make_shared<ModeProbe>();
+        engine.addProcessor(masterProbe);
+        std::vector<std::shared_ptr<ModeProbe>> chainProbes;
+        for (int i = 0; i < 4; ++i) {
+            chainProbes.push_back(std::make_shared<ModeProbe>());
+            engine.addParallelChain({ chainProbes.back() });
+        }
+
+        std::vector<float> output(kBlockSize * kNumChannels);
+        for (int block = 0; block < 50; ++block) {
+            engine.processOfflineBlock(output.data(), kBlockSize);
+        }
+
+        int calls = masterProbe->calls.load();
+        int withoutFlush = masterProbe->callsWithoutFlush.load();
+        for (const auto& probe : chainProbes) {
+            calls += probe->calls.load();
+            withoutFlush += probe->callsWithoutFlush.load();
+        }
+        check(calls == 50 * 5, "all processors ran");
+        check(withoutFlush == 0, "flush-to-zero on for every processor call");
+        check(DenormalMode::isFlushToZeroEnabled() == before, "caller's mode untouched");
+
+        engine.shutdown();
+    }
+
+    std::cout << "\n" << (failures == 0 ? "All denormal tests passed" : "Denormal tests FAILED") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,1463 @@
+#include "BiquadCascade.h"
+#include "Convolver.h"
+#include "FFT.h"
+#include "Mixer.h"
+#include "Resampler.h"
+#include "Router.h"
+#include "SIMDKernels.h"
+#include "STFT.h"
+#include "TimeStretch.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace OmegaDAW;
+
+namespace {
+
+// Planar and interleaved buffers for one block size / channel count
+struct BenchmarkBuffers {
+    std::vector<std::vector<float>> planar;
+    std::vector<float*> pointers;
+    std::vector<float> interleaved;
+    std::vector<float> output;
+
+    BenchmarkBuffers(int numChannels, int numFrames)
+        : planar(numChannels, std::vector<float>(numFrames))
+        , pointers(numChannels)
+        , interleaved(static_cast<size_t>(numChannels) * numFrames)
+        , output(static_cast<size_t>(numChannels) * numFrames) {
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> dist(-1.5f, 1.5f);
+        for (float& sample : interleaved) {
+            sample = dist(rng);
+        }
+        for (int ch = 0; ch < numChannels; ++ch) {
+            pointers[ch] = planar[ch].data();
+        }
+    }
+};
+
+// The engine's per-block I/O work: deinterleave input, master gain + clip, interleave output
+void runBlock(BenchmarkBuffers& buffers, int numChannels, int numFrames) {
+    SIMD::deinterleave(buffers.interleaved.data(), buffers.pointers.data(), numChannels, numFrames, 0.8f);
+    for (int ch = 0; ch < numChannels; ++ch) {
+        SIMD::applyGain(buffers.pointers[ch], numFrames, 1.1f);
+        SIMD::softClip(buffers.pointers[ch], numFrames);
+    }
+    SIMD::interleave(buffers.pointers.data(), buffers.output.data(), numChannels, numFrames);
+}
+
+double nanosecondsPerBlock(int numChannels, int numFrames) {
+    BenchmarkBuffers buffers(numChannels, numFrames);
+
+    // Aim for a similar amount of work per measurement at every size
+    int iterations = std::max(200, 4000000 / (numChannels * numFrames));
+    for (int i = 0; i < iterations / 10; ++i) {
+        runBlock(buffers, numChannels, numFrames);
+    }
+
+    // Best of five to filter out scheduler noise
+    double best = 1.0e30;
+    for (int run = 0; run < 5; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            runBlock(buffers, numChannels, numFrames);
+        }
+        auto end = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double, std::nano>(end - start).count();
+        best = std::min(best, elapsed / iterations);
+    }
+    return best;
+}
+
+// Maximum difference between the active instruction set and the scalar reference
+float compareWithScalar(SIMD::InstructionSet set, int numChannels, int numFrames) {
+    BenchmarkBuffers reference(numChannels, numFrames);
+    BenchmarkBuffers candidate(numChannels, numFrames);
+
+    SIMD::setInstructionSet(SIMD::InstructionSet::Scalar);
+    runBlock(reference, numChannels, numFrames);
+    SIMD::setInstructionSet(set);
+    runBlock(candidate, numChannels, numFrames);
+
+    float maxDiff = 0.0f;
+    for (size_t i = 0; i < reference.output.size(); ++i) {
+        maxDiff = std::max(maxDiff, std::abs(reference.output[i] - candidate.output[i]));
+    }
+    return maxDiff;
+}
+
+// AudioBuffer math, one channel at a time: dest (read/written), a, b
+struct BufferKernel {
+    const char* name;
+    int streams;  // Floats read or written per sample
+    void (*run)(float* dest, const float* a, const float* b, int numSamples);
+};
+
+const BufferKernel bufferKernels[] = {
+    { "copy", 2, [](float* d, const float* a, const float*, int n) { std::memcpy(d, a, n * sizeof(float)); } },
+    { "clear", 1, [](float* d, const float*, const float*, int n) { std::memset(d, 0, n * sizeof(float)); } },
+    { "applyGain", 2, [](float* d, const float*, const float*, int n) { SIMD::applyGain(d, n, 1.0f); } },
+    { "applyGainRamp", 2, [](float* d, const float*, const float*, int n) { SIMD::applyGainRamp(d, n, 1.0f, 1.0f); } },
+    { "add", 3, [](float* d, const float* a, const float*, int n) { SIMD::add(d, a, n); } },
+    { "addWithGain", 3, [](float* d, const float* a, const float*, int n) { SIMD::addWithGain(d, a, n, 0.5f); } },
+    { "addWithGainRamp", 3, [](float* d, const float* a, const float*, int n) { SIMD::addWithGainRamp(d, a, n, 0.0f, 1.0f); } },
+    { "multiplyAdd", 4, [](float* d, const float* a, const float* b, int n) { SIMD::multiplyAdd(d, a, b, n); } },
+    { "complexMultiplyAdd", 4, [](float* d, const float* a, const float* b, int n) { SIMD::complexMultiplyAdd(d, a, b, n / 2); } },
+};
+
+// Cache-resident throughput in GB/s (bytes read plus bytes written)
+double bufferKernelThroughput(const BufferKernel& kernel, int numSamples) {
+    std::vector<float> dest(numSamples, 0.25f);
+    std::vector<float> a(numSamples, 0.5f);
+    std::vector<float> b(numSamples, 0.75f);
+
+    int iterations = std::max(1000, 50000000 / numSamples);
+    double best = 1.0e30;
+    for (int run = 0; run < 5; ++run) {
+        std::fill(dest.begin(), dest.end(), 0.25f);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            kernel.run(dest.data(), a.data(), b.data(), numSamples);
+        }
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(end - start).count());
+    }
+    double bytes = static_cast<double>(iterations) * numSamples * kernel.streams * sizeof(float);
+    return bytes / best / 1.0e9;
+}
+
+// Maximum difference between each buffer kernel and its scalar reference
+float compareBufferKernelsWithScalar(SIMD::InstructionSet set) {
+    float maxDiff = 0.0f;
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    for (int numSamples : { 1, 3, 15, 17, 33, 100, 1027 }) {
+        std::vector<float> a(numSamples), b(numSamples), initial(numSamples);
+        for (int i = 0; i < numSamples; ++i) {
+            a[i] = dist(rng);
+            b[i] = dist(rng);
+            initial[i] = dist(rng);
+        }
+        for (const auto& kernel : bufferKernels) {
+            std::vector<float> reference = initial;
+            std::vector<float> candidate = initial;
+            SIMD::setInstructionSet(SIMD::InstructionSet::Scalar);
+            kernel.run(reference.data(), a.data(), b.data(), numSamples);
+            SIMD::setInstructionSet(set);
+            kernel.run(candidate.data(), a.data(), b.data(), numSamples);
+            for (int i = 0; i < numSamples; ++i) {
+                maxDiff = std::max(maxDiff, std::abs(reference[i] - candidate[i]));
+            }
+        }
+
+        SIMD::setInstructionSet(SIMD::InstructionSet::Scalar);
+        float referencePeak = SIMD::peakAbs(a.data(), numSamples);
+        SIMD::setInstructionSet(set);
+        maxDiff = std::max(maxDiff, std::abs(referencePeak - SIMD::peakAbs(a.data(), numSamples)));
+    }
+
+    // Two blocks per pass, for every vector width's short and long quarters
+    for (int quarter : { 1, 2, 4, 8, 16, 32, 64 }) {
+        int n = 8 * quarter;
+        std::vector<float> re(n), im(n), twiddles(4 * quarter);
+        for (int i = 0; i < n; ++i) {
+            re[i] = dist(rng);
+            im[i] = dist(rng);
+        }
+        for (float& twiddle : twiddles) {
+            twiddle = dist(rng);
+        }
+        std::vector<float> referenceRe = re, referenceIm = im;
+        SIMD::setInstructionSet(SIMD::InstructionSet::Scalar);
+        SIMD::fftRadix4(referenceRe.data(), referenceIm.data(), n, quarter, twiddles.data());
+        SIMD::setInstructionSet(set);
+        SIMD::fftRadix4(re.data(), im.data(), n, quarter, twiddles.data());
+        for (int i = 0; i < n; ++i) {
+            maxDiff = std::max(maxDiff, std::abs(referenceRe[i] - re[i]));
+            maxDiff = std::max(maxDiff, std::abs(referenceIm[i] - im[i]));
+        }
+    }
+
+    // Every lane packing, blocks shorter than the pipeline, with and without glides
+    for (int channels : { 1, 2, 4, 8 }) {
+        for (int frames : { 1, 3, 7, 64 }) {
+            for (bool glide : { false, true }) {
+                std::vector<float> samples(frames * channels), coefficients(5 * SIMD::kBiquadLanes);
+                std::vector<float> increments(5 * SIMD::kBiquadLanes), state(2 * SIMD::kBiquadLanes);
+                for (float& sample : samples) {
+                    sample = dist(rng);
+                }
+                for (int lane = 0; lane < SIMD::kBiquadLanes; ++lane) {
+                    coefficients[lane] = 0.5f + 0.25f * dist(rng);
+                    coefficients[SIMD::kBiquadLanes + lane] = 0.25f * dist(rng);
+                    coefficients[2 * SIMD::kBiquadLanes + lane] = 0.25f * dist(rng);
+                    coefficients[3 * SIMD::kBiquadLanes + lane] = -0.5f + 0.25f * dist(rng);
+                    coefficients[4 * SIMD::kBiquadLanes + lane] = 0.25f + 0.1f * dist(rng);
+                }
+                for (float& increment : increments) {
+                    increment = 0.001f * dist(rng);
+                }
+                for (float& value : state) {
+                    value = 0.1f * dist(rng);
+                }
+                std::vector<float> referenceSamples = samples, referenceCoefficients = coefficients;
+                std::vector<float> referenceState = state;
+                const float* step = glide ? increments.data() : nullptr;
+                SIMD::setInstructionSet(SIMD::InstructionSet::Scalar);
+                SIMD::biquadLanes(referenceSamples.data(), frames, channels, referenceCoefficients.data(), step,
+                                  referenceState.data());
+                SIMD::setInstructionSet(set);
+                SIMD::biquadLanes(samples.data(), frames, channels, coefficients.data(), step, state.data());
+                for (size_t i = 0; i < samples.size(); ++i) {
+                    maxDiff = std::max(maxDiff, std::abs(referenceSamples[i] - samples[i]));
+                }
+                for (size_t i = 0; i < state.size(); ++i) {
+                    maxDiff = std::max(maxDiff, std::abs(referenceState[i] - state[i]));
+                }
+                for (size_t i = 0; i < coefficients.size(); ++i) {
+                    maxDiff = std::max(maxDiff, std::abs(referenceCoefficients[i] - coefficients[i]));
+                }
+            }
+        }
+    }
+    return maxDiff;
+}
+
+struct ConvolutionResult {
+    double directRealtime;      // Times realtime; the old direct-form loop
+    double uniformRealtime;
+    double nonUniformRealtime;
+    double uniformWorstUs;      // Slowest block
+    double nonUniformWorstUs;
+    double errorDb;             // Worst sample of either mode against double precision, relative to the peak
+};
+
+// Stereo noise through a stereo noise-decay response, 256-frame blocks,
+// low-latency partitions of 128
+ConvolutionResult benchmarkConvolution(double irSeconds) {
+    const int sampleRate = 48000;
+    const int blockSize = 256;
+    const int irLength = static_cast<int>(irSeconds * sampleRate);
+    const int numFrames = irLength + sampleRate / 2;
+
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<std::vector<float>> ir(2, std::vector<float>(irLength));
+    std::vector<std::vector<float>> input(2, std::vector<float>(numFrames));
+    for (auto& channel : ir) {
+        for (int i = 0; i < irLength; ++i) {
+            channel[i] = 0.3f * dist(rng) * std::exp(-5.0f * i / irLength);
+        }
+    }
+    for (auto& channel : input) {
+        for (float& sample : channel) {
+            sample = dist(rng);
+        }
+    }
+
+    ConvolutionResult result;
+
+    // The old ConvolutionReverb loop (ring buffer, one multiply-add per
+    // tap); far too slow to run in full, so time a few blocks
+    {
+        const int directFrames = 2 * blockSize;
+        std::vector<float> history(irLength, 0.0f);
+        std::vector<float> output(directFrames);
+        int position = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int ch = 0; ch < 2; ++ch) {
+            for (int i = 0; i < directFrames; ++i) {
+                history[position] = input[ch][i];
+                float wet = 0.0f;
+                for (int j = 0; j < irLength; ++j) {
+                    int index = (position - j + irLength) % irLength;
+                    wet += history[index] * ir[ch][j];
+                }
+                position = (position + 1) % irLength;
+                output[i] = wet;
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(end - start).count();
+        result.directRealtime = (static_cast<double>(directFrames) / sampleRate) / elapsed;
+    }
+
+    auto run = [&](bool nonUniform, std::vector<std::vector<float>>& output, double& worstUs) {
+        ConvolverLayout layout;
+        layout.blockSize = 128;
+        layout.maxLength = irLength;
+        layout.nonUniform = nonUniform;
+        Convolver convolver;
+        convolver.prepare(2, layout);
+        convolver.setImpulseResponse(ConvolverIR::create(ir, layout));
+
+        // Prime with silence until the response has faded in at the
+        // largest partition size
+        std::vector<float> silence(blockSize, 0.0f);
+        std::vector<float> scratch(2 * blockSize);
+        const float* silent[2] = { silence.data(), silence.data() };
+        float* discard[2] = { scratch.data(), scratch.data() + blockSize };
+        for (int done = 0; done < 2 * 64 * layout.blockSize; done += blockSize) {
+            convolver.process(silent, discard, blockSize);
+        }
+
+        output.assign(2, std::vector<float>(numFrames));
+        worstUs = 0.0;
+        auto start = std::chrono::steady_clock::now();
+        for (int done = 0; done < numFrames; done += blockSize) {
+            int frames = std::min(blockSize, numFrames - done);
+            const float* in[2] = { input[0].data() + done, input[1].data() + done };
+            float* out[2] = { output[0].data() + done, output[1].data() + done };
+            auto blockStart = std::chrono::steady_clock::now();
+            convolver.process(in, out, frames);
+            auto blockEnd = std::chrono::steady_clock::now();
+            worstUs = std::max(worstUs, std::chrono::duration<double, std::micro>(blockEnd - blockStart).count());
+        }
+        auto end = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(end - start).count();
+        return (static_cast<double>(numFrames) / sampleRate) / elapsed;
+    };
+
+    std::vector<std::vector<float>> uniform;
+    std::vector<std::vector<float>> nonUniform;
+    result.uniformRealtime = run(false, uniform, result.uniformWorstUs);
+    result.nonUniformRealtime = run(true, nonUniform, result.nonUniformWorstUs);
+
+    // Exact output over the last 256 frames, where every tap is in play
+    double maxError = 0.0;
+    double peak = 0.0;
+    for (int ch = 0; ch < 2; ++ch) {
+        for (int n = numFrames - 256; n < numFrames; ++n) {
+            double exact = 0.0;
+            for (int k = 0; k < irLength; ++k) {
+                exact += static_cast<double>(ir[ch][k]) * input[ch][n - k];
+            }
+            peak = std::max(peak, std::abs(exact));
+            maxError = std::max(maxError, std::abs(exact - uniform[ch][n]));
+            maxError = std::max(maxError, std::abs(exact - nonUniform[ch][n]));
+        }
+    }
+    result.errorDb = 20.0 * std::log10(std::max(maxError / peak, 1.0e-12));
+    return result;
+}
+
+struct STFTResult {
+    double blockUs;           // Per 256-frame stereo block
+    double instancesPerCore;  // Realtime at 48 kHz
+    double reconstructionDb;  // Worst sample, untouched spectrum, against the delayed input
+};
+
+// Stereo noise through a StreamingSTFT with a per-bin gate in the callback
+STFTResult benchmarkSTFT(int fftSize, int overlap) {
+    const int sampleRate = 48000;
+    const int blockSize = 256;
+    const int numBlocks = 400;
+    const int numFrames = blockSize * numBlocks;
+
+    std::mt19937 rng(23);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<std::vector<float>> input(2, std::vector<float>(numFrames));
+    for (auto& channel : input) {
+        for (float& sample : channel) {
+            sample = dist(rng);
+        }
+    }
+    std::vector<std::vector<float>> output(2, std::vector<float>(numFrames));
+
+    StreamingSTFT stft;
+    stft.prepare(2, fftSize, overlap);
+    auto run = [&]() {
+        stft.reset();
+        for (int done = 0; done < numFrames; done += blockSize) {
+            const float* in[2] = { input[0].data() + done, input[1].data() + done };
+            float* out[2] = { output[0].data() + done, output[1].data() + done };
+            stft.process(in, out, 2, blockSize);
+        }
+    };
+
+    STFTResult result;
+
+    // Untouched spectrum first: the output is the input, delayed
+    run();
+    const int latency = stft.getLatency();
+    double maxError = 0.0;
+    for (int ch = 0; ch < 2; ++ch) {
+        for (int i = latency; i < numFrames; ++i) {
+            maxError = std::max(maxError, static_cast<double>(std::abs(output[ch][i] - input[ch][i - latency])));
+        }
+    }
+    result.reconstructionDb = 20.0 * std::log10(std::max(maxError, 1.0e-12));
+
+    const float thresholdPower = 1.0e-4f / (stft.getAmplitudeScale() * stft.getAmplitudeScale());
+    stft.setCallback([thresholdPower](int, std::complex<float>* bins, int numBins) {
+        for (int i = 0; i < numBins; ++i) {
+            if (std::norm(bins[i]) < thresholdPower) {
+                bins[i] *= 0.1f;
+            }
+        }
+    });
+
+    double best = 1.0e30;
+    for (int pass = 0; pass < 3; ++pass) {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::micro>(end - start).count());
+    }
+    result.blockUs = best / numBlocks;
+    result.instancesPerCore = (1.0e6 * blockSize / sampleRate) / result.blockUs;
+    return result;
+}
+
+struct TimeStretchResult {
+    double blockUs;          // Per 256-frame stereo output block
+    double voicesPerCore;    // Realtime at 48 kHz
+    double pitchErrorCents;  // 440 Hz sine, measured against the expected frequency
+};
+
+// Stereo clip audio pulled through a TimeStretcher a block at a time, the
+// way ClipVoice plays it
+TimeStretchResult benchmarkTimeStretch(const StretchSettings& settings, TimeStretcher::Quality quality) {
+    const int sampleRate = 48000;
+    const int blockSize = 256;
+    const int numBlocks = 400;
+    const int numFrames = blockSize * numBlocks;
+    const double pi = 3.14159265358979323846;
+    const double frequency = 440.0;
+
+    // Enough source for the output, whatever the stretch
+    const int sourceFrames = static_cast<int>(numFrames / settings.timeStretch) + 16384;
+    // A sine over a noise floor, so every bin has a peak region to lock
+    std::mt19937 rng(29);
+    std::uniform_real_distribution<float> noise(-0.002f, 0.002f);
+    std::vector<std::vector<float>> source(2, std::vector<float>(sourceFrames));
+    for (int ch = 0; ch < 2; ++ch) {
+        for (int i = 0; i < sourceFrames; ++i) {
+            source[ch][i] = static_cast<float>(0.5 * std::sin(2.0 * pi * frequency * i / sampleRate + ch)) + noise(rng);
+        }
+    }
+    std::vector<std::vector<float>> output(2, std::vector<float>(numFrames));
+
+    TimeStretcher stretcher;
+    stretcher.prepare(2, sampleRate, quality);
+    stretcher.setSettings(settings);
+    auto run = [&]() {
+        stretcher.reset();
+        int read = -stretcher.getPreRoll();
+        for (int block = 0; block < numBlocks; ++block) {
+            int done = 0;
+            while (done < blockSize) {
+                float* out[2] = { output[0].data() + block * blockSize + done,
+                                  output[1].data() + block * blockSize + done };
+                done += stretcher.read(out, blockSize - done);
+                if (done == blockSize) {
+                    break;
+                }
+                int needed = stretcher.getInputFramesNeeded();
+                if (read < 0) {
+                    read += stretcher.write(nullptr, std::min(needed, -read));
+                } else {
+                    const float* in[2] = { source[0].data() + read, source[1].data() + read };
+                    read += stretcher.write(in, needed);
+                }
+            }
+        }
+    };
+
+    double best = 1.0e30;
+    for (int pass = 0; pass < 3; ++pass) {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::micro>(end - start).count());
+    }
+
+    TimeStretchResult result;
+    result.blockUs = best / numBlocks;
+    result.voicesPerCore = (1.0e6 * blockSize / sampleRate) / result.blockUs;
+
+    // Frequency from the upward zero crossings of the second half, well past
+    // the start
+    const std::vector<float>& left = output[0];
+    double first = -1.0;
+    double last = -1.0;
+    int crossings = 0;
+    for (int i = numFrames / 2; i < numFrames; ++i) {
+        if (left[i - 1] < 0.0f && left[i] >= 0.0f) {
+            last = i - left[i] / (left[i] - left[i - 1]);
+            if (first < 0.0) {
+                first = last;
+            }
+            ++crossings;
+        }
+    }
+    double measured = crossings > 1 ? (crossings - 1) * sampleRate / (last - first) : 0.0;
+    double expected = frequency * std::pow(2.0, settings.pitchShift / 12.0);
+    result.pitchErrorCents = measured > 0.0 ? 1200.0 * std::log2(measured / expected) : 1.0e9;
+    return result;
+}
+
+struct ResamplerResult {
+    double megaSamplesPerSecond;  // Output samples (all channels)
+    double realtimeFactor;
+    double errorDb;               // Worst channel, relative to full scale
+};
+
+// Streams one second of a 997 Hz sine through the resampler in 256-frame
+// blocks and compares against the ideal sine at the output rate
+ResamplerResult benchmarkResampler(int inputRate, int outputRate, ResamplerQuality quality) {
+    const int numChannels = 2;
+    const int blockSize = 256;
+    const double pi = 3.14159265358979323846;
+    const double frequency = 997.0;
+
+    std::vector<std::vector<float>> input(numChannels, std::vector<float>(inputRate));
+    for (int ch = 0; ch < numChannels; ++ch) {
+        for (int i = 0; i < inputRate; ++i) {
+            input[ch][i] = static_cast<float>(0.5 * std::sin(2.0 * pi * frequency * i / inputRate + ch));
+        }
+    }
+
+    int maxOutput = outputRate + blockSize;
+    std::vector<std::vector<float>> output(numChannels, std::vector<float>(maxOutput));
+    std::vector<const float*> inputPointers(numChannels);
+    std::vector<float*> outputPointers(numChannels);
+
+    Resampler resampler;
+    resampler.initialize(inputRate, outputRate, numChannels, quality);
+
+    auto runOnce = [&]() {
+        resampler.reset();
+        int consumed = 0;
+        int produced = 0;
+        while (consumed < inputRate && produced < maxOutput) {
+            for (int ch = 0; ch < numChannels; ++ch) {
+                inputPointers[ch] = input[ch].data() + consumed;
+                outputPointers[ch] = output[ch].data() + produced;
+            }
+            int used = 0;
+            produced += resampler.process(inputPointers.data(), std::min(blockSize, inputRate - consumed),
+                                          outputPointers.data(), maxOutput - produced, used);
+            consumed += used;
+        }
+        return produced;
+    };
+
+    runOnce();
+    double best = 1.0e30;
+    int produced = 0;
+    for (int run = 0; run < 3; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        produced = runOnce();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(end - start).count());
+    }
+
+    // Output n sits at input time n * inputRate / outputRate; skip the filter's edges
+    double maxError = 0.0;
+    int margin = resampler.getLatency() * 2 + 16;
+    for (int ch = 0; ch < numChannels; ++ch) {
+        for (int n = margin; n < produced - margin; ++n) {
+            double ideal = 0.5 * std::sin(2.0 * pi * frequency * n / outputRate + ch);
+            maxError = std::max(maxError, std::abs(output[ch][n] - ideal));
+        }
+    }
+
+    ResamplerResult result;
+    result.megaSamplesPerSecond = produced * numChannels / best / 1.0e6;
+    result.realtimeFactor = (static_cast<double>(produced) / outputRate) / best;
+    result.errorDb = 20.0 * std::log10(std::max(maxError, 1.0e-12));
+    return result;
+}
+
+// The FFT FFTProcessor used before FFTPlan: a complex radix-2 transform of the
+// real input, twiddles from cos/sin per stage, inverse via a heap copy. In
+// double precision it is also the accuracy reference.
+template <typename T>
+void referenceFFT(std::complex<T>* data, int n, bool inverse) {
+    for (int i = 1, j = 0; i < n; ++i) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(data[i], data[j]);
+        }
+    }
+    const T twoPi = static_cast<T>(6.28318530717958647692);
+    for (int len = 2; len <= n; len <<= 1) {
+        T angle = (inverse ? twoPi : -twoPi) / len;
+        std::complex<T> wlen(std::cos(angle), std::sin(angle));
+        for (int i = 0; i < n; i += len) {
+            std::complex<T> w(1, 0);
+            for (int j = 0; j < len / 2; ++j) {
+                std::complex<T> u = data[i + j];
+                std::complex<T> v = data[i + j + len / 2] * w;
+                data[i + j] = u + v;
+                data[i + j + len / 2] = u - v;
+                w *= wlen;
+            }
+        }
+    }
+}
+
+void referenceForward(const float* input, std::complex<float>* output, int n) {
+    for (int i = 0; i < n; ++i) {
+        output[i] = std::complex<float>(input[i], 0.0f);
+    }
+    referenceFFT(output, n, false);
+}
+
+void referenceInverse(const std::complex<float>* input, float* output, int n) {
+    std::vector<std::complex<float>> temp(input, input + n);
+    referenceFFT(temp.data(), n, true);
+    for (int i = 0; i < n; ++i) {
+        output[i] = temp[i].real() / n;
+    }
+}
+
+struct FFTResult {
+    double referenceForwardNs;
+    double forwardNs;
+    double referenceInverseNs;
+    double inverseNs;
+    double referenceErrorDb;  // Worst bin against double precision, relative to the largest
+    double errorDb;
+    double roundTripDb;
+};
+
+FFTResult benchmarkFFT(int size) {
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> input(size);
+    for (float& sample : input) {
+        sample = dist(rng);
+    }
+    std::vector<std::complex<float>> referenceBins(size);
+    std::vector<std::complex<float>> bins(size / 2 + 1);
+    std::vector<float> output(size);
+    FFTProcessor fft(size);
+
+    // Best of five, each long enough to swamp the clock
+    int iterations = std::max(20, (1 << 22) / size);
+    auto time = [&](auto&& transform) {
+        double best = 1.0e30;
+        for (int run = 0; run < 5; ++run) {
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; ++i) {
+                transform();
+            }
+            auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count() / iterations);
+        }
+        return best;
+    };
+
+    FFTResult result;
+    result.referenceForwardNs = time([&]() { referenceForward(input.data(), referenceBins.data(), size); });
+    result.forwardNs = time([&]() { fft.forward(input.data(), bins.data()); });
+    result.referenceInverseNs = time([&]() { referenceInverse(referenceBins.data(), output.data(), size); });
+    result.inverseNs = time([&]() { fft.inverse(bins.data(), output.data()); });
+
+    std::vector<std::complex<double>> exact(input.begin(), input.end());
+    referenceFFT(exact.data(), size, false);
+    double maxReferenceError = 0.0;
+    double maxError = 0.0;
+    double maxBin = 0.0;
+    for (int k = 0; k <= size / 2; ++k) {
+        maxReferenceError = std::max(maxReferenceError, std::abs(exact[k] - std::complex<double>(referenceBins[k])));
+        maxError = std::max(maxError, std::abs(exact[k] - std::complex<double>(bins[k])));
+        maxBin = std::max(maxBin, std::abs(exact[k]));
+    }
+    double maxRoundTrip = 0.0;
+    for (int i = 0; i < size; ++i) {
+        maxRoundTrip = std::max(maxRoundTrip, static_cast<double>(std::abs(output[i] - input[i])));
+    }
+    result.referenceErrorDb = 20.0 * std::log10(std::max(maxReferenceError / maxBin, 1.0e-12));
+    result.errorDb = 20.0 * std::log10(std::max(maxError / maxBin, 1.0e-12));
+    result.roundTripDb = 20.0 * std::log10(std::max(maxRoundTrip, 1.0e-12));
+    return result;
+}
+
+// The loop ParametricEQ and EQPlugin ran before BiquadCascade: direct form
+// I, one sample of one channel through one section at a time. In double
+// precision it is also the accuracy reference.
+template <typename T>
+struct ReferenceBiquad {
+    T b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+    T x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+};
+
+template <typename T, typename Sample>
+void referenceBiquads(std::vector<std::vector<ReferenceBiquad<T>>>& filters, Sample* const* channels,
+                      int numFrames) {
+    for (size_t ch = 0; ch < filters.size(); ++ch) {
+        for (int i = 0; i < numFrames; ++i) {
+            T sample = channels[ch][i];
+            for (auto& f : filters[ch]) {
+                T output = f.b0 * sample + f.b1 * f.x1 + f.b2 * f.x2 - f.a1 * f.y1 - f.a2 * f.y2;
+                f.x2 = f.x1;
+                f.x1 = sample;
+                f.y2 = f.y1;
+                f.y1 = output;
+                sample = output;
+            }
+            channels[ch][i] = static_cast<Sample>(sample);
+        }
+    }
+}
+
+template <typename T>
+std::vector<std::vector<ReferenceBiquad<T>>> referenceFilters(int numChannels,
+                                                             const std::vector<BiquadCoefficients>& sections) {
+    std::vector<std::vector<ReferenceBiquad<T>>> filters(numChannels);
+    for (auto& channel : filters) {
+        channel.resize(sections.size());
+    }
+    for (auto& channel : filters) {
+        for (size_t i = 0; i < sections.size(); ++i) {
+            channel[i].b0 = sections[i].b0;
+            channel[i].b1 = sections[i].b1;
+            channel[i].b2 = sections[i].b2;
+            channel[i].a1 = sections[i].a1;
+            channel[i].a2 = sections[i].a2;
+        }
+    }
+    return filters;
+}
+
+// +/-6 dB peaking sections spread over the audio band
+BiquadCoefficients peakingSection(int section, int sampleRate) {
+    const double pi = 3.14159265358979323846;
+    double frequency = 100.0 * std::pow(2.0, section * 1.3);
+    double a = std::pow(10.0, (section % 2 ? -6.0 : 6.0) / 40.0);
+    double omega = 2.0 * pi * frequency / sampleRate;
+    double alpha = std::sin(omega) / 2.0;
+    double a0 = 1.0 + alpha / a;
+    BiquadCoefficients c;
+    c.b0 = static_cast<float>((1.0 + alpha * a) / a0);
+    c.b1 = static_cast<float>(-2.0 * std::cos(omega) / a0);
+    c.b2 = static_cast<float>((1.0 - alpha * a) / a0);
+    c.a1 = c.b1;
+    c.a2 = static_cast<float>((1.0 - alpha / a) / a0);
+    return c;
+}
+
+struct BiquadResult {
+    double referenceNs;         // Per frame, all channels and sections
+    double cascadeNs;
+    double referenceErrorDb;    // Worst sample against double precision, relative to the peak
+    double errorDb;
+};
+
+// Noise through numSections peaking sections on numChannels, 256-frame blocks
+BiquadResult benchmarkBiquads(int numChannels, int numSections) {
+    const int blockSize = 256;
+    const int numBlocks = 64;
+    const int length = blockSize * numBlocks;
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<std::vector<float>> input(numChannels, std::vector<float>(length));
+    for (auto& channel : input) {
+        for (float& sample : channel) {
+            sample = dist(rng);
+        }
+    }
+
+    std::vector<BiquadCoefficients> sections(numSections);
+    BiquadCascade cascade;
+    cascade.prepare(numChannels, numSections, blockSize);
+    for (int section = 0; section < numSections; ++section) {
+        sections[section] = peakingSection(section, 48000);
+        cascade.setSection(section, sections[section]);
+    }
+
+    std::vector<std::vector<float>> referenceOut, cascadeOut;
+    std::vector<float*> pointers(numChannels);
+    auto run = [&](std::vector<std::vector<float>>& buffers, auto&& process) {
+        auto start = std::chrono::steady_clock::now();
+        for (int block = 0; block < numBlocks; ++block) {
+            for (int ch = 0; ch < numChannels; ++ch) {
+                pointers[ch] = buffers[ch].data() + block * blockSize;
+            }
+            process(pointers.data(), blockSize);
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / length;
+    };
+
+    // Best of five passes over the same audio
+    BiquadResult result;
+    result.referenceNs = 1.0e30;
+    result.cascadeNs = 1.0e30;
+    for (int pass = 0; pass < 5; ++pass) {
+        referenceOut = input;
+        cascadeOut = input;
+        auto reference = referenceFilters<float>(numChannels, sections);
+        cascade.reset();
+        result.referenceNs = std::min(result.referenceNs, run(referenceOut, [&](float* const* channels, int frames) {
+            referenceBiquads(reference, channels, frames);
+        }));
+        result.cascadeNs = std::min(result.cascadeNs, run(cascadeOut, [&](float* const* channels, int frames) {
+            cascade.process(channels, numChannels, frames);
+        }));
+    }
+
+    std::vector<std::vector<double>> exact(numChannels);
+    std::vector<double*> exactPointers(numChannels);
+    for (int ch = 0; ch < numChannels; ++ch) {
+        exact[ch].assign(input[ch].begin(), input[ch].end());
+        exactPointers[ch] = exact[ch].data();
+    }
+    auto exactFilters = referenceFilters<double>(numChannels, sections);
+    referenceBiquads(exactFilters, exactPointers.data(), length);
+
+    double maxReferenceError = 0.0;
+    double maxError = 0.0;
+    double peak = 0.0;
+    for (int ch = 0; ch < numChannels; ++ch) {
+        for (int i = 0; i < length; ++i) {
+            maxReferenceError = std::max(maxReferenceError, std::abs(exact[ch][i] - referenceOut[ch][i]));
+            maxError = std::max(maxError, std::abs(exact[ch][i] - cascadeOut[ch][i]));
+            peak = std::max(peak, std::abs(exact[ch][i]));
+        }
+    }
+    result.referenceErrorDb = 20.0 * std::log10(std::max(maxReferenceError / peak, 1.0e-12));
+    result.errorDb = 20.0 * std::log10(std::max(maxError / peak, 1.0e-12));
+    return result;
+}
+
+// Stand-in for a plugin: a few cascaded one-pole lowpasses per channel
+class LoadEffect : public Effect {
+public:
+    void process(AudioBuffer& buffer) override {
+        for (int ch = 0; ch < std::min(buffer.getNumChannels(), 2); ++ch) {
+            float* data = buffer.getWritePointer(ch);
+            for (int stage = 0; stage < kStages; ++stage) {
+                float state = state_[ch][stage];
+                for (int i = 0; i < buffer.getNumSamples(); ++i) {
+                    state += 0.1f * (data[i] - state);
+                    data[i] = state;
+                }
+                state_[ch][stage] = state;
+            }
+        }
+    }
+    void reset() override { std::memset(state_, 0, sizeof(state_)); }
+    bool isEnabled() const override { return true; }
+    void setEnabled(bool) override {}
+
+private:
+    static constexpr int kStages = 8;
+    float state_[2][kStages] = {};
+};
+
+struct MixerResult {
+    double microsecondsPerBlock;
+    std::vector<float> output;  // Master output of every timed block
+};
+
+// numBuses track buses feeding 8 groups, each with a LoadEffect
+MixerResult benchmarkMixer(int numBuses, int numThreads, int blockSize) {
+    const int numGroups = 8;
+    const int numBlocks = 50;
+
+    Mixer mixer;
+    mixer.initialize(48000, blockSize);
+    if (numThreads > 0) {
+        mixer.setWorkerThreadCount(numThreads);
+    }
+
+    std::vector<int> groups;
+    for (int g = 0; g < numGroups; ++g) {
+        groups.push_back(mixer.addBus("Group", ChannelType::Group));
+        mixer.getBus(groups.back())->addEffect(std::make_shared<LoadEffect>());
+    }
+
+    std::vector<int> tracks;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    std::vector<AudioBuffer> inputs(numBuses, AudioBuffer(2, blockSize));
+    for (int t = 0; t < numBuses; ++t) {
+        tracks.push_back(mixer.addBus("Track", ChannelType::Audio));
+        mixer.getBus(tracks.back())->addEffect(std::make_shared<LoadEffect>());
+        mixer.getBus(tracks.back())->setPan(dist(rng));
+        mixer.routeAudio(tracks.back(), groups[t % numGroups], 0.5f);
+        for (int ch = 0; ch < 2; ++ch) {
+            for (int i = 0; i < blockSize; ++i) {
+                inputs[t].setSample(ch, i, dist(rng));
+            }
+        }
+    }
+    // The first block crossfades in from whichever plan the compiler last
+    // got to, which depends on timing; play it, then start both runs clean
+    mixer.flushEdits();
+    mixer.process(AudioBufferView());
+    mixer.reset();
+
+    MixerResult result;
+    double best = 1.0e30;
+    for (int block = 0; block < numBlocks + 5; ++block) {
+        for (int t = 0; t < numBuses; ++t) {
+            mixer.setBusInput(tracks[t], inputs[t]);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        mixer.process(AudioBufferView());
+        auto end = std::chrono::steady_clock::now();
+
+        // First few blocks warm up the caches and the workers
+        if (block >= 5) {
+            best = std::min(best, std::chrono::duration<double, std::micro>(end - start).count());
+            const AudioBuffer& master = mixer.getMasterOutput();
+            for (int ch = 0; ch < master.getNumChannels(); ++ch) {
+                result.output.insert(result.output.end(), master.getReadPointer(ch),
+                                     master.getReadPointer(ch) + master.getNumSamples());
+            }
+        }
+    }
+    result.microsecondsPerBlock = best;
+    return result;
+}
+
+struct RouterResult {
+    double sharedMicroseconds;      // Per block, compiled schedule with shared buffers
+    double unsharedMicroseconds;    // Per block, compiled schedule, a buffer per port
+    double scanMicroseconds;        // Per block, scanning every connection per node
+    double compileMicroseconds;     // One edit (recompiles the schedule)
+    bool identical;
+};
+
+// The router's per-block loop before it was compiled into a schedule
+void processByConnectionScan(const std::vector<int>& order, const std::vector<Connection>& connections,
+                             const std::map<int, std::shared_ptr<AudioNode>>& nodes,
+                             int sampleRate, int blockSize) {
+    for (int nodeId : order) {
+        auto it = nodes.find(nodeId);
+        it->second->clearInputs();
+        if (it->second->getNumInputs() > 0) {
+            it->second->clearOutputs();
+        }
+    }
+    for (int nodeId : order) {
+        auto it = nodes.find(nodeId);
+        auto& node = it->second;
+        double tailSamples = node->getTailLengthSeconds() * sampleRate;
+        if (!node->getTailTracker().canSkip(node->areInputsSilent(), tailSamples, blockSize)) {
+            node->process();
+        }
+        for (const auto& conn : connections) {
+            if (conn.sourceId == nodeId && conn.enabled) {
+                auto targetIt = nodes.find(conn.targetId);
+                if (targetIt != nodes.end()) {
+                    targetIt->second->getInputBuffer(conn.targetChannel)
+                        .addFrom(node->getOutputBuffer(conn.sourceChannel), conn.gain);
+                }
+            }
+        }
+    }
+}
+
+// Processing order the way the router used to sort it (Kahn, connection scan)
+std::vector<int> scanOrder(const std::map<int, std::shared_ptr<AudioNode>>& nodes,
+                           const std::vector<Connection>& connections) {
+    std::map<int, int> inDegree;
+    for (const auto& pair : nodes) {
+        inDegree[pair.first] = 0;
+    }
+    for (const auto& conn : connections) {
+        inDegree[conn.targetId]++;
+    }
+    std::queue<int> pending;
+    for (const auto& pair : inDegree) {
+        if (pair.second == 0) {
+            pending.push(pair.first);
+        }
+    }
+    std::vector<int> order;
+    while (!pending.empty()) {
+        int nodeId = pending.front();
+        pending.pop();
+        order.push_back(nodeId);
+        for (const auto& conn : connections) {
+            if (conn.sourceId == nodeId && --inDegree[conn.targetId] == 0) {
+                pending.push(conn.targetId);
+            }
+        }
+    }
+    return order;
+}
+
+struct RouterGraph {
+    Router router;
+    std::map<int, std::shared_ptr<AudioNode>> nodes;
+    std::vector<int> inputIds;
+    int outputId = -1;
+
+    template <typename NodeType, typename... Args>
+    int add(int id, Args... args) {
+        auto node = std::make_shared<NodeType>(id, args...);
+        router.addNode(node);
+        nodes[id] = node;
+        return id;
+    }
+};
+
+// numNodes nodes: 16 inputs, gain nodes each fed from 10 earlier nodes, and
+// one output; the last gain nodes feed the output to reach numConnections
+void buildDenseGraph(RouterGraph& graph, int numNodes, int numConnections) {
+    const int numInputs = 16;
+    const int fanIn = 10;
+    Router& router = graph.router;
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+
+    router.beginUpdate();
+    graph.outputId = numNodes - 1;
+    for (int id = 0; id < numNodes; ++id) {
+        if (id < numInputs) {
+            graph.inputIds.push_back(graph.add<InputNode>(id, 1));
+        } else if (id == graph.outputId) {
+            graph.add<OutputNode>(id, 1);
+        } else {
+            graph.add<GainNode>(id);
+        }
+    }
+    for (int id = numInputs; id < graph.outputId; ++id) {
+        std::uniform_int_distribution<int> source(0, id - 1);
+        for (int c = 0; c < fanIn; ++c) {
+            int sourceId;
+            do {
+                sourceId = source(rng);
+            } while (router.hasConnection(sourceId, 0, id, 0));
+            router.connect(sourceId, 0, id, 0, (1.0f + dist(rng)) / fanIn);
+        }
+    }
+    int numToOutput = numConnections - static_cast<int>(router.getAllConnections().size());
+    for (int id = graph.outputId - numToOutput; id < graph.outputId; ++id) {
+        router.connect(id, 0, graph.outputId, 0, 1.0f / numToOutput);
+    }
+    router.endUpdate();
+    router.flushEdits();
+}
+
+// Mixing-desk shape: per track input -> gain -> split, one side through a
+// pan into the track mix, the other into an aux mix; aux gain and track mix
+// meet in a master mix -> gain -> output
+void buildChannelStripGraph(RouterGraph& graph, int numTracks) {
+    Router& router = graph.router;
+    router.beginUpdate();
+    int trackMix = graph.add<MixNode>(0, numTracks);
+    int auxMix = graph.add<MixNode>(1, numTracks);
+    int auxGain = graph.add<GainNode>(2);
+    int masterMix = graph.add<MixNode>(3, 2);
+    int masterGain = graph.add<GainNode>(4);
+    graph.outputId = graph.add<OutputNode>(5, 1);
+    for (int t = 0; t < numTracks; ++t) {
+        int base = 6 + 4 * t;
+        graph.inputIds.push_back(graph.add<InputNode>(base, 1));
+        int gain = graph.add<GainNode>(base + 1);
+        int split = graph.add<SplitNode>(base + 2, 2);
+        int pan = graph.add<PanNode>(base + 3);
+        std::static_pointer_cast<PanNode>(graph.nodes[pan])->setPan((t % 5) * 0.4f - 0.8f);
+        router.connect(base, 0, gain, 0);
+        router.connect(gain, 0, split, 0);
+        router.connect(split, 0, pan, 0);
+        router.connect(pan, 0, trackMix, t);
+        router.connect(split, 1, auxMix, t, 0.3f);
+    }
+    router.connect(auxMix, 0, auxGain, 0);
+    router.connect(trackMix, 0, masterMix, 0);
+    router.connect(auxGain, 0, masterMix, 1);
+    router.connect(masterMix, 0, masterGain, 0, 0.5f);
+    router.connect(masterGain, 0, graph.outputId, 0);
+    router.endUpdate();
+    router.flushEdits();
+}
+
+// Fills the graph's inputs with fixed noise
+struct RouterSignal {
+    std::vector<AudioBuffer> inputs;
+
+    RouterSignal(int numInputs, int blockSize)
+        : inputs(numInputs, AudioBuffer(2, blockSize)) {
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+        for (auto& input : inputs) {
+            for (int ch = 0; ch < 2; ++ch) {
+                for (int i = 0; i < blockSize; ++i) {
+                    input.setSample(ch, i, dist(rng));
+                }
+            }
+        }
+    }
+
+    void apply(RouterGraph& graph) {
+        for (size_t i = 0; i < graph.inputIds.size(); ++i) {
+            std::static_pointer_cast<InputNode>(graph.nodes[graph.inputIds[i]])->setInputBuffer(inputs[i]);
+        }
+    }
+};
+
+void appendRouterOutput(RouterGraph& graph, std::vector<float>& output) {
+    const AudioBuffer& buffer = std::static_pointer_cast<OutputNode>(graph.nodes[graph.outputId])->getOutputBuffer();
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
+        output.insert(output.end(), buffer.getReadPointer(ch), buffer.getReadPointer(ch) + buffer.getNumSamples());
+    }
+}
+
+// Times the dense graph three ways; all three must produce the same output
+RouterResult benchmarkRouter(int numNodes, int numConnections, int blockSize) {
+    const int numBlocks = 50;
+    const int sampleRate = 48000;
+
+    RouterGraph shared;
+    RouterGraph unshared;
+    shared.router.initialize(sampleRate, blockSize);
+    unshared.router.initialize(sampleRate, blockSize);
+    unshared.router.setBufferSharing(false);
+    buildDenseGraph(shared, numNodes, numConnections);
+    buildDenseGraph(unshared, numNodes, numConnections);
+    RouterSignal signal(static_cast<int>(shared.inputIds.size()), blockSize);
+
+    // The scan runs on the unshared graph's nodes (every port its own buffer)
+    std::vector<Connection> connections = unshared.router.getAllConnections();
+    std::vector<int> order = scanOrder(unshared.nodes, connections);
+
+    RouterResult result;
+    result.sharedMicroseconds = 1.0e30;
+    result.unsharedMicroseconds = 1.0e30;
+    result.scanMicroseconds = 1.0e30;
+    std::vector<float> sharedOutput;
+    std::vector<float> unsharedOutput;
+    std::vector<float> scanOutput;
+    auto timeBlock = [](double& best, bool record, auto&& process) {
+        auto start = std::chrono::steady_clock::now();
+        process();
+        auto end = std::chrono::steady_clock::now();
+        if (record) {
+            best = std::min(best, std::chrono::duration<double, std::micro>(end - start).count());
+        }
+    };
+
+    for (int block = 0; block < numBlocks + 5; ++block) {
+        bool record = block >= 5;
+
+        signal.apply(shared);
+        timeBlock(result.sharedMicroseconds, record, [&]() { shared.router.process(); });
+        signal.apply(unshared);
+        timeBlock(result.unsharedMicroseconds, record, [&]() { unshared.router.process(); });
+        if (record) {
+            appendRouterOutput(shared, sharedOutput);
+            appendRouterOutput(unshared, unsharedOutput);
+        }
+
+        signal.apply(unshared);
+        timeBlock(result.scanMicroseconds, record, [&]() {
+            processByConnectionScan(order, connections, unshared.nodes, sampleRate, blockSize);
+        });
+        if (record) {
+            appendRouterOutput(unshared, scanOutput);
+        }
+    }
+
+    // Edit to new schedule; a block in between lets each one be adopted, so
+    // the next compile doesn't wait for it
+    result.compileMicroseconds = 1.0e30;
+    for (int i = 0; i < 5; ++i) {
+        const Connection& conn = connections[i];
+        timeBlock(result.compileMicroseconds, true, [&]() {
+            shared.router.setConnectionGain(conn.sourceId, conn.sourceChannel, conn.targetId, conn.targetChannel, conn.gain);
+            shared.router.flushEdits();
+        });
+        shared.router.process();
+    }
+
+    auto same = [](const std::vector<float>& a, const std::vector<float>& b) {
+        return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+    };
+    result.identical = same(sharedOutput, unsharedOutput) && same(sharedOutput, scanOutput);
+    return result;
+}
+
+} // anonymous namespace
+
+int main() {
+    std::cout << "=== DSP Kernel Benchmark ===" << std::endl;
+    std::cout << "Detected instruction set: "
+              << SIMD::getInstructionSetName(SIMD::getBestInstructionSet()) << std::endl;
+    std::cout << "Per block: deinterleave + gain + soft clip + interleave" << std::endl;
+
+    const int frameSizes[] = { 32, 64, 128, 256, 512, 1024 };
+    const int channelCounts[] = { 2, 4, 8, 16, 32 };
+    const SIMD::InstructionSet sets[] = { SIMD::InstructionSet::Scalar, SIMD::InstructionSet::SSE2,
+                                          SIMD::InstructionSet::AVX2, SIMD::InstructionSet::AVX512,
+                                          SIMD::InstructionSet::NEON };
+
+    bool passed = true;
+    for (SIMD::InstructionSet set : sets) {
+        if (!SIMD::isSupported(set)) {
+            continue;
+        }
+
+        std::cout << "\n[" << SIMD::getInstructionSetName(set) << "] ns per block" << std::endl;
+        std::cout << std::setw(8) << "frames";
+        for (int channels : channelCounts) {
+            std::cout << std::setw(10) << (std::to_string(channels) + "ch");
+        }
+        std::cout << std::endl;
+
+        for (int frames : frameSizes) {
+            SIMD::setInstructionSet(set);
+            std::cout << std::setw(8) << frames;
+            for (int channels : channelCounts) {
+                std::cout << std::setw(10) << std::fixed << std::setprecision(0)
+                          << nanosecondsPerBlock(channels, frames);
+            }
+            std::cout << std::endl;
+        }
+
+        // Odd sizes exercise the remainder paths
+        float maxDiff = 0.0f;
+        for (int channels : { 1, 2, 3, 6, 8, 11 }) {
+            for (int frames : { 1, 7, 33, 256 }) {
+                maxDiff = std::max(maxDiff, compareWithScalar(set, channels, frames));
+            }
+        }
+        maxDiff = std::max(maxDiff, compareBufferKernelsWithScalar(set));
+        std::cout << "Max difference from scalar: " << std::scientific << maxDiff << std::endl;
+        if (maxDiff > 1.0e-6f) {
+            passed = false;
+        }
+    }
+
+    std::cout << "\n[Buffer math] GB/s, 4096 samples per call (cache resident)" << std::endl;
+    std::cout << std::setw(20) << "kernel";
+    for (SIMD::InstructionSet set : sets) {
+        if (SIMD::isSupported(set)) {
+            std::cout << std::setw(10) << SIMD::getInstructionSetName(set);
+        }
+    }
+    std::cout << std::endl;
+    for (const auto& kernel : bufferKernels) {
+        std::cout << std::setw(20) << kernel.name;
+        for (SIMD::InstructionSet set : sets) {
+            if (SIMD::isSupported(set)) {
+                SIMD::setInstructionSet(set);
+                std::cout << std::setw(10) << std::fixed << std::setprecision(1)
+                          << bufferKernelThroughput(kernel, 4096);
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    SIMD::setInstructionSet(SIMD::getBestInstructionSet());
+
+    std::cout << "\n[Resampler] stereo, 256-frame blocks, 997 Hz sine" << std::endl;
+    std::cout << std::setw(12) << "quality" << std::setw(16) << "rates"
+              << std::setw(12) << "Msamples/s" << std::setw(12) << "x realtime"
+              << std::setw(12) << "error dB" << std::endl;
+    const std::pair<ResamplerQuality, const char*> qualities[] = {
+        { ResamplerQuality::Draft, "draft" },
+        { ResamplerQuality::Realtime, "realtime" },
+        { ResamplerQuality::Mastering, "mastering" } };
+    const std::pair<int, int> conversions[] = { { 44100, 48000 }, { 48000, 44100 } };
+    for (const auto& quality : qualities) {
+        for (const auto& rates : conversions) {
+            ResamplerResult result = benchmarkResampler(rates.first, rates.second, quality.first);
+            std::cout << std::setw(12) << quality.second
+                      << std::setw(16) << (std::to_string(rates.first) + "->" + std::to_string(rates.second))
+                      << std::fixed << std::setprecision(1)
+                      << std::setw(12) << result.megaSamplesPerSecond
+                      << std::setw(12) << std::setprecision(0) << result.realtimeFactor
+                      << std::setw(12) << std::setprecision(1) << result.errorDb << std::endl;
+        }
+    }
+
+    std::cout << "\n[FFT] real input, ns per transform (reference: complex radix-2, cos/sin per stage)" << std::endl;
+    std::cout << std::setw(8) << "size" << std::setw(12) << "ref fwd" << std::setw(10) << "fwd"
+              << std::setw(10) << "speedup" << std::setw(12) << "ref inv" << std::setw(10) << "inv"
+              << std::setw(10) << "speedup" << std::setw(12) << "ref err dB" << std::setw(10) << "err dB"
+              << std::setw(14) << "round trip dB" << std::endl;
+    for (int size = 256; size <= 16384; size *= 2) {
+        FFTResult result = benchmarkFFT(size);
+        std::cout << std::setw(8) << size << std::fixed << std::setprecision(0)
+                  << std::setw(12) << result.referenceForwardNs
+                  << std::setw(10) << result.forwardNs
+                  << std::setw(10) << std::setprecision(1) << result.referenceForwardNs / result.forwardNs
+                  << std::setw(12) << std::setprecision(0) << result.referenceInverseNs
+                  << std::setw(10) << result.inverseNs
+                  << std::setw(10) << std::setprecision(1) << result.referenceInverseNs / result.inverseNs
+                  << std::setw(12) << result.referenceErrorDb
+                  << std::setw(10) << result.errorDb
+                  << std::setw(14) << result.roundTripDb << std::endl;
+        if (result.errorDb > -100.0 || result.roundTripDb > -100.0) {
+            passed = false;
+        }
+    }
+
+    std::cout << "\n[Biquad] peaking sections, 256-frame blocks, ns per frame "
+              << "(reference: per-sample direct form I)" << std::endl;
+    std::cout << std::setw(10) << "channels" << std::setw(10) << "sections" << std::setw(12) << "reference"
+              << std::setw(10) << "cascade" << std::setw(10) << "speedup" << std::setw(12) << "ref err dB"
+              << std::setw(10) << "err dB" << std::endl;
+    for (auto config : { std::make_pair(1, 1), std::make_pair(1, 8), std::make_pair(2, 1), std::make_pair(2, 3),
+                         std::make_pair(2, 4), std::make_pair(2, 8), std::make_pair(8, 1), std::make_pair(8, 4) }) {
+        BiquadResult result = benchmarkBiquads(config.first, config.second);
+        std::cout << std::setw(10) << config.first << std::setw(10) << config.second
+                  << std::fixed << std::setprecision(2)
+                  << std::setw(12) << result.referenceNs
+                  << std::setw(10) << result.cascadeNs
+                  << std::setw(10) << std::setprecision(1) << result.referenceNs / result.cascadeNs
+                  << std::setw(12) << result.referenceErrorDb
+                  << std::setw(10) << result.errorDb << std::endl;
+        if (result.errorDb > result.referenceErrorDb + 6.0) {
+            passed = false;
+        }
+    }
+
+    std::cout << "\n[STFT] stereo, 256-frame blocks, Hann window, per-bin gate; instances per core at 48 kHz"
+              << std::endl;
+    std::cout << std::setw(8) << "fft" << std::setw(9) << "overlap" << std::setw(12) << "us/block"
+              << std::setw(11) << "instances" << std::setw(16) << "reconstruct dB" << std::endl;
+    for (auto config : { std::make_pair(1024, 4), std::make_pair(2048, 4), std::make_pair(2048, 8),
+                         std::make_pair(4096, 4) }) {
+        STFTResult result = benchmarkSTFT(config.first, config.second);
+        std::cout << std::setw(8) << config.first << std::setw(9) << config.second
+                  << std::fixed << std::setprecision(2) << std::setw(12) << result.blockUs
+                  << std::setprecision(0) << std::setw(11) << result.instancesPerCore
+                  << std::setprecision(1) << std::setw(16) << result.reconstructionDb << std::endl;
+        if (result.reconstructionDb > -100.0) {
+            passed = false;
+        }
+    }
+
+    std::cout << "\n[Time stretch] stereo 440 Hz over noise, 256-frame blocks; voices per core at 48 kHz" << std::endl;
+    std::cout << std::setw(10) << "quality" << std::setw(9) << "stretch" << std::setw(8) << "pitch"
+              << std::setw(10) << "formants" << std::setw(12) << "us/block" << std::setw(9) << "voices"
+              << std::setw(13) << "pitch cents" << std::endl;
+    struct StretchCase {
+        TimeStretcher::Quality quality;
+        StretchSettings settings;
+    };
+    for (const StretchCase& config : {
+             StretchCase{ TimeStretcher::Quality::Realtime, { 1.0, 0.0f, false } },
+             StretchCase{ TimeStretcher::Quality::Realtime, { 1.5, 0.0f, false } },
+             StretchCase{ TimeStretcher::Quality::Realtime, { 0.75, 0.0f, false } },
+             StretchCase{ TimeStretcher::Quality::Realtime, { 1.0, 7.0f, false } },
+             StretchCase{ TimeStretcher::Quality::Realtime, { 1.25, -5.0f, true } },
+             StretchCase{ TimeStretcher::Quality::Offline, { 1.25, -5.0f, true } } }) {
+        TimeStretchResult result = benchmarkTimeStretch(config.settings, config.quality);
+        std::cout << std::setw(10) << (config.quality == TimeStretcher::Quality::Offline ? "offline" : "realtime")
+                  << std::fixed << std::setprecision(2) << std::setw(9) << config.settings.timeStretch
+                  << std::setprecision(0) << std::setw(8) << config.settings.pitchShift
+                  << std::setw(10) << (config.settings.formantPreservation ? "yes" : "no")
+                  << std::setprecision(2) << std::setw(12) << result.blockUs
+                  << std::setprecision(0) << std::setw(9) << result.voicesPerCore
+                  << std::setprecision(1) << std::setw(13) << result.pitchErrorCents << std::endl;
+        if (std::abs(result.pitchErrorCents) > 5.0) {
+            passed = false;
+        }
+    }
+
+    std::cout << "\n[Convolution] stereo, 256-frame blocks, low latency, times realtime "
+              << "(direct: the old time-domain loop)" << std::endl;
+    std::cout << std::setw(8) << "IR s" << std::setw(10) << "direct" << std::setw(10) << "uniform"
+              << std::setw(14) << "non-uniform" << std::setw(17) << "uniform max us"
+              << std::setw(21) << "non-uniform max us" << std::setw(10) << "err dB" << std::endl;
+    for (double irSeconds : { 0.5, 1.0, 3.0 }) {
+        ConvolutionResult result = benchmarkConvolution(irSeconds);
+        std::cout << std::setw(8) << std::fixed << std::setprecision(1) << irSeconds
+                  << std::setw(10) << std::setprecision(2) << result.directRealtime
+                  << std::setw(10) << std::setprecision(1) << result.uniformRealtime
+                  << std::setw(14) << result.nonUniformRealtime
+                  << std::setw(17) << std::setprecision(0) << result.uniformWorstUs
+                  << std::setw(21) << result.nonUniformWorstUs
+                  << std::setw(10) << std::setprecision(1) << result.errorDb << std::endl;
+        if (result.errorDb > -100.0) {
+            passed = false;
+        }
+    }
+
+    int mixerThreads = std::max(1, RealtimeThreadPool::getDefaultWorkerCount());
+    std::cout << "\n[Mixer] 256-frame stereo blocks, 8 groups, "
+              << mixerThreads << " workers + caller" << std::endl;
+    std::cout << std::setw(8) << "buses" << std::setw(12) << "serial us" << std::setw(14) << "parallel us"
+              << std::setw(10) << "speedup" << std::setw(12) << "efficiency" << std::setw(12) << "identical"
+              << std::endl;
+    for (int numBuses : { 64, 128, 256 }) {
+        MixerResult serial = benchmarkMixer(numBuses, 0, 256);
+        MixerResult parallel = benchmarkMixer(numBuses, mixerThreads, 256);
+        bool identical = serial.output.size() == parallel.output.size() &&
+            std::memcmp(serial.output.data(), parallel.output.data(), serial.output.size() * sizeof(float)) == 0;
+        double speedup = serial.microsecondsPerBlock / parallel.microsecondsPerBlock;
+        std::cout << std::setw(8) << numBuses << std::fixed << std::setprecision(1)
+                  << std::setw(12) << serial.microsecondsPerBlock
+                  << std::setw(14) << parallel.microsecondsPerBlock
+                  << std::setw(10) << std::setprecision(2) << speedup
+                  << std::setw(11) << std::setprecision(0) << 100.0 * speedup / (mixerThreads + 1) << "%"
+                  << std::setw(12) << (identical ? "yes" : "NO") << std::endl;
+        if (!identical) {
+            passed = false;
+        }
+    }
+
+    std::cout << "\n[Router] 128-frame stereo blocks, us per block" << std::endl;
+    std::cout << std::setw(8) << "nodes" << std::setw(8) << "conns" << std::setw(10) << "shared"
+              << std::setw(10) << "unshared" << std::setw(10) << "scan" << std::setw(10) << "speedup"
+              << std::setw(12) << "compile us" << std::setw(12) << "identical" << std::endl;
+    for (const auto& size : { std::make_pair(250, 2500), std::make_pair(1000, 10000) }) {
+        RouterResult result = benchmarkRouter(size.first, size.second, 128);
+        std::cout << std::setw(8) << size.first << std::setw(8) << size.second << std::fixed << std::setprecision(1)
+                  << std::setw(10) << result.sharedMicroseconds
+                  << std::setw(10) << result.unsharedMicroseconds
+                  << std::setw(10) << result.scanMicroseconds
+                  << std::setw(10) << result.scanMicroseconds / result.sharedMicroseconds
+                  << std::setw(12) << result.compileMicroseconds
+                  << std::setw(12) << (result.identical ? "yes" : "NO") << std::endl;
+        if (!result.identical) {
+            passed = false;
+        }
+    }
+
+    std::cout << "\n[Router buffers] port working set, 128-frame stereo buffers" << std::endl;
+    std::cout << std::setw(22) << "graph" << std::setw(8) << "ports" << std::setw(9) << "buffers"
+              << std::setw(9) << "aliased" << std::setw(12) << "KB before" << std::setw(11) << "KB after"
+              << std::setw(11) << "reduction" << std::endl;
+    const double kilobytesPerBuffer = 2.0 * AudioBuffer(2, 128).getChannelStride() * sizeof(float) / 1024.0;
+    auto reportBuffers = [&](const std::string& name, auto&& build) {
+        RouterGraph graph;
+        graph.router.initialize(48000, 128);
+        build(graph);
+        int ports = graph.router.getNumPorts();
+        int buffers = graph.router.getNumPortBuffers();
+        std::cout << std::setw(22) << name << std::setw(8) << ports << std::setw(9) << buffers
+                  << std::setw(9) << graph.router.getNumAliasedConnections()
+                  << std::fixed << std::setprecision(0)
+                  << std::setw(12) << ports * kilobytesPerBuffer
+                  << std::setw(11) << buffers * kilobytesPerBuffer
+                  << std::setw(10) << 100.0 * (1.0 - static_cast<double>(buffers) / ports) << "%" << std::endl;
+    };
+    for (int tracks : { 16, 64, 256 }) {
+        reportBuffers(std::to_string(tracks) + "-track strips",
+                      [&](RouterGraph& graph) { buildChannelStripGraph(graph, tracks); });
+    }
+    reportBuffers("dense 250/2500", [](RouterGraph& graph) { buildDenseGraph(graph, 250, 2500); });
+    reportBuffers("dense 1000/10000", [](RouterGraph& graph) { buildDenseGraph(graph, 1000, 10000); });
+
+    std::cout << "\n" << (passed ? "All kernels match the scalar reference" : "Kernel mismatch!") << std::endl;
+    return passed ? 0 : 1;
+}